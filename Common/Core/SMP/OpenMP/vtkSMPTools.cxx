@@ -15,6 +15,8 @@
 
 #include "vtkSMPTools.h"
 
+#include "vtkSMPToolsConfig.h"
+
 #include <omp.h>
 
 #include <algorithm>
@@ -36,7 +38,9 @@ void vtkSMPTools::Initialize(int numThreads)
 
 int vtkSMPTools::GetEstimatedNumberOfThreads()
 {
-  return vtk::detail::smp::GetNumberOfThreads();
+  int numThreads = vtk::detail::smp::GetNumberOfThreads();
+  const vtkSMPToolsConfig* config = vtkSMPToolsConfig::GetLocal();
+  return config ? config->GetNumberOfThreads(numThreads) : numThreads;
 }
 
 int vtk::detail::smp::GetNumberOfThreads()
@@ -49,13 +53,19 @@ void vtk::detail::smp::vtkSMPTools_Impl_For_OpenMP(vtkIdType first,
   vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
   void *functor)
 {
+  int numThreads = omp_get_max_threads();
+  const vtkSMPToolsConfig* config = vtkSMPToolsConfig::GetLocal();
+  if (config)
+  {
+    numThreads = config->GetNumberOfThreads(numThreads);
+  }
   if (grain <= 0)
   {
-    vtkIdType estimateGrain = (last - first)/(omp_get_max_threads() * 4);
+    vtkIdType estimateGrain = (last - first)/(numThreads * 4);
     grain = (estimateGrain > 0) ? estimateGrain : 1;
   }
 
-# pragma omp parallel for schedule(runtime)
+# pragma omp parallel for schedule(runtime) num_threads(numThreads)
   for (vtkIdType from = first; from < last; from += grain)
   {
     functorExecuter(functor, from, grain, last);
@@ -0,0 +1,473 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTools.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPTools.h"
+
+#include "vtkSMPToolsConfig.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Implementation based on a persistent pool of std::thread workers. Each
+// worker (and the external threads, which share queue 0) owns a deque of
+// ranges. A For() call pushes its whole range to the queues, the owner
+// of a queue takes grain sized pieces from the front, while idle threads
+// steal half of the range at the back of another thread's queue. The thread
+// that called For() helps executing work until its range is completed; a
+// For() called from within a worker pushes its range to the worker's own
+// queue so that nested parallelism does not create additional threads.
+//
+// When the number of threads of a job is limited (see vtkSMPToolsConfig),
+// only the thread that started it and a window of workers following it
+// may execute its ranges.
+
+namespace
+{
+
+typedef vtk::detail::smp::ExecuteFunctorPtrType ExecuteFunctorPtrType;
+
+// One invocation of For()
+struct vtkSMPJob
+{
+  ExecuteFunctorPtrType Executer;
+  void *Functor;
+  vtkIdType Grain;
+  std::atomic<vtkIdType> Remaining; // number of items not yet processed
+
+  // Threads allowed to execute the job: the one owning queue Owner and
+  // WindowSize workers starting at WindowStart, or all if WindowSize < 0
+  int Owner;
+  int WindowStart;
+  int WindowSize;
+};
+
+// A range of a job that has not been processed yet
+struct vtkSMPRange
+{
+  vtkSMPJob *Job;
+  vtkIdType Begin;
+  vtkIdType End;
+};
+
+struct vtkSMPWorkQueue
+{
+  std::mutex Lock;
+  std::deque<vtkSMPRange> Ranges;
+};
+
+class vtkSMPThreadPool
+{
+public:
+  explicit vtkSMPThreadPool(int numThreads);
+  ~vtkSMPThreadPool();
+
+  int GetNumberOfThreads() const
+  {
+    return this->NumberOfThreads;
+  }
+
+  void For(vtkIdType first, vtkIdType last, vtkIdType grain,
+           ExecuteFunctorPtrType executer, void *functor, int maxThreads);
+
+private:
+  void WorkerMain(int index);
+
+  // Take the next piece of work for the thread owning queue 'index', either
+  // from its own queue or stolen from another one.
+  bool GetWork(int index, vtkSMPRange &work);
+  bool PopFront(int index, vtkSMPRange &work);
+  bool StealBack(int victim, int thief);
+  void Execute(const vtkSMPRange &work);
+  bool IsAllowed(const vtkSMPJob *job, int index) const;
+
+  int NumberOfThreads;
+  std::vector<std::unique_ptr<vtkSMPWorkQueue> > Queues;
+  std::vector<std::thread> Threads;
+
+  // Workers that did not find any work sleep until new ranges are pushed
+  // (which increments WorkGeneration) or until shutdown.
+  std::mutex WakeLock;
+  std::condition_variable WakeCondition;
+  std::atomic<vtkTypeUInt64> WorkGeneration;
+  bool Shutdown;
+
+  // Rotates the workers used by the limited jobs of external threads
+  std::atomic<int> NextWindow;
+
+  vtkSMPThreadPool(const vtkSMPThreadPool&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkSMPThreadPool&) VTK_DELETE_FUNCTION;
+};
+
+// Queue index of the calling thread if it is a worker of the given pool
+thread_local const vtkSMPThreadPool *vtkSMPCurrentPool = nullptr;
+thread_local int vtkSMPCurrentWorker = 0;
+
+// Job being executed by the calling thread, if any
+thread_local const vtkSMPJob *vtkSMPCurrentJob = nullptr;
+
+//--------------------------------------------------------------------------------
+vtkSMPThreadPool::vtkSMPThreadPool(int numThreads)
+  : NumberOfThreads(numThreads), WorkGeneration(0), Shutdown(false),
+    NextWindow(0)
+{
+  for (int i = 0; i < numThreads; ++i)
+  {
+    this->Queues.push_back(
+      std::unique_ptr<vtkSMPWorkQueue>(new vtkSMPWorkQueue));
+  }
+  // The calling thread counts as one of the threads
+  for (int i = 1; i < numThreads; ++i)
+  {
+    this->Threads.push_back(
+      std::thread(&vtkSMPThreadPool::WorkerMain, this, i));
+  }
+}
+
+//--------------------------------------------------------------------------------
+vtkSMPThreadPool::~vtkSMPThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->WakeLock);
+    this->Shutdown = true;
+  }
+  this->WakeCondition.notify_all();
+  for (size_t i = 0; i < this->Threads.size(); ++i)
+  {
+    this->Threads[i].join();
+  }
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::WorkerMain(int index)
+{
+  vtkSMPCurrentPool = this;
+  vtkSMPCurrentWorker = index;
+
+  vtkSMPRange work;
+  for (;;)
+  {
+    vtkTypeUInt64 generation = this->WorkGeneration.load();
+    if (this->GetWork(index, work))
+    {
+      this->Execute(work);
+    }
+    else
+    {
+      // All queues were empty: only new ranges can give us something to do
+      std::unique_lock<std::mutex> lock(this->WakeLock);
+      this->WakeCondition.wait(lock, [this, generation]
+        {
+        return this->Shutdown || this->WorkGeneration.load() != generation;
+        });
+      if (this->Shutdown)
+      {
+        return;
+      }
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPThreadPool::IsAllowed(const vtkSMPJob *job, int index) const
+{
+  if (job->WindowSize < 0 || index == job->Owner)
+  {
+    return true;
+  }
+  if (index == 0)
+  {
+    return false;
+  }
+  int numWorkers = this->NumberOfThreads - 1;
+  return (index - job->WindowStart + numWorkers) % numWorkers <
+    job->WindowSize;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPThreadPool::PopFront(int index, vtkSMPRange &work)
+{
+  vtkSMPWorkQueue &queue = *this->Queues[index];
+  std::lock_guard<std::mutex> lock(queue.Lock);
+  // Queue 0 is shared by the external threads, which may not be allowed to
+  // execute all of its ranges
+  std::deque<vtkSMPRange>::iterator front = queue.Ranges.begin();
+  while (front != queue.Ranges.end() && !this->IsAllowed(front->Job, index))
+  {
+    ++front;
+  }
+  if (front == queue.Ranges.end())
+  {
+    return false;
+  }
+  work.Job = front->Job;
+  work.Begin = front->Begin;
+  work.End = std::min(front->Begin + front->Job->Grain, front->End);
+  front->Begin = work.End;
+  if (front->Begin >= front->End)
+  {
+    queue.Ranges.erase(front);
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPThreadPool::StealBack(int victim, int thief)
+{
+  vtkSMPRange stolen;
+  {
+    vtkSMPWorkQueue &queue = *this->Queues[victim];
+    std::lock_guard<std::mutex> lock(queue.Lock);
+    // Take the upper half (in number of grains) of the last range the
+    // thief is allowed to execute
+    std::deque<vtkSMPRange>::reverse_iterator back = queue.Ranges.rbegin();
+    while (back != queue.Ranges.rend() && !this->IsAllowed(back->Job, thief))
+    {
+      ++back;
+    }
+    if (back == queue.Ranges.rend())
+    {
+      return false;
+    }
+    vtkIdType grain = back->Job->Grain;
+    vtkIdType numGrains = (back->End - back->Begin + grain - 1) / grain;
+    stolen = *back;
+    if (numGrains > 1)
+    {
+      stolen.Begin = back->Begin + (numGrains / 2) * grain;
+      back->End = stolen.Begin;
+    }
+    else
+    {
+      queue.Ranges.erase(std::next(back).base());
+    }
+  }
+
+  vtkSMPWorkQueue &queue = *this->Queues[thief];
+  std::lock_guard<std::mutex> lock(queue.Lock);
+  queue.Ranges.push_front(stolen);
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPThreadPool::GetWork(int index, vtkSMPRange &work)
+{
+  if (this->PopFront(index, work))
+  {
+    return true;
+  }
+  for (int i = 1; i < this->NumberOfThreads; ++i)
+  {
+    if (this->StealBack((index + i) % this->NumberOfThreads, index) &&
+        this->PopFront(index, work))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::Execute(const vtkSMPRange &work)
+{
+  vtkSMPJob *job = work.Job;
+  const vtkSMPJob *previousJob = vtkSMPCurrentJob;
+  vtkSMPCurrentJob = job;
+  job->Executer(job->Functor, work.Begin, work.End - work.Begin, work.End);
+  vtkSMPCurrentJob = previousJob;
+  // The job may be destroyed as soon as Remaining drops to zero: this must
+  // be the last access.
+  job->Remaining -= work.End - work.Begin;
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::For(vtkIdType first, vtkIdType last, vtkIdType grain,
+                           ExecuteFunctorPtrType executer, void *functor,
+                           int maxThreads)
+{
+  bool nested = (vtkSMPCurrentPool == this);
+  int self = nested ? vtkSMPCurrentWorker : 0;
+  int numWorkers = this->NumberOfThreads - 1;
+
+  vtkSMPJob job;
+  job.Executer = executer;
+  job.Functor = functor;
+  job.Grain = grain;
+  job.Remaining = last - first;
+  job.Owner = self;
+  job.WindowStart = 1;
+  job.WindowSize = -1;
+  const vtkSMPJob *parent = vtkSMPCurrentJob;
+  if (parent && parent->WindowSize >= 0 && parent->WindowSize < maxThreads)
+  {
+    // Nested in a limited job: stay within the threads of that job
+    job.Owner = parent->Owner;
+    job.WindowStart = parent->WindowStart;
+    job.WindowSize = parent->WindowSize;
+  }
+  else if (maxThreads > 0 && maxThreads < this->NumberOfThreads)
+  {
+    // The workers following the owner, rotating for external threads so
+    // that concurrent limited jobs use different workers
+    int start = nested ? self : this->NextWindow++;
+    job.WindowStart = (start % numWorkers + numWorkers) % numWorkers + 1;
+    job.WindowSize = maxThreads - 1;
+  }
+
+  if (nested)
+  {
+    // Idle threads will steal from our queue
+    vtkSMPWorkQueue &queue = *this->Queues[self];
+    std::lock_guard<std::mutex> lock(queue.Lock);
+    vtkSMPRange range = { &job, first, last };
+    queue.Ranges.push_front(range);
+  }
+  else
+  {
+    // Give a contiguous share of the grains to every allowed thread up
+    // front, starting with the calling thread
+    int numShares = job.WindowSize < 0 ? this->NumberOfThreads :
+      job.WindowSize + 1;
+    vtkIdType numGrains = (last - first + grain - 1) / grain;
+    for (int i = 0; i < numShares; ++i)
+    {
+      vtkIdType b = first + (numGrains * i / numShares) * grain;
+      vtkIdType e = first + (numGrains * (i+1) / numShares) * grain;
+      e = std::min(e, last);
+      int index = i;
+      if (job.WindowSize >= 0 && i > 0)
+      {
+        index = (job.WindowStart - 1 + i - 1) % numWorkers + 1;
+      }
+      if (b < e)
+      {
+        vtkSMPWorkQueue &queue = *this->Queues[index];
+        std::lock_guard<std::mutex> lock(queue.Lock);
+        vtkSMPRange range = { &job, b, e };
+        queue.Ranges.push_back(range);
+      }
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->WakeLock);
+    ++this->WorkGeneration;
+  }
+  this->WakeCondition.notify_all();
+
+  // Help until all the items of this job have been processed. The work
+  // executed here may belong to other jobs.
+  vtkSMPRange work;
+  while (job.Remaining.load() > 0)
+  {
+    if (this->GetWork(self, work))
+    {
+      this->Execute(work);
+    }
+    else
+    {
+      // The remaining items are being processed by other threads
+      std::this_thread::yield();
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------
+int vtkSMPDefaultNumberOfThreads()
+{
+  int numThreads = static_cast<int>(std::thread::hardware_concurrency());
+  return numThreads > 0 ? numThreads : 1;
+}
+
+std::mutex vtkSMPPoolLock;
+std::unique_ptr<vtkSMPThreadPool> vtkSMPPool;
+
+vtkSMPThreadPool &vtkSMPGetThreadPool()
+{
+  std::lock_guard<std::mutex> lock(vtkSMPPoolLock);
+  if (!vtkSMPPool)
+  {
+    vtkSMPPool.reset(new vtkSMPThreadPool(vtkSMPDefaultNumberOfThreads()));
+  }
+  return *vtkSMPPool;
+}
+
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPTools::Initialize(int numThreads)
+{
+  std::lock_guard<std::mutex> lock(vtkSMPPoolLock);
+  if (numThreads <= 0)
+  {
+    numThreads = vtkSMPDefaultNumberOfThreads();
+  }
+  // The pool cannot be replaced from within one of its workers
+  if (vtkSMPPool && (vtkSMPCurrentPool == vtkSMPPool.get() ||
+                     vtkSMPPool->GetNumberOfThreads() == numThreads))
+  {
+    return;
+  }
+  vtkSMPPool.reset(new vtkSMPThreadPool(numThreads));
+}
+
+//--------------------------------------------------------------------------------
+int vtkSMPTools::GetEstimatedNumberOfThreads()
+{
+  int numThreads = vtk::detail::smp::GetNumberOfThreads();
+  const vtkSMPToolsConfig* config = vtkSMPToolsConfig::GetLocal();
+  return config ? config->GetNumberOfThreads(numThreads) : numThreads;
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::GetNumberOfThreads()
+{
+  return vtkSMPGetThreadPool().GetNumberOfThreads();
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPTools_Impl_For_STDThread(vtkIdType first,
+  vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
+  void *functor)
+{
+  vtkSMPThreadPool &pool = vtkSMPGetThreadPool();
+  int numThreads = pool.GetNumberOfThreads();
+  const vtkSMPToolsConfig* config = vtkSMPToolsConfig::GetLocal();
+  if (config)
+  {
+    numThreads = config->GetNumberOfThreads(numThreads);
+  }
+  if (grain <= 0)
+  {
+    vtkIdType estimateGrain = (last - first)/(numThreads * 4);
+    grain = (estimateGrain > 0) ? estimateGrain : 1;
+  }
+
+  if (numThreads == 1)
+  {
+    for (vtkIdType from = first; from < last; from += grain)
+    {
+      functorExecuter(functor, from, grain, last);
+    }
+    return;
+  }
+
+  pool.For(first, last, grain, functorExecuter, functor, numThreads);
+}
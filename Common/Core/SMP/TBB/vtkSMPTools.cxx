@@ -16,6 +16,7 @@
 #include "vtkSMPTools.h"
 
 #include "vtkCriticalSection.h"
+#include "vtkSMPToolsConfig.h"
 
 #include <tbb/task_scheduler_init.h>
 
@@ -53,6 +54,8 @@ void vtkSMPTools::Initialize(int numThreads)
 //--------------------------------------------------------------------------------
 int vtkSMPTools::GetEstimatedNumberOfThreads()
 {
-  return vtkTBBNumSpecifiedThreads ? vtkTBBNumSpecifiedThreads
+  int numThreads = vtkTBBNumSpecifiedThreads ? vtkTBBNumSpecifiedThreads
     : tbb::task_scheduler_init::default_num_threads();
+  const vtkSMPToolsConfig* config = vtkSMPToolsConfig::GetLocal();
+  return config ? config->GetNumberOfThreads(numThreads) : numThreads;
 }
@@ -0,0 +1,152 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestBufferAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Allocate arrays through vtkPoolBufferAllocator, set per array, by
+// default and from several threads, and check the statistics.
+#include "vtkPoolBufferAllocator.h"
+
+#include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
+#include "vtkSOADataArrayTemplate.h"
+
+#define TEST_ASSERT(cond, msg) \
+  if (!(cond)) \
+  { \
+    cerr << "Error: " << msg << endl; \
+    return EXIT_FAILURE; \
+  }
+
+namespace
+{
+
+// Create and grow temporary arrays through the default allocator
+struct TemporaryArrays
+{
+  vtkAtomic<int> Errors;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkNew<vtkIntArray> array;
+      for (int j = 0; j < 100 + i % 50; ++j)
+      {
+        array->InsertNextValue(j);
+      }
+      for (int j = 0; j < 100 + i % 50; ++j)
+      {
+        if (array->GetValue(j) != j)
+        {
+          ++this->Errors;
+          break;
+        }
+      }
+    }
+  }
+};
+
+}
+
+int TestBufferAllocator(int, char*[])
+{
+  vtkNew<vtkPoolBufferAllocator> allocator;
+
+  // Blocks are reused by the thread that released them
+  void* block = allocator->Allocate(1000);
+  TEST_ASSERT(block, "allocation failed");
+  TEST_ASSERT(reinterpret_cast<size_t>(block) % 64 == 0, "block not aligned");
+  TEST_ASSERT(allocator->GetBytesInUse() == 1000,
+              "wrong bytes in use " << allocator->GetBytesInUse());
+  allocator->Free(block, 1000);
+  TEST_ASSERT(allocator->GetBytesInUse() == 0, "block not released");
+  TEST_ASSERT(vtkPoolBufferAllocator::GetThreadCachedBytes() >= 1024,
+              "block not kept by the thread");
+  TEST_ASSERT(allocator->Allocate(900) == block, "block not reused");
+  allocator->Free(block, 900);
+
+  // Per array
+  {
+    vtkNew<vtkDoubleArray> array;
+    array->SetBufferAllocator(allocator.GetPointer());
+    array->SetNumberOfComponents(3);
+    array->SetNumberOfTuples(1000);
+    for (vtkIdType i = 0; i < 3000; ++i)
+    {
+      array->SetValue(i, i);
+    }
+    TEST_ASSERT(allocator->GetBytesInUse() == 3000 * sizeof(double),
+                "wrong bytes in use " << allocator->GetBytesInUse());
+    // Resize() grows to 1000 + 2000 tuples
+    array->Resize(2000);
+    for (vtkIdType i = 0; i < 3000; ++i)
+    {
+      TEST_ASSERT(array->GetValue(i) == i, "value lost by resize");
+    }
+    TEST_ASSERT(allocator->GetBytesInUse() == 9000 * sizeof(double),
+                "wrong bytes in use " << allocator->GetBytesInUse());
+    TEST_ASSERT(allocator->GetPeakBytesInUse() == 9000 * sizeof(double),
+                "wrong peak " << allocator->GetPeakBytesInUse());
+
+    // External memory is not released by the allocator
+    double external[4] = { 1, 2, 3, 4 };
+    array->SetNumberOfComponents(1);
+    array->SetArray(external, 4, 1);
+    TEST_ASSERT(allocator->GetBytesInUse() == 0, "array not released");
+    // Growing to 4 + 5 values moves them to the allocator
+    array->InsertNextValue(5);
+    TEST_ASSERT(allocator->GetBytesInUse() == 9 * sizeof(double) &&
+                array->GetValue(3) == 4 && array->GetValue(4) == 5,
+                "array not moved to the allocator");
+  }
+  TEST_ASSERT(allocator->GetBytesInUse() == 0, "memory leaked");
+
+  {
+    vtkNew<vtkSOADataArrayTemplate<float> > soa;
+    soa->SetBufferAllocator(allocator.GetPointer());
+    soa->SetNumberOfComponents(2);
+    soa->SetNumberOfTuples(100);
+    TEST_ASSERT(allocator->GetBytesInUse() == 200 * sizeof(float),
+                "wrong bytes in use " << allocator->GetBytesInUse());
+  }
+  TEST_ASSERT(allocator->GetBytesInUse() == 0, "memory leaked");
+
+  // Huge pages
+  allocator->HugePageAlignmentOn();
+  size_t hugeSize = 3 * vtkPoolBufferAllocator::GetHugePageSize();
+  block = allocator->Allocate(hugeSize);
+  TEST_ASSERT(block && reinterpret_cast<size_t>(block) %
+              vtkPoolBufferAllocator::GetHugePageSize() == 0,
+              "block not aligned on huge pages");
+  allocator->Free(block, hugeSize);
+
+  // By default, from all the threads
+  allocator->ResetStatistics();
+  vtkBufferAllocator::SetDefaultAllocator(allocator.GetPointer());
+  TemporaryArrays functor;
+  functor.Errors = 0;
+  vtkSMPTools::For(0, 2000, 10, functor);
+  vtkBufferAllocator::SetDefaultAllocator(NULL);
+  TEST_ASSERT(functor.Errors == 0, "wrong values");
+  TEST_ASSERT(allocator->GetBytesInUse() == 0, "memory leaked");
+  TEST_ASSERT(allocator->GetNumberOfAllocations() >= 2000,
+              "default allocator not used");
+
+  vtkPoolBufferAllocator::ReleaseThreadCache();
+  TEST_ASSERT(vtkPoolBufferAllocator::GetThreadCachedBytes() == 0,
+              "cache not released");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataArrayRange.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test the range computations of large arrays, which are split into blocks
+// and between threads, against a straightforward reference.
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkSOADataArrayTemplate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace
+{
+
+// Not a multiple of the block size, and larger than the grain
+const vtkIdType NumberOfTuples = 300007;
+
+// Reference range of a component (-1 for the norm, or the component of
+// single component arrays)
+void ReferenceRange(vtkDataArray *array, int comp, bool finite,
+                    double range[2])
+{
+  if (comp < 0 && array->GetNumberOfComponents() == 1)
+  {
+    comp = 0;
+  }
+  range[0] = VTK_DOUBLE_MAX;
+  range[1] = VTK_DOUBLE_MIN;
+  for (vtkIdType t = 0; t < array->GetNumberOfTuples(); ++t)
+  {
+    double value = 0.0;
+    if (comp < 0)
+    {
+      for (int c = 0; c < array->GetNumberOfComponents(); ++c)
+      {
+        value += array->GetComponent(t, c) * array->GetComponent(t, c);
+      }
+    }
+    else
+    {
+      value = array->GetComponent(t, comp);
+    }
+    if (vtkMath::IsNan(value) || (finite && vtkMath::IsInf(value)))
+    {
+      continue;
+    }
+    range[0] = std::min(range[0], value);
+    range[1] = std::max(range[1], value);
+  }
+  if (comp < 0)
+  {
+    range[0] = sqrt(range[0]);
+    range[1] = sqrt(range[1]);
+  }
+}
+
+bool CheckRanges(vtkDataArray *array, const std::string &name)
+{
+  for (int comp = -1; comp < array->GetNumberOfComponents(); ++comp)
+  {
+    for (int finite = 0; finite < 2; ++finite)
+    {
+      double expected[2];
+      ReferenceRange(array, comp, finite != 0, expected);
+      double range[2];
+      array->Modified();
+      if (finite)
+      {
+        array->GetFiniteRange(range, comp);
+      }
+      else
+      {
+        array->GetRange(range, comp);
+      }
+      if (range[0] != expected[0] || range[1] != expected[1])
+      {
+        cerr << "Error: " << (finite ? "finite " : "") << "range of "
+             << name << " component " << comp << " is [" << range[0] << ", "
+             << range[1] << "] instead of [" << expected[0] << ", "
+             << expected[1] << "]" << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Deterministic values with extremes scattered through the array
+double Value(vtkIdType t, int c)
+{
+  return static_cast<double>(((t * 7919 + c * 104729) % 200003) - 100000);
+}
+
+}
+
+int TestDataArrayRange(int, char*[])
+{
+  bool success = true;
+
+  const int numComps[] = { 1, 3, 12 };
+  for (int i = 0; i < 3; ++i)
+  {
+    vtkNew<vtkFloatArray> floats;
+    floats->SetNumberOfComponents(numComps[i]);
+    floats->SetNumberOfTuples(NumberOfTuples);
+    vtkNew<vtkIntArray> ints;
+    ints->SetNumberOfComponents(numComps[i]);
+    ints->SetNumberOfTuples(NumberOfTuples);
+    for (vtkIdType t = 0; t < NumberOfTuples; ++t)
+    {
+      for (int c = 0; c < numComps[i]; ++c)
+      {
+        floats->SetTypedComponent(t, c, static_cast<float>(Value(t, c) / 8));
+        ints->SetTypedComponent(t, c, static_cast<int>(Value(t, c)));
+      }
+    }
+    // Non finite values, including at the first and last positions
+    floats->SetTypedComponent(0, 0, vtkMath::Nan());
+    floats->SetTypedComponent(1234, 0, vtkMath::Inf());
+    floats->SetTypedComponent(NumberOfTuples / 2, numComps[i] - 1,
+                              vtkMath::NegInf());
+    floats->SetTypedComponent(NumberOfTuples - 1, numComps[i] - 1,
+                              vtkMath::Nan());
+
+    success &= CheckRanges(floats.GetPointer(), "float array");
+    success &= CheckRanges(ints.GetPointer(), "int array");
+  }
+
+  vtkNew<vtkSOADataArrayTemplate<double> > soa;
+  soa->SetNumberOfComponents(3);
+  soa->SetNumberOfTuples(NumberOfTuples);
+  for (vtkIdType t = 0; t < NumberOfTuples; ++t)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      soa->SetTypedComponent(t, c, Value(t, c) / 3);
+    }
+  }
+  soa->SetTypedComponent(17, 1, vtkMath::Inf());
+  soa->SetTypedComponent(NumberOfTuples - 1, 2, vtkMath::Nan());
+  success &= CheckRanges(soa.GetPointer(), "SOA array");
+
+  return success ? 0 : 1;
+}
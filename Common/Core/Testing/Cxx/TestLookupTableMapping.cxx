@@ -0,0 +1,146 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLookupTableMapping.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Map large arrays, which are mapped in parallel or through palettes, and
+// compare the colors with those of the values mapped one at a time.
+#include "vtkDoubleArray.h"
+#include "vtkLookupTable.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkVariant.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+const int NumberOfValues = 300007;
+
+template <class T>
+bool CheckMapping(vtkLookupTable *lut, const std::vector<T> &values,
+                  int dataType, int inIncr, int outFormat, const char *name)
+{
+  int numValues = static_cast<int>(values.size()) / inIncr;
+  std::vector<unsigned char> colors(numValues * outFormat);
+  lut->MapScalarsThroughTable2(const_cast<T*>(&values[0]), &colors[0],
+                               dataType, numValues, inIncr, outFormat);
+  for (int i = 0; i < numValues; ++i)
+  {
+    unsigned char expected[4];
+    lut->MapScalarsThroughTable2(const_cast<T*>(&values[i * inIncr]),
+                                 expected, dataType, 1, 1, outFormat);
+    if (memcmp(expected, &colors[i * outFormat], outFormat) != 0)
+    {
+      cerr << "Error: wrong color for value " << i << " of " << name
+           << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+int TestLookupTableMapping(int, char*[])
+{
+  bool success = true;
+
+  vtkNew<vtkLookupTable> lut;
+  lut->SetNumberOfTableValues(1000);
+  lut->SetTableRange(-1000.0, 30000.0);
+  lut->SetNanColor(0.2, 0.4, 0.6, 0.8);
+  lut->UseBelowRangeColorOn();
+  lut->UseAboveRangeColorOn();
+  lut->Build();
+
+  std::vector<double> doubles(NumberOfValues);
+  for (int i = 0; i < NumberOfValues; ++i)
+  {
+    doubles[i] = ((static_cast<vtkIdType>(i) * 7919) % 40000) - 5000.5;
+  }
+  doubles[17] = vtkMath::Nan();
+  doubles[NumberOfValues - 1] = vtkMath::Nan();
+
+  std::vector<unsigned char> uchars(NumberOfValues);
+  std::vector<short> shorts(2 * NumberOfValues);
+  for (int i = 0; i < NumberOfValues; ++i)
+  {
+    uchars[i] = static_cast<unsigned char>(i * 31);
+    shorts[2 * i] = static_cast<short>(i * 7919);
+    shorts[2 * i + 1] = static_cast<short>(i);
+  }
+
+  for (int outFormat = VTK_LUMINANCE; outFormat <= VTK_RGBA; ++outFormat)
+  {
+    success &= CheckMapping(lut.GetPointer(), doubles, VTK_DOUBLE, 1,
+                            outFormat, "doubles");
+    success &= CheckMapping(lut.GetPointer(), uchars, VTK_UNSIGNED_CHAR, 1,
+                            outFormat, "unsigned chars");
+    success &= CheckMapping(lut.GetPointer(), shorts, VTK_SHORT, 2,
+                            outFormat, "shorts");
+  }
+
+  // Log scale and alpha
+  lut->SetTableRange(1.0, 30000.0);
+  lut->SetScaleToLog10();
+  lut->SetAlpha(0.5);
+  success &= CheckMapping(lut.GetPointer(), doubles, VTK_DOUBLE, 1,
+                          VTK_RGBA, "doubles with log scale");
+  success &= CheckMapping(lut.GetPointer(), shorts, VTK_SHORT, 2,
+                          VTK_LUMINANCE_ALPHA, "shorts with log scale");
+  lut->SetScaleToLinear();
+  lut->SetAlpha(1.0);
+
+  // Magnitude of vectors
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(NumberOfValues / 3);
+  std::vector<double> magnitudes(NumberOfValues / 3);
+  for (int i = 0; i < NumberOfValues / 3; ++i)
+  {
+    double *v = &doubles[3 * i];
+    vectors->SetTuple(i, v);
+    magnitudes[i] = sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+  }
+  lut->SetVectorModeToMagnitude();
+  vtkUnsignedCharArray *colors =
+    lut->MapScalars(vectors.GetPointer(), VTK_COLOR_MODE_MAP_SCALARS, -1);
+  for (int i = 0; i < NumberOfValues / 3 && success; ++i)
+  {
+    unsigned char expected[4];
+    lut->MapScalarsThroughTable2(&magnitudes[i], expected, VTK_DOUBLE, 1, 1,
+                                 VTK_RGBA);
+    if (memcmp(expected, colors->GetPointer(4 * i), 4) != 0)
+    {
+      cerr << "Error: wrong color for vector " << i << endl;
+      success = false;
+    }
+  }
+  colors->Delete();
+  lut->SetVectorModeToComponent();
+
+  // Indexed lookup
+  lut->IndexedLookupOn();
+  for (int i = 0; i < 100; ++i)
+  {
+    lut->SetAnnotation(vtkVariant(static_cast<short>(i * 7)), "annotation");
+  }
+  success &= CheckMapping(lut.GetPointer(), shorts, VTK_SHORT, 1,
+                          VTK_RGBA, "shorts with indexed lookup");
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
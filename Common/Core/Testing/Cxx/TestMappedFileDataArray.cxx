@@ -0,0 +1,135 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestMappedFileDataArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Map regions of a file as arrays and check that modifying the arrays
+// leaves the file unchanged.
+#include "vtkMappedFileDataArray.h"
+
+#include "vtkArrayDispatch.h"
+#include "vtkFloatArray.h"
+#include "vtkNew.h"
+#include "vtkTestErrorObserver.h"
+
+#include <cstdio>
+#include <vector>
+
+#define TEST_ASSERT(cond, msg) \
+  if (!(cond)) \
+  { \
+    cerr << "Error: " << msg << endl; \
+    return EXIT_FAILURE; \
+  }
+
+namespace
+{
+
+const vtkIdType NumberOfValues = 3000;
+
+struct SumWorker
+{
+  double Sum;
+  SumWorker() : Sum(0.0) {}
+
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
+  {
+    for (vtkIdType i = 0; i < array->GetNumberOfValues(); ++i)
+    {
+      this->Sum += array->GetValue(i);
+    }
+  }
+};
+
+}
+
+int TestMappedFileDataArray(int argc, char *argv[])
+{
+  if (argc < 2)
+  {
+    std::cout << "Usage: " << argv[0] << " outputFilename" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char *fileName = argv[1];
+
+  // A header of 8 bytes followed by the values
+  std::vector<float> values(NumberOfValues + 2);
+  for (vtkIdType i = 0; i < NumberOfValues + 2; ++i)
+  {
+    values[i] = static_cast<float>(i - 2);
+  }
+  FILE *file = fopen(fileName, "wb");
+  TEST_ASSERT(file, "cannot create " << fileName);
+  fwrite(&values[0], sizeof(float), values.size(), file);
+  fclose(file);
+
+  vtkNew<vtkMemoryMappedFile> mapped;
+  TEST_ASSERT(mapped->Open(fileName), "cannot map " << fileName);
+  TEST_ASSERT(mapped->GetSize() == values.size() * sizeof(float),
+              "wrong size " << mapped->GetSize());
+
+  vtkNew<vtkMappedFileDataArray<float> > array;
+  array->SetNumberOfComponents(3);
+  TEST_ASSERT(array->MapRegion(mapped.GetPointer(), 8, NumberOfValues / 3),
+              "cannot map region");
+  TEST_ASSERT(array->IsMapped(), "array not mapped");
+  TEST_ASSERT(array->GetNumberOfTuples() == NumberOfValues / 3,
+              "wrong number of tuples " << array->GetNumberOfTuples());
+  TEST_ASSERT(array->GetVoidPointer(0) == mapped->GetPointer(8),
+              "values were copied");
+
+  // The array is processed like any float array
+  vtkFloatArray *floats = vtkArrayDownCast<vtkFloatArray>(array.GetPointer());
+  TEST_ASSERT(floats, "not a float array");
+  SumWorker worker;
+  TEST_ASSERT(vtkArrayDispatch::Dispatch::Execute(array.GetPointer(), worker),
+              "dispatch failed");
+  TEST_ASSERT(worker.Sum == NumberOfValues * (NumberOfValues - 1) / 2.0,
+              "wrong sum " << worker.Sum);
+
+  vtkDataArray *copy = array->NewInstance();
+  TEST_ASSERT(!vtkMappedFileDataArray<float>::SafeDownCast(copy),
+              "new instance is mapped");
+  copy->Delete();
+
+  // Invalid regions
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  array->AddObserver(vtkCommand::ErrorEvent, errorObserver.GetPointer());
+  TEST_ASSERT(!array->MapRegion(mapped.GetPointer(), 6, 1) &&
+              array->IsMapped(), "unaligned region mapped");
+  TEST_ASSERT(!errorObserver->CheckErrorMessage("not aligned"),
+              "no error for the unaligned region");
+  TEST_ASSERT(!array->MapRegion(mapped.GetPointer(), 8, NumberOfValues),
+              "region past the end of the file mapped");
+  TEST_ASSERT(!errorObserver->CheckErrorMessage("outside of"),
+              "no error for the region past the end of the file");
+
+  // Copy on write
+  array->SetTypedComponent(0, 0, 42.0f);
+  TEST_ASSERT(array->GetTypedComponent(0, 0) == 42.0f, "value not modified");
+
+  vtkNew<vtkMappedFileDataArray<float> > other;
+  TEST_ASSERT(other->MapFile(fileName, 0, NumberOfValues + 2),
+              "cannot map file");
+  TEST_ASSERT(other->GetValue(2) == 0.0f, "file was modified");
+
+  // Growing the array copies the values out of the file
+  array->InsertNextTuple3(1.0, 2.0, 3.0);
+  TEST_ASSERT(!array->IsMapped(), "resized array still mapped");
+  TEST_ASSERT(array->GetValue(0) == 42.0f &&
+              array->GetValue(NumberOfValues - 1) == NumberOfValues - 1 &&
+              array->GetValue(NumberOfValues) == 1.0f,
+              "values lost when resizing");
+
+  return EXIT_SUCCESS;
+}
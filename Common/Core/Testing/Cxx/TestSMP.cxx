@@ -91,6 +91,33 @@ public:
 
 };
 
+// Each outer iteration launches an inner parallel loop
+class NestedFunctor
+{
+public:
+  vtkSMPThreadLocal<int> Counter;
+
+  NestedFunctor(): Counter(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      ARangeFunctor inner;
+      vtkSMPTools::For(0, 100, 1, inner);
+      int innerTotal = 0;
+      for (vtkSMPThreadLocal<int>::iterator itr = inner.Counter.begin();
+           itr != inner.Counter.end(); ++itr)
+      {
+        innerTotal += *itr;
+      }
+      this->Counter.Local() += innerTotal;
+    }
+  }
+};
+
 // For sorting comparison
 bool myComp (double a, double b) { return (a<b); }
 
@@ -140,6 +167,24 @@ int TestSMP(int, char*[])
     return 1;
   }
 
+  // Nested parallel loops
+  NestedFunctor functor3;
+
+  vtkSMPTools::For(0, 100, 1, functor3);
+
+  total = 0;
+  for (vtkSMPThreadLocal<int>::iterator itr3 = functor3.Counter.begin();
+       itr3 != functor3.Counter.end(); ++itr3)
+  {
+    total += *itr3;
+  }
+
+  if (total != Target)
+  {
+    cerr << "Error: NestedFunctor did not generate " << Target << endl;
+    return 1;
+  }
+
   // Test sorting
   double data0[] = {2,1,0,3,9,6,7,3,8,4,5};
   std::vector<double> myvector (data0, data0+11);
@@ -167,5 +212,22 @@ int TestSMP(int, char*[])
     }
   }
 
+  // Large enough for the backends to sort in parallel
+  std::vector<int> largeVector(100000);
+  for (size_t i=0; i<largeVector.size(); ++i)
+  {
+    largeVector[i] = static_cast<int>((i * 7919) % largeVector.size());
+  }
+  vtkSMPTools::Sort(largeVector.begin(), largeVector.end(),
+                    std::greater<int>());
+  for (size_t i=0; i<largeVector.size(); ++i)
+  {
+    if ( largeVector[i] != static_cast<int>(largeVector.size() - 1 - i) )
+    {
+      cerr << "Error: Bad large sort!" << endl;
+      return 1;
+    }
+  }
+
   return 0;
 }
@@ -0,0 +1,159 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPAlgorithms.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test the algorithms built on top of vtkSMPTools::For().
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+// Large enough to span several blocks with any back-end
+const vtkIdType Size = 100003;
+
+// Associative but not commutative: keep the first and last elements seen
+struct FirstLast
+{
+  std::pair<vtkIdType, vtkIdType> operator()(
+    const std::pair<vtkIdType, vtkIdType>& a,
+    const std::pair<vtkIdType, vtkIdType>& b) const
+  {
+    return std::make_pair(a.first, b.second);
+  }
+};
+
+struct Square
+{
+  vtkIdType operator()(vtkIdType a) const
+  {
+    return a * a;
+  }
+};
+
+// Sort on the key (first) only, the second member records the initial order
+struct CompareKeys
+{
+  bool operator()(const std::pair<int, vtkIdType>& a,
+                  const std::pair<int, vtkIdType>& b) const
+  {
+    return a.first < b.first;
+  }
+};
+
+}
+
+int TestSMPAlgorithms(int, char*[])
+{
+  std::vector<vtkIdType> values(Size);
+  vtkSMPTools::Fill(values.begin(), values.end(), 2);
+  if (std::count(values.begin(), values.end(), 2) != Size)
+  {
+    cerr << "Error: Fill failed" << endl;
+    return 1;
+  }
+
+  // Transforms
+  for (vtkIdType i = 0; i < Size; ++i)
+  {
+    values[i] = i;
+  }
+  std::vector<vtkIdType> squares(Size);
+  if (vtkSMPTools::Transform(values.begin(), values.end(), squares.begin(),
+                             Square()) != squares.end())
+  {
+    cerr << "Error: Transform returned the wrong iterator" << endl;
+    return 1;
+  }
+  std::vector<vtkIdType> sums(Size);
+  vtkSMPTools::Transform(values.begin(), values.end(), squares.begin(),
+                         sums.begin(), std::plus<vtkIdType>());
+  for (vtkIdType i = 0; i < Size; ++i)
+  {
+    if (squares[i] != i * i || sums[i] != i * i + i)
+    {
+      cerr << "Error: Transform failed at " << i << endl;
+      return 1;
+    }
+  }
+
+  // Reductions
+  vtkIdType total = vtkSMPTools::Reduce(values.begin(), values.end(),
+                                        static_cast<vtkIdType>(10));
+  if (total != 10 + Size * (Size - 1) / 2)
+  {
+    cerr << "Error: Reduce returned " << total << endl;
+    return 1;
+  }
+  std::vector<std::pair<vtkIdType, vtkIdType> > pairs(Size);
+  for (vtkIdType i = 0; i < Size; ++i)
+  {
+    pairs[i] = std::make_pair(i, i);
+  }
+  std::pair<vtkIdType, vtkIdType> none(-1, -1);
+  std::pair<vtkIdType, vtkIdType> firstLast = vtkSMPTools::Reduce(
+    pairs.begin(), pairs.end(), none, FirstLast());
+  if (firstLast.first != -1 || firstLast.second != Size - 1)
+  {
+    cerr << "Error: Reduce does not preserve the order of the operands"
+         << endl;
+    return 1;
+  }
+
+  // Scans, the inclusive one in place
+  std::vector<vtkIdType> exclusive(Size);
+  vtkSMPTools::ExclusiveScan(values.begin(), values.end(), exclusive.begin(),
+                             static_cast<vtkIdType>(5));
+  std::vector<vtkIdType> inclusive(values);
+  vtkSMPTools::InclusiveScan(inclusive.begin(), inclusive.end(),
+                             inclusive.begin());
+  for (vtkIdType i = 0; i < Size; ++i)
+  {
+    if (exclusive[i] != 5 + i * (i - 1) / 2 ||
+        inclusive[i] != i * (i + 1) / 2)
+    {
+      cerr << "Error: Scan failed at " << i << endl;
+      return 1;
+    }
+  }
+
+  // Stable sort on a key with many duplicates
+  std::vector<std::pair<int, vtkIdType> > keys(Size);
+  for (vtkIdType i = 0; i < Size; ++i)
+  {
+    keys[i] = std::make_pair(static_cast<int>((i * 7919) % 97), i);
+  }
+  vtkSMPTools::StableSort(keys.begin(), keys.end(), CompareKeys());
+  for (vtkIdType i = 1; i < Size; ++i)
+  {
+    if (keys[i-1].first > keys[i].first ||
+        (keys[i-1].first == keys[i].first && keys[i-1].second > keys[i].second))
+    {
+      cerr << "Error: StableSort failed at " << i << endl;
+      return 1;
+    }
+  }
+  std::vector<vtkIdType> reversed(values.rbegin(), values.rend());
+  vtkSMPTools::StableSort(reversed.begin(), reversed.end());
+  if (reversed != values)
+  {
+    cerr << "Error: StableSort with the default comparison failed" << endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPToolsConfig.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test the scoped settings of vtkSMPTools.
+#include "vtkSMPTools.h"
+#include "vtkSMPToolsConfig.h"
+
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace
+{
+
+// Record the threads executing the loop (and a nested loop), the largest
+// range and the settings seen by the threads.
+class RecordFunctor
+{
+public:
+  std::mutex Lock;
+  std::set<std::thread::id> Threads;
+  vtkIdType MaxRange;
+  int WrongSettings;
+  bool Nested;
+
+  RecordFunctor(bool nested) : MaxRange(0), WrongSettings(0), Nested(nested)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const vtkSMPToolsConfig* config = vtkSMPToolsConfig::GetLocal();
+    {
+      std::lock_guard<std::mutex> lock(this->Lock);
+      this->Threads.insert(std::this_thread::get_id());
+      this->MaxRange = std::max(this->MaxRange, end - begin);
+      if (!config || config->MaxNumberOfThreads != 2)
+      {
+        ++this->WrongSettings;
+      }
+    }
+    if (this->Nested)
+    {
+      RecordFunctor inner(false);
+      vtkSMPTools::For(0, 100, 1, inner);
+      std::lock_guard<std::mutex> lock(this->Lock);
+      this->Threads.insert(inner.Threads.begin(), inner.Threads.end());
+      this->WrongSettings += inner.WrongSettings;
+    }
+  }
+};
+
+}
+
+int TestSMPToolsConfig(int, char*[])
+{
+  if (vtkSMPToolsConfig::GetLocal())
+  {
+    cerr << "Error: settings installed without a scope" << endl;
+    return 1;
+  }
+  if (!vtkSMPToolsConfig::IsBackendAvailable("Sequential") ||
+      !vtkSMPToolsConfig::IsBackendAvailable(vtkSMPTools::GetBackend()))
+  {
+    cerr << "Error: the back-ends should be available" << endl;
+    return 1;
+  }
+
+  // Sequential back-end selected at run time
+  vtkSMPTools::LocalScope(vtkSMPTools::Config("Sequential"), []()
+  {
+    if (std::string(vtkSMPTools::GetBackend()) != "Sequential" ||
+        vtkSMPTools::GetEstimatedNumberOfThreads() != 1)
+    {
+      cerr << "Error: Sequential back-end not selected" << endl;
+      exit(1);
+    }
+    RecordFunctor functor(false);
+    vtkSMPTools::For(0, 1000, 1, functor);
+    if (functor.Threads.size() != 1 ||
+        *functor.Threads.begin() != std::this_thread::get_id())
+    {
+      cerr << "Error: Sequential loop executed in other threads" << endl;
+      exit(1);
+    }
+  });
+
+  // Limited number of threads, including the nested loops
+  {
+    vtkSMPToolsScope scope(vtkSMPToolsConfig(2));
+    if (vtkSMPTools::GetEstimatedNumberOfThreads() > 2)
+    {
+      cerr << "Error: the number of threads is not limited" << endl;
+      return 1;
+    }
+    {
+      // A nested scope cannot raise the limit
+      vtkSMPToolsScope inner(vtkSMPToolsConfig(8));
+      if (inner.GetConfig().MaxNumberOfThreads != 2)
+      {
+        cerr << "Error: nested scope raised the limit" << endl;
+        return 1;
+      }
+    }
+    if (vtkSMPToolsConfig::GetLocal() != &scope.GetConfig())
+    {
+      cerr << "Error: settings not restored" << endl;
+      return 1;
+    }
+
+    RecordFunctor functor(true);
+    vtkSMPTools::For(0, 200, 1, functor);
+    if (functor.Threads.size() > 2 || functor.WrongSettings != 0)
+    {
+      cerr << "Error: " << functor.Threads.size() << " threads used, "
+           << functor.WrongSettings << " calls with the wrong settings"
+           << endl;
+      return 1;
+    }
+  }
+  if (vtkSMPToolsConfig::GetLocal())
+  {
+    cerr << "Error: settings not removed" << endl;
+    return 1;
+  }
+
+  // Default grain
+  vtkSMPToolsConfig grainConfig(2);
+  grainConfig.Grain = 7;
+  vtkSMPTools::LocalScope(grainConfig, []()
+  {
+    RecordFunctor functor(false);
+    vtkSMPTools::For(0, 1000, functor);
+    if (functor.MaxRange > 7)
+    {
+      cerr << "Error: grain not applied" << endl;
+      exit(1);
+    }
+  });
+
+  return 0;
+}
@@ -175,6 +175,22 @@ public:
                     int deleteMethod) VTK_OVERRIDE;
   //@}
 
+  //@{
+  /**
+   * Set/Get the allocator of the values (see vtkBufferAllocator). NULL, the
+   * default, uses the default allocator. The allocator belongs to the
+   * storage, which is shared by shallow copies.
+   */
+  void SetBufferAllocator(vtkBufferAllocator* allocator)
+  {
+    this->Buffer->SetAllocator(allocator);
+  }
+  vtkBufferAllocator* GetBufferAllocator()
+  {
+    return this->Buffer->GetAllocator();
+  }
+  //@}
+
   // Overridden for optimized implementations:
   void SetTuple(vtkIdType tupleIdx, const float *tuple) VTK_OVERRIDE;
   void SetTuple(vtkIdType tupleIdx, const double *tuple) VTK_OVERRIDE;
@@ -20,12 +20,17 @@
  * vtkBuffer makes it easier to keep data pointers in vtkDataArray subclasses.
  * This is an internal class and not intended for direct use expect when writing
  * new types of vtkDataArray subclasses.
+ *
+ * The memory is allocated by the vtkBufferAllocator set on the buffer, or
+ * else by the default allocator (vtkBufferAllocator::GetDefaultAllocator()),
+ * or else with malloc.
 */
 
 #ifndef vtkBuffer_h
 #define vtkBuffer_h
 
 #include "vtkObject.h"
+#include "vtkBufferAllocator.h" // For the allocations
 #include "vtkObjectFactory.h" // New() implementation
 
 template <class ScalarTypeT>
@@ -69,25 +74,57 @@ public:
    */
   bool Reallocate(vtkIdType newsize);
 
+  //@{
+  /**
+   * Set/Get the allocator of the next allocations of this buffer. NULL, the
+   * default, uses the default allocator. The current memory is kept, and
+   * released by the allocator that provided it.
+   */
+  vtkSetObjectMacro(Allocator, vtkBufferAllocator);
+  vtkGetObjectMacro(Allocator, vtkBufferAllocator);
+  //@}
+
 protected:
   vtkBuffer()
     : Pointer(NULL),
       Size(0),
       Save(false),
-      DeleteFunction(free)
+      DeleteFunction(free),
+      Allocator(NULL),
+      PointerAllocator(NULL),
+      AllocatedBytes(0)
   {
   }
 
   ~vtkBuffer() VTK_OVERRIDE
   {
     this->SetBuffer(NULL, 0);
+    this->SetAllocator(NULL);
+  }
+
+  // Allocator of the next allocations, NULL if they use malloc
+  vtkBufferAllocator* GetAllocationAllocator()
+  {
+    return this->Allocator ?
+      this->Allocator : vtkBufferAllocator::GetDefaultAllocator();
   }
 
+  // Manage array, of allocatedBytes bytes provided by allocator
+  void SetAllocatedBuffer(ScalarType* array, vtkIdType size,
+                          vtkBufferAllocator* allocator,
+                          size_t allocatedBytes);
+
   ScalarType *Pointer;
   vtkIdType Size;
   bool Save;
   void (*DeleteFunction)(void*);
 
+  // The allocator of Pointer if it provided it, NULL if DeleteFunction
+  // releases it
+  vtkBufferAllocator* Allocator;
+  vtkBufferAllocator* PointerAllocator;
+  size_t AllocatedBytes;
+
 private:
   vtkBuffer(const vtkBuffer&) VTK_DELETE_FUNCTION;
   void operator=(const vtkBuffer&) VTK_DELETE_FUNCTION;
@@ -107,17 +144,42 @@ void vtkBuffer<ScalarT>::SetBuffer(
 {
   if (this->Pointer != array)
   {
-    if (!this->Save)
+    if (this->PointerAllocator)
+    {
+      this->PointerAllocator->Free(this->Pointer, this->AllocatedBytes);
+      this->PointerAllocator->UnRegister(this);
+      this->PointerAllocator = NULL;
+      this->AllocatedBytes = 0;
+    }
+    else if (!this->Save)
     {
       this->DeleteFunction(this->Pointer);
     }
     this->Pointer = array;
   }
+  else if (this->PointerAllocator)
+  {
+    // The memory stays owned by its allocator
+    this->Size = size;
+    return;
+  }
   this->Size = size;
   this->Save = save;
   this->DeleteFunction = deleteFunction;
 }
 
+//------------------------------------------------------------------------------
+template <typename ScalarT>
+void vtkBuffer<ScalarT>::SetAllocatedBuffer(
+    typename vtkBuffer<ScalarT>::ScalarType *array, vtkIdType size,
+    vtkBufferAllocator *allocator, size_t allocatedBytes)
+{
+  this->SetBuffer(array, size);
+  allocator->Register(this);
+  this->PointerAllocator = allocator;
+  this->AllocatedBytes = allocatedBytes;
+}
+
 //------------------------------------------------------------------------------
 template <typename ScalarT>
 bool vtkBuffer<ScalarT>::Allocate(vtkIdType size)
@@ -126,6 +188,18 @@ bool vtkBuffer<ScalarT>::Allocate(vtkIdType size)
   this->SetBuffer(NULL, 0);
   if (size > 0)
   {
+    vtkBufferAllocator* allocator = this->GetAllocationAllocator();
+    if (allocator)
+    {
+      size_t bytes = static_cast<size_t>(size) * sizeof(ScalarType);
+      ScalarType* newArray = static_cast<ScalarType*>(allocator->Allocate(bytes));
+      if (newArray)
+      {
+        this->SetAllocatedBuffer(newArray, size, allocator, bytes);
+        return true;
+      }
+      return false;
+    }
     ScalarType* newArray =
         static_cast<ScalarType*>(malloc(size * sizeof(ScalarType)));
     if (newArray)
@@ -144,8 +218,38 @@ bool vtkBuffer<ScalarT>::Reallocate(vtkIdType newsize)
 {
   if (newsize == 0) { return this->Allocate(0); }
 
-  if (this->Pointer &&
-      (this->Save || this->DeleteFunction != free))
+  vtkBufferAllocator* allocator = this->GetAllocationAllocator();
+  size_t newBytes = static_cast<size_t>(newsize) * sizeof(ScalarType);
+  if (this->PointerAllocator && this->PointerAllocator == allocator)
+  {
+    // Let the allocator avoid the copy if it can
+    ScalarType* newArray = static_cast<ScalarType*>(allocator->Reallocate(
+      this->Pointer, this->AllocatedBytes, newBytes));
+    if (!newArray)
+    {
+      return false;
+    }
+    this->Pointer = newArray;
+    this->Size = newsize;
+    this->AllocatedBytes = newBytes;
+  }
+  else if (allocator)
+  {
+    ScalarType* newArray =
+      static_cast<ScalarType*>(allocator->Allocate(newBytes));
+    if (!newArray)
+    {
+      return false;
+    }
+    if (this->Pointer)
+    {
+      std::copy(this->Pointer, this->Pointer + std::min(this->Size, newsize),
+                newArray);
+    }
+    this->SetAllocatedBuffer(newArray, newsize, allocator, newBytes);
+  }
+  else if (this->Pointer &&
+      (this->Save || this->DeleteFunction != free || this->PointerAllocator))
   {
     ScalarType* newArray =
         static_cast<ScalarType*>(malloc(newsize * sizeof(ScalarType)));
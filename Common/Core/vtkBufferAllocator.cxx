@@ -0,0 +1,146 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBufferAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkBufferAllocator.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+vtkAtomic<vtkBufferAllocator*> vtkBufferAllocatorDefault;
+}
+
+//----------------------------------------------------------------------------
+vtkBufferAllocator::vtkBufferAllocator()
+{
+  this->BytesInUse = 0;
+  this->PeakBytesInUse = 0;
+  this->NumberOfAllocations = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkBufferAllocator::~vtkBufferAllocator()
+{
+}
+
+//----------------------------------------------------------------------------
+void* vtkBufferAllocator::Allocate(size_t size)
+{
+  if (size == 0)
+  {
+    return NULL;
+  }
+  void* ptr = this->AllocateMemory(size);
+  if (ptr)
+  {
+    this->AddBytesInUse(static_cast<vtkTypeInt64>(size));
+    ++this->NumberOfAllocations;
+  }
+  return ptr;
+}
+
+//----------------------------------------------------------------------------
+void* vtkBufferAllocator::Reallocate(void* ptr, size_t oldSize, size_t newSize)
+{
+  if (!ptr)
+  {
+    return this->Allocate(newSize);
+  }
+  if (newSize == 0)
+  {
+    this->Free(ptr, oldSize);
+    return NULL;
+  }
+  void* newPtr = this->ReallocateMemory(ptr, oldSize, newSize);
+  if (newPtr)
+  {
+    this->AddBytesInUse(static_cast<vtkTypeInt64>(newSize) -
+                        static_cast<vtkTypeInt64>(oldSize));
+    ++this->NumberOfAllocations;
+  }
+  return newPtr;
+}
+
+//----------------------------------------------------------------------------
+void vtkBufferAllocator::Free(void* ptr, size_t size)
+{
+  if (ptr)
+  {
+    this->FreeMemory(ptr, size);
+    this->BytesInUse -= static_cast<vtkTypeInt64>(size);
+  }
+}
+
+//----------------------------------------------------------------------------
+void* vtkBufferAllocator::ReallocateMemory(void* ptr, size_t oldSize,
+                                           size_t newSize)
+{
+  void* newPtr = this->AllocateMemory(newSize);
+  if (newPtr)
+  {
+    memcpy(newPtr, ptr, std::min(oldSize, newSize));
+    this->FreeMemory(ptr, oldSize);
+  }
+  return newPtr;
+}
+
+//----------------------------------------------------------------------------
+void vtkBufferAllocator::AddBytesInUse(vtkTypeInt64 size)
+{
+  vtkTypeInt64 bytes = (this->BytesInUse += size);
+  // Not exact when another thread updates the peak at the same time
+  if (bytes > this->PeakBytesInUse.load())
+  {
+    this->PeakBytesInUse = bytes;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkBufferAllocator::ResetStatistics()
+{
+  this->PeakBytesInUse = this->BytesInUse.load();
+  this->NumberOfAllocations = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkBufferAllocator::SetDefaultAllocator(vtkBufferAllocator* allocator)
+{
+  if (allocator)
+  {
+    allocator->Register(NULL);
+  }
+  vtkBufferAllocator* previous = vtkBufferAllocatorDefault;
+  vtkBufferAllocatorDefault = allocator;
+  if (previous)
+  {
+    previous->UnRegister(NULL);
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkBufferAllocator* vtkBufferAllocator::GetDefaultAllocator()
+{
+  return vtkBufferAllocatorDefault;
+}
+
+//----------------------------------------------------------------------------
+void vtkBufferAllocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "BytesInUse: " << this->GetBytesInUse() << "\n";
+  os << indent << "PeakBytesInUse: " << this->GetPeakBytesInUse() << "\n";
+  os << indent << "NumberOfAllocations: " << this->GetNumberOfAllocations()
+     << "\n";
+}
@@ -0,0 +1,135 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBufferAllocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkBufferAllocator
+ * @brief   abstract memory allocator of vtkBuffer
+ *
+ * vtkBufferAllocator is the interface through which vtkBuffer, and
+ * therefore vtkAOSDataArrayTemplate and vtkSOADataArrayTemplate, may
+ * allocate the memory of the values instead of using malloc and free.
+ * Subclasses implement AllocateMemory() and FreeMemory(), and optionally
+ * ReallocateMemory(); this class keeps statistics of the memory allocated
+ * through it.
+ *
+ * An allocator is used by a buffer when it is set on the buffer (or its
+ * array, see vtkAOSDataArrayTemplate::SetBufferAllocator()), or, for the
+ * buffers without one, when it is the default allocator. Without an
+ * allocator, buffers use malloc as before. A buffer keeps a reference to
+ * the allocator of its memory, so the memory is always released by the
+ * allocator that provided it.
+ *
+ * The methods of the allocators must be thread safe, since arrays are
+ * created and deleted concurrently.
+ *
+ * @sa
+ * vtkPoolBufferAllocator vtkBuffer
+*/
+
+#ifndef vtkBufferAllocator_h
+#define vtkBufferAllocator_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkObject.h"
+#include "vtkAtomic.h" // For the statistics
+
+class VTKCOMMONCORE_EXPORT vtkBufferAllocator : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkBufferAllocator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  /**
+   * Allocate size bytes. Return NULL on failure or if size is 0.
+   */
+  void* Allocate(size_t size);
+
+  /**
+   * Resize the block of oldSize bytes at ptr (allocated by this allocator)
+   * to newSize bytes, preserving its content. Return the new block, or NULL
+   * on failure, in which case ptr is left untouched.
+   */
+  void* Reallocate(void* ptr, size_t oldSize, size_t newSize);
+
+  /**
+   * Release the block of size bytes at ptr, allocated by this allocator.
+   */
+  void Free(void* ptr, size_t size);
+
+  //@{
+  /**
+   * Statistics of the memory allocated through this allocator: the bytes
+   * currently allocated, the highest value it reached (approximate when
+   * threads allocate concurrently), and the number of allocations
+   * (including reallocations).
+   */
+  vtkTypeInt64 GetBytesInUse() const
+  {
+    return this->BytesInUse.load();
+  }
+  vtkTypeInt64 GetPeakBytesInUse() const
+  {
+    return this->PeakBytesInUse.load();
+  }
+  vtkTypeInt64 GetNumberOfAllocations() const
+  {
+    return this->NumberOfAllocations.load();
+  }
+  //@}
+
+  /**
+   * Restart the peak from the bytes currently in use and the count of
+   * allocations from 0.
+   */
+  void ResetStatistics();
+
+  //@{
+  /**
+   * Set/Get the allocator of the buffers that do not have one. NULL, the
+   * default, makes them use malloc. The allocator is referenced until it is
+   * replaced; set it back to NULL before exiting. Changing it does not
+   * affect the memory already allocated.
+   */
+  static void SetDefaultAllocator(vtkBufferAllocator* allocator);
+  static vtkBufferAllocator* GetDefaultAllocator();
+  //@}
+
+protected:
+  vtkBufferAllocator();
+  ~vtkBufferAllocator() VTK_OVERRIDE;
+
+  //@{
+  /**
+   * Implementation of the allocation. size is never 0 and ptr never NULL.
+   * The default ReallocateMemory() allocates a new block, copies the
+   * content and releases the old one.
+   */
+  virtual void* AllocateMemory(size_t size) = 0;
+  virtual void* ReallocateMemory(void* ptr, size_t oldSize, size_t newSize);
+  virtual void FreeMemory(void* ptr, size_t size) = 0;
+  //@}
+
+  // Account size more bytes
+  void AddBytesInUse(vtkTypeInt64 size);
+
+  vtkAtomic<vtkTypeInt64> BytesInUse;
+  vtkAtomic<vtkTypeInt64> PeakBytesInUse;
+  vtkAtomic<vtkTypeInt64> NumberOfAllocations;
+
+private:
+  vtkBufferAllocator(const vtkBufferAllocator&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkBufferAllocator&) VTK_DELETE_FUNCTION;
+};
+
+#endif
@@ -15,12 +15,16 @@
 #ifndef vtkDataArrayPrivate_txx
 #define vtkDataArrayPrivate_txx
 
-#include "vtkAssume.h"
+#include "vtkAOSDataArrayTemplate.h"
 #include "vtkDataArray.h"
 #include "vtkDataArrayAccessor.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSOADataArrayTemplate.h"
 #include "vtkTypeTraits.h"
 #include <algorithm>
 #include <cassert> // for assert()
+#include <vector>
 
 namespace vtkDataArrayPrivate
 {
@@ -102,295 +106,454 @@ bool isinf(T x)
 }
 }
 
+namespace detail
+{
 //----------------------------------------------------------------------------
-template <class APIType, int NumComps, int RangeSize>
-struct ComputeScalarRange
+// The range kernels of the arrays whose memory layout is known process the
+// tuples by blocks of RangeLanes. Every value of a block has its own
+// accumulator, so the iterations of the inner loops are independent and the
+// compiler can vectorize them with the min/max instructions of the target.
+// Arrays larger than RangeGrain values are split between threads.
+const int RangeLanes = 8;
+const vtkIdType RangeGrain = 65536;
+
+// Like min/max above, a NaN value leaves the accumulator unchanged.
+template <class T>
+inline T LaneMin(T acc, T value)
 {
-  template<class ArrayT>
-  bool operator()(ArrayT *array, double *ranges)
-  {
-    VTK_ASSUME(array->GetNumberOfComponents() == NumComps);
+  return value < acc ? value : acc;
+}
+
+template <class T>
+inline T LaneMax(T acc, T value)
+{
+  return value > acc ? value : acc;
+}
+
+// Value merged into an accumulator: the value itself, or the accumulator
+// (which skips the value) when only finite values are considered.
+template <bool Finite>
+struct RangeFilter
+{
+  template <class T>
+  static T Apply(T value, T) { return value; }
+};
+
+template <>
+struct RangeFilter<true>
+{
+  template <class T>
+  static T Apply(T value, T acc) { return isinf(value) ? acc : value; }
+};
 
-    vtkDataArrayAccessor<ArrayT> access(array);
-    APIType tempRange[RangeSize];
+//----------------------------------------------------------------------------
+template <class T>
+void InitializeRange(T *range, int numRanges)
+{
+  for (int i = 0, j = 0; i < numRanges; ++i, j+=2)
+  {
+    range[j] = vtkTypeTraits<T>::Max();
+    range[j+1] = vtkTypeTraits<T>::Min();
+  }
+}
 
-    for(int i = 0, j = 0; i < NumComps; ++i, j+=2)
+//----------------------------------------------------------------------------
+// Merge the range of each component of numTuples contiguous tuples into
+// range (one min/max pair per component).
+template <class APIType, int NumComps, bool Finite>
+struct ContiguousRange
+{
+  static void Compute(const APIType *data, vtkIdType numTuples, int,
+                      APIType *range)
+  {
+    const int blockSize = RangeLanes * NumComps;
+    APIType mins[blockSize];
+    APIType maxs[blockSize];
+    for (int k = 0; k < blockSize; ++k)
     {
-      tempRange[j] = vtkTypeTraits<APIType>::Max();
-      tempRange[j+1] = vtkTypeTraits<APIType>::Min();
+      mins[k] = range[2 * (k % NumComps)];
+      maxs[k] = range[2 * (k % NumComps) + 1];
     }
 
-    //compute the range for each component of the data array at the same time
-    const vtkIdType numTuples = array->GetNumberOfTuples();
-    for(vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+    const vtkIdType numBlocks = numTuples / RangeLanes;
+    for (vtkIdType block = 0; block < numBlocks; ++block, data += blockSize)
     {
-      for(int compIdx = 0, j = 0; compIdx < NumComps; ++compIdx, j+=2)
+      for (int k = 0; k < blockSize; ++k)
       {
-        APIType value = access.Get(tupleIdx, compIdx);
-        tempRange[j]   = detail::min(tempRange[j], value);
-        tempRange[j+1] = detail::max(tempRange[j+1], value);
+        const APIType value = data[k];
+        mins[k] = LaneMin(mins[k], RangeFilter<Finite>::Apply(value, mins[k]));
+        maxs[k] = LaneMax(maxs[k], RangeFilter<Finite>::Apply(value, maxs[k]));
       }
     }
+    const int numRemaining =
+      static_cast<int>(numTuples - numBlocks * RangeLanes) * NumComps;
+    for (int k = 0; k < numRemaining; ++k)
+    {
+      const APIType value = data[k];
+      mins[k] = LaneMin(mins[k], RangeFilter<Finite>::Apply(value, mins[k]));
+      maxs[k] = LaneMax(maxs[k], RangeFilter<Finite>::Apply(value, maxs[k]));
+    }
 
-    //convert the range to doubles
-    for (int i = 0, j = 0; i < NumComps; ++i, j+=2)
+    for (int k = 0; k < blockSize; ++k)
     {
-      ranges[j] = static_cast<double>(tempRange[j]);
-      ranges[j+1] = static_cast<double>(tempRange[j+1]);
+      const int j = 2 * (k % NumComps);
+      range[j] = LaneMin(range[j], mins[k]);
+      range[j+1] = LaneMax(range[j+1], maxs[k]);
     }
-    return true;
   }
 };
 
-//----------------------------------------------------------------------------
-template <class APIType, int NumComps, int RangeSize>
-struct ComputeScalarFiniteRange
+// Number of components only known at run time
+template <class APIType, bool Finite>
+struct ContiguousRange<APIType, 0, Finite>
 {
-  template<class ArrayT>
-  bool operator()(ArrayT *array, double *ranges)
+  static void Compute(const APIType *data, vtkIdType numTuples, int numComps,
+                      APIType *range)
   {
-    VTK_ASSUME(array->GetNumberOfComponents() == NumComps);
-
-    vtkDataArrayAccessor<ArrayT> access(array);
-    APIType tempRange[RangeSize];
-
-    for(int i = 0, j = 0; i < NumComps; ++i, j+=2)
+    for (vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
     {
-      tempRange[j] = vtkTypeTraits<APIType>::Max();
-      tempRange[j+1] = vtkTypeTraits<APIType>::Min();
+      for (int compIdx = 0, j = 0; compIdx < numComps; ++compIdx, j+=2)
+      {
+        const APIType value = *data++;
+        range[j] = LaneMin(range[j], RangeFilter<Finite>::Apply(value, range[j]));
+        range[j+1] =
+          LaneMax(range[j+1], RangeFilter<Finite>::Apply(value, range[j+1]));
+      }
     }
+  }
+};
 
-    //compute the range for each component of the data array at the same time
-    const vtkIdType numTuples = array->GetNumberOfTuples();
-    for(vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+//----------------------------------------------------------------------------
+// Merge the range of the squared norm of numTuples contiguous tuples into
+// range. NumComps is 0 when the number of components is only known at run
+// time.
+template <class APIType, int NumComps, bool Finite>
+void ComputeContiguousNormRange(const APIType *data, vtkIdType numTuples,
+                                int numComps, double range[2])
+{
+  const int nc = NumComps > 0 ? NumComps : numComps;
+  double mins[RangeLanes];
+  double maxs[RangeLanes];
+  std::fill(mins, mins + RangeLanes, range[0]);
+  std::fill(maxs, maxs + RangeLanes, range[1]);
+
+  for (vtkIdType tupleIdx = 0; tupleIdx < numTuples; tupleIdx += RangeLanes)
+  {
+    const int numLanes = static_cast<int>(
+      std::min(static_cast<vtkIdType>(RangeLanes), numTuples - tupleIdx));
+    for (int lane = 0; lane < numLanes; ++lane, data += nc)
     {
-      for(int compIdx = 0, j = 0; compIdx < NumComps; ++compIdx, j+=2)
+      double squaredSum = 0.0;
+      for (int compIdx = 0; compIdx < nc; ++compIdx)
       {
-        APIType value = access.Get(tupleIdx, compIdx);
-        if (!detail::isinf(value))
-        {
-          tempRange[j]   = detail::min(tempRange[j], value);
-          tempRange[j+1] = detail::max(tempRange[j+1], value);
-        }
+        const double t = static_cast<double>(data[compIdx]);
+        squaredSum += t * t;
       }
+      mins[lane] = LaneMin(mins[lane],
+        RangeFilter<Finite>::Apply(squaredSum, mins[lane]));
+      maxs[lane] = LaneMax(maxs[lane],
+        RangeFilter<Finite>::Apply(squaredSum, maxs[lane]));
     }
+  }
 
-    //convert the range to doubles
-    for (int i = 0, j = 0; i < NumComps; ++i, j+=2)
-    {
-      ranges[j] = static_cast<double>(tempRange[j]);
-      ranges[j+1] = static_cast<double>(tempRange[j+1]);
-    }
-    return true;
+  for (int lane = 0; lane < RangeLanes; ++lane)
+  {
+    range[0] = LaneMin(range[0], mins[lane]);
+    range[1] = LaneMax(range[1], maxs[lane]);
   }
-};
+}
 
 //----------------------------------------------------------------------------
-template <typename ArrayT>
-bool DoComputeScalarFiniteRange(ArrayT *array, double *ranges)
+// Kernels merging the range of the components of the tuples [begin, end)
+// of an array into a range. The generic one uses vtkDataArrayAccessor and
+// is not threaded since the API of some arrays is not thread safe;
+// vtkAOSDataArrayTemplate and vtkSOADataArrayTemplate read their memory
+// directly.
+template <class ArrayT, int NumComps, bool Finite>
+struct ScalarRangeKernel
 {
-  vtkDataArrayAccessor<ArrayT> access(array);
-  typedef typename vtkDataArrayAccessor<ArrayT>::APIType APIType;
+  typedef typename vtkDataArrayAccessor<ArrayT>::APIType RangeType;
+  static const bool Threaded = false;
 
-  const vtkIdType numTuples = array->GetNumberOfTuples();
-  const int numComp = array->GetNumberOfComponents();
+  vtkDataArrayAccessor<ArrayT> Access;
+  int NumberOfComponents;
 
-  //setup the initial ranges to be the max,min for double
-  for (int i = 0, j = 0; i < numComp; ++i, j+=2)
+  explicit ScalarRangeKernel(ArrayT *array)
+    : Access(array), NumberOfComponents(array->GetNumberOfComponents())
   {
-    ranges[j] =  vtkTypeTraits<double>::Max();
-    ranges[j+1] = vtkTypeTraits<double>::Min();
   }
 
-  //do this after we make sure range is max to min
-  if (numTuples == 0)
+  void operator()(vtkIdType begin, vtkIdType end, RangeType *range) const
   {
-    return false;
+    const int numComps = NumComps > 0 ? NumComps : this->NumberOfComponents;
+    for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
+    {
+      for (int compIdx = 0, j = 0; compIdx < numComps; ++compIdx, j+=2)
+      {
+        RangeType value = this->Access.Get(tupleIdx, compIdx);
+        if (!Finite || !isinf(value))
+        {
+          range[j]   = min(range[j], value);
+          range[j+1] = max(range[j+1], value);
+        }
+      }
+    }
   }
+};
 
-  //Special case for single value scalar range. This is done to help the
-  //compiler detect it can perform loop optimizations.
-  if (numComp == 1)
-  {
-    return ComputeScalarFiniteRange<APIType,1,2>()(array, ranges);
-  }
-  else if (numComp == 2)
+template <class ValueT, int NumComps, bool Finite>
+struct ScalarRangeKernel<vtkAOSDataArrayTemplate<ValueT>, NumComps, Finite>
+{
+  typedef ValueT RangeType;
+  static const bool Threaded = true;
+
+  const ValueT *Data;
+  int NumberOfComponents;
+
+  explicit ScalarRangeKernel(vtkAOSDataArrayTemplate<ValueT> *array)
+    : Data(array->GetPointer(0)),
+      NumberOfComponents(array->GetNumberOfComponents())
   {
-    return ComputeScalarFiniteRange<APIType,2,4>()(array, ranges);
   }
-  else if (numComp == 3)
+
+  void operator()(vtkIdType begin, vtkIdType end, RangeType *range) const
   {
-    return ComputeScalarFiniteRange<APIType,3,6>()(array, ranges);
+    ContiguousRange<ValueT, NumComps, Finite>::Compute(
+      this->Data + begin * this->NumberOfComponents, end - begin,
+      this->NumberOfComponents, range);
   }
-  else if (numComp == 4)
+};
+
+template <class ValueT, int NumComps, bool Finite>
+struct ScalarRangeKernel<vtkSOADataArrayTemplate<ValueT>, NumComps, Finite>
+{
+  typedef ValueT RangeType;
+  static const bool Threaded = true;
+
+  std::vector<const ValueT*> Components;
+
+  explicit ScalarRangeKernel(vtkSOADataArrayTemplate<ValueT> *array)
   {
-    return ComputeScalarFiniteRange<APIType,4,8>()(array, ranges);
+    for (int c = 0; c < array->GetNumberOfComponents(); ++c)
+    {
+      this->Components.push_back(array->GetComponentArrayPointer(c));
+    }
   }
-  else if (numComp == 5)
+
+  void operator()(vtkIdType begin, vtkIdType end, RangeType *range) const
   {
-    return ComputeScalarFiniteRange<APIType,5,10>()(array, ranges);
+    for (size_t c = 0; c < this->Components.size(); ++c)
+    {
+      ContiguousRange<ValueT, 1, Finite>::Compute(
+        this->Components[c] + begin, end - begin, 1, range + 2 * c);
+    }
   }
-  else if (numComp == 6)
+};
+
+//----------------------------------------------------------------------------
+// Kernels merging the range of the squared norm of the tuples [begin, end)
+// of an array into a range.
+template <class ArrayT, int NumComps, bool Finite>
+struct VectorRangeKernel
+{
+  typedef double RangeType;
+  static const bool Threaded = false;
+
+  vtkDataArrayAccessor<ArrayT> Access;
+  int NumberOfComponents;
+
+  explicit VectorRangeKernel(ArrayT *array)
+    : Access(array), NumberOfComponents(array->GetNumberOfComponents())
   {
-    return ComputeScalarFiniteRange<APIType,6,12>()(array, ranges);
   }
-  else if (numComp == 7)
+
+  void operator()(vtkIdType begin, vtkIdType end, double range[2]) const
   {
-    return ComputeScalarFiniteRange<APIType,7,14>()(array, ranges);
+    const int numComps = NumComps > 0 ? NumComps : this->NumberOfComponents;
+    for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
+    {
+      double squaredSum = 0.0;
+      for (int compIdx = 0; compIdx < numComps; ++compIdx)
+      {
+        const double t =
+          static_cast<double>(this->Access.Get(tupleIdx, compIdx));
+        squaredSum += t * t;
+      }
+      if (!Finite || !isinf(squaredSum))
+      {
+        range[0] = min(range[0], squaredSum);
+        range[1] = max(range[1], squaredSum);
+      }
+    }
   }
-  else if (numComp == 8)
+};
+
+template <class ValueT, int NumComps, bool Finite>
+struct VectorRangeKernel<vtkAOSDataArrayTemplate<ValueT>, NumComps, Finite>
+{
+  typedef double RangeType;
+  static const bool Threaded = true;
+
+  const ValueT *Data;
+  int NumberOfComponents;
+
+  explicit VectorRangeKernel(vtkAOSDataArrayTemplate<ValueT> *array)
+    : Data(array->GetPointer(0)),
+      NumberOfComponents(array->GetNumberOfComponents())
   {
-    return ComputeScalarFiniteRange<APIType,8,16>()(array, ranges);
   }
-  else if (numComp == 9)
+
+  void operator()(vtkIdType begin, vtkIdType end, double range[2]) const
   {
-    return ComputeScalarFiniteRange<APIType,9,18>()(array, ranges);
+    ComputeContiguousNormRange<ValueT, NumComps, Finite>(
+      this->Data + begin * this->NumberOfComponents, end - begin,
+      this->NumberOfComponents, range);
   }
-  else
+};
+
+template <class ValueT, int NumComps, bool Finite>
+struct VectorRangeKernel<vtkSOADataArrayTemplate<ValueT>, NumComps, Finite>
+{
+  typedef double RangeType;
+  static const bool Threaded = true;
+
+  std::vector<const ValueT*> Components;
+
+  explicit VectorRangeKernel(vtkSOADataArrayTemplate<ValueT> *array)
   {
-    //initialize the temp range storage to min/max pairs
-    APIType* tempRange = new APIType[numComp*2];
-    for (int i = 0, j = 0; i < numComp; ++i, j+=2)
+    for (int c = 0; c < array->GetNumberOfComponents(); ++c)
     {
-      tempRange[j] = vtkTypeTraits<APIType>::Max();
-      tempRange[j+1] = vtkTypeTraits<APIType>::Min();
+      this->Components.push_back(array->GetComponentArrayPointer(c));
     }
+  }
 
-    //compute the range for each component of the data array at the same time
-    for (vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+  void operator()(vtkIdType begin, vtkIdType end, double range[2]) const
+  {
+    double mins[RangeLanes];
+    double maxs[RangeLanes];
+    std::fill(mins, mins + RangeLanes, range[0]);
+    std::fill(maxs, maxs + RangeLanes, range[1]);
+
+    // Accumulate the squares one component at a time over a block of tuples
+    for (vtkIdType tupleIdx = begin; tupleIdx < end; tupleIdx += RangeLanes)
     {
-      for(int compIdx = 0, j = 0; compIdx < numComp; ++compIdx, j+=2)
+      const int numLanes = static_cast<int>(
+        std::min(static_cast<vtkIdType>(RangeLanes), end - tupleIdx));
+      double squaredSums[RangeLanes] = { 0.0 };
+      for (size_t c = 0; c < this->Components.size(); ++c)
       {
-        APIType value = access.Get(tupleIdx, compIdx);
-        if (!detail::isinf(value))
+        const ValueT *data = this->Components[c] + tupleIdx;
+        for (int lane = 0; lane < numLanes; ++lane)
         {
-          tempRange[j]   = detail::min(tempRange[j],value);
-          tempRange[j+1] = detail::max(tempRange[j+1],value);
+          const double t = static_cast<double>(data[lane]);
+          squaredSums[lane] += t * t;
         }
       }
+      for (int lane = 0; lane < numLanes; ++lane)
+      {
+        mins[lane] = LaneMin(mins[lane],
+          RangeFilter<Finite>::Apply(squaredSums[lane], mins[lane]));
+        maxs[lane] = LaneMax(maxs[lane],
+          RangeFilter<Finite>::Apply(squaredSums[lane], maxs[lane]));
+      }
     }
 
-    //convert the range to doubles
-    for (int i = 0, j = 0; i < numComp; ++i, j+=2)
+    for (int lane = 0; lane < RangeLanes; ++lane)
     {
-      ranges[j] = static_cast<double>(tempRange[j]);
-      ranges[j+1] = static_cast<double>(tempRange[j+1]);
+      range[0] = LaneMin(range[0], mins[lane]);
+      range[1] = LaneMax(range[1], maxs[lane]);
     }
-
-    //cleanup temp range storage
-    delete[] tempRange;
-
-    return true;
   }
-}
+};
 
 //----------------------------------------------------------------------------
-template <typename ArrayT>
-bool DoComputeScalarRange(ArrayT *array, double *ranges)
+// vtkSMPTools functor merging the ranges computed by each thread.
+template <class KernelT>
+class RangeFunctor
 {
-  vtkDataArrayAccessor<ArrayT> access(array);
-  typedef typename vtkDataArrayAccessor<ArrayT>::APIType APIType;
+  typedef typename KernelT::RangeType RangeType;
 
-  const vtkIdType numTuples = array->GetNumberOfTuples();
-  const int numComp = array->GetNumberOfComponents();
+  const KernelT &Kernel;
+  int NumberOfRanges;
+  RangeType *Range;
+  vtkSMPThreadLocal<std::vector<RangeType> > TLRange;
 
-  //setup the initial ranges to be the max,min for double
-  for (int i = 0, j = 0; i < numComp; ++i, j+=2)
+public:
+  RangeFunctor(const KernelT &kernel, int numRanges, RangeType *range)
+    : Kernel(kernel), NumberOfRanges(numRanges), Range(range)
   {
-    ranges[j] =  vtkTypeTraits<double>::Max();
-    ranges[j+1] = vtkTypeTraits<double>::Min();
   }
 
-  //do this after we make sure range is max to min
-  if (numTuples == 0)
+  void Initialize()
   {
-    return false;
+    std::vector<RangeType> &range = this->TLRange.Local();
+    range.resize(2 * this->NumberOfRanges);
+    InitializeRange(&range[0], this->NumberOfRanges);
   }
 
-  //Special case for single value scalar range. This is done to help the
-  //compiler detect it can perform loop optimizations.
-  if (numComp == 1)
-  {
-    return ComputeScalarRange<APIType,1,2>()(array, ranges);
-  }
-  else if (numComp == 2)
-  {
-    return ComputeScalarRange<APIType,2,4>()(array, ranges);
-  }
-  else if (numComp == 3)
-  {
-    return ComputeScalarRange<APIType,3,6>()(array, ranges);
-  }
-  else if (numComp == 4)
-  {
-    return ComputeScalarRange<APIType,4,8>()(array, ranges);
-  }
-  else if (numComp == 5)
-  {
-    return ComputeScalarRange<APIType,5,10>()(array, ranges);
-  }
-  else if (numComp == 6)
-  {
-    return ComputeScalarRange<APIType,6,12>()(array, ranges);
-  }
-  else if (numComp == 7)
-  {
-    return ComputeScalarRange<APIType,7,14>()(array, ranges);
-  }
-  else if (numComp == 8)
-  {
-    return ComputeScalarRange<APIType,8,16>()(array, ranges);
-  }
-  else if (numComp == 9)
+  void operator()(vtkIdType begin, vtkIdType end)
   {
-    return ComputeScalarRange<APIType,9,18>()(array, ranges);
+    this->Kernel(begin, end, &this->TLRange.Local()[0]);
   }
-  else
-  {
-    //initialize the temp range storage to min/max pairs
-    APIType* tempRange = new APIType[numComp*2];
-    for (int i = 0, j = 0; i < numComp; ++i, j+=2)
-    {
-      tempRange[j] = vtkTypeTraits<APIType>::Max();
-      tempRange[j+1] = vtkTypeTraits<APIType>::Min();
-    }
 
-    //compute the range for each component of the data array at the same time
-    for (vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+  void Reduce()
+  {
+    typedef typename vtkSMPThreadLocal<std::vector<RangeType> >::iterator
+      IteratorType;
+    for (IteratorType itr = this->TLRange.begin();
+         itr != this->TLRange.end(); ++itr)
     {
-      for(int compIdx = 0, j = 0; compIdx < numComp; ++compIdx, j+=2)
+      const std::vector<RangeType> &range = *itr;
+      for (int i = 0, j = 0; i < this->NumberOfRanges; ++i, j+=2)
       {
-        APIType value = access.Get(tupleIdx, compIdx);
-        tempRange[j]   = detail::min(tempRange[j],value);
-        tempRange[j+1] = detail::max(tempRange[j+1],value);
+        this->Range[j] = LaneMin(this->Range[j], range[j]);
+        this->Range[j+1] = LaneMax(this->Range[j+1], range[j+1]);
       }
     }
+  }
+};
 
-    //convert the range to doubles
-    for (int i = 0, j = 0; i < numComp; ++i, j+=2)
-    {
-      ranges[j] = static_cast<double>(tempRange[j]);
-      ranges[j+1] = static_cast<double>(tempRange[j+1]);
-    }
-
-    //cleanup temp range storage
-    delete[] tempRange;
-
-    return true;
+//----------------------------------------------------------------------------
+// Compute numRanges min/max pairs over all the tuples with the kernel.
+template <class KernelT>
+void ExecuteRangeKernel(const KernelT &kernel, vtkIdType numTuples,
+                        int numComps, int numRanges,
+                        typename KernelT::RangeType *range)
+{
+  InitializeRange(range, numRanges);
+  const vtkIdType grain =
+    std::max(RangeGrain / std::max(numComps, 1), static_cast<vtkIdType>(1));
+  if (!KernelT::Threaded || numTuples <= grain)
+  {
+    kernel(0, numTuples, range);
+    return;
   }
+  RangeFunctor<KernelT> functor(kernel, numRanges, range);
+  vtkSMPTools::For(0, numTuples, grain, functor);
 }
 
 //----------------------------------------------------------------------------
-template <typename ArrayT>
-bool DoComputeVectorRange(ArrayT *array, double range[2])
+template <class ArrayT, int NumComps, bool Finite>
+void ComputeScalarRange(ArrayT *array,
+  typename ScalarRangeKernel<ArrayT, NumComps, Finite>::RangeType *range)
 {
-  vtkDataArrayAccessor<ArrayT> access(array);
+  const int numComps = array->GetNumberOfComponents();
+  ScalarRangeKernel<ArrayT, NumComps, Finite> kernel(array);
+  ExecuteRangeKernel(kernel, array->GetNumberOfTuples(), numComps, numComps,
+                     range);
+}
+
+//----------------------------------------------------------------------------
+template <bool Finite, typename ArrayT>
+bool DoComputeScalarRange(ArrayT *array, double *ranges)
+{
+  typedef typename ScalarRangeKernel<ArrayT, 0, Finite>::RangeType APIType;
 
   const vtkIdType numTuples = array->GetNumberOfTuples();
-  const int numComps = array->GetNumberOfComponents();
+  const int numComp = array->GetNumberOfComponents();
 
-  range[0] = vtkTypeTraits<double>::Max();
-  range[1] = vtkTypeTraits<double>::Min();
+  //setup the initial ranges to be the max,min for double
+  InitializeRange(ranges, numComp);
 
   //do this after we make sure range is max to min
   if (numTuples == 0)
@@ -398,38 +561,70 @@ bool DoComputeVectorRange(ArrayT *array, double range[2])
     return false;
   }
 
-  //iterate over all the tuples
-  for (vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+  //compute the range for each component of the data array at the same
+  //time. The common numbers of components are special cased to help the
+  //compiler detect it can perform loop optimizations.
+  std::vector<APIType> tempRange(2 * numComp);
+  switch (numComp)
+  {
+    case 1:
+      ComputeScalarRange<ArrayT, 1, Finite>(array, &tempRange[0]);
+      break;
+    case 2:
+      ComputeScalarRange<ArrayT, 2, Finite>(array, &tempRange[0]);
+      break;
+    case 3:
+      ComputeScalarRange<ArrayT, 3, Finite>(array, &tempRange[0]);
+      break;
+    case 4:
+      ComputeScalarRange<ArrayT, 4, Finite>(array, &tempRange[0]);
+      break;
+    case 5:
+      ComputeScalarRange<ArrayT, 5, Finite>(array, &tempRange[0]);
+      break;
+    case 6:
+      ComputeScalarRange<ArrayT, 6, Finite>(array, &tempRange[0]);
+      break;
+    case 7:
+      ComputeScalarRange<ArrayT, 7, Finite>(array, &tempRange[0]);
+      break;
+    case 8:
+      ComputeScalarRange<ArrayT, 8, Finite>(array, &tempRange[0]);
+      break;
+    case 9:
+      ComputeScalarRange<ArrayT, 9, Finite>(array, &tempRange[0]);
+      break;
+    default:
+      ComputeScalarRange<ArrayT, 0, Finite>(array, &tempRange[0]);
+      break;
+  }
+
+  //convert the range to doubles
+  for (int i = 0, j = 0; i < numComp; ++i, j+=2)
   {
-    double squaredSum = 0.0;
-    for (int compIdx = 0; compIdx < numComps; ++compIdx)
-    {
-      const double t = static_cast<double>(access.Get(tupleIdx, compIdx));
-      squaredSum += t * t;
-    }
-    range[0] = detail::min(range[0], squaredSum);
-    range[1] = detail::max(range[1], squaredSum);
+    ranges[j] = static_cast<double>(tempRange[j]);
+    ranges[j+1] = static_cast<double>(tempRange[j+1]);
   }
-
-  //now that we have computed the smallest and largest value, take the
-  //square root of that value.
-  range[0] = sqrt(range[0]);
-  range[1] = sqrt(range[1]);
-
   return true;
 }
 
 //----------------------------------------------------------------------------
-template <typename ArrayT>
-bool DoComputeVectorFiniteRange(ArrayT *array, double range[2])
+template <class ArrayT, int NumComps, bool Finite>
+void ComputeVectorRange(ArrayT *array, double range[2])
 {
-  vtkDataArrayAccessor<ArrayT> access(array);
+  VectorRangeKernel<ArrayT, NumComps, Finite> kernel(array);
+  ExecuteRangeKernel(kernel, array->GetNumberOfTuples(),
+                     array->GetNumberOfComponents(), 1, range);
+}
 
+//----------------------------------------------------------------------------
+template <bool Finite, typename ArrayT>
+bool DoComputeVectorRange(ArrayT *array, double range[2])
+{
   const vtkIdType numTuples = array->GetNumberOfTuples();
   const int numComps = array->GetNumberOfComponents();
 
-  range[0] = vtkTypeTraits<double>::Max();
-  range[1] = vtkTypeTraits<double>::Min();
+  InitializeRange(range, 1);
 
   //do this after we make sure range is max to min
   if (numTuples == 0)
@@ -437,20 +632,24 @@ bool DoComputeVectorFiniteRange(ArrayT *array, double range[2])
     return false;
   }
 
-  //iterate over all the tuples
-  for (vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+  //compute the smallest and largest squared norm
+  switch (numComps)
   {
-    double squaredSum = 0.0;
-    for (int compIdx = 0; compIdx < numComps; ++compIdx)
-    {
-      const double t = static_cast<double>(access.Get(tupleIdx, compIdx));
-      squaredSum += t * t;
-    }
-    if (!detail::isinf(squaredSum))
-    {
-      range[0] = detail::min(range[0], squaredSum);
-      range[1] = detail::max(range[1], squaredSum);
-    }
+    case 1:
+      ComputeVectorRange<ArrayT, 1, Finite>(array, range);
+      break;
+    case 2:
+      ComputeVectorRange<ArrayT, 2, Finite>(array, range);
+      break;
+    case 3:
+      ComputeVectorRange<ArrayT, 3, Finite>(array, range);
+      break;
+    case 4:
+      ComputeVectorRange<ArrayT, 4, Finite>(array, range);
+      break;
+    default:
+      ComputeVectorRange<ArrayT, 0, Finite>(array, range);
+      break;
   }
 
   //now that we have computed the smallest and largest value, take the
@@ -461,6 +660,36 @@ bool DoComputeVectorFiniteRange(ArrayT *array, double range[2])
   return true;
 }
 
+} // end namespace detail
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+bool DoComputeScalarRange(ArrayT *array, double *ranges)
+{
+  return detail::DoComputeScalarRange<false>(array, ranges);
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+bool DoComputeScalarFiniteRange(ArrayT *array, double *ranges)
+{
+  return detail::DoComputeScalarRange<true>(array, ranges);
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+bool DoComputeVectorRange(ArrayT *array, double range[2])
+{
+  return detail::DoComputeVectorRange<false>(array, range);
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+bool DoComputeVectorFiniteRange(ArrayT *array, double range[2])
+{
+  return detail::DoComputeVectorRange<true>(array, range);
+}
+
 } // end namespace vtkDataArrayPrivate
 #endif
 // VTK-HeaderTest-Exclude: vtkDataArrayPrivate.txx
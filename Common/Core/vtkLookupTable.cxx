@@ -19,10 +19,14 @@
 #include "vtkMath.h"
 #include "vtkMathConfigure.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkStringArray.h"
 #include "vtkVariantArray.h"
 
 #include <cassert>
+#include <cstring>
+#include <limits>
+#include <vector>
 
 const vtkIdType vtkLookupTable::BELOW_RANGE_COLOR_INDEX  = 0;
 const vtkIdType vtkLookupTable::ABOVE_RANGE_COLOR_INDEX  = 1;
@@ -1137,9 +1141,180 @@ void vtkLookupTableIndexedMapData(
   } // alpha blending
 }
 
+//----------------------------------------------------------------------------
+// Number of values mapped by each task of the threaded mappings
+const vtkIdType vtkLookupTableMapGrain = 16384;
+
+//----------------------------------------------------------------------------
+// Map a range of the values with vtkLookupTableMapData.
+template<class T>
+struct vtkLookupTableMapFunctor
+{
+  vtkLookupTable *Self;
+  T *Input;
+  unsigned char *Output;
+  int InIncr;
+  int OutFormat;
+  TableParameters Parameters;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    TableParameters p = this->Parameters;
+    vtkLookupTableMapData(this->Self, this->Input + begin*this->InIncr,
+                          this->Output + begin*this->OutFormat,
+                          static_cast<int>(end - begin), this->InIncr,
+                          this->OutFormat, p);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Map a range of the values with vtkLookupTableIndexedMapData.
+template<class T>
+struct vtkLookupTableIndexedMapFunctor
+{
+  vtkLookupTable *Self;
+  T *Input;
+  unsigned char *Output;
+  int InIncr;
+  int OutFormat;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkLookupTableIndexedMapData(this->Self, this->Input + begin*this->InIncr,
+                                 this->Output + begin*this->OutFormat,
+                                 static_cast<int>(end - begin), this->InIncr,
+                                 this->OutFormat);
+  }
+};
+
+//----------------------------------------------------------------------------
+// The types with few enough values to be mapped through a palette of the
+// colors of all their values.
+template<class T>
+struct vtkLookupTablePaletteTraits
+{
+  enum { Size = 0 };
+};
+template<>
+struct vtkLookupTablePaletteTraits<char>
+{
+  enum { Size = 256 };
+};
+template<>
+struct vtkLookupTablePaletteTraits<signed char>
+{
+  enum { Size = 256 };
+};
+template<>
+struct vtkLookupTablePaletteTraits<unsigned char>
+{
+  enum { Size = 256 };
+};
+template<>
+struct vtkLookupTablePaletteTraits<short>
+{
+  enum { Size = 65536 };
+};
+template<>
+struct vtkLookupTablePaletteTraits<unsigned short>
+{
+  enum { Size = 65536 };
+};
+
+//----------------------------------------------------------------------------
+// Copy the palette colors of a range of the values.
+template<class T>
+struct vtkLookupTablePaletteFunctor
+{
+  const unsigned char *Palette;
+  T *Input;
+  unsigned char *Output;
+  int InIncr;
+  int OutFormat;
+
+  template<int N>
+  void Copy(const T *input, unsigned char *output, vtkIdType n)
+  {
+    const int offset = -static_cast<int>(std::numeric_limits<T>::min());
+    for (vtkIdType i = 0; i < n; ++i)
+    {
+      memcpy(output, this->Palette + N*(static_cast<int>(*input) + offset), N);
+      input += this->InIncr;
+      output += N;
+    }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const T *input = this->Input + begin*this->InIncr;
+    unsigned char *output = this->Output + begin*this->OutFormat;
+    switch (this->OutFormat)
+    {
+      case VTK_RGBA:
+        this->Copy<4>(input, output, end - begin);
+        break;
+      case VTK_RGB:
+        this->Copy<3>(input, output, end - begin);
+        break;
+      case VTK_LUMINANCE_ALPHA:
+        this->Copy<2>(input, output, end - begin);
+        break;
+      default:
+        this->Copy<1>(input, output, end - begin);
+        break;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Map the values in parallel. The values of the small integer types are
+// mapped through a palette when there are many more values than colors in
+// the palette, which replaces the computations per value by a copy.
+template<class T>
+void vtkLookupTableMapDataThreaded(vtkLookupTable *self,
+                                   T *input, unsigned char *output,
+                                   int length, int inIncr, int outFormat,
+                                   TableParameters &p)
+{
+  const int paletteSize = vtkLookupTablePaletteTraits<T>::Size;
+  if (paletteSize > 0 && length >= 4*paletteSize)
+  {
+    std::vector<T> values(paletteSize);
+    for (int i = 0; i < paletteSize; ++i)
+    {
+      values[i] = static_cast<T>(std::numeric_limits<T>::min() + i);
+    }
+    std::vector<unsigned char> palette(paletteSize*outFormat);
+    vtkLookupTableMapData(self, &values[0], &palette[0], paletteSize, 1,
+                          outFormat, p);
+    vtkLookupTablePaletteFunctor<T> functor =
+      { &palette[0], input, output, inIncr, outFormat };
+    vtkSMPTools::For(0, length, vtkLookupTableMapGrain, functor);
+    return;
+  }
+
+  vtkLookupTableMapFunctor<T> functor =
+    { self, input, output, inIncr, outFormat, p };
+  vtkSMPTools::For(0, length, vtkLookupTableMapGrain, functor);
+}
+
+//----------------------------------------------------------------------------
+template<class T>
+void vtkLookupTableIndexedMapDataThreaded(vtkLookupTable *self,
+                                          T *input, unsigned char *output,
+                                          int length, int inIncr,
+                                          int outFormat)
+{
+  vtkLookupTableIndexedMapFunctor<T> functor =
+    { self, input, output, inIncr, outFormat };
+  vtkSMPTools::For(0, length, vtkLookupTableMapGrain, functor);
+}
+
 } // end anonymous namespace
 
 //----------------------------------------------------------------------------
+// The values are mapped in parallel by vtkSMPTools: the mapping only reads
+// the state of the table.
 void vtkLookupTable::MapScalarsThroughTable2(void *input,
                                              unsigned char *output,
                                              int inputDataType,
@@ -1162,7 +1337,7 @@ void vtkLookupTable::MapScalarsThroughTable2(void *input,
         {
           newInput->SetValue(i, bitArray->GetValue(id));
         }
-        vtkLookupTableIndexedMapData(this,
+        vtkLookupTableIndexedMapDataThreaded(this,
                                      static_cast<unsigned char*>(newInput->GetPointer(0)),
                                      output,numberOfValues,
                                      inputIncrement,outputFormat);
@@ -1172,12 +1347,12 @@ void vtkLookupTable::MapScalarsThroughTable2(void *input,
         break;
 
       vtkTemplateMacro(
-        vtkLookupTableIndexedMapData(this,static_cast<VTK_TT*>(input),output,
+        vtkLookupTableIndexedMapDataThreaded(this,static_cast<VTK_TT*>(input),output,
                                      numberOfValues,inputIncrement,outputFormat)
         );
 
       case VTK_STRING:
-        vtkLookupTableIndexedMapData(this,static_cast<vtkStdString*>(input),output,
+        vtkLookupTableIndexedMapDataThreaded(this,static_cast<vtkStdString*>(input),output,
                                      numberOfValues,inputIncrement,outputFormat);
         break;
 
@@ -1204,7 +1379,7 @@ void vtkLookupTable::MapScalarsThroughTable2(void *input,
         {
           newInput->SetValue(i, bitArray->GetValue(id));
         }
-        vtkLookupTableMapData(this, static_cast<unsigned char*>(newInput->GetPointer(0)),
+        vtkLookupTableMapDataThreaded(this, static_cast<unsigned char*>(newInput->GetPointer(0)),
                               output, numberOfValues,
                               inputIncrement, outputFormat, p);
         newInput->Delete();
@@ -1213,7 +1388,7 @@ void vtkLookupTable::MapScalarsThroughTable2(void *input,
         break;
 
       vtkTemplateMacro(
-        vtkLookupTableMapData(this, static_cast<VTK_TT*>(input),output,
+        vtkLookupTableMapDataThreaded(this, static_cast<VTK_TT*>(input),output,
                               numberOfValues, inputIncrement, outputFormat, p)
         );
       default:
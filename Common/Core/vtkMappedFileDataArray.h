@@ -0,0 +1,117 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMappedFileDataArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkMappedFileDataArray
+ * @brief   Array-Of-Structs array whose values
+ * are a region of a memory mapped file.
+ *
+ *
+ * vtkMappedFileDataArray uses a region of a vtkMemoryMappedFile as the
+ * storage of a vtkAOSDataArrayTemplate: mapping a region does not read
+ * anything, the values are loaded by the system as they are accessed and
+ * the pages are shared with the other processes mapping the file. The file
+ * must hold the values in the native byte order.
+ *
+ * The values may be modified without affecting the file (copy on write).
+ * Operations that resize the array copy the values to memory owned by the
+ * array, which then no longer depends on the file.
+ *
+ * Since the array is a vtkAOSDataArrayTemplate, vtkArrayDispatch and
+ * vtkArrayDownCast process it like any other AOS array of the same value
+ * type, and GetVoidPointer() returns the mapped memory. NewInstance() creates
+ * regular arrays (e.g. vtkFloatArray).
+ *
+ * @sa
+ * vtkMemoryMappedFile vtkAOSDataArrayTemplate
+*/
+
+#ifndef vtkMappedFileDataArray_h
+#define vtkMappedFileDataArray_h
+
+#include "vtkAOSDataArrayTemplate.h" // Parent
+#include "vtkMemoryMappedFile.h" // For the mapping
+#include "vtkSmartPointer.h" // For File
+
+#include <typeinfo> // For typeid
+
+template <class ValueTypeT>
+class vtkMappedFileDataArray : public vtkAOSDataArrayTemplate<ValueTypeT>
+{
+public:
+  typedef vtkMappedFileDataArray<ValueTypeT> SelfType;
+  vtkAbstractTypeMacroWithNewInstanceType(SelfType,
+    vtkAOSDataArrayTemplate<ValueTypeT>, vtkAOSDataArrayTemplate<ValueTypeT>,
+    typeid(SelfType).name())
+  vtkAOSArrayNewInstanceMacro(SelfType)
+  typedef typename Superclass::ValueType ValueType;
+
+  static vtkMappedFileDataArray* New();
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  /**
+   * Use numTuples tuples of the mapped file, starting at the given byte
+   * offset, as the values of the array. The number of components must be
+   * set first. Return false, leaving the array unchanged, if the region is
+   * not within the file or if offset is not a multiple of the size of
+   * ValueType.
+   */
+  bool MapRegion(vtkMemoryMappedFile* file, vtkTypeUInt64 offset,
+                 vtkIdType numTuples);
+
+  /**
+   * Map the named file and use a region of it, see MapRegion().
+   */
+  bool MapFile(const char* fileName, vtkTypeUInt64 offset,
+               vtkIdType numTuples);
+
+  /**
+   * Return the file the values were mapped from, NULL if none.
+   */
+  vtkMemoryMappedFile* GetFile()
+  {
+    return this->File;
+  }
+
+  /**
+   * Return whether the values are still those of the mapped file (i.e. the
+   * array was not resized since the region was mapped).
+   */
+  bool IsMapped() const
+  {
+    return this->File && this->MappedPointer &&
+      this->Buffer->GetBuffer() == this->MappedPointer;
+  }
+
+  /**
+   * Release the storage and the file.
+   */
+  void Initialize() VTK_OVERRIDE;
+
+protected:
+  vtkMappedFileDataArray();
+  ~vtkMappedFileDataArray() VTK_OVERRIDE;
+
+  vtkSmartPointer<vtkMemoryMappedFile> File;
+  ValueType* MappedPointer;
+
+private:
+  vtkMappedFileDataArray(const vtkMappedFileDataArray&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkMappedFileDataArray&) VTK_DELETE_FUNCTION;
+};
+
+#include "vtkMappedFileDataArray.txx"
+
+#endif
+// VTK-HeaderTest-Exclude: vtkMappedFileDataArray.h
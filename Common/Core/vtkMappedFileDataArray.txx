@@ -0,0 +1,107 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMappedFileDataArray.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkObjectFactory.h"
+
+//------------------------------------------------------------------------------
+// Can't use vtkStandardNewMacro on a templated class.
+template <class ValueTypeT>
+vtkMappedFileDataArray<ValueTypeT>* vtkMappedFileDataArray<ValueTypeT>::New()
+{
+  VTK_STANDARD_NEW_BODY(vtkMappedFileDataArray<ValueTypeT>);
+}
+
+//------------------------------------------------------------------------------
+template <class ValueTypeT>
+vtkMappedFileDataArray<ValueTypeT>::vtkMappedFileDataArray()
+  : MappedPointer(NULL)
+{
+}
+
+//------------------------------------------------------------------------------
+template <class ValueTypeT>
+vtkMappedFileDataArray<ValueTypeT>::~vtkMappedFileDataArray()
+{
+  // Release the mapped memory before the file
+  this->SetArray(NULL, 0, 1);
+}
+
+//------------------------------------------------------------------------------
+template <class ValueTypeT>
+bool vtkMappedFileDataArray<ValueTypeT>::MapRegion(vtkMemoryMappedFile* file,
+                                                   vtkTypeUInt64 offset,
+                                                   vtkIdType numTuples)
+{
+  if (!file || !file->IsOpen() || numTuples < 0)
+  {
+    vtkErrorMacro("No mapped file to use.");
+    return false;
+  }
+  if (offset % sizeof(ValueType) != 0)
+  {
+    vtkErrorMacro("Offset " << offset << " is not aligned on the size of the "
+                  "values.");
+    return false;
+  }
+  const vtkTypeUInt64 numValues = static_cast<vtkTypeUInt64>(numTuples) *
+    this->NumberOfComponents;
+  const vtkTypeUInt64 size = file->GetSize();
+  if (offset > size || numValues > (size - offset) / sizeof(ValueType))
+  {
+    vtkErrorMacro("Region of " << numValues << " values at offset " << offset
+                  << " is outside of " << file->GetFileName());
+    return false;
+  }
+
+  // Keep the array empty rather than pointing past the end of the file
+  ValueType* data = numValues > 0 ?
+    static_cast<ValueType*>(file->GetPointer(offset)) : NULL;
+  this->SetArray(data, static_cast<vtkIdType>(numValues), 1);
+  this->File = file;
+  this->MappedPointer = data;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+template <class ValueTypeT>
+bool vtkMappedFileDataArray<ValueTypeT>::MapFile(const char* fileName,
+                                                 vtkTypeUInt64 offset,
+                                                 vtkIdType numTuples)
+{
+  vtkSmartPointer<vtkMemoryMappedFile> file =
+    vtkSmartPointer<vtkMemoryMappedFile>::New();
+  return file->Open(fileName) && this->MapRegion(file, offset, numTuples);
+}
+
+//------------------------------------------------------------------------------
+template <class ValueTypeT>
+void vtkMappedFileDataArray<ValueTypeT>::Initialize()
+{
+  this->Superclass::Initialize();
+  this->File = NULL;
+  this->MappedPointer = NULL;
+}
+
+//------------------------------------------------------------------------------
+template <class ValueTypeT>
+void vtkMappedFileDataArray<ValueTypeT>::PrintSelf(ostream& os,
+                                                   vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "File: "
+     << (this->File && this->File->GetFileName() ?
+         this->File->GetFileName() : "(none)") << "\n";
+  os << indent << "Mapped: " << (this->IsMapped() ? "On" : "Off") << "\n";
+}
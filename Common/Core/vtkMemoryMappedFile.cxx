@@ -0,0 +1,151 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryMappedFile.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMemoryMappedFile.h"
+
+#include "vtkObjectFactory.h"
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# include "vtkWindows.h"
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+vtkStandardNewMacro(vtkMemoryMappedFile);
+
+//----------------------------------------------------------------------------
+vtkMemoryMappedFile::vtkMemoryMappedFile()
+{
+  this->FileName = NULL;
+  this->Data = NULL;
+  this->Size = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMemoryMappedFile::~vtkMemoryMappedFile()
+{
+  this->Close();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMemoryMappedFile::Open(const char* fileName)
+{
+  this->Close();
+  if (!fileName)
+  {
+    vtkErrorMacro("No file name specified.");
+    return false;
+  }
+
+  vtkTypeUInt64 size = 0;
+  void* data = NULL;
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    vtkErrorMacro("Cannot open file " << fileName);
+    return false;
+  }
+  LARGE_INTEGER fileSize;
+  if (GetFileSizeEx(file, &fileSize))
+  {
+    size = static_cast<vtkTypeUInt64>(fileSize.QuadPart);
+  }
+  if (size > 0 && size <= static_cast<vtkTypeUInt64>(static_cast<size_t>(-1)))
+  {
+    // The view keeps a reference to the mapping, which keeps one to the file
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (mapping)
+    {
+      data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+#else
+  int file = open(fileName, O_RDONLY);
+  if (file < 0)
+  {
+    vtkErrorMacro("Cannot open file " << fileName);
+    return false;
+  }
+  struct stat fileStat;
+  if (fstat(file, &fileStat) == 0)
+  {
+    size = static_cast<vtkTypeUInt64>(fileStat.st_size);
+  }
+  if (size > 0 && size <= static_cast<vtkTypeUInt64>(static_cast<size_t>(-1)))
+  {
+    // The mapping stays valid after the descriptor is closed
+    data = mmap(NULL, static_cast<size_t>(size), PROT_READ | PROT_WRITE,
+                MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED)
+    {
+      data = NULL;
+    }
+  }
+  close(file);
+#endif
+
+  if (!data)
+  {
+    vtkErrorMacro("Cannot map file " << fileName << " of " << size
+                  << " bytes");
+    return false;
+  }
+
+  this->Data = static_cast<char*>(data);
+  this->Size = size;
+  this->SetFileName(fileName);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMemoryMappedFile::Close()
+{
+  if (this->Data)
+  {
+#if defined(_WIN32) && !defined(__CYGWIN__)
+    UnmapViewOfFile(this->Data);
+#else
+    munmap(this->Data, static_cast<size_t>(this->Size));
+#endif
+    this->Data = NULL;
+    this->Size = 0;
+    this->SetFileName(NULL);
+  }
+}
+
+//----------------------------------------------------------------------------
+void* vtkMemoryMappedFile::GetPointer(vtkTypeUInt64 offset)
+{
+  if (!this->Data || offset >= this->Size)
+  {
+    return NULL;
+  }
+  return this->Data + offset;
+}
+
+//----------------------------------------------------------------------------
+void vtkMemoryMappedFile::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: "
+     << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "Size: " << this->Size << "\n";
+}
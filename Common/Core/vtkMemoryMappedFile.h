@@ -0,0 +1,100 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryMappedFile.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkMemoryMappedFile
+ * @brief   file mapped into memory
+ *
+ * vtkMemoryMappedFile maps a whole file into the address space of the
+ * process. Nothing is read when the file is opened: the system loads the
+ * pages of the file as they are accessed and shares them with the other
+ * processes mapping the same file. The mapping is private (copy on write):
+ * the memory may be modified, but the modifications are never written to
+ * the file.
+ *
+ * The mapping stays valid as long as the object exists, which lets several
+ * arrays reference regions of one file (see vtkMappedFileDataArray). The
+ * file should not be truncated while it is mapped.
+ *
+ * @sa
+ * vtkMappedFileDataArray
+*/
+
+#ifndef vtkMemoryMappedFile_h
+#define vtkMemoryMappedFile_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkObject.h"
+
+class VTKCOMMONCORE_EXPORT vtkMemoryMappedFile : public vtkObject
+{
+public:
+  static vtkMemoryMappedFile* New();
+  vtkTypeMacro(vtkMemoryMappedFile, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  /**
+   * Map the named file, closing the previous one. Return false (and leave
+   * the object closed) if the file cannot be opened or mapped.
+   */
+  bool Open(const char* fileName);
+
+  /**
+   * Unmap the file. The memory must not be accessed anymore.
+   */
+  void Close();
+
+  /**
+   * Return whether a file is mapped.
+   */
+  bool IsOpen() const
+  {
+    return this->Data != NULL;
+  }
+
+  /**
+   * Name of the mapped file, NULL if none.
+   */
+  vtkGetStringMacro(FileName);
+
+  /**
+   * Size of the mapped file in bytes.
+   */
+  vtkTypeUInt64 GetSize() const
+  {
+    return this->Size;
+  }
+
+  /**
+   * Return the address of the byte at the given offset of the file, or NULL
+   * if it is not mapped.
+   */
+  void* GetPointer(vtkTypeUInt64 offset);
+
+protected:
+  vtkMemoryMappedFile();
+  ~vtkMemoryMappedFile() VTK_OVERRIDE;
+
+  vtkSetStringMacro(FileName);
+
+  char* FileName;
+  char* Data;
+  vtkTypeUInt64 Size;
+
+private:
+  vtkMemoryMappedFile(const vtkMemoryMappedFile&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkMemoryMappedFile&) VTK_DELETE_FUNCTION;
+};
+
+#endif
@@ -0,0 +1,244 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPoolBufferAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPoolBufferAllocator.h"
+
+#include "vtkObjectFactory.h"
+
+#include <cstdlib>
+#include <vector>
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# include <malloc.h>
+#else
+# include <sys/mman.h>
+#endif
+
+vtkStandardNewMacro(vtkPoolBufferAllocator);
+
+namespace
+{
+
+// Blocks of 2^MinimumClass to 2^MaximumClass bytes are pooled
+const int MinimumClass = 6;
+const int MaximumClass = 20;
+const size_t BlockAlignment = static_cast<size_t>(1) << MinimumClass;
+const size_t HugePageSize = static_cast<size_t>(1) << 21;
+
+//----------------------------------------------------------------------------
+void* vtkPoolSystemAllocate(size_t size, size_t alignment)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  return _aligned_malloc(size, alignment);
+#else
+  void* ptr = NULL;
+  if (posix_memalign(&ptr, alignment, size) != 0)
+  {
+    return NULL;
+  }
+  return ptr;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkPoolSystemFree(void* ptr)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Size class of the pooled allocations of size bytes
+int vtkPoolSizeClass(size_t size)
+{
+  int sizeClass = MinimumClass;
+  while ((static_cast<size_t>(1) << sizeClass) < size)
+  {
+    ++sizeClass;
+  }
+  return sizeClass;
+}
+
+//----------------------------------------------------------------------------
+// The free blocks kept by a thread, by size class
+struct vtkPoolThreadCache
+{
+  std::vector<void*> Blocks[MaximumClass + 1];
+  size_t CachedBytes;
+
+  vtkPoolThreadCache() : CachedBytes(0) {}
+  ~vtkPoolThreadCache() { this->Release(); }
+
+  void Release()
+  {
+    for (int c = MinimumClass; c <= MaximumClass; ++c)
+    {
+      for (size_t i = 0; i < this->Blocks[c].size(); ++i)
+      {
+        vtkPoolSystemFree(this->Blocks[c][i]);
+      }
+      std::vector<void*>().swap(this->Blocks[c]);
+    }
+    this->CachedBytes = 0;
+  }
+};
+
+// Buffers may still be released while the thread local objects of the
+// thread are destroyed (e.g. by static objects of the main thread), so the
+// cache is reached through trivially destructible variables and deleted by
+// an owner that marks it destroyed.
+enum { CacheNone, CacheAlive, CacheDestroyed };
+thread_local vtkPoolThreadCache* vtkPoolCache = nullptr;
+thread_local int vtkPoolCacheState = CacheNone;
+
+struct vtkPoolThreadCacheOwner
+{
+  ~vtkPoolThreadCacheOwner()
+  {
+    delete vtkPoolCache;
+    vtkPoolCache = nullptr;
+    vtkPoolCacheState = CacheDestroyed;
+  }
+};
+thread_local vtkPoolThreadCacheOwner vtkPoolCacheOwner;
+
+//----------------------------------------------------------------------------
+// The cache of the calling thread, NULL once the thread is exiting
+vtkPoolThreadCache* vtkPoolGetThreadCache()
+{
+  if (vtkPoolCacheState == CacheNone)
+  {
+    // Touching the owner registers its destruction at thread exit
+    (void)&vtkPoolCacheOwner;
+    vtkPoolCache = new vtkPoolThreadCache;
+    vtkPoolCacheState = CacheAlive;
+  }
+  return vtkPoolCache;
+}
+
+}
+
+//----------------------------------------------------------------------------
+vtkPoolBufferAllocator::vtkPoolBufferAllocator()
+{
+  this->MaximumCachedBytes = static_cast<size_t>(32) << 20;
+  this->HugePageAlignment = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkPoolBufferAllocator::~vtkPoolBufferAllocator()
+{
+}
+
+//----------------------------------------------------------------------------
+size_t vtkPoolBufferAllocator::GetMaximumPooledSize()
+{
+  return static_cast<size_t>(1) << MaximumClass;
+}
+
+//----------------------------------------------------------------------------
+size_t vtkPoolBufferAllocator::GetHugePageSize()
+{
+  return HugePageSize;
+}
+
+//----------------------------------------------------------------------------
+void vtkPoolBufferAllocator::ReleaseThreadCache()
+{
+  if (vtkPoolCacheState == CacheAlive)
+  {
+    vtkPoolCache->Release();
+  }
+}
+
+//----------------------------------------------------------------------------
+size_t vtkPoolBufferAllocator::GetThreadCachedBytes()
+{
+  return vtkPoolCacheState == CacheAlive ? vtkPoolCache->CachedBytes : 0;
+}
+
+//----------------------------------------------------------------------------
+void* vtkPoolBufferAllocator::AllocateMemory(size_t size)
+{
+  if (size > GetMaximumPooledSize())
+  {
+    if (this->HugePageAlignment && size >= HugePageSize)
+    {
+      void* ptr = vtkPoolSystemAllocate(size, HugePageSize);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+      if (ptr)
+      {
+        // Only advisory: ignore the failures
+        madvise(ptr, size & ~(HugePageSize - 1), MADV_HUGEPAGE);
+      }
+#endif
+      return ptr;
+    }
+    return vtkPoolSystemAllocate(size, BlockAlignment);
+  }
+
+  int sizeClass = vtkPoolSizeClass(size);
+  size_t blockSize = static_cast<size_t>(1) << sizeClass;
+  vtkPoolThreadCache* cache = vtkPoolGetThreadCache();
+  if (cache && !cache->Blocks[sizeClass].empty())
+  {
+    void* ptr = cache->Blocks[sizeClass].back();
+    cache->Blocks[sizeClass].pop_back();
+    cache->CachedBytes -= blockSize;
+    return ptr;
+  }
+  return vtkPoolSystemAllocate(blockSize, BlockAlignment);
+}
+
+//----------------------------------------------------------------------------
+void* vtkPoolBufferAllocator::ReallocateMemory(void* ptr, size_t oldSize,
+                                               size_t newSize)
+{
+  // The block may already be large enough
+  if (oldSize <= GetMaximumPooledSize() && newSize <= GetMaximumPooledSize() &&
+      vtkPoolSizeClass(oldSize) == vtkPoolSizeClass(newSize))
+  {
+    return ptr;
+  }
+  return this->Superclass::ReallocateMemory(ptr, oldSize, newSize);
+}
+
+//----------------------------------------------------------------------------
+void vtkPoolBufferAllocator::FreeMemory(void* ptr, size_t size)
+{
+  if (size <= GetMaximumPooledSize())
+  {
+    int sizeClass = vtkPoolSizeClass(size);
+    size_t blockSize = static_cast<size_t>(1) << sizeClass;
+    vtkPoolThreadCache* cache = vtkPoolGetThreadCache();
+    if (cache && cache->CachedBytes + blockSize <= this->MaximumCachedBytes)
+    {
+      cache->Blocks[sizeClass].push_back(ptr);
+      cache->CachedBytes += blockSize;
+      return;
+    }
+  }
+  vtkPoolSystemFree(ptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkPoolBufferAllocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumCachedBytes: " << this->MaximumCachedBytes << "\n";
+  os << indent << "HugePageAlignment: " << this->HugePageAlignment << "\n";
+}
@@ -0,0 +1,112 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPoolBufferAllocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPoolBufferAllocator
+ * @brief   buffer allocator reusing small blocks
+ * through thread local pools
+ *
+ * vtkPoolBufferAllocator serves the allocations of up to
+ * GetMaximumPooledSize() bytes with blocks of power of two sizes. Released
+ * blocks are not returned to the system but kept in a pool of the thread
+ * that releases them, without any locking, and reused by the next
+ * allocations of the same size class in that thread. This suits the many
+ * short lived arrays and id lists created by filters, and keeps long
+ * running processes from fragmenting the heap. Each thread keeps at most
+ * MaximumCachedBytes bytes of free blocks; the pool of a thread is released
+ * when the thread exits or by ReleaseThreadCache().
+ *
+ * Larger allocations go to the system. If HugePageAlignment is on, those of
+ * at least GetHugePageSize() bytes are aligned on huge pages and, on Linux,
+ * advised to be backed by transparent huge pages, which reduces the TLB
+ * misses when traversing large arrays.
+ *
+ * All the blocks are aligned on 64 bytes. The pools are shared by all the
+ * instances of this class; the statistics are per instance.
+ *
+ * @sa
+ * vtkBufferAllocator vtkBuffer
+*/
+
+#ifndef vtkPoolBufferAllocator_h
+#define vtkPoolBufferAllocator_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkBufferAllocator.h"
+
+class VTKCOMMONCORE_EXPORT vtkPoolBufferAllocator : public vtkBufferAllocator
+{
+public:
+  static vtkPoolBufferAllocator* New();
+  vtkTypeMacro(vtkPoolBufferAllocator, vtkBufferAllocator);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  //@{
+  /**
+   * Set/Get the number of bytes of free blocks that a thread keeps for
+   * reuse. The blocks released by a thread whose pool is full are returned
+   * to the system. 0 disables the pools. Default is 32 MiB.
+   */
+  vtkSetMacro(MaximumCachedBytes, size_t);
+  vtkGetMacro(MaximumCachedBytes, size_t);
+  //@}
+
+  //@{
+  /**
+   * Set/Get whether the allocations of at least GetHugePageSize() bytes are
+   * aligned on huge pages. Default is off.
+   */
+  vtkSetMacro(HugePageAlignment, int);
+  vtkGetMacro(HugePageAlignment, int);
+  vtkBooleanMacro(HugePageAlignment, int);
+  //@}
+
+  /**
+   * Size of the largest allocations served by the pools (1 MiB).
+   */
+  static size_t GetMaximumPooledSize();
+
+  /**
+   * Size, and alignment, of the huge pages (2 MiB).
+   */
+  static size_t GetHugePageSize();
+
+  /**
+   * Return the blocks kept by the pool of the calling thread to the system.
+   */
+  static void ReleaseThreadCache();
+
+  /**
+   * Number of bytes of free blocks kept by the pool of the calling thread.
+   */
+  static size_t GetThreadCachedBytes();
+
+protected:
+  vtkPoolBufferAllocator();
+  ~vtkPoolBufferAllocator() VTK_OVERRIDE;
+
+  void* AllocateMemory(size_t size) VTK_OVERRIDE;
+  void* ReallocateMemory(void* ptr, size_t oldSize,
+                         size_t newSize) VTK_OVERRIDE;
+  void FreeMemory(void* ptr, size_t size) VTK_OVERRIDE;
+
+  size_t MaximumCachedBytes;
+  int HugePageAlignment;
+
+private:
+  vtkPoolBufferAllocator(const vtkPoolBufferAllocator&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkPoolBufferAllocator&) VTK_DELETE_FUNCTION;
+};
+
+#endif
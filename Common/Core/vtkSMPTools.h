@@ -19,8 +19,11 @@
  * vtkSMPTools provides a set of utility functions that can
  * be used to parallelize parts of VTK code using multiple threads.
  * There are several back-end implementations of parallel functionality
- * (currently Sequential, TBB and X-Kaapi) that actual execution is
- * delegated to.
+ * (currently Sequential, STDThread, OpenMP and TBB) that actual execution
+ * is delegated to. The STDThread back-end only depends on the C++11
+ * standard library: it runs a persistent pool of std::thread workers with
+ * work stealing, and supports nested For() calls without creating
+ * additional threads.
 */
 
 #ifndef vtkSMPTools_h
@@ -30,8 +33,14 @@
 #include "vtkObject.h"
 
 #include "vtkSMPThreadLocal.h" // For Initialized
+#include "vtkSMPToolsConfig.h" // For Config
 #include "vtkSMPToolsInternal.h"
 
+#include <algorithm> // For std::min and std::sort
+#include <functional> // For std::plus
+#include <iterator> // For std::iterator_traits
+#include <vector> // For the partial results of Reduce and scans
+
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #ifndef __VTK_WRAP__
@@ -65,6 +74,40 @@ public:
   static bool const value = sizeof(check<T>(0)) == sizeof(yes_type);
 };
 
+// Makes the settings of the thread that started a parallel operation
+// current in the threads executing it, so that they apply to nested
+// operations as well.
+class vtkSMPTools_ConfigGuard
+{
+public:
+  explicit vtkSMPTools_ConfigGuard(const vtkSMPToolsConfig* config)
+    : Previous(vtkSMPToolsConfig::SetLocal(config)) {}
+  ~vtkSMPTools_ConfigGuard()
+  {
+    vtkSMPToolsConfig::SetLocal(this->Previous);
+  }
+private:
+  const vtkSMPToolsConfig* Previous;
+  vtkSMPTools_ConfigGuard(const vtkSMPTools_ConfigGuard&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkSMPTools_ConfigGuard&) VTK_DELETE_FUNCTION;
+};
+
+// Apply the settings of the current scope to a For() call. Returns false
+// if the loop must be executed in the calling thread.
+inline bool vtkSMPTools_ApplyConfig(const vtkSMPToolsConfig* config,
+                                    vtkIdType& grain)
+{
+  if (!config)
+  {
+    return true;
+  }
+  if (grain <= 0)
+  {
+    grain = config->Grain;
+  }
+  return !config->IsSequential();
+}
+
 template <typename Functor, bool Init>
 struct vtkSMPTools_FunctorInternal;
 
@@ -72,14 +115,24 @@ template <typename Functor>
 struct vtkSMPTools_FunctorInternal<Functor, false>
 {
   Functor& F;
-  vtkSMPTools_FunctorInternal(Functor& f): F(f) {}
+  const vtkSMPToolsConfig* Config;
+  vtkSMPTools_FunctorInternal(Functor& f)
+    : F(f), Config(vtkSMPToolsConfig::GetLocal()) {}
   void Execute(vtkIdType first, vtkIdType last)
   {
+    vtkSMPTools_ConfigGuard guard(this->Config);
     this->F(first, last);
   }
   void For(vtkIdType first, vtkIdType last, vtkIdType grain)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_For(first, last, grain, *this);
+    if (vtkSMPTools_ApplyConfig(this->Config, grain))
+    {
+      vtk::detail::smp::vtkSMPTools_Impl_For(first, last, grain, *this);
+    }
+    else if (first < last)
+    {
+      this->Execute(first, last);
+    }
   }
   vtkSMPTools_FunctorInternal<Functor, false>& operator=(
     const vtkSMPTools_FunctorInternal<Functor, false>&);
@@ -91,10 +144,13 @@ template <typename Functor>
 struct vtkSMPTools_FunctorInternal<Functor, true>
 {
   Functor& F;
+  const vtkSMPToolsConfig* Config;
   vtkSMPThreadLocal<unsigned char> Initialized;
-  vtkSMPTools_FunctorInternal(Functor& f): F(f), Initialized(0) {}
+  vtkSMPTools_FunctorInternal(Functor& f)
+    : F(f), Config(vtkSMPToolsConfig::GetLocal()), Initialized(0) {}
   void Execute(vtkIdType first, vtkIdType last)
   {
+    vtkSMPTools_ConfigGuard guard(this->Config);
     unsigned char& inited = this->Initialized.Local();
     if (!inited)
     {
@@ -105,7 +161,14 @@ struct vtkSMPTools_FunctorInternal<Functor, true>
   }
   void For(vtkIdType first, vtkIdType last, vtkIdType grain)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_For(first, last, grain, *this);
+    if (vtkSMPTools_ApplyConfig(this->Config, grain))
+    {
+      vtk::detail::smp::vtkSMPTools_Impl_For(first, last, grain, *this);
+    }
+    else if (first < last)
+    {
+      this->Execute(first, last);
+    }
     this->F.Reduce();
   }
   vtkSMPTools_FunctorInternal<Functor, true>& operator=(
@@ -129,6 +192,210 @@ class vtkSMPTools_Lookup_For<Functor const>
 public:
   typedef vtkSMPTools_FunctorInternal<Functor const, init> type;
 };
+
+//--------------------------------------------------------------------------------
+// Functors for the algorithms implemented on top of For(). The iterators
+// must be random access iterators; the operators are copied and may be
+// invoked concurrently.
+template <typename InputIt, typename OutputIt, typename UnaryOp>
+struct vtkSMPTools_UnaryTransform
+{
+  InputIt In;
+  OutputIt Out;
+  UnaryOp Op;
+  vtkSMPTools_UnaryTransform(InputIt in, OutputIt out, UnaryOp op)
+    : In(in), Out(out), Op(op) {}
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    InputIt in = this->In + begin;
+    OutputIt out = this->Out + begin;
+    for (; begin < end; ++begin, ++in, ++out)
+    {
+      *out = this->Op(*in);
+    }
+  }
+};
+
+template <typename InputIt1, typename InputIt2, typename OutputIt,
+          typename BinaryOp>
+struct vtkSMPTools_BinaryTransform
+{
+  InputIt1 In1;
+  InputIt2 In2;
+  OutputIt Out;
+  BinaryOp Op;
+  vtkSMPTools_BinaryTransform(InputIt1 in1, InputIt2 in2, OutputIt out,
+                              BinaryOp op)
+    : In1(in1), In2(in2), Out(out), Op(op) {}
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    InputIt1 in1 = this->In1 + begin;
+    InputIt2 in2 = this->In2 + begin;
+    OutputIt out = this->Out + begin;
+    for (; begin < end; ++begin, ++in1, ++in2, ++out)
+    {
+      *out = this->Op(*in1, *in2);
+    }
+  }
+};
+
+template <typename Iterator, typename T>
+struct vtkSMPTools_Fill
+{
+  Iterator Begin;
+  const T& Value;
+  vtkSMPTools_Fill(Iterator begin, const T& value)
+    : Begin(begin), Value(value) {}
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::fill(this->Begin + begin, this->Begin + end, this->Value);
+  }
+};
+
+// Reduce and the scans work in two passes over the same partition of the
+// range into blocks. The partition depends on the size of the range and on
+// the number of threads only, so that the results do not depend on
+// scheduling (which matters for floating point sums).
+struct vtkSMPTools_Blocks
+{
+  vtkIdType Size;
+  vtkIdType BlockSize;
+  vtkIdType NumberOfBlocks;
+  vtkSMPTools_Blocks(vtkIdType size, int numThreads) : Size(size)
+  {
+    // A few blocks per thread for load balancing, but not tiny ones
+    const vtkIdType minBlockSize = 1024;
+    vtkIdType numBlocks = 4 * static_cast<vtkIdType>(numThreads);
+    this->BlockSize = (size + numBlocks - 1) / numBlocks;
+    if (this->BlockSize < minBlockSize)
+    {
+      this->BlockSize = minBlockSize;
+    }
+    this->NumberOfBlocks = (size + this->BlockSize - 1) / this->BlockSize;
+  }
+  vtkIdType GetBegin(vtkIdType block) const
+  {
+    return block * this->BlockSize;
+  }
+  vtkIdType GetEnd(vtkIdType block) const
+  {
+    return std::min((block + 1) * this->BlockSize, this->Size);
+  }
+};
+
+// First pass: reduce each block (blocks are never empty)
+template <typename InputIt, typename T, typename BinaryOp>
+struct vtkSMPTools_BlockReduce
+{
+  InputIt In;
+  const vtkSMPTools_Blocks& Blocks;
+  std::vector<T>& Partials;
+  BinaryOp Op;
+  vtkSMPTools_BlockReduce(InputIt in, const vtkSMPTools_Blocks& blocks,
+                          std::vector<T>& partials, BinaryOp op)
+    : In(in), Blocks(blocks), Partials(partials), Op(op) {}
+  void operator()(vtkIdType block, vtkIdType endBlock)
+  {
+    for (; block < endBlock; ++block)
+    {
+      vtkIdType i = this->Blocks.GetBegin(block);
+      vtkIdType end = this->Blocks.GetEnd(block);
+      InputIt in = this->In + i;
+      T acc = *in;
+      for (++i, ++in; i < end; ++i, ++in)
+      {
+        acc = this->Op(acc, *in);
+      }
+      this->Partials[block] = acc;
+    }
+  }
+};
+
+// Second pass of the scans: scan each block starting from the combination
+// of all the preceding blocks. Inclusive scans of block 0 have no such
+// starting value. Input and output may be the same.
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp,
+          bool Inclusive>
+struct vtkSMPTools_BlockScan
+{
+  InputIt In;
+  OutputIt Out;
+  const vtkSMPTools_Blocks& Blocks;
+  const std::vector<T>& Offsets;
+  BinaryOp Op;
+  vtkSMPTools_BlockScan(InputIt in, OutputIt out,
+                        const vtkSMPTools_Blocks& blocks,
+                        const std::vector<T>& offsets, BinaryOp op)
+    : In(in), Out(out), Blocks(blocks), Offsets(offsets), Op(op) {}
+  void operator()(vtkIdType block, vtkIdType endBlock)
+  {
+    for (; block < endBlock; ++block)
+    {
+      vtkIdType i = this->Blocks.GetBegin(block);
+      vtkIdType end = this->Blocks.GetEnd(block);
+      InputIt in = this->In + i;
+      OutputIt out = this->Out + i;
+      if (Inclusive)
+      {
+        T acc = (block == 0 ? T(*in) : this->Op(this->Offsets[block], *in));
+        *out = acc;
+        for (++i, ++in, ++out; i < end; ++i, ++in, ++out)
+        {
+          acc = this->Op(acc, *in);
+          *out = acc;
+        }
+      }
+      else
+      {
+        T acc = this->Offsets[block];
+        for (; i < end; ++i, ++in, ++out)
+        {
+          T value = *in;
+          *out = acc;
+          acc = this->Op(acc, value);
+        }
+      }
+    }
+  }
+};
+
+// Parallel stable sort: chunks are sorted concurrently with
+// std::stable_sort and then merged pairwise (std::inplace_merge is stable)
+template <typename RandomAccessIterator, typename Compare>
+struct vtkSMPTools_StableSort
+{
+  RandomAccessIterator Begin;
+  const std::vector<vtkIdType>& Bounds;
+  Compare Comp;
+  vtkIdType Width;
+  vtkSMPTools_StableSort(RandomAccessIterator begin,
+                         const std::vector<vtkIdType>& bounds,
+                         Compare comp, vtkIdType width)
+    : Begin(begin), Bounds(bounds), Comp(comp), Width(width) {}
+  // Sort chunks when Width is 0, otherwise merge pairs of sorted runs of
+  // Width chunks
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType numChunks = static_cast<vtkIdType>(this->Bounds.size()) - 1;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (this->Width == 0)
+      {
+        std::stable_sort(this->Begin + this->Bounds[i],
+                         this->Begin + this->Bounds[i+1], this->Comp);
+      }
+      else
+      {
+        vtkIdType first = 2 * this->Width * i;
+        vtkIdType middle = std::min(first + this->Width, numChunks);
+        vtkIdType last = std::min(first + 2 * this->Width, numChunks);
+        std::inplace_merge(this->Begin + this->Bounds[first],
+                           this->Begin + this->Bounds[middle],
+                           this->Begin + this->Bounds[last], this->Comp);
+      }
+    }
+  }
+};
 } // namespace smp
 } // namespace detail
 } // namespace vtk
@@ -210,8 +477,11 @@ public:
    * not required as it is automatically called before the first
    * execution of any parallel code. However, it can be used to
    * control the maximum number of threads used when the back-end
-   * supports it (currently Simple and TBB only). Make sure to call
-   * it before any other parallel operation.
+   * supports it (currently STDThread, OpenMP and TBB). Make sure to call
+   * it before any other parallel operation. With STDThread, a numThreads
+   * of 0 uses the number of hardware threads and calling it again with a
+   * different value replaces the thread pool (not while parallel code is
+   * running).
    * When using Kaapi, use the KAAPI_CPUCOUNT env. variable to control
    * the number of threads used in the thread pool.
    */
@@ -225,14 +495,57 @@ public:
    */
   static int GetEstimatedNumberOfThreads();
 
+  /**
+   * Settings that can be applied to a region of code with LocalScope():
+   * maximum number of threads, default grain and back-end. See
+   * vtkSMPToolsConfig.
+   */
+  typedef vtkSMPToolsConfig Config;
+
+  /**
+   * Execute lambda (any callable object taking no argument) with the
+   * given settings in effect for the current thread, e.g.:
+   * \code
+   * vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]() { f->Update(); });
+   * \endcode
+   * The settings apply to all the parallel operations started by lambda,
+   * including nested ones, but not to the operations started concurrently
+   * by other threads. This is a shortcut for creating a vtkSMPToolsScope.
+   */
+  template <typename T>
+  static void LocalScope(const Config& config, T&& lambda)
+  {
+    vtkSMPToolsScope scope(config);
+    lambda();
+  }
+
+  /**
+   * Return the back-end in use by the current thread: "Sequential" if the
+   * current scope selects it, the back-end VTK was configured with
+   * otherwise.
+   */
+  static const char* GetBackend()
+  {
+    const vtkSMPToolsConfig* config = vtkSMPToolsConfig::GetLocal();
+    return (config && config->IsSequential()) ? "Sequential" :
+      vtkSMPToolsConfig::GetBackend();
+  }
+
   /**
    * A convenience method for sorting data. It is a drop in replacement for
    * std::sort(). Under the hood different methods are used. For example,
-   * tbb::parallel_sort is used in TBB.
+   * tbb::parallel_sort is used in TBB, while STDThread sorts chunks in
+   * parallel and merges them pairwise.
    */
   template<typename RandomAccessIterator>
     static void Sort(RandomAccessIterator begin, RandomAccessIterator end)
   {
+    const vtkSMPToolsConfig* config = vtkSMPToolsConfig::GetLocal();
+    if (config && config->IsSequential())
+    {
+      std::sort(begin, end);
+      return;
+    }
     vtk::detail::smp::vtkSMPTools_Impl_Sort(begin,end);
   }
 
@@ -246,9 +559,237 @@ public:
     static void Sort(RandomAccessIterator begin, RandomAccessIterator end,
       Compare comp)
   {
+    const vtkSMPToolsConfig* config = vtkSMPToolsConfig::GetLocal();
+    if (config && config->IsSequential())
+    {
+      std::sort(begin, end, comp);
+      return;
+    }
     vtk::detail::smp::vtkSMPTools_Impl_Sort(begin,end,comp);
   }
 
+  //@{
+  /**
+   * Stable version of Sort(): elements that compare equal keep their
+   * relative order. It is a drop in replacement for std::stable_sort(). The
+   * range is split in chunks that are sorted in parallel and then merged
+   * pairwise, for all the back-ends.
+   */
+  template<typename RandomAccessIterator, typename Compare>
+    static void StableSort(RandomAccessIterator begin,
+      RandomAccessIterator end, Compare comp)
+  {
+    // Below this size the threading overhead outweighs the benefits
+    const vtkIdType minimumChunkSize = 4096;
+    vtkIdType n = static_cast<vtkIdType>(end - begin);
+    vtkIdType numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+    vtkIdType numChunks = 1;
+    while (numChunks < numThreads && n / (2 * numChunks) >= minimumChunkSize)
+    {
+      numChunks *= 2;
+    }
+    if (numChunks == 1)
+    {
+      std::stable_sort(begin, end, comp);
+      return;
+    }
+
+    std::vector<vtkIdType> bounds(numChunks + 1);
+    for (vtkIdType i = 0; i <= numChunks; ++i)
+    {
+      bounds[i] = (n * i) / numChunks;
+    }
+    vtk::detail::smp::vtkSMPTools_StableSort<RandomAccessIterator, Compare>
+      sorter(begin, bounds, comp, 0);
+    vtkSMPTools::For(0, numChunks, 1, sorter);
+    for (vtkIdType width = 1; width < numChunks; width *= 2)
+    {
+      vtk::detail::smp::vtkSMPTools_StableSort<RandomAccessIterator, Compare>
+        merger(begin, bounds, comp, width);
+      vtkSMPTools::For(0, numChunks / (2 * width), 1, merger);
+    }
+  }
+  template<typename RandomAccessIterator>
+    static void StableSort(RandomAccessIterator begin,
+      RandomAccessIterator end)
+  {
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+      ValueType;
+    vtkSMPTools::StableSort(begin, end, std::less<ValueType>());
+  }
+  //@}
+
+  //@{
+  /**
+   * Parallel version of std::transform(). Assign op(*in) (or
+   * op(*in1, *in2) for the binary version) to the corresponding output for
+   * every element of the input range, and return the end of the output
+   * range. The iterators must be random access iterators and op is invoked
+   * concurrently from several threads. The work is split as in For() with
+   * the default grain.
+   */
+  template<typename InputIt, typename OutputIt, typename UnaryOp>
+    static OutputIt Transform(InputIt inBegin, InputIt inEnd,
+      OutputIt outBegin, UnaryOp op)
+  {
+    vtkIdType n = static_cast<vtkIdType>(inEnd - inBegin);
+    vtk::detail::smp::vtkSMPTools_UnaryTransform<InputIt, OutputIt, UnaryOp>
+      worker(inBegin, outBegin, op);
+    vtkSMPTools::For(0, n, worker);
+    return outBegin + n;
+  }
+  template<typename InputIt1, typename InputIt2, typename OutputIt,
+           typename BinaryOp>
+    static OutputIt Transform(InputIt1 inBegin1, InputIt1 inEnd,
+      InputIt2 inBegin2, OutputIt outBegin, BinaryOp op)
+  {
+    vtkIdType n = static_cast<vtkIdType>(inEnd - inBegin1);
+    vtk::detail::smp::vtkSMPTools_BinaryTransform<InputIt1, InputIt2,
+      OutputIt, BinaryOp> worker(inBegin1, inBegin2, outBegin, op);
+    vtkSMPTools::For(0, n, worker);
+    return outBegin + n;
+  }
+  //@}
+
+  /**
+   * Parallel version of std::fill(): assign value to every element of the
+   * range [begin, end) of random access iterators.
+   */
+  template<typename Iterator, typename T>
+    static void Fill(Iterator begin, Iterator end, const T& value)
+  {
+    vtkIdType n = static_cast<vtkIdType>(end - begin);
+    vtk::detail::smp::vtkSMPTools_Fill<Iterator, T> worker(begin, value);
+    vtkSMPTools::For(0, n, worker);
+  }
+
+  //@{
+  /**
+   * Parallel version of std::reduce(): combine init and all the elements
+   * of the range with op (std::plus by default). op must be associative;
+   * unlike std::reduce() it does not need to be commutative since partial
+   * results are always combined in order. For a given number of threads,
+   * the result does not depend on the scheduling of the work.
+   */
+  template<typename InputIt, typename T, typename BinaryOp>
+    static T Reduce(InputIt begin, InputIt end, T init, BinaryOp op)
+  {
+    vtkIdType n = static_cast<vtkIdType>(end - begin);
+    if (n <= 0)
+    {
+      return init;
+    }
+    vtk::detail::smp::vtkSMPTools_Blocks blocks(
+      n, vtkSMPTools::GetEstimatedNumberOfThreads());
+    std::vector<T> partials(blocks.NumberOfBlocks, init);
+    vtk::detail::smp::vtkSMPTools_BlockReduce<InputIt, T, BinaryOp>
+      reducer(begin, blocks, partials, op);
+    vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, reducer);
+    T result = init;
+    for (vtkIdType i = 0; i < blocks.NumberOfBlocks; ++i)
+    {
+      result = op(result, partials[i]);
+    }
+    return result;
+  }
+  template<typename InputIt, typename T>
+    static T Reduce(InputIt begin, InputIt end, T init)
+  {
+    return vtkSMPTools::Reduce(begin, end, init, std::plus<T>());
+  }
+  //@}
+
+  //@{
+  /**
+   * Parallel versions of std::exclusive_scan() and std::inclusive_scan()
+   * (prefix sums by default). Element i of the output receives the
+   * combination with op of the input elements before i (exclusive scan,
+   * starting from init) or up to and including i (inclusive scan). op must
+   * be associative. The input and output ranges may be the same, enabling
+   * in place scans. Returns the end of the output range. The input is read
+   * twice: once to reduce blocks of elements, then to scan each block from
+   * the combination of the preceding blocks.
+   */
+  template<typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+    static OutputIt ExclusiveScan(InputIt inBegin, InputIt inEnd,
+      OutputIt outBegin, T init, BinaryOp op)
+  {
+    vtkIdType n = static_cast<vtkIdType>(inEnd - inBegin);
+    if (n <= 0)
+    {
+      return outBegin;
+    }
+    vtk::detail::smp::vtkSMPTools_Blocks blocks(
+      n, vtkSMPTools::GetEstimatedNumberOfThreads());
+    std::vector<T> offsets(blocks.NumberOfBlocks, init);
+    if (blocks.NumberOfBlocks > 1)
+    {
+      vtk::detail::smp::vtkSMPTools_BlockReduce<InputIt, T, BinaryOp>
+        reducer(inBegin, blocks, offsets, op);
+      vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, reducer);
+      // Partial results become the starting values of the blocks
+      T acc = init;
+      for (vtkIdType i = 0; i < blocks.NumberOfBlocks; ++i)
+      {
+        T partial = offsets[i];
+        offsets[i] = acc;
+        acc = op(acc, partial);
+      }
+    }
+    vtk::detail::smp::vtkSMPTools_BlockScan<InputIt, OutputIt, T, BinaryOp,
+      false> scanner(inBegin, outBegin, blocks, offsets, op);
+    vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, scanner);
+    return outBegin + n;
+  }
+  template<typename InputIt, typename OutputIt, typename T>
+    static OutputIt ExclusiveScan(InputIt inBegin, InputIt inEnd,
+      OutputIt outBegin, T init)
+  {
+    return vtkSMPTools::ExclusiveScan(inBegin, inEnd, outBegin, init,
+                                      std::plus<T>());
+  }
+  template<typename InputIt, typename OutputIt, typename BinaryOp>
+    static OutputIt InclusiveScan(InputIt inBegin, InputIt inEnd,
+      OutputIt outBegin, BinaryOp op)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type T;
+    vtkIdType n = static_cast<vtkIdType>(inEnd - inBegin);
+    if (n <= 0)
+    {
+      return outBegin;
+    }
+    vtk::detail::smp::vtkSMPTools_Blocks blocks(
+      n, vtkSMPTools::GetEstimatedNumberOfThreads());
+    std::vector<T> offsets(blocks.NumberOfBlocks, *inBegin);
+    if (blocks.NumberOfBlocks > 1)
+    {
+      vtk::detail::smp::vtkSMPTools_BlockReduce<InputIt, T, BinaryOp>
+        reducer(inBegin, blocks, offsets, op);
+      vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, reducer);
+      // Block i starts from the combination of blocks 0 to i-1 (the value
+      // for block 0 is not used)
+      T acc = offsets[0];
+      for (vtkIdType i = 1; i < blocks.NumberOfBlocks; ++i)
+      {
+        T partial = offsets[i];
+        offsets[i] = acc;
+        acc = op(acc, partial);
+      }
+    }
+    vtk::detail::smp::vtkSMPTools_BlockScan<InputIt, OutputIt, T, BinaryOp,
+      true> scanner(inBegin, outBegin, blocks, offsets, op);
+    vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, scanner);
+    return outBegin + n;
+  }
+  template<typename InputIt, typename OutputIt>
+    static OutputIt InclusiveScan(InputIt inBegin, InputIt inEnd,
+      OutputIt outBegin)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type T;
+    return vtkSMPTools::InclusiveScan(inBegin, inEnd, outBegin,
+                                      std::plus<T>());
+  }
+  //@}
 };
 
 #endif
@@ -0,0 +1,92 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsConfig.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSMPToolsConfig.h"
+
+#include "vtkObject.h" // For vtkGenericWarningMacro
+
+namespace
+{
+// Settings of the current thread
+thread_local const vtkSMPToolsConfig* vtkSMPLocalConfig = nullptr;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkSMPToolsConfig::GetBackend()
+{
+  return VTK_SMP_BACKEND;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSMPToolsConfig::IsBackendAvailable(const std::string& backend)
+{
+  return backend == "Sequential" || backend == VTK_SMP_BACKEND;
+}
+
+//----------------------------------------------------------------------------
+const vtkSMPToolsConfig* vtkSMPToolsConfig::GetLocal()
+{
+  return vtkSMPLocalConfig;
+}
+
+//----------------------------------------------------------------------------
+const vtkSMPToolsConfig* vtkSMPToolsConfig::SetLocal(
+  const vtkSMPToolsConfig* config)
+{
+  const vtkSMPToolsConfig* previous = vtkSMPLocalConfig;
+  vtkSMPLocalConfig = config;
+  return previous;
+}
+
+//----------------------------------------------------------------------------
+vtkSMPToolsScope::vtkSMPToolsScope(const vtkSMPToolsConfig& config)
+{
+  const vtkSMPToolsConfig* enclosing = vtkSMPToolsConfig::GetLocal();
+  if ( enclosing )
+  {
+    this->Config = *enclosing;
+  }
+
+  if ( config.MaxNumberOfThreads > 0 &&
+       (this->Config.MaxNumberOfThreads <= 0 ||
+        config.MaxNumberOfThreads < this->Config.MaxNumberOfThreads) )
+  {
+    this->Config.MaxNumberOfThreads = config.MaxNumberOfThreads;
+  }
+  if ( config.Grain > 0 )
+  {
+    this->Config.Grain = config.Grain;
+  }
+  if ( !config.Backend.empty() )
+  {
+    if ( vtkSMPToolsConfig::IsBackendAvailable(config.Backend) )
+    {
+      this->Config.Backend = config.Backend;
+    }
+    else
+    {
+      vtkGenericWarningMacro("SMP back-end " << config.Backend
+                             << " is not available, keeping "
+                             << vtkSMPToolsConfig::GetBackend());
+    }
+  }
+
+  this->Previous = vtkSMPToolsConfig::SetLocal(&this->Config);
+}
+
+//----------------------------------------------------------------------------
+vtkSMPToolsScope::~vtkSMPToolsScope()
+{
+  vtkSMPToolsConfig::SetLocal(this->Previous);
+}
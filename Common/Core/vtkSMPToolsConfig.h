@@ -0,0 +1,171 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsConfig.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkSMPToolsConfig
+ * @brief   settings of vtkSMPTools for a region of code
+ *
+ * vtkSMPToolsConfig holds the settings that vtkSMPTools applies to the
+ * parallel operations started by a thread: the maximum number of threads
+ * an operation may use, the grain used by vtkSMPTools::For() when it is
+ * invoked with a grain of 0, and the back-end to use. Settings left to
+ * their default value (0 or an empty string) are inherited from the
+ * enclosing scope.
+ *
+ * The settings are installed for the current thread with a vtkSMPToolsScope
+ * object (or vtkSMPTools::LocalScope()) and remain in effect until it is
+ * destroyed. They apply to the operations started by the thread that owns
+ * the scope, including the parallel operations nested within them (even
+ * though these execute in other threads), but not to the operations
+ * started concurrently by unrelated threads. This makes it possible, for
+ * example, to limit one request of a server to 4 threads while another one
+ * uses all the cores.
+ *
+ * The back-end is chosen at configure time (VTK_SMP_IMPLEMENTATION_TYPE);
+ * at run time a scope may select either that back-end or "Sequential",
+ * which executes the operations in the calling thread.
+ *
+ * @sa
+ * vtkSMPTools vtkSMPToolsScope
+*/
+
+#ifndef vtkSMPToolsConfig_h
+#define vtkSMPToolsConfig_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkSystemIncludes.h"
+
+#include <string> // For Backend
+
+class VTKCOMMONCORE_EXPORT vtkSMPToolsConfig
+{
+public:
+  //@{
+  /**
+   * Construct settings that do not change anything, limit the number of
+   * threads, or select a back-end.
+   */
+  vtkSMPToolsConfig()
+    : MaxNumberOfThreads(0), Grain(0) {}
+  explicit vtkSMPToolsConfig(int maxNumberOfThreads)
+    : MaxNumberOfThreads(maxNumberOfThreads), Grain(0) {}
+  explicit vtkSMPToolsConfig(const std::string& backend)
+    : MaxNumberOfThreads(0), Grain(0), Backend(backend) {}
+  //@}
+
+  /**
+   * Maximum number of threads used by an operation, 0 for no limit. A
+   * nested scope cannot raise the limit of an enclosing one.
+   */
+  int MaxNumberOfThreads;
+
+  /**
+   * Grain used by vtkSMPTools::For() when it is invoked with a grain of 0,
+   * 0 to let the back-end decide.
+   */
+  vtkIdType Grain;
+
+  /**
+   * Back-end to use: "Sequential" or the one VTK was configured with (see
+   * GetBackend()). Empty to keep the current one.
+   */
+  std::string Backend;
+
+  /**
+   * Return whether operations run in the calling thread only with these
+   * settings.
+   */
+  bool IsSequential() const
+  {
+    return this->MaxNumberOfThreads == 1 || this->Backend == "Sequential";
+  }
+
+  /**
+   * Return the number of threads an operation may use given the number
+   * of threads available.
+   */
+  int GetNumberOfThreads(int available) const
+  {
+    if (this->IsSequential())
+    {
+      return 1;
+    }
+    return (this->MaxNumberOfThreads > 0 &&
+            this->MaxNumberOfThreads < available) ?
+      this->MaxNumberOfThreads : available;
+  }
+
+  /**
+   * Return the back-end VTK was configured with.
+   */
+  static const char* GetBackend();
+
+  /**
+   * Return whether the named back-end can be selected at run time.
+   */
+  static bool IsBackendAvailable(const std::string& backend);
+
+  //@{
+  /**
+   * Access the settings of the current thread, NULL if no scope is active.
+   * SetLocal() returns the previous settings; it is meant to be used by
+   * vtkSMPToolsScope and by vtkSMPTools to propagate the settings to
+   * worker threads. The settings must outlive their installation.
+   */
+  static const vtkSMPToolsConfig* GetLocal();
+  static const vtkSMPToolsConfig* SetLocal(const vtkSMPToolsConfig* config);
+  //@}
+};
+
+/**
+ * @class   vtkSMPToolsScope
+ * @brief   installs vtkSMPToolsConfig settings for a region of code
+ *
+ * Creating a vtkSMPToolsScope installs the given settings, merged with the
+ * ones of the enclosing scope, for the current thread; destroying it
+ * restores the previous settings. Scopes must be destroyed in the reverse
+ * order of their creation, which is naturally the case for automatic
+ * variables:
+ *
+ * \code
+ * {
+ *   vtkSMPToolsScope scope(vtkSMPToolsConfig(4));
+ *   filter->Update(); // uses at most 4 threads
+ * }
+ * \endcode
+ */
+class VTKCOMMONCORE_EXPORT vtkSMPToolsScope
+{
+public:
+  explicit vtkSMPToolsScope(const vtkSMPToolsConfig& config);
+  ~vtkSMPToolsScope();
+
+  /**
+   * Return the settings in effect within the scope.
+   */
+  const vtkSMPToolsConfig& GetConfig() const
+  {
+    return this->Config;
+  }
+
+private:
+  vtkSMPToolsConfig Config;
+  const vtkSMPToolsConfig* Previous;
+
+  vtkSMPToolsScope(const vtkSMPToolsScope&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkSMPToolsScope&) VTK_DELETE_FUNCTION;
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPToolsConfig.h
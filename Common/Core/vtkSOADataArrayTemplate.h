@@ -140,6 +140,18 @@ public:
                 bool updateMaxId = false, bool save=false,
                 int deleteMethod=VTK_DATA_ARRAY_FREE);
 
+  //@{
+  /**
+   * Set/Get the allocator of the values of all the components (see
+   * vtkBufferAllocator). NULL, the default, uses the default allocator.
+   */
+  void SetBufferAllocator(vtkBufferAllocator* allocator);
+  vtkBufferAllocator* GetBufferAllocator()
+  {
+    return this->BufferAllocator;
+  }
+  //@}
+
   /**
    * Return a pointer to a contiguous block of memory containing all values for
    * a particular components (ie. a single array of the struct-of-arrays).
@@ -217,6 +229,7 @@ protected:
 
   std::vector<vtkBuffer<ValueType>*> Data;
   vtkBuffer<ValueType> *AoSCopy;
+  vtkBufferAllocator *BufferAllocator;
 
   double NumberOfComponentsReciprocal;
 
@@ -35,6 +35,7 @@ vtkSOADataArrayTemplate<ValueType>::New()
 template<class ValueType>
 vtkSOADataArrayTemplate<ValueType>::vtkSOADataArrayTemplate()
   : AoSCopy(NULL),
+    BufferAllocator(NULL),
     NumberOfComponentsReciprocal(1.0)
 {
 }
@@ -53,6 +54,7 @@ vtkSOADataArrayTemplate<ValueType>::~vtkSOADataArrayTemplate()
     this->AoSCopy->Delete();
     this->AoSCopy = NULL;
   }
+  this->SetBufferAllocator(NULL);
 }
 
 //-----------------------------------------------------------------------------
@@ -70,10 +72,39 @@ void vtkSOADataArrayTemplate<ValueType>::SetNumberOfComponents(int val)
   while (this->Data.size() < numComps)
   {
     this->Data.push_back(vtkBuffer<ValueType>::New());
+    this->Data.back()->SetAllocator(this->BufferAllocator);
   }
   this->NumberOfComponentsReciprocal = 1.0 / this->NumberOfComponents;
 }
 
+//-----------------------------------------------------------------------------
+template<class ValueType>
+void vtkSOADataArrayTemplate<ValueType>::SetBufferAllocator(
+  vtkBufferAllocator *allocator)
+{
+  if (allocator == this->BufferAllocator)
+  {
+    return;
+  }
+  if (allocator)
+  {
+    allocator->Register(this);
+  }
+  if (this->BufferAllocator)
+  {
+    this->BufferAllocator->UnRegister(this);
+  }
+  this->BufferAllocator = allocator;
+  for (size_t cc = 0; cc < this->Data.size(); ++cc)
+  {
+    this->Data[cc]->SetAllocator(allocator);
+  }
+  if (this->AoSCopy)
+  {
+    this->AoSCopy->SetAllocator(allocator);
+  }
+}
+
 //-----------------------------------------------------------------------------
 template<class ValueType>
 vtkArrayIterator* vtkSOADataArrayTemplate<ValueType>::NewIterator()
@@ -292,6 +323,7 @@ void *vtkSOADataArrayTemplate<ValueType>::GetVoidPointer(vtkIdType valueIdx)
   if (!this->AoSCopy)
   {
     this->AoSCopy = vtkBuffer<ValueType>::New();
+    this->AoSCopy->SetAllocator(this->BufferAllocator);
   }
 
   if (!this->AoSCopy->Allocate(static_cast<vtkIdType>(numValues)))
@@ -21,8 +21,10 @@
 #include "vtkUnsignedCharArray.h"
 #include "vtkVariantArray.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 
 #include <map>
+#include <vector>
 
 #include <cmath>
 
@@ -371,10 +373,15 @@ void vtkScalarsToColors::MapVectorsThroughTable(
 
     case vtkScalarsToColors::MAGNITUDE:
     {
-      // convert to magnitude in blocks of 300 values
+      // convert to magnitude in blocks, large enough for the magnitudes
+      // and the colors to be computed in parallel
       int inInc = vtkDataArray::GetDataTypeSize(scalarType)*inComponents;
-      double magValues[300];
-      int blockSize = 300;
+      int blockSize = 65536;
+      if (numValues < blockSize)
+      {
+        blockSize = (numValues > 0 ? numValues : 1);
+      }
+      std::vector<double> magValues(blockSize);
       int numBlocks = (numValues + blockSize - 1)/blockSize;
       int lastBlockSize = numValues - blockSize*(numBlocks - 1);
 
@@ -382,10 +389,10 @@ void vtkScalarsToColors::MapVectorsThroughTable(
       {
         int numMagValues = ((i < numBlocks-1) ? blockSize : lastBlockSize);
         this->MapVectorsToMagnitude(
-          input, magValues, scalarType, numMagValues, inComponents,
+          input, &magValues[0], scalarType, numMagValues, inComponents,
           vectorSize);
         this->MapScalarsThroughTable(
-          magValues, output, VTK_DOUBLE, numMagValues, 1, outputFormat);
+          &magValues[0], output, VTK_DOUBLE, numMagValues, 1, outputFormat);
         input = static_cast<char *>(input) + numMagValues*inInc;
         output += numMagValues*outputFormat;
       }
@@ -1362,6 +1369,35 @@ void vtkScalarsToColorsMapVectorsToMagnitude(
   while (--numTuples);
 }
 
+//----------------------------------------------------------------------------
+// Compute the magnitudes of a range of the tuples
+template<class T>
+struct vtkScalarsToColorsMagnitudeFunctor
+{
+  const T *InPtr;
+  double *OutPtr;
+  int VectorSize;
+  int InInc;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkScalarsToColorsMapVectorsToMagnitude(
+      this->InPtr + begin*(this->VectorSize + this->InInc),
+      this->OutPtr + begin, static_cast<int>(end - begin),
+      this->VectorSize, this->InInc);
+  }
+};
+
+//----------------------------------------------------------------------------
+template<class T>
+void vtkScalarsToColorsMapVectorsToMagnitudeThreaded(
+  const T *inPtr, double *outPtr, int numTuples, int vectorSize, int inInc)
+{
+  vtkScalarsToColorsMagnitudeFunctor<T> functor =
+    { inPtr, outPtr, vectorSize, inInc };
+  vtkSMPTools::For(0, numTuples, 16384, functor);
+}
+
 //----------------------------------------------------------------------------
 void vtkScalarsToColors::MapVectorsToMagnitude(
   void *inPtr, double *outPtr, int inputDataType,
@@ -1390,7 +1426,7 @@ void vtkScalarsToColors::MapVectorsToMagnitude(
   switch (inputDataType)
   {
     vtkTemplateAliasMacro(
-      vtkScalarsToColorsMapVectorsToMagnitude(
+      vtkScalarsToColorsMapVectorsToMagnitudeThreaded(
         static_cast<VTK_TT*>(inPtr), outPtr,
         numberOfTuples, vectorSize, inInc));
   }
@@ -0,0 +1,238 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellLinks.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the links built in parallel by vtkStaticCellLinksTemplate and
+// vtkCellLinks against the cells of polydata mixing the four types of cells
+// and of an unstructured grid, and the incremental editing of such links.
+
+#include "vtkCellArray.h"
+#include "vtkCellLinks.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStaticCellLinksTemplate.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vector>
+
+#define TEST_ASSERT(cond, msg) \
+  if (!(cond)) \
+  { \
+    cerr << "Error: " << msg << endl; \
+    return false; \
+  }
+
+namespace
+{
+
+// The cells using each point, in ascending order
+void ExpectedLinks(vtkDataSet *ds, std::vector<std::vector<vtkIdType> > &links)
+{
+  links.assign(ds->GetNumberOfPoints(), std::vector<vtkIdType>());
+  vtkNew<vtkIdList> pts;
+  for (vtkIdType cellId = 0; cellId < ds->GetNumberOfCells(); ++cellId)
+  {
+    ds->GetCellPoints(cellId, pts.GetPointer());
+    for (vtkIdType i = 0; i < pts->GetNumberOfIds(); ++i)
+    {
+      links[pts->GetId(i)].push_back(cellId);
+    }
+  }
+}
+
+template <typename TIds>
+bool CheckStaticLinks(vtkDataSet *ds, vtkStaticCellLinksTemplate<TIds> &links,
+                      const std::vector<std::vector<vtkIdType> > &expected)
+{
+  for (vtkIdType ptId = 0; ptId < ds->GetNumberOfPoints(); ++ptId)
+  {
+    TEST_ASSERT(links.GetNumberOfCells(ptId) ==
+                static_cast<TIds>(expected[ptId].size()),
+                "wrong number of static links of point " << ptId);
+    const TIds *cells = links.GetCells(ptId);
+    for (size_t i = 0; i < expected[ptId].size(); ++i)
+    {
+      TEST_ASSERT(cells[i] == expected[ptId][i],
+                  "wrong static link of point " << ptId);
+    }
+  }
+  return true;
+}
+
+bool CheckLinks(vtkDataSet *ds, vtkCellLinks *links,
+                const std::vector<std::vector<vtkIdType> > &expected)
+{
+  for (vtkIdType ptId = 0; ptId < ds->GetNumberOfPoints(); ++ptId)
+  {
+    TEST_ASSERT(links->GetNcells(ptId) == expected[ptId].size(),
+                "wrong number of links of point " << ptId);
+    const vtkIdType *cells = links->GetCells(ptId);
+    for (size_t i = 0; i < expected[ptId].size(); ++i)
+    {
+      TEST_ASSERT(cells[i] == expected[ptId][i],
+                  "wrong link of point " << ptId);
+    }
+  }
+  return true;
+}
+
+bool CheckDataSet(vtkDataSet *ds)
+{
+  std::vector<std::vector<vtkIdType> > expected;
+  ExpectedLinks(ds, expected);
+
+  vtkStaticCellLinksTemplate<int> intLinks;
+  intLinks.BuildLinks(ds);
+  vtkStaticCellLinksTemplate<vtkIdType> idLinks;
+  idLinks.BuildLinks(ds);
+  if (!CheckStaticLinks(ds, intLinks, expected) ||
+      !CheckStaticLinks(ds, idLinks, expected))
+  {
+    return false;
+  }
+
+  // Both ways of building vtkCellLinks
+  for (int staticBuild = 0; staticBuild < 2; ++staticBuild)
+  {
+    vtkCellLinks::SetGlobalStaticBuild(staticBuild);
+    vtkNew<vtkCellLinks> links;
+    links->Allocate(ds->GetNumberOfPoints());
+    links->BuildLinks(ds);
+    if (!CheckLinks(ds, links.GetPointer(), expected))
+    {
+      return false;
+    }
+  }
+  vtkCellLinks::GlobalStaticBuildOn();
+  return true;
+}
+
+// A strip of quads made of verts, lines, triangles and triangle strips
+void MakePolyData(vtkPolyData *pd, int n)
+{
+  vtkNew<vtkPoints> points;
+  for (int i = 0; i < n; ++i)
+  {
+    points->InsertNextPoint(i, 0, 0);
+    points->InsertNextPoint(i, 1, 0);
+  }
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+  for (vtkIdType i = 0; i < n - 1; ++i)
+  {
+    vtkIdType p = 2 * i;
+    vtkIdType tri1[3] = { p, p + 2, p + 1 };
+    vtkIdType tri2[3] = { p + 1, p + 2, p + 3 };
+    vtkIdType strip[4] = { p, p + 2, p + 1, p + 3 };
+    vtkIdType line[2] = { p, p + 2 };
+    switch (i % 4)
+    {
+      case 0:
+        verts->InsertNextCell(1, &p);
+        lines->InsertNextCell(2, line);
+        break;
+      case 1:
+        polys->InsertNextCell(3, tri1);
+        polys->InsertNextCell(3, tri2);
+        break;
+      default:
+        strips->InsertNextCell(4, strip);
+        break;
+    }
+  }
+  pd->SetPoints(points.GetPointer());
+  pd->SetVerts(verts.GetPointer());
+  pd->SetLines(lines.GetPointer());
+  pd->SetPolys(polys.GetPointer());
+  pd->SetStrips(strips.GetPointer());
+}
+
+// A column of hexahedra with a triangle on each shared face
+void MakeUnstructuredGrid(vtkUnstructuredGrid *ug, int n)
+{
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < n; ++k)
+  {
+    points->InsertNextPoint(0, 0, k);
+    points->InsertNextPoint(1, 0, k);
+    points->InsertNextPoint(1, 1, k);
+    points->InsertNextPoint(0, 1, k);
+  }
+  ug->SetPoints(points.GetPointer());
+  ug->Allocate(2 * n);
+  for (vtkIdType k = 0; k < n - 1; ++k)
+  {
+    vtkIdType hex[8];
+    for (int i = 0; i < 8; ++i)
+    {
+      hex[i] = 4 * k + i;
+    }
+    ug->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+    vtkIdType tri[3] = { 4 * k + 4, 4 * k + 5, 4 * k + 6 };
+    ug->InsertNextCell(VTK_TRIANGLE, 3, tri);
+  }
+}
+
+bool TestEditing(vtkPolyData *pd)
+{
+  // The links are built in a single allocation
+  vtkNew<vtkCellLinks> links;
+  links->Allocate(pd->GetNumberOfPoints());
+  links->BuildLinks(pd);
+  vtkIdType ptId = 5;
+  vtkIdType ncells = links->GetNcells(ptId);
+  TEST_ASSERT(ncells > 1, "point " << ptId << " not shared");
+  vtkIdType first = links->GetCells(ptId)[0];
+
+  links->RemoveCellReference(first, ptId);
+  TEST_ASSERT(links->GetNcells(ptId) == ncells - 1, "reference not removed");
+  links->ResizeCellList(ptId, 2);
+  links->InsertNextCellReference(ptId, 1000);
+  links->InsertNextCellReference(ptId, 1001);
+  TEST_ASSERT(links->GetNcells(ptId) == ncells + 1 &&
+              links->GetCells(ptId)[ncells] == 1001, "reference not added");
+
+  // Deleting points releases both kinds of lists
+  links->DeletePoint(ptId);
+  links->DeletePoint(ptId + 1);
+  TEST_ASSERT(links->GetNcells(ptId) == 0, "point not deleted");
+
+  vtkNew<vtkCellLinks> copy;
+  copy->DeepCopy(links.GetPointer());
+  TEST_ASSERT(copy->GetNcells(ptId + 2) == links->GetNcells(ptId + 2) &&
+              copy->GetCells(ptId + 2) != links->GetCells(ptId + 2),
+              "links not copied");
+  return true;
+}
+
+}
+
+int TestCellLinks(int, char *[])
+{
+  vtkNew<vtkPolyData> pd;
+  MakePolyData(pd.GetPointer(), 2000);
+  vtkNew<vtkUnstructuredGrid> ug;
+  MakeUnstructuredGrid(ug.GetPointer(), 2000);
+
+  if (!CheckDataSet(pd.GetPointer()) ||
+      !CheckDataSet(ug.GetPointer()) ||
+      !TestEditing(pd.GetPointer()))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellPointsCursor.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellArray.h"
+#include "vtkCellPointsCursor.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+// Compare the cursor against reference point ids for all cells, in
+// parallel, with one cursor per thread.
+struct CompareCells
+{
+  const std::vector<vtkIdType> &Offsets;
+  const std::vector<vtkIdType> &Ids;
+  vtkSMPThreadLocal<vtkCellPointsCursor> Cursors;
+  vtkSMPThreadLocal<int> Errors;
+
+  CompareCells(const std::vector<vtkIdType> &offsets,
+               const std::vector<vtkIdType> &ids,
+               const vtkCellPointsCursor &cursor) :
+    Offsets(offsets), Ids(ids), Cursors(cursor), Errors(0) {}
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkCellPointsCursor &cursor = this->Cursors.Local();
+    int &errors = this->Errors.Local();
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      vtkIdType npts = cursor.GetCellPoints(cellId, pts);
+      if ( cursor.GetCellType(cellId) == VTK_EMPTY_CELL ||
+           npts != this->Offsets[cellId+1] - this->Offsets[cellId] )
+      {
+        ++errors;
+        continue;
+      }
+      if ( ! std::equal(pts, pts+npts, &this->Ids[this->Offsets[cellId]]) )
+      {
+        ++errors;
+      }
+    }
+  }
+
+  int GetNumberOfErrors()
+  {
+    int total = 0;
+    vtkSMPThreadLocal<int>::iterator itr;
+    for ( itr=this->Errors.begin(); itr != this->Errors.end(); ++itr )
+    {
+      total += *itr;
+    }
+    return total;
+  }
+};
+
+int CheckDataSet(vtkDataSet *ds, const char *label)
+{
+  // Reference point ids, gathered serially
+  vtkIdType numCells = ds->GetNumberOfCells();
+  std::vector<vtkIdType> offsets(1, 0);
+  std::vector<vtkIdType> ids;
+  vtkSmartPointer<vtkIdList> cellIds = vtkSmartPointer<vtkIdList>::New();
+  for ( vtkIdType cellId=0; cellId < numCells; ++cellId )
+  {
+    ds->GetCellPoints(cellId, cellIds);
+    for ( vtkIdType i=0; i < cellIds->GetNumberOfIds(); ++i )
+    {
+      ids.push_back(cellIds->GetId(i));
+    }
+    offsets.push_back(static_cast<vtkIdType>(ids.size()));
+  }
+
+  // The cursor is prepared before going parallel
+  vtkCellPointsCursor cursor(ds);
+  if ( cursor.GetNumberOfCells() != numCells )
+  {
+    cerr << label << ": wrong number of cells" << endl;
+    return 1;
+  }
+
+  CompareCells compare(offsets, ids, cursor);
+  vtkSMPTools::For(0, numCells, 4, compare);
+  int errors = compare.GetNumberOfErrors();
+  if ( errors )
+  {
+    cerr << label << ": " << errors << " mismatches" << endl;
+  }
+  return errors;
+}
+
+}
+
+int TestCellPointsCursor(int, char *[])
+{
+  int errors = 0;
+
+  // Image data
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(0, 4, 0, 3, 0, 2);
+  errors += CheckDataSet(image, "vtkImageData");
+
+  // Structured grid with the same topology
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for ( vtkIdType ptId=0; ptId < image->GetNumberOfPoints(); ++ptId )
+  {
+    points->InsertNextPoint(image->GetPoint(ptId));
+  }
+  vtkSmartPointer<vtkStructuredGrid> sgrid =
+    vtkSmartPointer<vtkStructuredGrid>::New();
+  sgrid->SetDimensions(image->GetDimensions());
+  sgrid->SetPoints(points);
+  errors += CheckDataSet(sgrid, "vtkStructuredGrid");
+
+  // Unstructured grid made of the voxels of the image
+  vtkSmartPointer<vtkUnstructuredGrid> ugrid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  ugrid->SetPoints(points);
+  ugrid->Allocate(image->GetNumberOfCells());
+  vtkSmartPointer<vtkIdList> ids = vtkSmartPointer<vtkIdList>::New();
+  for ( vtkIdType cellId=0; cellId < image->GetNumberOfCells(); ++cellId )
+  {
+    image->GetCellPoints(cellId, ids);
+    ugrid->InsertNextCell(VTK_VOXEL, ids);
+  }
+  errors += CheckDataSet(ugrid, "vtkUnstructuredGrid");
+
+  // Polydata mixing vertices, lines and polygons of various sizes
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  vtkSmartPointer<vtkCellArray> verts = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  vtkIdType pts[6] = {0, 1, 2, 3, 4, 5};
+  for ( int i=0; i < 10; ++i )
+  {
+    verts->InsertNextCell(1, pts + (i % 6));
+    lines->InsertNextCell(2, pts + (i % 5));
+    polys->InsertNextCell(3 + (i % 4), pts);
+  }
+  polyData->SetPoints(points);
+  polyData->SetVerts(verts);
+  polyData->SetLines(lines);
+  polyData->SetPolys(polys);
+  errors += CheckDataSet(polyData, "vtkPolyData");
+
+  return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
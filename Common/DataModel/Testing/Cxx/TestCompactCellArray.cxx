@@ -0,0 +1,200 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCompactCellArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellArray.h"
+#include "vtkCompactCellArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkSmartPointer.h"
+#include "vtkTypeInt32Array.h"
+
+#include <algorithm>
+
+namespace
+{
+
+// Cell i has (i%5)+1 points with ids i, i+1, ...
+const vtkIdType NumberOfCells = 1000;
+
+void MakeCell(vtkIdType cellId, vtkIdList *ids)
+{
+  vtkIdType npts = (cellId % 5) + 1;
+  ids->SetNumberOfIds(npts);
+  for ( vtkIdType i=0; i < npts; ++i )
+  {
+    ids->SetId(i, cellId + i);
+  }
+}
+
+bool CheckCells(vtkCompactCellArray *ca, const char *label)
+{
+  if ( ca->GetNumberOfCells() != NumberOfCells )
+  {
+    cerr << label << ": expected " << NumberOfCells << " cells, got "
+         << ca->GetNumberOfCells() << endl;
+    return false;
+  }
+
+  vtkSmartPointer<vtkIdList> expected = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkIdList> scratch = vtkSmartPointer<vtkIdList>::New();
+  vtkIdType npts;
+  const vtkIdType *pts;
+
+  // Access in reverse order to exercise random access
+  for ( vtkIdType cellId=NumberOfCells-1; cellId >= 0; --cellId )
+  {
+    MakeCell(cellId, expected);
+    ca->GetCellAtId(cellId, npts, pts, scratch);
+    if ( npts != expected->GetNumberOfIds() ||
+         ca->GetCellSize(cellId) != npts )
+    {
+      cerr << label << ": wrong size for cell " << cellId << endl;
+      return false;
+    }
+    for ( vtkIdType i=0; i < npts; ++i )
+    {
+      if ( pts[i] != expected->GetId(i) )
+      {
+        cerr << label << ": wrong point id in cell " << cellId << endl;
+        return false;
+      }
+    }
+  }
+
+  if ( ca->GetMaxCellSize() != 5 )
+  {
+    cerr << label << ": wrong max cell size " << ca->GetMaxCellSize() << endl;
+    return false;
+  }
+
+  return true;
+}
+
+}
+
+int TestCompactCellArray(int, char *[])
+{
+  vtkSmartPointer<vtkIdList> ids = vtkSmartPointer<vtkIdList>::New();
+
+  // Build a legacy cell array and a compact cell array side by side
+  vtkSmartPointer<vtkCellArray> legacy = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkCompactCellArray> ca =
+    vtkSmartPointer<vtkCompactCellArray>::New();
+  for ( vtkIdType cellId=0; cellId < NumberOfCells; ++cellId )
+  {
+    MakeCell(cellId, ids);
+    legacy->InsertNextCell(ids);
+    if ( ca->InsertNextCell(ids) != cellId )
+    {
+      cerr << "InsertNextCell returned the wrong cell id" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if ( ! CheckCells(ca, "insertion") )
+  {
+    return EXIT_FAILURE;
+  }
+
+  // 32-bit storage
+  if ( ! ca->CanConvertTo32BitStorage() || ! ca->ConvertTo32BitStorage() )
+  {
+    cerr << "Conversion to 32-bit storage failed" << endl;
+    return EXIT_FAILURE;
+  }
+  if ( ! CheckCells(ca, "32-bit") )
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Legacy import with 32-bit storage retained
+  vtkSmartPointer<vtkCompactCellArray> imported =
+    vtkSmartPointer<vtkCompactCellArray>::New();
+  imported->Use32BitStorage();
+  if ( ! imported->ImportLegacyFormat(legacy) ||
+       ! CheckCells(imported, "import") )
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Round trip through the legacy format
+  vtkSmartPointer<vtkCellArray> exported =
+    vtkSmartPointer<vtkCellArray>::New();
+  imported->ExportLegacyFormat(exported);
+  if ( exported->GetNumberOfCells() != NumberOfCells ||
+       exported->GetNumberOfConnectivityEntries() !=
+       legacy->GetNumberOfConnectivityEntries() ||
+       ! std::equal(legacy->GetPointer(), legacy->GetPointer() +
+                    legacy->GetNumberOfConnectivityEntries(),
+                    exported->GetPointer()) )
+  {
+    cerr << "Legacy export does not match the original cells" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Back to the default storage
+  ca->ConvertToDefaultStorage();
+  if ( ca->IsStorage32Bit() || ! CheckCells(ca, "default") )
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Ids that do not fit in 32 bits
+#if VTK_SIZEOF_ID_TYPE == 8
+  vtkIdType bigIds[2] = {0, static_cast<vtkIdType>(VTK_TYPE_INT32_MAX) + 1};
+  vtkSmartPointer<vtkCompactCellArray> big =
+    vtkSmartPointer<vtkCompactCellArray>::New();
+  big->InsertNextCell(2, bigIds);
+  if ( big->CanConvertTo32BitStorage() || big->ConvertTo32BitStorage() )
+  {
+    cerr << "Conversion to 32-bit storage should have failed" << endl;
+    return EXIT_FAILURE;
+  }
+#endif
+
+  // Editing cells
+  vtkIdType newIds[3] = {7, 8, 9};
+  ca->ReplaceCellAtId(2, newIds);
+  ca->ReverseCellAtId(2);
+  ca->GetCellAtId(2, ids);
+  if ( ids->GetNumberOfIds() != 3 || ids->GetId(0) != 9 ||
+       ids->GetId(1) != 8 || ids->GetId(2) != 7 )
+  {
+    cerr << "Replace/reverse failed" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Set the arrays directly: two triangles
+  vtkSmartPointer<vtkTypeInt32Array> offsets =
+    vtkSmartPointer<vtkTypeInt32Array>::New();
+  vtkSmartPointer<vtkTypeInt32Array> conn =
+    vtkSmartPointer<vtkTypeInt32Array>::New();
+  offsets->InsertNextValue(0);
+  offsets->InsertNextValue(3);
+  offsets->InsertNextValue(6);
+  for ( int i=0; i < 6; ++i )
+  {
+    conn->InsertNextValue(i);
+  }
+  vtkSmartPointer<vtkCompactCellArray> direct =
+    vtkSmartPointer<vtkCompactCellArray>::New();
+  if ( ! direct->SetData(offsets, conn) ||
+       direct->GetNumberOfCells() != 2 ||
+       direct->GetCellSize(1) != 3 )
+  {
+    cerr << "SetData failed" << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetAttributesBatch.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the batched copy and edge interpolation of vtkDataSetAttributes
+// produce the same tuples as CopyData() and InterpolateEdge(), for several
+// array types, a string array and a nearest neighbor attribute, including
+// when disjoint ranges of tuples are processed by different threads.
+
+#include "vtkDataSetAttributes.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
+#include "vtkStringArray.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+const vtkIdType NumberOfInputTuples = 200;
+const vtkIdType NumberOfOutputTuples = 1000;
+
+void MakeAttributes(vtkDataSetAttributes *attributes)
+{
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("Ids");
+  vtkNew<vtkUnsignedCharArray> colors;
+  colors->SetName("Colors");
+  colors->SetNumberOfComponents(4);
+  vtkNew<vtkIdTypeArray> globalIds;
+  globalIds->SetName("GlobalIds");
+  vtkNew<vtkStringArray> labels;
+  labels->SetName("Labels");
+  for (vtkIdType i = 0; i < NumberOfInputTuples; ++i)
+  {
+    scalars->InsertNextValue(0.37 * i - 11.0);
+    vectors->InsertNextTuple3(i, -0.5 * i, 1.0 / (i + 1));
+    ids->InsertNextValue(static_cast<int>(3 * i - 250));
+    colors->InsertNextTuple4(i % 256, (7 * i) % 256, (13 * i) % 256, 255);
+    globalIds->InsertNextValue(1000 + i);
+    std::ostringstream label;
+    label << "label" << i;
+    labels->InsertNextValue(label.str());
+  }
+  attributes->SetScalars(scalars.GetPointer());
+  attributes->SetVectors(vectors.GetPointer());
+  attributes->AddArray(ids.GetPointer());
+  attributes->AddArray(colors.GetPointer());
+  attributes->SetGlobalIds(globalIds.GetPointer());
+  attributes->AddArray(labels.GetPointer());
+}
+
+bool SameAttributes(vtkDataSetAttributes *a1, vtkDataSetAttributes *a2)
+{
+  if (a1->GetNumberOfArrays() != a2->GetNumberOfArrays())
+  {
+    cerr << "Error: different arrays" << endl;
+    return false;
+  }
+  for (int i = 0; i < a1->GetNumberOfArrays(); ++i)
+  {
+    vtkAbstractArray *array1 = a1->GetAbstractArray(i);
+    vtkAbstractArray *array2 = a2->GetAbstractArray(array1->GetName());
+    if (!array2 || array1->GetDataType() != array2->GetDataType() ||
+        array1->GetNumberOfValues() != array2->GetNumberOfValues())
+    {
+      cerr << "Error: different array " << array1->GetName() << endl;
+      return false;
+    }
+    for (vtkIdType j = 0; j < array1->GetNumberOfValues(); ++j)
+    {
+      if (array1->GetVariantValue(j) != array2->GetVariantValue(j))
+      {
+        cerr << "Error: different value " << j << " of array "
+             << array1->GetName() << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}
+
+int TestDataSetAttributesBatch(int, char *[])
+{
+  vtkNew<vtkDataSetAttributes> input;
+  MakeAttributes(input.GetPointer());
+
+  std::vector<vtkIdType> fromIds(NumberOfOutputTuples);
+  std::vector<vtkIdType> edges(2 * NumberOfOutputTuples);
+  std::vector<double> t(NumberOfOutputTuples);
+  for (vtkIdType i = 0; i < NumberOfOutputTuples; ++i)
+  {
+    fromIds[i] = (i * 37) % NumberOfInputTuples;
+    edges[2*i] = (i * 11) % NumberOfInputTuples;
+    edges[2*i+1] = (i * 17 + 5) % NumberOfInputTuples;
+    t[i] = (i % 21) / 20.0;
+  }
+
+  // CopyBatch() follows the copy flags of CopyData()
+  for (int config = 0; config < 2; ++config)
+  {
+    vtkNew<vtkDataSetAttributes> serial;
+    vtkNew<vtkDataSetAttributes> batched;
+    if (config == 1)
+    {
+      serial->CopyFieldOff("Ids");
+      batched->CopyFieldOff("Ids");
+      serial->CopyGlobalIdsOn();
+      batched->CopyGlobalIdsOn();
+    }
+    serial->CopyAllocate(input.GetPointer(), NumberOfOutputTuples);
+    batched->CopyAllocate(input.GetPointer(), NumberOfOutputTuples);
+    for (vtkIdType i = 0; i < NumberOfOutputTuples; ++i)
+    {
+      serial->CopyData(input.GetPointer(), fromIds[i], i);
+    }
+    batched->SetNumberOfAllocatedTuples(NumberOfOutputTuples);
+    batched->CopyBatch(input.GetPointer(), 0, NumberOfOutputTuples,
+                       &fromIds[0]);
+    if (!SameAttributes(serial.GetPointer(), batched.GetPointer()))
+    {
+      cerr << "Error: CopyBatch, configuration " << config << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // InterpolateEdgeBatch(), with and without nearest neighbor interpolation
+  // of the vectors
+  for (int config = 0; config < 2; ++config)
+  {
+    vtkNew<vtkDataSetAttributes> serial;
+    vtkNew<vtkDataSetAttributes> batched;
+    if (config == 1)
+    {
+      serial->SetCopyVectors(2, vtkDataSetAttributes::INTERPOLATE);
+      batched->SetCopyVectors(2, vtkDataSetAttributes::INTERPOLATE);
+    }
+    serial->InterpolateAllocate(input.GetPointer(), NumberOfOutputTuples);
+    batched->InterpolateAllocate(input.GetPointer(), NumberOfOutputTuples);
+    for (vtkIdType i = 0; i < NumberOfOutputTuples; ++i)
+    {
+      serial->InterpolateEdge(input.GetPointer(), i, edges[2*i], edges[2*i+1],
+                              t[i]);
+    }
+    batched->SetNumberOfAllocatedTuples(NumberOfOutputTuples);
+    batched->InterpolateEdgeBatch(input.GetPointer(), 0, NumberOfOutputTuples,
+                                  &edges[0], &t[0]);
+    if (!SameAttributes(serial.GetPointer(), batched.GetPointer()))
+    {
+      cerr << "Error: InterpolateEdgeBatch, configuration " << config << endl;
+      return EXIT_FAILURE;
+    }
+
+    // Disjoint ranges of tuples processed by different threads
+    vtkNew<vtkDataSetAttributes> threaded;
+    if (config == 1)
+    {
+      threaded->SetCopyVectors(2, vtkDataSetAttributes::INTERPOLATE);
+    }
+    threaded->InterpolateAllocate(input.GetPointer(), NumberOfOutputTuples);
+    threaded->SetNumberOfAllocatedTuples(NumberOfOutputTuples);
+    vtkDataSetAttributes *in = input.GetPointer();
+    vtkDataSetAttributes *out = threaded.GetPointer();
+    vtkSMPTools::For(0, NumberOfOutputTuples, 64,
+      [&](vtkIdType begin, vtkIdType end)
+    {
+      out->InterpolateEdgeBatch(in, begin, end - begin, &edges[2*begin],
+                                &t[begin]);
+    });
+    if (!SameAttributes(serial.GetPointer(), threaded.GetPointer()))
+    {
+      cerr << "Error: threaded InterpolateEdgeBatch, configuration " << config
+           << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
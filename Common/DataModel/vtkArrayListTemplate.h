@@ -42,6 +42,7 @@
 
 #include "vtkDataArray.h"
 #include "vtkDataSetAttributes.h"
+#include "vtkMath.h"
 #include "vtkSmartPointer.h"
 #include "vtkStdString.h"
 
@@ -67,6 +68,7 @@ struct BaseArrayPair
   virtual void Copy(vtkIdType inId, vtkIdType outId) = 0;
   virtual void Interpolate(int numWeights, const vtkIdType *ids,
                            const double *weights, vtkIdType outId) = 0;
+  virtual void Average(int numIds, const vtkIdType *ids, vtkIdType outId) = 0;
   virtual void InterpolateEdge(vtkIdType v0, vtkIdType v1,
                                double t, vtkIdType outId) = 0;
   virtual void AssignNullValue(vtkIdType outId) = 0;
@@ -111,6 +113,22 @@ struct ArrayPair : public BaseArrayPair
     }
   }
 
+  // Same weights and rounding as vtkDataSetAttributes::InterpolatePoint()
+  void Average(int numIds, const vtkIdType *ids, vtkIdType outId) VTK_OVERRIDE
+  {
+    double weight = 1.0 / numIds;
+    for (int j=0; j < this->NumComp; ++j)
+    {
+      double v = 0.0;
+      for (vtkIdType i=0; i < numIds; ++i)
+      {
+        v += weight * static_cast<double>(this->Input[ids[i]*this->NumComp+j]);
+      }
+      vtkMath::RoundDoubleToIntegralIfNecessary(
+        v, this->Output + outId*this->NumComp + j);
+    }
+  }
+
   void InterpolateEdge(vtkIdType v0, vtkIdType v1, double t, vtkIdType outId) VTK_OVERRIDE
   {
     double v;
@@ -178,6 +196,20 @@ struct RealArrayPair : public BaseArrayPair
     }
   }
 
+  void Average(int numIds, const vtkIdType *ids, vtkIdType outId) VTK_OVERRIDE
+  {
+    double weight = 1.0 / numIds;
+    for (int j=0; j < this->NumComp; ++j)
+    {
+      double v = 0.0;
+      for (vtkIdType i=0; i < numIds; ++i)
+      {
+        v += weight * static_cast<double>(this->Input[ids[i]*this->NumComp+j]);
+      }
+      this->Output[outId*this->NumComp+j] = static_cast<TOutput>(v);
+    }
+  }
+
   void InterpolateEdge(vtkIdType v0, vtkIdType v1, double t, vtkIdType outId) VTK_OVERRIDE
   {
     double v;
@@ -241,6 +273,36 @@ struct ArrayList
   void ExcludeArray(vtkDataArray *da);
   bool IsExcluded(vtkDataArray *da);
 
+  // Whether all the arrays of the field data are named data arrays, other
+  // than bit arrays, so that AddArrays() processes all of them
+  static bool HasNamedDataArrays(vtkFieldData *fd)
+  {
+    for (int i=0; i < fd->GetNumberOfArrays(); ++i)
+    {
+      vtkDataArray *array = fd->GetArray(i);
+      if ( !array || !array->GetName() || array->GetDataType() == VTK_BIT )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Whether the field data has bit arrays, whose tuples share bytes and
+  // therefore cannot be written by several threads
+  static bool HasBitArrays(vtkFieldData *fd)
+  {
+    for (int i=0; i < fd->GetNumberOfArrays(); ++i)
+    {
+      vtkAbstractArray *array = fd->GetAbstractArray(i);
+      if ( array && array->GetDataType() == VTK_BIT )
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
   // Loop over the array pairs and copy data from one to another
   void Copy(vtkIdType inId, vtkIdType outId)
   {
@@ -261,6 +323,16 @@ struct ArrayList
       }
   }
 
+  // Loop over the arrays and average the given tuples with equal weights
+  void Average(int numIds, const vtkIdType *ids, vtkIdType outId)
+  {
+      for (std::vector<BaseArrayPair*>::iterator it = Arrays.begin();
+           it != Arrays.end(); ++it)
+      {
+        (*it)->Average(numIds, ids, outId);
+      }
+  }
+
   // Loop over the arrays perform edge interpolation
   void InterpolateEdge(vtkIdType v0, vtkIdType v1, double t, vtkIdType outId)
   {
@@ -19,9 +19,47 @@
 #include "vtkGenericCell.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticCellLinksTemplate.h"
+#include "vtkUnstructuredGrid.h"
 
 vtkStandardNewMacro(vtkCellLinks);
 
+namespace
+{
+int vtkCellLinksGlobalStaticBuild = 1;
+
+// Point the lists of cells into the runs of static links
+struct vtkCellLinksSetLinks
+{
+  vtkCellLinks::Link *Array;
+  vtkIdType *Storage;
+  const vtkIdType *Offsets;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      this->Array[ptId].ncells = static_cast<unsigned short>(
+        this->Offsets[ptId+1] - this->Offsets[ptId]);
+      this->Array[ptId].cells = this->Storage + this->Offsets[ptId];
+    }
+  }
+};
+}
+
+//----------------------------------------------------------------------------
+void vtkCellLinks::SetGlobalStaticBuild(int val)
+{
+  vtkCellLinksGlobalStaticBuild = val;
+}
+
+//----------------------------------------------------------------------------
+int vtkCellLinks::GetGlobalStaticBuild()
+{
+  return vtkCellLinksGlobalStaticBuild;
+}
+
 //----------------------------------------------------------------------------
 vtkCellLinks::~vtkCellLinks()
 {
@@ -35,12 +73,15 @@ void vtkCellLinks::Initialize()
   {
     for (vtkIdType i=0; i<=this->MaxId; i++)
     {
-      delete [] this->Array[i].cells;
+      this->FreeCells(i);
     }
 
     delete [] this->Array;
     this->Array = NULL;
   }
+  delete [] this->Storage;
+  this->Storage = NULL;
+  this->StorageSize = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -127,6 +168,14 @@ vtkCellLinks::Link *vtkCellLinks::Resize(vtkIdType sz)
 // Build the link list array.
 void vtkCellLinks::BuildLinks(vtkDataSet *data)
 {
+  if ( vtkCellLinksGlobalStaticBuild &&
+       (data->GetDataObjectType() == VTK_POLY_DATA ||
+        data->GetDataObjectType() == VTK_UNSTRUCTURED_GRID) )
+  {
+    this->BuildStaticLinks(data);
+    return;
+  }
+
   vtkIdType numPts = data->GetNumberOfPoints();
   vtkIdType numCells = data->GetNumberOfCells();
   int j;
@@ -207,6 +256,14 @@ void vtkCellLinks::BuildLinks(vtkDataSet *data)
 // Build the link list array.
 void vtkCellLinks::BuildLinks(vtkDataSet *data, vtkCellArray *Connectivity)
 {
+  if ( vtkCellLinksGlobalStaticBuild && Connectivity != NULL &&
+       data->GetDataObjectType() == VTK_UNSTRUCTURED_GRID &&
+       static_cast<vtkUnstructuredGrid*>(data)->GetCells() == Connectivity )
+  {
+    this->BuildStaticLinks(data);
+    return;
+  }
+
   vtkIdType numPts = data->GetNumberOfPoints();
   vtkIdType j, cellId;
   unsigned short *linkLoc;
@@ -245,6 +302,36 @@ void vtkCellLinks::BuildLinks(vtkDataSet *data, vtkCellArray *Connectivity)
   Connectivity->SetTraversalLocation(loc);
 }
 
+//----------------------------------------------------------------------------
+// Build the links as static links, then take over their cell ids. The lists
+// of cells all lie in this storage.
+void vtkCellLinks::BuildStaticLinks(vtkDataSet *data)
+{
+  vtkIdType numPts = data->GetNumberOfPoints();
+  vtkStaticCellLinksTemplate<vtkIdType> links;
+  links.BuildLinks(data);
+
+  // Release the previous lists
+  for (vtkIdType ptId=0; ptId <= this->MaxId; ptId++)
+  {
+    this->DeletePoint(ptId);
+  }
+  delete [] this->Storage;
+  if ( this->Size < numPts )
+  {
+    this->Resize(numPts);
+  }
+
+  this->Storage = links.Links;
+  this->StorageSize = links.LinksSize + 1;
+  links.Links = NULL;
+
+  vtkCellLinksSetLinks setLinks = { this->Array, this->Storage,
+                                    links.Offsets };
+  vtkSMPTools::For(0, numPts, setLinks);
+  this->MaxId = numPts - 1;
+}
+
 //----------------------------------------------------------------------------
 // Insert a new point into the cell-links data structure. The size parameter
 // is the initial size of the list.
@@ -278,9 +365,29 @@ unsigned long vtkCellLinks::GetActualMemorySize()
 //----------------------------------------------------------------------------
 void vtkCellLinks::DeepCopy(vtkCellLinks *src)
 {
+  this->Initialize();
   this->Allocate(src->Size, src->Extend);
-  memcpy(this->Array, src->Array, this->Size * sizeof(vtkCellLinks::Link));
   this->MaxId = src->MaxId;
+
+  // Copy the lists of cells into a single allocation. As for static links,
+  // an extra entry keeps the empty lists at the end within the storage.
+  vtkIdType ptId;
+  this->StorageSize = 1;
+  for (ptId=0; ptId <= this->MaxId; ptId++)
+  {
+    this->StorageSize += src->Array[ptId].ncells;
+  }
+  this->Storage = new vtkIdType[this->StorageSize];
+
+  vtkIdType *cells = this->Storage;
+  for (ptId=0; ptId <= this->MaxId; ptId++)
+  {
+    unsigned short ncells = src->Array[ptId].ncells;
+    this->Array[ptId].ncells = ncells;
+    this->Array[ptId].cells = cells;
+    memcpy(cells, src->Array[ptId].cells, ncells * sizeof(vtkIdType));
+    cells += ncells;
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -28,6 +28,13 @@
  * (and vtkStaticCellLinksTemplate). However these other classes are typically
  * meant for one-time (static) construction.
  *
+ * By default, BuildLinks() builds the links of vtkPolyData and
+ * vtkUnstructuredGrid as static links do: in parallel, with the cell ids
+ * of all the points stored in a single allocation instead of one
+ * allocation per point. The links can still be modified incrementally
+ * afterwards; ResizeCellList() moves the list of a point to its own
+ * allocation. See SetGlobalStaticBuild().
+ *
  * @sa
  * vtkCellArray vtkCellTypes vtkStaticCellLinks vtkStaticCellLinksTemplate
 */
@@ -71,6 +78,19 @@ public:
    */
   void BuildLinks(vtkDataSet *data, vtkCellArray *Connectivity);
 
+  //@{
+  /**
+   * Global flag controlling whether BuildLinks() builds the links of
+   * vtkPolyData and vtkUnstructuredGrid in parallel, in a single allocation
+   * (see vtkStaticCellLinksTemplate), rather than serially with one
+   * allocation per point. Both produce the same links. On by default.
+   */
+  static void SetGlobalStaticBuild(int val);
+  static void GlobalStaticBuildOn() {vtkCellLinks::SetGlobalStaticBuild(1);}
+  static void GlobalStaticBuildOff() {vtkCellLinks::SetGlobalStaticBuild(0);}
+  static int GetGlobalStaticBuild();
+  //@}
+
   /**
    * Allocate the specified number of links (i.e., number of points) that
    * will be built.
@@ -162,7 +182,8 @@ public:
   void DeepCopy(vtkCellLinks *src);
 
 protected:
-  vtkCellLinks():Array(NULL),Size(0),MaxId(-1),Extend(1000) {}
+  vtkCellLinks():Array(NULL),Size(0),MaxId(-1),Extend(1000),
+                 Storage(NULL),StorageSize(0) {}
   ~vtkCellLinks() VTK_OVERRIDE;
 
   /**
@@ -172,6 +193,17 @@ protected:
 
   void AllocateLinks(vtkIdType n);
 
+  /**
+   * Build the links of polydata and unstructured grids in parallel, into
+   * the Storage shared by the lists.
+   */
+  void BuildStaticLinks(vtkDataSet *data);
+
+  /**
+   * Release the list of cells of a point, unless it lies in the Storage.
+   */
+  void FreeCells(vtkIdType ptId);
+
   /**
    * Insert a cell id into the list of cells using the point.
    */
@@ -184,6 +216,9 @@ protected:
   vtkIdType Extend;     // grow array by this point
   Link *Resize(vtkIdType sz);  // function to resize data
 
+  vtkIdType *Storage;   // lists of cells built by BuildStaticLinks()
+  vtkIdType StorageSize;
+
 private:
   vtkCellLinks(const vtkCellLinks&) VTK_DELETE_FUNCTION;
   void operator=(const vtkCellLinks&) VTK_DELETE_FUNCTION;
@@ -197,11 +232,21 @@ inline void vtkCellLinks::InsertCellReference(vtkIdType ptId,
   this->Array[ptId].cells[pos] = cellId;
 }
 
+//----------------------------------------------------------------------------
+inline void vtkCellLinks::FreeCells(vtkIdType ptId)
+{
+  vtkIdType *cells = this->Array[ptId].cells;
+  if ( cells < this->Storage || cells >= this->Storage + this->StorageSize )
+  {
+    delete [] cells;
+  }
+}
+
 //----------------------------------------------------------------------------
 inline void vtkCellLinks::DeletePoint(vtkIdType ptId)
 {
   this->Array[ptId].ncells = 0;
-  delete [] this->Array[ptId].cells;
+  this->FreeCells(ptId);
   this->Array[ptId].cells = NULL;
 }
 
@@ -248,7 +293,7 @@ inline void vtkCellLinks::ResizeCellList(vtkIdType ptId, int size)
   cells = new vtkIdType[newSize];
   memcpy(cells, this->Array[ptId].cells,
          this->Array[ptId].ncells*sizeof(vtkIdType));
-  delete [] this->Array[ptId].cells;
+  this->FreeCells(ptId);
   this->Array[ptId].cells = cells;
 }
 
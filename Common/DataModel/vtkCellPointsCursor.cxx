@@ -0,0 +1,171 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCellPointsCursor.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellPointsCursor.h"
+
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+//----------------------------------------------------------------------------
+vtkCellPointsCursor::vtkCellPointsCursor(vtkDataSet *ds) :
+  Kind(GENERIC), DataSet(ds), NumberOfCells(ds->GetNumberOfCells()),
+  PolyData(NULL), Connectivity(NULL), Locations(NULL), Types(NULL),
+  DataDescription(VTK_EMPTY), CellIds(NULL)
+{
+  this->Dimensions[0] = this->Dimensions[1] = this->Dimensions[2] = 0;
+
+  switch ( ds->GetDataObjectType() )
+  {
+    case VTK_POLY_DATA:
+      this->PolyData = static_cast<vtkPolyData*>(ds);
+      if ( this->PolyData->NeedToBuildCells() )
+      {
+        this->PolyData->BuildCells();
+      }
+      this->Kind = POLYGONAL;
+      break;
+
+    case VTK_UNSTRUCTURED_GRID:
+    {
+      vtkUnstructuredGrid *ugrid = static_cast<vtkUnstructuredGrid*>(ds);
+      if ( this->NumberOfCells > 0 && ugrid->GetCells() &&
+           ugrid->GetCellLocationsArray() && ugrid->GetCellTypesArray() )
+      {
+        this->Connectivity = ugrid->GetCells()->GetPointer();
+        this->Locations = ugrid->GetCellLocationsArray()->GetPointer(0);
+        this->Types = ugrid->GetCellTypesArray()->GetPointer(0);
+        this->Kind = UNSTRUCTURED;
+      }
+      break;
+    }
+
+    case VTK_IMAGE_DATA:
+    case VTK_STRUCTURED_POINTS:
+    case VTK_UNIFORM_GRID:
+      static_cast<vtkImageData*>(ds)->GetDimensions(this->Dimensions);
+      this->DataDescription =
+        vtkStructuredData::GetDataDescription(this->Dimensions);
+      this->Kind = STRUCTURED;
+      break;
+
+    case VTK_STRUCTURED_GRID:
+      static_cast<vtkStructuredGrid*>(ds)->GetDimensions(this->Dimensions);
+      this->DataDescription =
+        vtkStructuredData::GetDataDescription(this->Dimensions);
+      this->Kind = STRUCTURED;
+      break;
+
+    case VTK_RECTILINEAR_GRID:
+      static_cast<vtkRectilinearGrid*>(ds)->GetDimensions(this->Dimensions);
+      this->DataDescription =
+        vtkStructuredData::GetDataDescription(this->Dimensions);
+      this->Kind = STRUCTURED;
+      break;
+
+    default:
+      break;
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkCellPointsCursor::vtkCellPointsCursor() :
+  Kind(GENERIC), DataSet(NULL), NumberOfCells(0),
+  PolyData(NULL), Connectivity(NULL), Locations(NULL), Types(NULL),
+  DataDescription(VTK_EMPTY), CellIds(NULL)
+{
+  this->Dimensions[0] = this->Dimensions[1] = this->Dimensions[2] = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkCellPointsCursor::vtkCellPointsCursor(const vtkCellPointsCursor &other) :
+  CellIds(NULL)
+{
+  this->CopyState(other);
+}
+
+//----------------------------------------------------------------------------
+vtkCellPointsCursor&
+vtkCellPointsCursor::operator=(const vtkCellPointsCursor &other)
+{
+  // The scratch id list (if any) is kept; it is never shared.
+  if ( this != &other )
+  {
+    this->CopyState(other);
+  }
+  return *this;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellPointsCursor::CopyState(const vtkCellPointsCursor &other)
+{
+  this->Kind = other.Kind;
+  this->DataSet = other.DataSet;
+  this->NumberOfCells = other.NumberOfCells;
+  this->PolyData = other.PolyData;
+  this->Connectivity = other.Connectivity;
+  this->Locations = other.Locations;
+  this->Types = other.Types;
+  this->DataDescription = other.DataDescription;
+  for ( int i=0; i < 3; ++i )
+  {
+    this->Dimensions[i] = other.Dimensions[i];
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkCellPointsCursor::~vtkCellPointsCursor()
+{
+  if ( this->CellIds )
+  {
+    this->CellIds->Delete();
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkCellPointsCursor::GetCellType(vtkIdType cellId)
+{
+  switch ( this->Kind )
+  {
+    case UNSTRUCTURED:
+      return this->Types[cellId];
+
+    case POLYGONAL:
+      return this->PolyData->vtkPolyData::GetCellType(cellId);
+
+    default:
+      // Structured datasets compute the type (accounting for blanking)
+      // without modifying their state.
+      return this->DataSet->GetCellType(cellId);
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellPointsCursor::GetGenericCellPoints(vtkIdType cellId,
+                                                    const vtkIdType* &pts)
+{
+  if ( this->CellIds == NULL )
+  {
+    this->CellIds = vtkIdList::New();
+    this->CellIds->Allocate(VTK_CELL_SIZE);
+  }
+  this->DataSet->GetCellPoints(cellId, this->CellIds);
+  pts = this->CellIds->GetPointer(0);
+  return this->CellIds->GetNumberOfIds();
+}
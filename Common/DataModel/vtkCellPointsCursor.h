@@ -0,0 +1,183 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCellPointsCursor.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkCellPointsCursor
+ * @brief   lightweight, thread-safe access to the point ids of cells
+ *
+ * vtkCellPointsCursor provides random access to the point ids (and type) of
+ * the cells of a dataset without heap allocation and without touching any
+ * state shared between threads. It is meant to be used from within
+ * vtkSMPTools functors: construct one cursor from the dataset in the
+ * calling (main) thread, then give each thread its own copy (copying is
+ * cheap). For example:
+ *
+ * \code
+ * vtkCellPointsCursor cursor(input); // main thread
+ * vtkSMPThreadLocal<vtkCellPointsCursor> cursors(cursor);
+ * ...
+ * // in operator()(vtkIdType cellId, vtkIdType endCellId)
+ * vtkCellPointsCursor &c = cursors.Local();
+ * const vtkIdType *pts;
+ * for ( ; cellId < endCellId; ++cellId )
+ * {
+ *   vtkIdType npts = c.GetCellPoints(cellId, pts);
+ *   ...
+ * }
+ * \endcode
+ *
+ * Fast paths are provided for vtkPolyData, vtkUnstructuredGrid,
+ * vtkImageData (and subclasses), vtkStructuredGrid and vtkRectilinearGrid.
+ * For explicit datasets the returned pointer refers directly to the
+ * dataset's connectivity; for structured datasets the ids are computed into
+ * a small buffer embedded in the cursor. Other dataset types fall back to
+ * vtkDataSet::GetCellPoints() with a vtkIdList owned by the cursor, in which
+ * case thread safety depends on the dataset type.
+ *
+ * The constructor performs any one-time preparation (e.g., building the
+ * vtkPolyData cell map), so it is not thread safe and must be invoked
+ * before entering parallel code. The dataset must not be modified while
+ * cursors referring to it are in use. Returned pointers are valid until the
+ * next call on the same cursor.
+ *
+ * @sa
+ * vtkDataSet vtkSMPTools vtkCompactCellArray
+*/
+
+#ifndef vtkCellPointsCursor_h
+#define vtkCellPointsCursor_h
+
+#include "vtkCommonDataModelModule.h" // For export macro
+#include "vtkPolyData.h" // Needed for inline methods
+#include "vtkStructuredData.h" // Needed for inline methods
+
+class vtkIdList;
+
+class VTKCOMMONDATAMODEL_EXPORT vtkCellPointsCursor
+{
+public:
+  /**
+   * Prepare access to the cells of the dataset ds. Not thread safe.
+   */
+  explicit vtkCellPointsCursor(vtkDataSet *ds);
+
+  /**
+   * Construct a cursor not bound to any dataset. A bound cursor must be
+   * assigned to it before use (this is what vtkSMPThreadLocal does with
+   * its exemplar).
+   */
+  vtkCellPointsCursor();
+
+  //@{
+  /**
+   * Copy a cursor, typically to hand one to each thread. The copy shares
+   * nothing with the original but the dataset.
+   */
+  vtkCellPointsCursor(const vtkCellPointsCursor &other);
+  vtkCellPointsCursor& operator=(const vtkCellPointsCursor &other);
+  //@}
+
+  ~vtkCellPointsCursor();
+
+  /**
+   * Return the dataset the cursor refers to.
+   */
+  vtkDataSet *GetDataSet() const
+    {return this->DataSet;}
+
+  /**
+   * Return the number of cells in the dataset.
+   */
+  vtkIdType GetNumberOfCells() const
+    {return this->NumberOfCells;}
+
+  /**
+   * Return the number of points of the cell cellId and set pts to point to
+   * its point ids. The pointer remains valid until the next call on this
+   * cursor.
+   */
+  vtkIdType GetCellPoints(vtkIdType cellId, const vtkIdType* &pts);
+
+  /**
+   * Return the type of the cell cellId.
+   */
+  int GetCellType(vtkIdType cellId);
+
+private:
+  // Supported access paths
+  enum
+  {
+    POLYGONAL = 0,
+    UNSTRUCTURED = 1,
+    STRUCTURED = 2,
+    GENERIC = 3
+  };
+
+  vtkIdType GetGenericCellPoints(vtkIdType cellId, const vtkIdType* &pts);
+
+  int Kind;
+  vtkDataSet *DataSet;
+  vtkIdType NumberOfCells;
+
+  // Explicit datasets
+  vtkPolyData *PolyData;
+  const vtkIdType *Connectivity;
+  const vtkIdType *Locations;
+  const unsigned char *Types;
+
+  // Structured datasets
+  int DataDescription;
+  int Dimensions[3];
+  vtkIdType Buffer[8];
+
+  // Fallback for other datasets, created on demand
+  vtkIdList *CellIds;
+
+  void CopyState(const vtkCellPointsCursor &other);
+};
+
+//----------------------------------------------------------------------------
+inline vtkIdType vtkCellPointsCursor::GetCellPoints(vtkIdType cellId,
+                                                    const vtkIdType* &pts)
+{
+  switch ( this->Kind )
+  {
+    case UNSTRUCTURED:
+    {
+      const vtkIdType *cell = this->Connectivity + this->Locations[cellId];
+      pts = cell + 1;
+      return *cell;
+    }
+
+    case STRUCTURED:
+      pts = this->Buffer;
+      return vtkStructuredData::GetCellPoints(cellId, this->Buffer,
+        this->DataDescription, this->Dimensions);
+
+    case POLYGONAL:
+    {
+      vtkIdType npts;
+      vtkIdType *cellPts;
+      this->PolyData->GetCellPoints(cellId, npts, cellPts);
+      pts = cellPts;
+      return npts;
+    }
+
+    default:
+      return this->GetGenericCellPoints(cellId, pts);
+  }
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkCellPointsCursor.h
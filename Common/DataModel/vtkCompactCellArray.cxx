@@ -0,0 +1,651 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCompactCellArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCompactCellArray.h"
+
+#include "vtkCellArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkTypeInt32Array.h"
+
+vtkStandardNewMacro(vtkCompactCellArray);
+
+//----------------------------------------------------------------------------
+// Helper classes used to process the cell array in parallel. They are
+// templated over the integral type used to store ids.
+namespace {
+
+// Compute the largest cell size.
+template <typename TIds>
+struct vtkCompactMaxCellSize
+{
+  const TIds *Offsets;
+  vtkSMPThreadLocal<vtkIdType> LocalMax;
+  vtkIdType Max;
+
+  vtkCompactMaxCellSize(const TIds *offsets) :
+    Offsets(offsets), LocalMax(0), Max(0) {}
+
+  void Initialize()
+  {
+    this->LocalMax.Local() = 0;
+  }
+
+  void operator() (vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdType &localMax = this->LocalMax.Local();
+    const TIds *offsets = this->Offsets;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      vtkIdType npts =
+        static_cast<vtkIdType>(offsets[cellId+1] - offsets[cellId]);
+      localMax = ( npts > localMax ? npts : localMax );
+    }
+  }
+
+  void Reduce()
+  {
+    this->Max = 0;
+    typename vtkSMPThreadLocal<vtkIdType>::iterator itr;
+    for ( itr=this->LocalMax.begin(); itr != this->LocalMax.end(); ++itr )
+    {
+      this->Max = ( *itr > this->Max ? *itr : this->Max );
+    }
+  }
+};
+
+// Determine whether a list of values can be represented with vtkTypeInt32.
+template <typename TIds>
+struct vtkCompactFitsIn32Bits
+{
+  const TIds *Values;
+  vtkSMPThreadLocal<unsigned char> LocalFits;
+  bool Fits;
+
+  vtkCompactFitsIn32Bits(const TIds *values) :
+    Values(values), LocalFits(1), Fits(true) {}
+
+  void Initialize()
+  {
+    this->LocalFits.Local() = 1;
+  }
+
+  void operator() (vtkIdType idx, vtkIdType endIdx)
+  {
+    unsigned char &fits = this->LocalFits.Local();
+    const TIds *values = this->Values;
+    for ( ; fits && idx < endIdx; ++idx )
+    {
+      if ( values[idx] > VTK_TYPE_INT32_MAX ||
+           values[idx] < VTK_TYPE_INT32_MIN )
+      {
+        fits = 0;
+      }
+    }
+  }
+
+  void Reduce()
+  {
+    this->Fits = true;
+    vtkSMPThreadLocal<unsigned char>::iterator itr;
+    for ( itr=this->LocalFits.begin(); itr != this->LocalFits.end(); ++itr )
+    {
+      this->Fits = this->Fits && *itr != 0;
+    }
+  }
+};
+
+// Copy (and convert) a list of ids.
+template <typename TIn, typename TOut>
+struct vtkCompactCopyIds
+{
+  const TIn *In;
+  TOut *Out;
+
+  vtkCompactCopyIds(const TIn *in, TOut *out) : In(in), Out(out) {}
+
+  void operator() (vtkIdType idx, vtkIdType endIdx)
+  {
+    const TIn *in = this->In;
+    TOut *out = this->Out;
+    for ( ; idx < endIdx; ++idx )
+    {
+      out[idx] = static_cast<TOut>(in[idx]);
+    }
+  }
+};
+
+// Scatter the point ids of a legacy (n,id0,id1,...) list into the
+// connectivity array. The offsets are known, so the legacy location of cell
+// i is simply offsets[i]+i.
+template <typename TIds>
+struct vtkCompactImportLegacy
+{
+  const vtkIdType *Legacy;
+  const TIds *Offsets;
+  TIds *Connectivity;
+
+  vtkCompactImportLegacy(const vtkIdType *legacy, const TIds *offsets,
+                         TIds *conn) :
+    Legacy(legacy), Offsets(offsets), Connectivity(conn) {}
+
+  void operator() (vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      vtkIdType offset = static_cast<vtkIdType>(this->Offsets[cellId]);
+      vtkIdType npts = static_cast<vtkIdType>(this->Offsets[cellId+1]) - offset;
+      const vtkIdType *in = this->Legacy + offset + cellId + 1;
+      TIds *out = this->Connectivity + offset;
+      for ( vtkIdType i=0; i < npts; ++i )
+      {
+        out[i] = static_cast<TIds>(in[i]);
+      }
+    }
+  }
+};
+
+// Gather the connectivity into a legacy (n,id0,id1,...) list.
+template <typename TIds>
+struct vtkCompactExportLegacy
+{
+  const TIds *Offsets;
+  const TIds *Connectivity;
+  vtkIdType *Legacy;
+
+  vtkCompactExportLegacy(const TIds *offsets, const TIds *conn,
+                         vtkIdType *legacy) :
+    Offsets(offsets), Connectivity(conn), Legacy(legacy) {}
+
+  void operator() (vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      vtkIdType offset = static_cast<vtkIdType>(this->Offsets[cellId]);
+      vtkIdType npts = static_cast<vtkIdType>(this->Offsets[cellId+1]) - offset;
+      const TIds *in = this->Connectivity + offset;
+      vtkIdType *out = this->Legacy + offset + cellId;
+      *out++ = npts;
+      for ( vtkIdType i=0; i < npts; ++i )
+      {
+        out[i] = static_cast<vtkIdType>(in[i]);
+      }
+    }
+  }
+};
+
+// Convert an array of ids into an array of another integral type.
+template <typename TIn, typename TOut>
+void vtkCompactConvertArray(vtkAOSDataArrayTemplate<TIn> *in,
+                            vtkAOSDataArrayTemplate<TOut> *out)
+{
+  vtkIdType num = in->GetNumberOfTuples();
+  out->SetNumberOfTuples(num);
+  vtkCompactCopyIds<TIn,TOut> copy(in->GetPointer(0), out->GetPointer(0));
+  vtkSMPTools::For(0, num, copy);
+}
+
+// Return true if the offsets are a valid description of the connectivity.
+template <typename TIds>
+bool vtkCompactValidOffsets(vtkAOSDataArrayTemplate<TIds> *offsets,
+                            vtkAOSDataArrayTemplate<TIds> *conn)
+{
+  vtkIdType numOffsets = offsets->GetNumberOfTuples();
+  return ( numOffsets > 0 && offsets->GetValue(0) == 0 &&
+           static_cast<vtkIdType>(offsets->GetValue(numOffsets-1)) ==
+           conn->GetNumberOfTuples() );
+}
+
+} // anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkCompactCellArray::vtkCompactCellArray()
+{
+  this->Storage32Bit = false;
+  this->Offsets = NULL;
+  this->Connectivity = NULL;
+  this->ResetStorage(false);
+}
+
+//----------------------------------------------------------------------------
+vtkCompactCellArray::~vtkCompactCellArray()
+{
+  this->Offsets->Delete();
+  this->Connectivity->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::ResetStorage(bool use32Bit)
+{
+#if VTK_SIZEOF_ID_TYPE == 4
+  // vtkIdType is already a 32-bit integer
+  use32Bit = false;
+#endif
+
+  if ( this->Offsets )
+  {
+    this->Offsets->Delete();
+    this->Connectivity->Delete();
+  }
+
+  if ( use32Bit )
+  {
+    this->Offsets = vtkTypeInt32Array::New();
+    this->Connectivity = vtkTypeInt32Array::New();
+  }
+  else
+  {
+    this->Offsets = vtkIdTypeArray::New();
+    this->Connectivity = vtkIdTypeArray::New();
+  }
+  this->Offsets->InsertNextTuple1(0.0);
+  this->Storage32Bit = use32Bit;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::Initialize()
+{
+  this->ResetStorage(this->Storage32Bit);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::Reset()
+{
+  this->Offsets->Reset();
+  this->Offsets->InsertNextTuple1(0.0);
+  this->Connectivity->Reset();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::Squeeze()
+{
+  this->Offsets->Squeeze();
+  this->Connectivity->Squeeze();
+}
+
+//----------------------------------------------------------------------------
+bool vtkCompactCellArray::AllocateExact(vtkIdType numCells,
+                                        vtkIdType connSize)
+{
+  int ok = this->Offsets->Allocate(numCells+1) &&
+    this->Connectivity->Allocate(connSize);
+  this->Offsets->InsertNextTuple1(0.0);
+  this->Modified();
+  return ok != 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::Use32BitStorage()
+{
+  this->ResetStorage(true);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::UseDefaultStorage()
+{
+  this->ResetStorage(false);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkCompactCellArray::CanConvertTo32BitStorage()
+{
+  if ( this->Storage32Bit )
+  {
+    return true;
+  }
+#if VTK_SIZEOF_ID_TYPE == 4
+  return true;
+#else
+  // The largest offset is the connectivity size, so only the size and the
+  // point ids themselves need to be checked.
+  vtkIdType connSize = this->GetNumberOfConnectivityIds();
+  if ( connSize > VTK_TYPE_INT32_MAX )
+  {
+    return false;
+  }
+  vtkCompactFitsIn32Bits<vtkIdType>
+    fits(static_cast<IdArrayType*>(this->Connectivity)->GetPointer(0));
+  vtkSMPTools::For(0, connSize, fits);
+  return fits.Fits;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool vtkCompactCellArray::ConvertTo32BitStorage()
+{
+#if VTK_SIZEOF_ID_TYPE == 4
+  return true;
+#else
+  if ( this->Storage32Bit )
+  {
+    return true;
+  }
+  if ( ! this->CanConvertTo32BitStorage() )
+  {
+    return false;
+  }
+
+  vtkTypeInt32Array *offsets = vtkTypeInt32Array::New();
+  vtkTypeInt32Array *conn = vtkTypeInt32Array::New();
+  vtkCompactConvertArray(static_cast<IdArrayType*>(this->Offsets), offsets);
+  vtkCompactConvertArray(static_cast<IdArrayType*>(this->Connectivity), conn);
+
+  this->Offsets->Delete();
+  this->Connectivity->Delete();
+  this->Offsets = offsets;
+  this->Connectivity = conn;
+  this->Storage32Bit = true;
+  this->Modified();
+
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool vtkCompactCellArray::ConvertToDefaultStorage()
+{
+  if ( ! this->Storage32Bit )
+  {
+    return true;
+  }
+
+  vtkIdTypeArray *offsets = vtkIdTypeArray::New();
+  vtkIdTypeArray *conn = vtkIdTypeArray::New();
+  vtkCompactConvertArray(static_cast<Int32ArrayType*>(this->Offsets), offsets);
+  vtkCompactConvertArray(static_cast<Int32ArrayType*>(this->Connectivity),
+                         conn);
+
+  this->Offsets->Delete();
+  this->Connectivity->Delete();
+  this->Offsets = offsets;
+  this->Connectivity = conn;
+  this->Storage32Bit = false;
+  this->Modified();
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCompactCellArray::InsertNextCell(vtkIdType npts,
+                                              const vtkIdType *pts)
+{
+  if ( this->Storage32Bit )
+  {
+    Int32ArrayType *conn = static_cast<Int32ArrayType*>(this->Connectivity);
+    vtkIdType loc = conn->GetNumberOfTuples();
+    vtkTypeInt32 *ptr = conn->WritePointer(loc, npts);
+    for ( vtkIdType i=0; i < npts; ++i )
+    {
+      ptr[i] = static_cast<vtkTypeInt32>(pts[i]);
+    }
+    static_cast<Int32ArrayType*>(this->Offsets)->InsertNextValue(
+      static_cast<vtkTypeInt32>(loc+npts));
+  }
+  else
+  {
+    IdArrayType *conn = static_cast<IdArrayType*>(this->Connectivity);
+    vtkIdType loc = conn->GetNumberOfTuples();
+    vtkIdType *ptr = conn->WritePointer(loc, npts);
+    std::copy(pts, pts+npts, ptr);
+    static_cast<IdArrayType*>(this->Offsets)->InsertNextValue(loc+npts);
+  }
+
+  return this->GetNumberOfCells() - 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::ReplaceCellAtId(vtkIdType cellId,
+                                          const vtkIdType *pts)
+{
+  vtkIdType offset = this->GetOffset(cellId);
+  vtkIdType npts = this->GetOffset(cellId+1) - offset;
+  if ( this->Storage32Bit )
+  {
+    vtkTypeInt32 *ptr = static_cast<Int32ArrayType*>
+      (this->Connectivity)->GetPointer(offset);
+    for ( vtkIdType i=0; i < npts; ++i )
+    {
+      ptr[i] = static_cast<vtkTypeInt32>(pts[i]);
+    }
+  }
+  else
+  {
+    std::copy(pts, pts+npts, static_cast<IdArrayType*>
+              (this->Connectivity)->GetPointer(offset));
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::ReverseCellAtId(vtkIdType cellId)
+{
+  vtkIdType offset = this->GetOffset(cellId);
+  vtkIdType npts = this->GetOffset(cellId+1) - offset;
+  if ( this->Storage32Bit )
+  {
+    vtkTypeInt32 *ptr = static_cast<Int32ArrayType*>
+      (this->Connectivity)->GetPointer(offset);
+    std::reverse(ptr, ptr+npts);
+  }
+  else
+  {
+    vtkIdType *ptr = static_cast<IdArrayType*>
+      (this->Connectivity)->GetPointer(offset);
+    std::reverse(ptr, ptr+npts);
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkCompactCellArray::GetMaxCellSize()
+{
+  vtkIdType numCells = this->GetNumberOfCells();
+  if ( this->Storage32Bit )
+  {
+    vtkCompactMaxCellSize<vtkTypeInt32>
+      maxSize(static_cast<Int32ArrayType*>(this->Offsets)->GetPointer(0));
+    vtkSMPTools::For(0, numCells, maxSize);
+    return static_cast<int>(maxSize.Max);
+  }
+  vtkCompactMaxCellSize<vtkIdType>
+    maxSize(static_cast<IdArrayType*>(this->Offsets)->GetPointer(0));
+  vtkSMPTools::For(0, numCells, maxSize);
+  return static_cast<int>(maxSize.Max);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCompactCellArray::SetData(vtkDataArray *offsets,
+                                  vtkDataArray *connectivity)
+{
+  if ( offsets == NULL || connectivity == NULL ||
+       offsets->GetNumberOfComponents() != 1 ||
+       connectivity->GetNumberOfComponents() != 1 )
+  {
+    vtkErrorMacro("Offsets and connectivity must be single component arrays");
+    return false;
+  }
+
+  bool use32Bit;
+  IdArrayType *idOffsets = vtkArrayDownCast<IdArrayType>(offsets);
+  IdArrayType *idConn = vtkArrayDownCast<IdArrayType>(connectivity);
+  Int32ArrayType *int32Offsets = vtkArrayDownCast<Int32ArrayType>(offsets);
+  Int32ArrayType *int32Conn = vtkArrayDownCast<Int32ArrayType>(connectivity);
+  if ( idOffsets && idConn )
+  {
+    use32Bit = false;
+    if ( ! vtkCompactValidOffsets(idOffsets, idConn) )
+    {
+      vtkErrorMacro("Offsets are inconsistent with the connectivity");
+      return false;
+    }
+  }
+  else if ( int32Offsets && int32Conn )
+  {
+    use32Bit = true;
+    if ( ! vtkCompactValidOffsets(int32Offsets, int32Conn) )
+    {
+      vtkErrorMacro("Offsets are inconsistent with the connectivity");
+      return false;
+    }
+  }
+  else
+  {
+    vtkErrorMacro("Offsets and connectivity must both hold either vtkIdType "
+                  "or vtkTypeInt32 values");
+    return false;
+  }
+
+  offsets->Register(this);
+  connectivity->Register(this);
+  this->Offsets->Delete();
+  this->Connectivity->Delete();
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+  this->Storage32Bit = use32Bit;
+  this->Modified();
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCompactCellArray::ImportLegacyFormat(vtkCellArray *cells)
+{
+  if ( cells == NULL )
+  {
+    return false;
+  }
+
+  vtkIdType numCells = cells->GetNumberOfCells();
+  vtkIdType numEntries = cells->GetNumberOfConnectivityEntries();
+  vtkIdType connSize = numEntries - numCells;
+  const vtkIdType *legacy = cells->GetPointer();
+
+  if ( this->Storage32Bit )
+  {
+    // Point ids and cell sizes share the same legacy array, so checking the
+    // whole array covers both.
+    vtkCompactFitsIn32Bits<vtkIdType> fits(legacy);
+    vtkSMPTools::For(0, numEntries, fits);
+    if ( connSize > VTK_TYPE_INT32_MAX || ! fits.Fits )
+    {
+      vtkErrorMacro("Cells cannot be represented with 32-bit storage");
+      return false;
+    }
+  }
+
+  // The offsets require a linear walk of the legacy array. Then the point
+  // ids can be copied in parallel.
+  this->Offsets->SetNumberOfTuples(numCells+1);
+  this->Connectivity->SetNumberOfTuples(connSize);
+  if ( this->Storage32Bit )
+  {
+    vtkTypeInt32 *offsets =
+      static_cast<Int32ArrayType*>(this->Offsets)->GetPointer(0);
+    offsets[0] = 0;
+    for ( vtkIdType cellId=0, loc=0; cellId < numCells; ++cellId )
+    {
+      offsets[cellId+1] = offsets[cellId] +
+        static_cast<vtkTypeInt32>(legacy[loc]);
+      loc += legacy[loc] + 1;
+    }
+    vtkCompactImportLegacy<vtkTypeInt32> import(legacy, offsets,
+      static_cast<Int32ArrayType*>(this->Connectivity)->GetPointer(0));
+    vtkSMPTools::For(0, numCells, import);
+  }
+  else
+  {
+    vtkIdType *offsets =
+      static_cast<IdArrayType*>(this->Offsets)->GetPointer(0);
+    offsets[0] = 0;
+    for ( vtkIdType cellId=0, loc=0; cellId < numCells; ++cellId )
+    {
+      offsets[cellId+1] = offsets[cellId] + legacy[loc];
+      loc += legacy[loc] + 1;
+    }
+    vtkCompactImportLegacy<vtkIdType> import(legacy, offsets,
+      static_cast<IdArrayType*>(this->Connectivity)->GetPointer(0));
+    vtkSMPTools::For(0, numCells, import);
+  }
+  this->Modified();
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::ExportLegacyFormat(vtkCellArray *cells)
+{
+  if ( cells == NULL )
+  {
+    return;
+  }
+
+  vtkIdType numCells = this->GetNumberOfCells();
+  vtkIdType connSize = this->GetNumberOfConnectivityIds();
+  vtkIdType *legacy = cells->WritePointer(numCells, connSize+numCells);
+  if ( this->Storage32Bit )
+  {
+    vtkCompactExportLegacy<vtkTypeInt32> exporter(
+      static_cast<Int32ArrayType*>(this->Offsets)->GetPointer(0),
+      static_cast<Int32ArrayType*>(this->Connectivity)->GetPointer(0),
+      legacy);
+    vtkSMPTools::For(0, numCells, exporter);
+  }
+  else
+  {
+    vtkCompactExportLegacy<vtkIdType> exporter(
+      static_cast<IdArrayType*>(this->Offsets)->GetPointer(0),
+      static_cast<IdArrayType*>(this->Connectivity)->GetPointer(0),
+      legacy);
+    vtkSMPTools::For(0, numCells, exporter);
+  }
+  cells->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::DeepCopy(vtkCompactCellArray *ca)
+{
+  // Do nothing on a NULL input.
+  if ( ca == NULL || ca == this )
+  {
+    return;
+  }
+
+  this->ResetStorage(ca->Storage32Bit);
+  this->Offsets->DeepCopy(ca->Offsets);
+  this->Connectivity->DeepCopy(ca->Connectivity);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkCompactCellArray::GetActualMemorySize()
+{
+  return this->Offsets->GetActualMemorySize() +
+    this->Connectivity->GetActualMemorySize();
+}
+
+//----------------------------------------------------------------------------
+void vtkCompactCellArray::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Storage: "
+     << (this->Storage32Bit ? "32-bit" : "vtkIdType") << endl;
+  os << indent << "Number Of Cells: " << this->GetNumberOfCells() << endl;
+  os << indent << "Number Of Connectivity Ids: "
+     << this->GetNumberOfConnectivityIds() << endl;
+}
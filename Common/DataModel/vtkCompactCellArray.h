@@ -0,0 +1,307 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCompactCellArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkCompactCellArray
+ * @brief   cell connectivity stored as offsets plus connectivity
+ *
+ * vtkCompactCellArray represents cell connectivity with two arrays rather
+ * than the single interleaved (n,id0,id1,...) list used by vtkCellArray.
+ * The connectivity array holds the point ids of all cells back to back, and
+ * the offsets array holds (numberOfCells+1) entries where offset[i] is the
+ * position of the first point id of cell i in the connectivity array (the
+ * last entry is the total connectivity size). The number of points of cell
+ * i is thus offset[i+1]-offset[i].
+ *
+ * This layout provides O(1) random access to any cell without the need of a
+ * supplemental vtkCellTypes location array, and makes it trivial for
+ * parallel algorithms to compute where each cell is to be written. In
+ * addition, if the number of points (and connectivity entries) can be
+ * represented with 32-bit integers, the storage may be switched to 32-bit
+ * ids, halving the memory footprint compared to a vtkIdType based layout
+ * (when vtkIdType is 64 bits).
+ *
+ * The methods GetCellSize() and GetCellAtId() do not modify the state of the
+ * object, so they are safe to invoke concurrently (e.g., from vtkSMPTools
+ * workers) provided that each thread uses its own vtkIdList as scratch
+ * space. Note that this is not the case for the vtkCellArray traversal
+ * methods InitTraversal()/GetNextCell() which maintain an internal cursor.
+ *
+ * Use ImportLegacyFormat() and ExportLegacyFormat() to convert from and to
+ * vtkCellArray.
+ *
+ * @sa
+ * vtkCellArray vtkCellTypes vtkStaticCellLinks
+*/
+
+#ifndef vtkCompactCellArray_h
+#define vtkCompactCellArray_h
+
+#include "vtkCommonDataModelModule.h" // For export macro
+#include "vtkObject.h"
+
+#include "vtkAOSDataArrayTemplate.h" // Needed for inline methods
+#include "vtkIdList.h" // Needed for inline methods
+
+#include <algorithm> // For std::copy
+
+class vtkCellArray;
+class vtkDataArray;
+
+class VTKCOMMONDATAMODEL_EXPORT vtkCompactCellArray : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkCompactCellArray,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  /**
+   * Instantiate an empty cell array using vtkIdType storage.
+   */
+  static vtkCompactCellArray *New();
+
+  /**
+   * Free any memory and reset to an empty state. The storage type is
+   * retained.
+   */
+  void Initialize();
+
+  /**
+   * Reset to an empty state but retain previously allocated memory.
+   */
+  void Reset();
+
+  /**
+   * Reclaim any extra memory.
+   */
+  void Squeeze();
+
+  /**
+   * Preallocate memory for numCells cells requiring connSize point ids in
+   * total. Any existing cells are discarded. Returns true on success.
+   */
+  bool AllocateExact(vtkIdType numCells, vtkIdType connSize);
+
+  //@{
+  /**
+   * Control the integral type used to store offsets and connectivity.
+   * Use32BitStorage() and UseDefaultStorage() discard any existing cells
+   * and switch to vtkTypeInt32 and vtkIdType storage respectively. To switch
+   * while retaining the cells, use ConvertTo32BitStorage() and
+   * ConvertToDefaultStorage(). Converting to 32-bit storage fails (returning
+   * false) if the cell array contains ids or offsets that do not fit in a
+   * vtkTypeInt32; CanConvertTo32BitStorage() checks for this condition.
+   * Note that if vtkIdType is itself a 32-bit type, the default storage is
+   * already 32-bit and these methods have no effect.
+   */
+  void Use32BitStorage();
+  void UseDefaultStorage();
+  bool IsStorage32Bit()
+    {return this->Storage32Bit;}
+  bool CanConvertTo32BitStorage();
+  bool ConvertTo32BitStorage();
+  bool ConvertToDefaultStorage();
+  //@}
+
+  /**
+   * Get the number of cells in the array.
+   */
+  vtkIdType GetNumberOfCells()
+    {return this->Offsets->GetNumberOfTuples() - 1;}
+
+  /**
+   * Get the total number of point ids stored in the connectivity array.
+   */
+  vtkIdType GetNumberOfConnectivityIds()
+    {return this->Connectivity->GetNumberOfTuples();}
+
+  /**
+   * Return the offset of the first point id of the cell cellId into the
+   * connectivity array. Passing cellId == GetNumberOfCells() is valid and
+   * returns the connectivity size.
+   */
+  vtkIdType GetOffset(vtkIdType cellId);
+
+  /**
+   * Return the number of points defining the cell cellId.
+   */
+  vtkIdType GetCellSize(vtkIdType cellId)
+    {return this->GetOffset(cellId+1) - this->GetOffset(cellId);}
+
+  /**
+   * Return the point ids of the cell cellId in constant time. When the
+   * storage is vtkIdType based, pts points directly into the connectivity
+   * array and ptIds is left untouched; otherwise the ids are copied into
+   * ptIds and pts points into it. In either case pts remains valid until
+   * the cell array or ptIds are modified. This method does not change the
+   * state of the object and may be called concurrently from several threads
+   * as long as every thread supplies its own ptIds.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdType& npts, const vtkIdType* &pts,
+                   vtkIdList *ptIds);
+
+  /**
+   * Copy the point ids of the cell cellId into ptIds. Thread safe as long as
+   * ptIds is not shared between threads.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdList *ptIds);
+
+  /**
+   * Append a cell defined by npts point ids. Return the id of the new cell.
+   */
+  vtkIdType InsertNextCell(vtkIdType npts, const vtkIdType *pts);
+
+  /**
+   * Append a cell defined by the list of point ids. Return the id of the new
+   * cell.
+   */
+  vtkIdType InsertNextCell(vtkIdList *pts)
+    {return this->InsertNextCell(pts->GetNumberOfIds(), pts->GetPointer(0));}
+
+  /**
+   * Replace the point ids of the cell cellId. The new list must have the
+   * same number of points as the cell being replaced. As with
+   * vtkCellArray::ReplaceCell(), this does not mark the object as modified.
+   */
+  void ReplaceCellAtId(vtkIdType cellId, const vtkIdType *pts);
+
+  /**
+   * Reverse the ordering of the point ids of the cell cellId. Does not mark
+   * the object as modified.
+   */
+  void ReverseCellAtId(vtkIdType cellId);
+
+  /**
+   * Returns the size of the largest cell. The size is the number of points
+   * defining the cell. Evaluated in parallel with vtkSMPTools.
+   */
+  int GetMaxCellSize();
+
+  //@{
+  /**
+   * Set the offsets and connectivity arrays directly. Both arrays must be
+   * single component arrays holding either vtkIdType values (e.g.,
+   * vtkIdTypeArray) or vtkTypeInt32 values (e.g., vtkTypeInt32Array); the
+   * storage type is adjusted to match. The offsets
+   * array must contain (numberOfCells+1) monotonically increasing values
+   * starting at 0 and ending with the number of connectivity entries. The
+   * arrays are referenced, not copied. Returns false (leaving the cell array
+   * unchanged) if the arrays are not suitable.
+   */
+  bool SetData(vtkDataArray *offsets, vtkDataArray *connectivity);
+  vtkDataArray *GetOffsetsArray()
+    {return this->Offsets;}
+  vtkDataArray *GetConnectivityArray()
+    {return this->Connectivity;}
+  //@}
+
+  //@{
+  /**
+   * Convert from/to the legacy interleaved vtkCellArray layout. Importing
+   * replaces the current cells (retaining the storage type, the import
+   * fails if 32-bit storage is in use and the data does not fit).
+   * Exporting replaces the cells of the given vtkCellArray.
+   */
+  bool ImportLegacyFormat(vtkCellArray *cells);
+  void ExportLegacyFormat(vtkCellArray *cells);
+  //@}
+
+  /**
+   * Perform a deep copy (no reference counting) of the given cell array.
+   */
+  void DeepCopy(vtkCompactCellArray *ca);
+
+  /**
+   * Return the memory in kibibytes (1024 bytes) consumed by this cell array.
+   */
+  unsigned long GetActualMemorySize();
+
+protected:
+  vtkCompactCellArray();
+  ~vtkCompactCellArray() VTK_OVERRIDE;
+
+  // Both vtkIdTypeArray/vtkTypeInt32Array and any other array with a
+  // matching value type (e.g. vtkIntArray) derive from these.
+  typedef vtkAOSDataArrayTemplate<vtkIdType> IdArrayType;
+  typedef vtkAOSDataArrayTemplate<vtkTypeInt32> Int32ArrayType;
+
+  // Replace the internal arrays with new (empty) arrays of the requested
+  // storage type.
+  void ResetStorage(bool use32Bit);
+
+  bool Storage32Bit;
+  vtkDataArray *Offsets; // IdArrayType or Int32ArrayType
+  vtkDataArray *Connectivity; // same type as Offsets
+
+private:
+  vtkCompactCellArray(const vtkCompactCellArray&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkCompactCellArray&) VTK_DELETE_FUNCTION;
+};
+
+//----------------------------------------------------------------------------
+inline vtkIdType vtkCompactCellArray::GetOffset(vtkIdType cellId)
+{
+  if ( this->Storage32Bit )
+  {
+    return static_cast<vtkIdType>(
+      static_cast<Int32ArrayType*>(this->Offsets)->GetValue(cellId));
+  }
+  return static_cast<IdArrayType*>(this->Offsets)->GetValue(cellId);
+}
+
+//----------------------------------------------------------------------------
+inline void vtkCompactCellArray::GetCellAtId(vtkIdType cellId,
+                                             vtkIdType& npts,
+                                             const vtkIdType* &pts,
+                                             vtkIdList *ptIds)
+{
+  if ( this->Storage32Bit )
+  {
+    const vtkTypeInt32 *offsets =
+      static_cast<Int32ArrayType*>(this->Offsets)->GetPointer(0);
+    const vtkTypeInt32 *conn = static_cast<Int32ArrayType*>
+      (this->Connectivity)->GetPointer(offsets[cellId]);
+    npts = static_cast<vtkIdType>(offsets[cellId+1] - offsets[cellId]);
+    ptIds->SetNumberOfIds(npts);
+    vtkIdType *ids = ptIds->GetPointer(0);
+    for ( vtkIdType i=0; i < npts; ++i )
+    {
+      ids[i] = static_cast<vtkIdType>(conn[i]);
+    }
+    pts = ids;
+  }
+  else
+  {
+    const vtkIdType *offsets =
+      static_cast<IdArrayType*>(this->Offsets)->GetPointer(0);
+    npts = offsets[cellId+1] - offsets[cellId];
+    pts = static_cast<IdArrayType*>
+      (this->Connectivity)->GetPointer(offsets[cellId]);
+  }
+}
+
+//----------------------------------------------------------------------------
+inline void vtkCompactCellArray::GetCellAtId(vtkIdType cellId,
+                                             vtkIdList *ptIds)
+{
+  vtkIdType npts;
+  const vtkIdType *pts;
+  this->GetCellAtId(cellId, npts, pts, ptIds);
+  if ( !this->Storage32Bit )
+  {
+    ptIds->SetNumberOfIds(npts);
+    std::copy(pts, pts+npts, ptIds->GetPointer(0));
+  }
+}
+
+#endif
@@ -160,6 +160,7 @@ public:
    * Topological inquiry to get points defining cell.
    * THIS METHOD IS THREAD SAFE IF FIRST CALLED FROM A SINGLE THREAD AND
    * THE DATASET IS NOT MODIFIED
+   * For allocation-free access from multiple threads see vtkCellPointsCursor.
    */
   virtual void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds) = 0;
 
@@ -947,6 +947,179 @@ void vtkDataSetAttributes::InterpolateTime(vtkDataSetAttributes *from1,
   }
 }
 
+//----------------------------------------------------------------------------
+namespace {
+struct CopyBatchWorker
+{
+  vtkIdType DstStart;
+  vtkIdType N;
+  const vtkIdType *FromIds;
+
+  CopyBatchWorker(vtkIdType dstStart, vtkIdType n, const vtkIdType *fromIds)
+    : DstStart(dstStart), N(n), FromIds(fromIds)
+  {}
+
+  template <typename Array1T, typename Array2T>
+  void operator()(Array1T *dest, Array2T *src)
+  {
+    VTK_ASSUME(src->GetNumberOfComponents() == dest->GetNumberOfComponents());
+
+    vtkDataArrayAccessor<Array1T> d(dest);
+    vtkDataArrayAccessor<Array2T> s(src);
+
+    const int numComps = dest->GetNumberOfComponents();
+    for (vtkIdType i = 0; i < this->N; ++i)
+    {
+      const vtkIdType inTupleIdx = this->FromIds[i];
+      const vtkIdType outTupleIdx = this->DstStart + i;
+      for (int comp = 0; comp < numComps; ++comp)
+      {
+        d.Set(outTupleIdx, comp, s.Get(inTupleIdx, comp));
+      }
+    }
+  }
+};
+
+struct InterpolateEdgeBatchWorker
+{
+  vtkIdType DstStart;
+  vtkIdType N;
+  const vtkIdType *Edges;
+  const double *T;
+  bool NearestNeighbor;
+
+  InterpolateEdgeBatchWorker(vtkIdType dstStart, vtkIdType n,
+                             const vtkIdType *edges, const double *t,
+                             bool nearestNeighbor)
+    : DstStart(dstStart), N(n), Edges(edges), T(t),
+      NearestNeighbor(nearestNeighbor)
+  {}
+
+  template <typename Array1T, typename Array2T>
+  void operator()(Array1T *dest, Array2T *src)
+  {
+    VTK_ASSUME(src->GetNumberOfComponents() == dest->GetNumberOfComponents());
+
+    typedef typename vtkDataArrayAccessor<Array1T>::APIType ValueType;
+    vtkDataArrayAccessor<Array1T> d(dest);
+    vtkDataArrayAccessor<Array2T> s(src);
+
+    const int numComps = dest->GetNumberOfComponents();
+    for (vtkIdType i = 0; i < this->N; ++i)
+    {
+      const vtkIdType p1 = this->Edges[2*i];
+      const vtkIdType p2 = this->Edges[2*i+1];
+      const double t = this->T[i];
+      const vtkIdType outTupleIdx = this->DstStart + i;
+      if (this->NearestNeighbor)
+      {
+        const vtkIdType inTupleIdx = t < .5 ? p1 : p2;
+        for (int comp = 0; comp < numComps; ++comp)
+        {
+          d.Set(outTupleIdx, comp, s.Get(inTupleIdx, comp));
+        }
+        continue;
+      }
+      // Same arithmetic as vtkGenericDataArray::InterpolateTuple()
+      const double oneMinusT = 1. - t;
+      for (int comp = 0; comp < numComps; ++comp)
+      {
+        double val = s.Get(p1, comp) * oneMinusT + s.Get(p2, comp) * t;
+        ValueType valT;
+        vtkMath::RoundDoubleToIntegralIfNecessary(val, &valT);
+        d.Set(outTupleIdx, comp, valT);
+      }
+    }
+  }
+};
+} // end anon namespace
+
+//--------------------------------------------------------------------------
+void vtkDataSetAttributes::SetNumberOfAllocatedTuples(vtkIdType numTuples)
+{
+  vtkFieldData::BasicIterator required(this->RequiredArrays);
+  for (int i = required.BeginIndex(); !required.End();
+       i = required.NextIndex())
+  {
+    this->Data[this->TargetIndices[i]]->SetNumberOfTuples(numTuples);
+  }
+}
+
+//--------------------------------------------------------------------------
+// The required arrays are traversed with a local iterator, so that several
+// threads may process the same attributes.
+void vtkDataSetAttributes::CopyBatch(vtkDataSetAttributes *fromPd,
+                                     vtkIdType dstStart, vtkIdType n,
+                                     const vtkIdType *fromIds)
+{
+  vtkFieldData::BasicIterator required(this->RequiredArrays);
+  for (int i = required.BeginIndex(); !required.End();
+       i = required.NextIndex())
+  {
+    vtkAbstractArray *fromArray = fromPd->Data[i];
+    vtkAbstractArray *toArray = this->Data[this->TargetIndices[i]];
+    vtkDataArray *fromDA = vtkArrayDownCast<vtkDataArray>(fromArray);
+    vtkDataArray *toDA = vtkArrayDownCast<vtkDataArray>(toArray);
+    if (!fromDA || !toDA) // String array, etc
+    {
+      for (vtkIdType j = 0; j < n; ++j)
+      {
+        toArray->SetTuple(dstStart + j, fromIds[j], fromArray);
+      }
+      continue;
+    }
+
+    CopyBatchWorker worker(dstStart, n, fromIds);
+    if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(toDA, fromDA,
+                                                           worker))
+    {
+      // Fallback to vtkDataArray API (e.g. vtkBitArray):
+      worker(toDA, fromDA);
+    }
+  }
+}
+
+//--------------------------------------------------------------------------
+void vtkDataSetAttributes::InterpolateEdgeBatch(vtkDataSetAttributes *fromPd,
+                                                vtkIdType dstStart,
+                                                vtkIdType n,
+                                                const vtkIdType *edges,
+                                                const double *t)
+{
+  vtkFieldData::BasicIterator required(this->RequiredArrays);
+  for (int i = required.BeginIndex(); !required.End();
+       i = required.NextIndex())
+  {
+    vtkAbstractArray *fromArray = fromPd->Data[i];
+    vtkAbstractArray *toArray = this->Data[this->TargetIndices[i]];
+
+    //check if the destination array needs nearest neighbor interpolation
+    int attributeIndex = this->IsArrayAnAttribute(this->TargetIndices[i]);
+    bool nearestNeighbor = attributeIndex != -1 &&
+      this->CopyAttributeFlags[INTERPOLATE][attributeIndex] == 2;
+
+    vtkDataArray *fromDA = vtkArrayDownCast<vtkDataArray>(fromArray);
+    vtkDataArray *toDA = vtkArrayDownCast<vtkDataArray>(toArray);
+    if (!fromDA || !toDA) // String array, etc: the closest tuple is taken
+    {
+      for (vtkIdType j = 0; j < n; ++j)
+      {
+        toArray->SetTuple(dstStart + j,
+                          t[j] < .5 ? edges[2*j] : edges[2*j+1], fromArray);
+      }
+      continue;
+    }
+
+    InterpolateEdgeBatchWorker worker(dstStart, n, edges, t, nearestNeighbor);
+    if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(toDA, fromDA,
+                                                           worker))
+    {
+      // Fallback to vtkDataArray API (e.g. vtkBitArray):
+      worker(toDA, fromDA);
+    }
+  }
+}
+
 //--------------------------------------------------------------------------
 // Copy a tuple of data from one data array to another. This method (and
 // following ones) assume that the fromData and toData objects are of the
@@ -530,6 +530,39 @@ public:
                        vtkDataSetAttributes *from2,
                        vtkIdType id, double t);
 
+  // -- batched operations ------------------------------------------------
+
+  /**
+   * Set the number of tuples of the arrays allocated by the last call to
+   * CopyAllocate() or InterpolateAllocate(), so that the batched operations
+   * below can assign their tuples in place. The other arrays are left as
+   * they are.
+   */
+  void SetNumberOfAllocatedTuples(vtkIdType numTuples);
+
+  /**
+   * Copy the tuples fromIds[0], ..., fromIds[n-1] of fromPd to the n
+   * consecutive tuples starting at dstStart. The copy rules are those of
+   * CopyData(). The typed loop of each data array is dispatched once, with
+   * vtkArrayDispatch. The output tuples are assigned, not inserted: call
+   * SetNumberOfAllocatedTuples() first. Different threads may then copy
+   * to disjoint ranges of tuples, except for bit arrays.
+   */
+  void CopyBatch(vtkDataSetAttributes *fromPd, vtkIdType dstStart,
+                 vtkIdType n, const vtkIdType *fromIds);
+
+  /**
+   * Interpolate n edges of fromPd, as InterpolateEdge() does, to the n
+   * consecutive tuples starting at dstStart. Edge i is made of the tuples
+   * edges[2*i] and edges[2*i+1], with the interpolation factor t[i]. As
+   * with CopyBatch(), the typed loop of each data array is dispatched once,
+   * the output tuples are assigned in place and different threads may
+   * interpolate to disjoint ranges of tuples, except for bit arrays.
+   */
+  void InterpolateEdgeBatch(vtkDataSetAttributes *fromPd, vtkIdType dstStart,
+                            vtkIdType n, const vtkIdType *edges,
+                            const double *t);
+
   class FieldList;
 
   // field list copy operations ------------------------------------------
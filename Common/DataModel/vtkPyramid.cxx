@@ -457,6 +457,12 @@ void vtkPyramid::Contour(double value, vtkDataArray *cellScalars,
   }
 }
 
+//----------------------------------------------------------------------------
+int *vtkPyramid::GetTriangleCases(int caseId)
+{
+  return triCases[caseId].edges;
+}
+
 //----------------------------------------------------------------------------
 int *vtkPyramid::GetEdgeArray(int edgeId)
 {
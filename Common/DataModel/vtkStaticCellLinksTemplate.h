@@ -38,6 +38,12 @@
  * although it uses vtkIdType and thereby loses some speed and memory
  * advantage.
  *
+ * The links of vtkPolyData and vtkUnstructuredGrid are built in parallel
+ * with vtkSMPTools: the uses of each point are counted with atomics, a
+ * prefix sum gives the offsets, and the cell ids are then inserted
+ * concurrently. The cell ids of each point are sorted in ascending order,
+ * so the result does not depend on the number of threads.
+ *
  * @sa
  * vtkCellLinks vtkStaticCellLinks
 */
@@ -49,7 +55,7 @@ class vtkDataSet;
 class vtkPolyData;
 class vtkUnstructuredGrid;
 class vtkCellArray;
-
+class vtkCellLinks;
 
 template <typename TIds>
 class vtkStaticCellLinksTemplate
@@ -106,6 +112,10 @@ public:
   }
 
 protected:
+  // Count, offset and insert the links of the cells of ds in parallel.
+  // LinksSize must be set; Links and Offsets must be allocated.
+  void ThreadedBuildLinks(vtkDataSet *ds);
+
   // The various templated data members
   TIds LinksSize;
   TIds NumPts;
@@ -116,6 +126,9 @@ protected:
   TIds *Offsets; //offsets for each point into the link array
 
 private:
+  // vtkCellLinks takes over the links it builds through this class
+  friend class vtkCellLinks;
+
   vtkStaticCellLinksTemplate(const vtkStaticCellLinksTemplate&) VTK_DELETE_FUNCTION;
   void operator=(const vtkStaticCellLinksTemplate&) VTK_DELETE_FUNCTION;
 
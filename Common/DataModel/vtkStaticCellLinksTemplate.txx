@@ -18,15 +18,108 @@
 #define vtkStaticCellLinksTemplate_txx
 
 #include "vtkCellArray.h"
+#include "vtkCellPointsCursor.h"
 #include "vtkDataSet.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+
 //----------------------------------------------------------------------------
-// Note: this class is a faster, serial version of vtkCellLinks. Future work
-// to parallelize this class is possible. This includes:
-// = using a parallel prefix sum operation
-// = using atomics to update counts (i.e., number of cells using a point)
+// Functors building the links of vtkPolyData and vtkUnstructuredGrid in
+// parallel. The cells are visited through thread local cursors.
+
+// Count the number of cells using each point
+template <typename TIds>
+struct vtkStaticCellLinksCountUses
+{
+  vtkSMPThreadLocal<vtkCellPointsCursor> Cursors;
+  vtkAtomic<TIds> *Counts;
+
+  vtkStaticCellLinksCountUses(const vtkCellPointsCursor &cursor,
+                              vtkAtomic<TIds> *counts) :
+    Cursors(cursor), Counts(counts)
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkCellPointsCursor &cursor = this->Cursors.Local();
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      vtkIdType npts = cursor.GetCellPoints(cellId, pts);
+      for (vtkIdType i=0; i < npts; ++i)
+      {
+        ++this->Counts[pts[i]];
+      }
+    }
+  }
+};
+
+// Turn the counts into insertion positions, starting at the offsets
+template <typename TIds>
+struct vtkStaticCellLinksStartPositions
+{
+  const TIds *Offsets;
+  vtkAtomic<TIds> *Positions;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      this->Positions[ptId] = this->Offsets[ptId];
+    }
+  }
+};
+
+// Insert the cell ids in the runs of their points
+template <typename TIds>
+struct vtkStaticCellLinksInsertCells
+{
+  vtkSMPThreadLocal<vtkCellPointsCursor> Cursors;
+  vtkAtomic<TIds> *Positions;
+  TIds *Links;
+
+  vtkStaticCellLinksInsertCells(const vtkCellPointsCursor &cursor,
+                                vtkAtomic<TIds> *positions, TIds *links) :
+    Cursors(cursor), Positions(positions), Links(links)
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkCellPointsCursor &cursor = this->Cursors.Local();
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      vtkIdType npts = cursor.GetCellPoints(cellId, pts);
+      for (vtkIdType i=0; i < npts; ++i)
+      {
+        this->Links[this->Positions[pts[i]]++] = static_cast<TIds>(cellId);
+      }
+    }
+  }
+};
+
+// Sort the runs, whose order depends on the scheduling of the threads
+template <typename TIds>
+struct vtkStaticCellLinksSortRuns
+{
+  const TIds *Offsets;
+  TIds *Links;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      std::sort(this->Links + this->Offsets[ptId],
+                this->Links + this->Offsets[ptId+1]);
+    }
+  }
+};
 
 //----------------------------------------------------------------------------
 // Clean up any previously allocated memory
@@ -118,6 +211,48 @@ BuildLinks(vtkDataSet *ds)
   cellPts->Delete();
 }
 
+//----------------------------------------------------------------------------
+// Build the link list array of the cells of ds in parallel.
+template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
+ThreadedBuildLinks(vtkDataSet *ds)
+{
+  this->Links[this->LinksSize] = this->NumPts;
+  this->Offsets[this->NumPts] = this->LinksSize;
+  if ( this->NumPts < 1 )
+  {
+    return;
+  }
+
+  // The cursor prepares the access to the cells in this thread
+  vtkCellPointsCursor cursor(ds);
+
+  // Count number of point uses
+  vtkAtomic<TIds> *counts = new vtkAtomic<TIds>[this->NumPts];
+  vtkStaticCellLinksCountUses<TIds> countUses(cursor, counts);
+  vtkSMPTools::For(0, this->NumCells, countUses);
+
+  // Perform prefix sum
+  vtkSMPTools::ExclusiveScan(counts, counts + this->NumPts, this->Offsets,
+                             static_cast<TIds>(0));
+
+  // Now build the links. The cells of a point are inserted from the
+  // beginning of its run, the counts being reused as insertion positions.
+  vtkStaticCellLinksStartPositions<TIds> startPositions =
+    { this->Offsets, counts };
+  vtkSMPTools::For(0, this->NumPts, startPositions);
+  vtkStaticCellLinksInsertCells<TIds> insertCells(cursor, counts,
+                                                  this->Links);
+  vtkSMPTools::For(0, this->NumCells, insertCells);
+  delete [] counts;
+
+  // A single thread inserts the cells in order
+  if ( vtkSMPTools::GetEstimatedNumberOfThreads() > 1 )
+  {
+    vtkStaticCellLinksSortRuns<TIds> sortRuns = { this->Offsets, this->Links };
+    vtkSMPTools::For(0, this->NumPts, sortRuns);
+  }
+}
+
 //----------------------------------------------------------------------------
 // Build the link list array for unstructured grids
 template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
@@ -127,62 +262,22 @@ BuildLinks(vtkUnstructuredGrid *ugrid)
   this->NumCells = ugrid->GetNumberOfCells();
   this->NumPts = ugrid->GetNumberOfPoints();
 
-  // We're going to get into the guts of the class
-  vtkCellArray *cellArray = ugrid->GetCells();
-  const vtkIdType *cells = cellArray->GetPointer();
-
   // I love this trick: the size of the Links array is equal to
   // the size of the cell array, minus the number of cells.
-  this->LinksSize =
-    cellArray->GetNumberOfConnectivityEntries() - this->NumCells;
+  vtkCellArray *cellArray = ugrid->GetCells();
+  this->LinksSize = ( cellArray == NULL ? 0 :
+    cellArray->GetNumberOfConnectivityEntries() - this->NumCells );
 
   // Extra one allocated to simplify later pointer manipulation
   this->Links = new TIds[this->LinksSize+1];
-  this->Links[this->LinksSize] = this->NumPts;
   this->Offsets = new TIds[this->NumPts+1];
-  std::fill_n(this->Offsets, this->NumPts, 0);
-
-  // Now create the links.
-  vtkIdType npts, cellId, ptId;
-  const vtkIdType *cell=cells;
-  int i;
 
-  // Count number of point uses
-  for ( cellId=0; cellId < this->NumCells; ++cellId )
-  {
-    npts = *cell++;
-    for (i=0; i<npts; ++i)
-    {
-      this->Offsets[*cell++]++;
-    }
-  }
-
-  // Perform prefix sum
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
-  {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
-  }
-
-  // Now build the links. The summation from the prefix sum indicates where
-  // the cells are to be inserted. Each time a cell is inserted, the offset
-  // is decremented. In the end, the offset array is also constructed as it
-  // points to the beginning of each cell run.
-  for ( cell=cells, cellId=0; cellId < this->NumCells; ++cellId )
-  {
-    npts = *cell++;
-    for (i=0; i<npts; ++i)
-    {
-      this->Offsets[*cell]--;
-      this->Links[this->Offsets[*cell++]] = cellId;
-    }
-  }
-  this->Offsets[this->NumPts] = this->LinksSize;
+  this->ThreadedBuildLinks(ugrid);
 }
 
 //----------------------------------------------------------------------------
-// Build the link list array for poly data. This is more complex because there
-// are potentially fout different cell arrays to contend with.
+// Build the link list array for poly data. The cells of the four cell
+// arrays are visited through the cell ids of the polydata.
 template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
 BuildLinks(vtkPolyData *pd)
 {
@@ -191,83 +286,26 @@ BuildLinks(vtkPolyData *pd)
   this->NumPts = pd->GetNumberOfPoints();
 
   vtkCellArray *cellArrays[4];
-  vtkIdType numCells[4];
-  vtkIdType sizes[4];
-  int i, j;
-
   cellArrays[0] = pd->GetVerts();
   cellArrays[1] = pd->GetLines();
   cellArrays[2] = pd->GetPolys();
   cellArrays[3] = pd->GetStrips();
 
-  for (i=0; i<4; ++i)
+  this->LinksSize = 0;
+  for (int i=0; i<4; ++i)
   {
     if ( cellArrays[i] != NULL )
     {
-      numCells[i] = cellArrays[i]->GetNumberOfCells();
-      sizes[i] = cellArrays[i]->GetNumberOfConnectivityEntries() - numCells[i];
-    }
-    else
-    {
-      numCells[i] = 0;
-      sizes[i] = 0;
+      this->LinksSize += cellArrays[i]->GetNumberOfConnectivityEntries() -
+        cellArrays[i]->GetNumberOfCells();
     }
   }//for the four polydata arrays
 
   // Allocate
-  this->LinksSize = sizes[0] + sizes[1] + sizes[2] + sizes[3];
   this->Links = new TIds[this->LinksSize+1];
-  this->Links[this->LinksSize] = this->NumPts;
   this->Offsets = new TIds[this->NumPts+1];
-  this->Offsets[this->NumPts] = this->LinksSize;
-  std::fill_n(this->Offsets, this->NumPts, 0);
-
-  // Now create the links.
-  vtkIdType npts, cellId, CellId, ptId;
-  const vtkIdType *cell;
-
-  // Visit the four arrays
-  for ( CellId=0, j=0; j < 4; ++j )
-  {
-    // Count number of point uses
-    cell = cellArrays[j]->GetPointer();
-    for ( cellId=0; cellId < numCells[j]; ++cellId )
-    {
-      npts = *cell++;
-      for (i=0; i<npts; ++i)
-      {
-        this->Offsets[CellId+(*cell++)]++;
-      }
-    }
-    CellId += numCells[j];
-  } //for each of the four polydata cell arrays
-
-  // Perform prefix sum
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
-  {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
-  }
 
-  // Now build the links. The summation from the prefix sum indicates where
-  // the cells are to be inserted. Each time a cell is inserted, the offset
-  // is decremented. In the end, the offset array is also constructed as it
-  // points to the beginning of each cell run.
-  for ( CellId=0, j=0; j < 4; ++j )
-  {
-    cell = cellArrays[j]->GetPointer();
-    for ( cellId=0; cellId < numCells[j]; ++cellId )
-    {
-      npts = *cell++;
-      for (i=0; i<npts; ++i)
-      {
-        this->Offsets[*cell]--;
-        this->Links[this->Offsets[*cell++]] = CellId+cellId;
-      }
-    }
-    CellId += numCells[j];
-  }//for each of the four polydata arrays
-  this->Offsets[this->NumPts] = this->LinksSize;
+  this->ThreadedBuildLinks(pd);
 }
 
 #endif
@@ -484,7 +484,9 @@ public:
                                          double inputDataLength, double& dist2);
   void FindClosestNPoints(int N, const double x[3], vtkIdList *result);
   void FindPointsWithinRadius(double R, const double x[3], vtkIdList *result);
+  vtkIdType FindLowestPointWithinRadius(double R, const double x[3]);
   void GenerateRepresentation(int vtkNotUsed(level), vtkPolyData *pd);
+  void MergePoints(double tol, vtkIdType *mergeMap);
 
   // Internal methods
   void GetOverlappingBuckets(NeighborBuckets* buckets, const double x[3],
@@ -615,6 +617,33 @@ public:
       }//operator()
   };
 
+  // Find for each point the lowest id point within the merging tolerance.
+  // Since the point itself is found, the id is never larger than its own.
+  template <typename T>
+  class MergeMapper
+  {
+    public:
+      BucketList<T> *BList;
+      double Tol;
+      vtkIdType *MergeMap;
+
+      MergeMapper(BucketList<T> *blist, double tol, vtkIdType *mergeMap) :
+        BList(blist), Tol(tol), MergeMap(mergeMap)
+      {
+      }
+
+      void  operator()(vtkIdType ptId, vtkIdType end)
+      {
+        double p[3];
+        for ( ; ptId < end; ++ptId )
+        {
+          this->BList->DataSet->GetPoint(ptId,p);
+          this->MergeMap[ptId] =
+            this->BList->FindLowestPointWithinRadius(this->Tol,p);
+        }//for all points in this batch
+      }
+  };
+
   // Build the map and other structures to support locator operations
   void BuildLocator() VTK_OVERRIDE
   {
@@ -1108,6 +1137,87 @@ FindPointsWithinRadius(double R, const double x[3], vtkIdList *result)
   }//k-footprint
 }
 
+//-----------------------------------------------------------------------------
+// Return the lowest id of the points within radius R of position x. With a
+// zero radius only the bucket containing x is visited, and only the points
+// coincident with x are considered.
+template <typename TIds> vtkIdType BucketList<TIds>::
+FindLowestPointWithinRadius(double R, const double x[3])
+{
+  double pt[3];
+  vtkIdType ptId, cno, numIds, lowest = -1;
+  double R2 = R*R;
+  const LocatorTuple<TIds> *ids;
+  double xMin[3], xMax[3];
+  int i, j, k, ii, jOffset, kOffset, ijkMin[3], ijkMax[3];
+
+  // Determine the range of indices in each direction based on radius R
+  xMin[0] = x[0] - R;
+  xMin[1] = x[1] - R;
+  xMin[2] = x[2] - R;
+  xMax[0] = x[0] + R;
+  xMax[1] = x[1] + R;
+  xMax[2] = x[2] + R;
+
+  //  Find the footprint in the locator
+  this->GetBucketIndices(xMin, ijkMin);
+  this->GetBucketIndices(xMax, ijkMax);
+
+  // Check the points within footprint and radius
+  for ( k=ijkMin[2]; k <= ijkMax[2]; ++k)
+  {
+    kOffset = k*this->xyD;
+    for ( j=ijkMin[1]; j <= ijkMax[1]; ++j)
+    {
+      jOffset = j*this->xD;
+      for ( i=ijkMin[0]; i <= ijkMax[0]; ++i)
+      {
+        cno = i + jOffset + kOffset;
+
+        if ( (numIds = this->GetNumberOfIds(cno)) > 0 )
+        {
+          ids = this->GetIds(cno);
+          for (ii=0; ii < numIds; ii++)
+          {
+            ptId = ids[ii].PtId;
+            if ( lowest >= 0 && ptId >= lowest )
+            {
+              continue;
+            }
+            this->DataSet->GetPoint(ptId, pt);
+            if ( vtkMath::Distance2BetweenPoints(x,pt) <= R2 )
+            {
+              lowest = ptId;
+            }
+          }//for all points in bucket
+        }//if points in bucket
+      }//i-footprint
+    }//j-footprint
+  }//k-footprint
+
+  return lowest;
+}
+
+//-----------------------------------------------------------------------------
+// Each point is first mapped in parallel to the lowest id point within
+// tolerance. Since that point has a lower id, a single ordered pass then
+// resolves the chains of merged points. Coincident points all map to the
+// same lowest id, so there are no chains with a zero tolerance.
+template <typename TIds> void BucketList<TIds>::
+MergePoints(double tol, vtkIdType *mergeMap)
+{
+  MergeMapper<TIds> mapper(this, tol, mergeMap);
+  vtkSMPTools::For(0, this->NumPts, mapper);
+
+  if ( tol > 0.0 )
+  {
+    for ( vtkIdType ptId=0; ptId < this->NumPts; ++ptId )
+    {
+      mergeMap[ptId] = mergeMap[mergeMap[ptId]];
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 // Internal method to find those buckets that are within distance specified
 // only those buckets outside of level radiuses of ijk are returned
@@ -1594,6 +1704,28 @@ FindPointsWithinRadius(double R, const double x[3], vtkIdList *result)
   }
 }
 
+//-----------------------------------------------------------------------------
+void vtkStaticPointLocator::
+MergePoints(double tol, vtkIdType *mergeMap)
+{
+  this->BuildLocator(); // will subdivide if modified; otherwise returns
+  if ( !this->Buckets )
+  {
+    return;
+  }
+
+  if ( this->LargeIds )
+  {
+    static_cast<BucketList<vtkIdType>*>(this->Buckets)->
+      MergePoints(tol,mergeMap);
+  }
+  else
+  {
+    static_cast<BucketList<int>*>(this->Buckets)->
+      MergePoints(tol,mergeMap);
+  }
+}
+
 //-----------------------------------------------------------------------------
 void vtkStaticPointLocator::
 GenerateRepresentation(int level, vtkPolyData *pd)
@@ -144,6 +144,20 @@ public:
   void FindPointsWithinRadius(double R, const double x[3],
                               vtkIdList *result) VTK_OVERRIDE;
 
+  /**
+   * Merge the points of the dataset that lie within the tolerance tol of
+   * each other. The user must provide an array mergeMap of the size of the
+   * number of points, which on return gives for each point the id of the
+   * point it merges into (the point itself if it is kept). With a tolerance
+   * of zero only coincident points are merged, into the one with the lowest
+   * id. Otherwise a point merges into the same point as the lowest id point
+   * within tolerance; note that such chains of merged points may span more
+   * than the tolerance. The points are processed in parallel, and the result
+   * does not depend on the number of threads. This method builds the locator
+   * if needed.
+   */
+  void MergePoints(double tol, vtkIdType *mergeMap);
+
   //@{
   /**
    * See vtkLocator and vtkAbstractPointLocator interface documentation.
@@ -228,19 +228,35 @@ int vtkStructuredData::SetExtent(int inExt[6], int ext[6])
 // Get the points defining a cell. (See vtkDataSet for more info.)
 void vtkStructuredData::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds,
                                       int dataDescription, int dim[3])
+{
+  vtkIdType pts[8];
+  vtkIdType npts =
+    vtkStructuredData::GetCellPoints(cellId, pts, dataDescription, dim);
+
+  ptIds->SetNumberOfIds(npts);
+  for (vtkIdType i=0; i < npts; i++)
+  {
+    ptIds->SetId(i, pts[i]);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the points defining a cell into a buffer of (at least) eight ids.
+vtkIdType vtkStructuredData::GetCellPoints(vtkIdType cellId, vtkIdType *ptIds,
+                                           int dataDescription,
+                                           const int dim[3])
 {
   int loc[3];
   vtkIdType idx, npts;
   int iMin, iMax, jMin, jMax, kMin, kMax;
   vtkIdType d01 = static_cast<vtkIdType>(dim[0])*dim[1];
 
-  ptIds->Reset();
   iMin = iMax = jMin = jMax = kMin = kMax = 0;
 
   switch (dataDescription)
   {
     case VTK_EMPTY:
-      return;
+      return 0;
 
     case VTK_SINGLE_POINT: // cellId can only be = 0
       break;
@@ -302,10 +318,12 @@ void vtkStructuredData::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds,
       for (loc[0]=iMin; loc[0]<=iMax; loc[0]++)
       {
         idx = loc[0] + loc[1]*static_cast<vtkIdType>(dim[0]) + loc[2]*d01;
-        ptIds->InsertId(npts++,idx);
+        ptIds[npts++] = idx;
       }
     }
   }
+
+  return npts;
 }
 
 //------------------------------------------------------------------------------
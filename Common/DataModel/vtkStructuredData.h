@@ -148,6 +148,15 @@ public:
   static void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds,
                             int dataDescription, int dim[3]);
 
+  /**
+   * Get the points defining a cell into a caller-provided buffer which must
+   * be able to hold at least eight ids. Returns the number of points. This
+   * method neither allocates memory nor touches shared state, so it is safe
+   * to call from multiple threads.
+   */
+  static vtkIdType GetCellPoints(vtkIdType cellId, vtkIdType *ptIds,
+                                 int dataDescription, const int dim[3]);
+
   /**
    * Get the cells using a point. (See vtkDataSet for more info.)
    */
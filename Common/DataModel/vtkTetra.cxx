@@ -327,6 +327,12 @@ void vtkTetra::Contour(double value, vtkDataArray *cellScalars,
   }
 }
 
+//----------------------------------------------------------------------------
+int *vtkTetra::GetTriangleCases(int caseId)
+{
+  return triCases[caseId].edges;
+}
+
 //----------------------------------------------------------------------------
 int *vtkTetra::GetEdgeArray(int edgeId)
 {
@@ -186,6 +186,14 @@ public:
   static int *GetFaceArray(int faceId);
   //@}
 
+  /**
+   * Return the case table used by Contour(): for the case caseId (the
+   * cell points whose scalar is at or above the contour value, as a bit
+   * mask), the edges of the triangles, three edge ids each, terminated by
+   * -1. Edge ids are those of GetEdgeArray().
+   */
+  static int *GetTriangleCases(int caseId);
+
 protected:
   vtkTetra();
   ~vtkTetra() VTK_OVERRIDE;
@@ -452,6 +452,12 @@ void vtkWedge::Contour(double value, vtkDataArray *cellScalars,
   }
 }
 
+//----------------------------------------------------------------------------
+int *vtkWedge::GetTriangleCases(int caseId)
+{
+  return triCases[caseId].edges;
+}
+
 //----------------------------------------------------------------------------
 int *vtkWedge::GetEdgeArray(int edgeId)
 {
@@ -86,6 +86,7 @@ public:
   {
     vtkIdType i = static_cast<vtkIdType>(
       static_cast<double>(this->Dim) * (value - this->SMin) / this->Range);
+    i = ( i < 0 ? 0 : (i >= this->Dim ? this->Dim-1 : i));
 
     rMin[0] = 0; //xmin on rectangle left boundary
     rMin[1] = i; //ymin on rectangle bottom
@@ -432,7 +433,7 @@ vtkIdType vtkSpanSpace::GetNumberOfCellBatches()
     }
   }//for all rows in span rectangle
 
-  // Watch for boundary conditions. Return 10 cells to a batch.
+  // Watch for boundary conditions. Return BatchSize cells to a batch.
   if ( this->SpanSpace->NumCandidates < 1 )
   {
     return 0;
@@ -451,7 +452,7 @@ GetCellBatch(vtkIdType batchNum, vtkIdType& numCells)
   // Make sure that everything is hunky dory
   vtkIdType pos = batchNum * this->BatchSize;
   if ( this->SpanSpace->NumCells < 1 || ! this->SpanSpace->CandidateCells ||
-       pos > this->SpanSpace->NumCandidates )
+       pos >= this->SpanSpace->NumCandidates )
   {
     numCells = 0;
     return NULL;
@@ -475,4 +476,5 @@ void vtkSpanSpace::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "Resolution: " << this->Resolution << "\n" ;
+  os << indent << "Batch Size: " << this->BatchSize << "\n" ;
 }
@@ -77,6 +77,16 @@ public:
   vtkGetMacro(Resolution,vtkIdType);
   //@}
 
+  //@{
+  /**
+   * Set/Get the number of cells in the batches returned by GetCellBatch().
+   * Larger batches reduce the scheduling overhead of the parallel
+   * traversals. By default BatchSize = 10.
+   */
+  vtkSetClampMacro(BatchSize,vtkIdType,1,VTK_INT_MAX);
+  vtkGetMacro(BatchSize,vtkIdType);
+  //@}
+
   //----------------------------------------------------------------------
   // The following methods satisfy the vtkScalarTree abstract API.
 
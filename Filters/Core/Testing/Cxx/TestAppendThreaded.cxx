@@ -0,0 +1,371 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestAppendThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded vtkAppendPolyData and vtkAppendFilter produce the
+// same points, cells and arrays as the serial ones, for many blocks of
+// different types, and that a single non-empty input is shallow copied.
+
+#include "vtkAppendFilter.h"
+#include "vtkAppendPolyData.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStringArray.h"
+#include "vtkTestDataComparison.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+// Point and cell arrays common to all the blocks: scalars, unnamed normals,
+// a field array and a string array
+void AddArrays(vtkDataSet *block, int seed)
+{
+  vtkIdType numPts = block->GetNumberOfPoints();
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkFloatArray> normals;
+  normals->SetNumberOfComponents(3);
+  vtkNew<vtkStringArray> labels;
+  labels->SetName("Labels");
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    scalars->InsertNextValue(seed + 0.25 * i);
+    normals->InsertNextTuple3(seed, i, -i);
+    std::ostringstream label;
+    label << seed << "-" << i;
+    labels->InsertNextValue(label.str());
+  }
+  block->GetPointData()->SetScalars(scalars.GetPointer());
+  block->GetPointData()->SetNormals(normals.GetPointer());
+  block->GetPointData()->AddArray(labels.GetPointer());
+
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("Ids");
+  ids->SetNumberOfComponents(2);
+  for (vtkIdType i = 0; i < block->GetNumberOfCells(); ++i)
+  {
+    ids->InsertNextTuple2(seed, i);
+  }
+  block->GetCellData()->AddArray(ids.GetPointer());
+}
+
+// A strip of quads with vertices, a polyline and a triangle strip
+vtkSmartPointer<vtkPolyData> MakePolyData(int seed, int n, int pointsType)
+{
+  vtkSmartPointer<vtkPolyData> block = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  points->SetDataType(pointsType);
+  for (int i = 0; i <= n; ++i)
+  {
+    points->InsertNextPoint(seed + i, 0.0, 0.1 * seed);
+    points->InsertNextPoint(seed + i, 1.0, 0.1 * seed);
+  }
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+  for (int i = 0; i < n; ++i)
+  {
+    vtkIdType quad[4] = { 2 * i, 2 * i + 2, 2 * i + 3, 2 * i + 1 };
+    polys->InsertNextCell(4, quad);
+    if (i % 3 == seed % 3)
+    {
+      verts->InsertNextCell(1, quad);
+    }
+  }
+  lines->InsertNextCell(n + 1);
+  strips->InsertNextCell(2 * (n + 1));
+  for (int i = 0; i <= n; ++i)
+  {
+    lines->InsertCellPoint(2 * i);
+    strips->InsertCellPoint(2 * i);
+    strips->InsertCellPoint(2 * i + 1);
+  }
+  block->SetPoints(points.GetPointer());
+  block->SetVerts(verts.GetPointer());
+  block->SetLines(lines.GetPointer());
+  block->SetPolys(polys.GetPointer());
+  if (seed % 2)
+  {
+    block->SetStrips(strips.GetPointer());
+  }
+  AddArrays(block, seed);
+  return block;
+}
+
+// A row of hexahedra and tetrahedra
+vtkSmartPointer<vtkUnstructuredGrid> MakeGrid(int seed, int n)
+{
+  vtkSmartPointer<vtkUnstructuredGrid> block =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  for (int i = 0; i <= n; ++i)
+  {
+    for (int c = 0; c < 4; ++c)
+    {
+      points->InsertNextPoint(seed + i, c % 2, c / 2);
+    }
+  }
+  block->SetPoints(points.GetPointer());
+  block->Allocate(2 * n);
+  for (int i = 0; i < n; ++i)
+  {
+    vtkIdType p = 4 * i;
+    vtkIdType hex[8] = { p, p + 1, p + 3, p + 2, p + 4, p + 5, p + 7, p + 6 };
+    block->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+    vtkIdType tetra[4] = { p, p + 1, p + 2, p + 4 };
+    block->InsertNextCell(VTK_TETRA, 4, tetra);
+  }
+  AddArrays(block, seed);
+  return block;
+}
+
+vtkSmartPointer<vtkImageData> MakeImage(int seed)
+{
+  vtkSmartPointer<vtkImageData> block = vtkSmartPointer<vtkImageData>::New();
+  block->SetDimensions(4, 3, 2);
+  block->SetOrigin(seed, 0.0, 0.0);
+  AddArrays(block, seed);
+  return block;
+}
+
+bool SamePolyData(vtkPolyData *serial, vtkPolyData *threaded)
+{
+  if (serial->GetNumberOfCells() < 10 ||
+      !vtkTest::SameArrays(serial->GetPoints()->GetData(),
+                           threaded->GetPoints()->GetData()) ||
+      !vtkTest::SameCells(serial->GetVerts(), threaded->GetVerts()) ||
+      !vtkTest::SameCells(serial->GetLines(), threaded->GetLines()) ||
+      !vtkTest::SameCells(serial->GetPolys(), threaded->GetPolys()) ||
+      !vtkTest::SameCells(serial->GetStrips(), threaded->GetStrips()))
+  {
+    cerr << "Error: different points or cells" << endl;
+    return false;
+  }
+  return vtkTest::SameAttributes(serial->GetPointData(),
+                                 threaded->GetPointData()) &&
+         vtkTest::SameAttributes(serial->GetCellData(),
+                                 threaded->GetCellData());
+}
+
+bool SameGrids(vtkUnstructuredGrid *serial, vtkUnstructuredGrid *threaded)
+{
+  if (serial->GetNumberOfCells() < 10 ||
+      !vtkTest::SameArrays(serial->GetPoints()->GetData(),
+                           threaded->GetPoints()->GetData()) ||
+      !vtkTest::SameArrays(serial->GetCellTypesArray(),
+                           threaded->GetCellTypesArray()) ||
+      !vtkTest::SameArrays(serial->GetCellLocationsArray(),
+                           threaded->GetCellLocationsArray()) ||
+      !vtkTest::SameCells(serial->GetCells(), threaded->GetCells()))
+  {
+    cerr << "Error: different points or cells" << endl;
+    return false;
+  }
+  return vtkTest::SameAttributes(serial->GetPointData(),
+                                 threaded->GetPointData()) &&
+         vtkTest::SameAttributes(serial->GetCellData(),
+                                 threaded->GetCellData());
+}
+
+bool TestAppendPolyData()
+{
+  vtkNew<vtkAppendPolyData> serial;
+  vtkNew<vtkAppendPolyData> threaded;
+  threaded->ThreadedOn();
+  vtkNew<vtkPolyData> empty;
+  for (int seed = 0; seed < 60; ++seed)
+  {
+    vtkSmartPointer<vtkPolyData> block =
+      MakePolyData(seed, 3 + seed % 7, seed % 5 ? VTK_FLOAT : VTK_DOUBLE);
+    serial->AddInputData(block);
+    threaded->AddInputData(block);
+    if (seed % 20 == 0)
+    {
+      serial->AddInputData(empty.GetPointer());
+      threaded->AddInputData(empty.GetPointer());
+    }
+  }
+  serial->Update();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Update();
+  });
+  if (!SamePolyData(serial->GetOutput(), threaded->GetOutput()))
+  {
+    cerr << "Error: vtkAppendPolyData" << endl;
+    return false;
+  }
+
+  // The output does not depend on the number of threads
+  vtkNew<vtkPolyData> reference;
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]()
+  {
+    threaded->Modified();
+    threaded->Update();
+  });
+  reference->DeepCopy(threaded->GetOutput());
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Modified();
+    threaded->Update();
+  });
+  if (!SamePolyData(reference.GetPointer(), threaded->GetOutput()))
+  {
+    cerr << "Error: vtkAppendPolyData with one thread" << endl;
+    return false;
+  }
+
+  // A single non-empty input is shallow copied, unless its points have to
+  // be converted
+  vtkSmartPointer<vtkPolyData> block = MakePolyData(1, 10, VTK_FLOAT);
+  vtkNew<vtkAppendPolyData> single;
+  single->ThreadedOn();
+  single->AddInputData(empty.GetPointer());
+  single->AddInputData(block);
+  single->Update();
+  if (single->GetOutput()->GetPoints() != block->GetPoints() ||
+      single->GetOutput()->GetPolys() != block->GetPolys())
+  {
+    cerr << "Error: vtkAppendPolyData single input not shallow copied"
+         << endl;
+    return false;
+  }
+  single->SetOutputPointsPrecision(vtkAlgorithm::DOUBLE_PRECISION);
+  single->Update();
+  if (single->GetOutput()->GetPoints()->GetDataType() != VTK_DOUBLE ||
+      single->GetOutput()->GetNumberOfCells() != block->GetNumberOfCells())
+  {
+    cerr << "Error: vtkAppendPolyData single input with double precision"
+         << endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestAppendFilter()
+{
+  vtkNew<vtkAppendFilter> serial;
+  vtkNew<vtkAppendFilter> threaded;
+  threaded->ThreadedOn();
+  vtkNew<vtkUnstructuredGrid> empty;
+  for (int seed = 0; seed < 60; ++seed)
+  {
+    vtkSmartPointer<vtkDataSet> block;
+    switch (seed % 3)
+    {
+      case 0:
+        block = MakeGrid(seed, 2 + seed % 5);
+        break;
+      case 1:
+        block = MakePolyData(seed, 3 + seed % 4, VTK_FLOAT);
+        break;
+      default:
+        block = MakeImage(seed);
+        break;
+    }
+    serial->AddInputData(block);
+    threaded->AddInputData(block);
+    if (seed % 25 == 0)
+    {
+      serial->AddInputData(empty.GetPointer());
+      threaded->AddInputData(empty.GetPointer());
+    }
+  }
+  serial->Update();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Update();
+  });
+  if (!SameGrids(serial->GetOutput(), threaded->GetOutput()))
+  {
+    cerr << "Error: vtkAppendFilter" << endl;
+    return false;
+  }
+
+  // The output does not depend on the number of threads
+  vtkNew<vtkUnstructuredGrid> reference;
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]()
+  {
+    threaded->Modified();
+    threaded->Update();
+  });
+  reference->DeepCopy(threaded->GetOutput());
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Modified();
+    threaded->Update();
+  });
+  if (!SameGrids(reference.GetPointer(), threaded->GetOutput()))
+  {
+    cerr << "Error: vtkAppendFilter with one thread" << endl;
+    return false;
+  }
+
+  // Merged points are appended serially
+  serial->MergePointsOn();
+  threaded->MergePointsOn();
+  serial->Update();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Update();
+  });
+  if (!SameGrids(serial->GetOutput(), threaded->GetOutput()))
+  {
+    cerr << "Error: vtkAppendFilter with merged points" << endl;
+    return false;
+  }
+
+  // A single non-empty unstructured grid is shallow copied
+  vtkSmartPointer<vtkUnstructuredGrid> block = MakeGrid(2, 10);
+  vtkNew<vtkAppendFilter> single;
+  single->ThreadedOn();
+  single->AddInputData(empty.GetPointer());
+  single->AddInputData(block);
+  single->Update();
+  if (single->GetOutput()->GetPoints() != block->GetPoints() ||
+      single->GetOutput()->GetCells() != block->GetCells())
+  {
+    cerr << "Error: vtkAppendFilter single input not shallow copied" << endl;
+    return false;
+  }
+  return true;
+}
+
+}
+
+int TestAppendThreaded(int, char *[])
+{
+  if (!TestAppendPolyData() || !TestAppendFilter())
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellDataToPointDataThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded vtkCellDataToPointData and vtkPointDataToCellData
+// produce the same attributes as the serial filters, for unstructured
+// grids, polydata and image data. The serial filter accumulates the cell
+// data of unstructured grids in the type of the arrays, so these are
+// compared with a tolerance.
+
+#include "vtkCellData.h"
+#include "vtkCellDataToPointData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointDataToCellData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataComparison.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+namespace
+{
+
+// Add a double vector, a float scalar and an int array to the attributes,
+// computed from the given centers
+void AddArrays(vtkDataSetAttributes *attributes, vtkPoints *centers)
+{
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("Ids");
+  for (vtkIdType i = 0; i < centers->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    centers->GetPoint(i, x);
+    vectors->InsertNextTuple3(std::sin(x[0]) * x[2], x[1] - x[2], 0.3 * x[0]);
+    scalars->InsertNextValue(static_cast<float>(std::cos(x[1]) + x[0] * x[2]));
+    ids->InsertNextValue(static_cast<int>(i % 23));
+  }
+  attributes->AddArray(vectors.GetPointer());
+  attributes->AddArray(scalars.GetPointer());
+  attributes->AddArray(ids.GetPointer());
+}
+
+// Point and cell data, the cell data being computed at the first point of
+// each cell
+void AddData(vtkDataSet *data)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkPoints> centers;
+  for (vtkIdType ptId = 0; ptId < data->GetNumberOfPoints(); ++ptId)
+  {
+    points->InsertNextPoint(data->GetPoint(ptId));
+  }
+  for (vtkIdType cellId = 0; cellId < data->GetNumberOfCells(); ++cellId)
+  {
+    double x[3];
+    data->GetPoint(data->GetCell(cellId)->GetPointId(0), x);
+    x[0] += 0.5;
+    centers->InsertNextPoint(x);
+  }
+  AddArrays(data->GetPointData(), points.GetPointer());
+  AddArrays(data->GetCellData(), centers.GetPointer());
+}
+
+// A lattice grid of hexahedra, wedges and tetrahedra, with data
+void MakeGrid(vtkUnstructuredGrid *grid, int n)
+{
+  const int cellTypes[3] = { VTK_HEXAHEDRON, VTK_WEDGE, VTK_TETRA };
+  vtkTest::MakeLatticeGrid(grid, n, cellTypes, 3);
+  AddData(grid);
+}
+
+// A wavy surface with data
+void MakeSurface(vtkPolyData *surface, int n)
+{
+  vtkTest::MakeWavySurface(surface, n);
+  AddData(surface);
+}
+
+void MakeVolume(vtkImageData *volume, int n)
+{
+  volume->SetDimensions(n, n - 2, n + 3);
+  volume->SetSpacing(0.5, 0.7, 0.3);
+  AddData(volume);
+}
+
+// Integral values may be truncated by the serial filter, and rounded by the
+// threaded one
+bool SameData(vtkDataSet *serial, vtkDataSet *threaded, bool exact)
+{
+  double tolerance = exact ? 0.0 : 1.0e-6;
+  return vtkTest::SameAttributes(serial->GetPointData(),
+                                 threaded->GetPointData(), tolerance) &&
+         vtkTest::SameAttributes(serial->GetCellData(),
+                                 threaded->GetCellData(), tolerance);
+}
+
+template <class TFilter>
+bool TestFilter(vtkDataSet *input, bool exact, const char *name)
+{
+  vtkSmartPointer<vtkDataSet> copy;
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    vtkNew<TFilter> serial;
+    vtkNew<TFilter> threaded;
+    threaded->ThreadedOn();
+    TFilter *filters[2] = { serial.GetPointer(), threaded.GetPointer() };
+    for (int f = 0; f < 2; ++f)
+    {
+      filters[f]->SetInputData(input);
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+      {
+        filters[f]->Update();
+      });
+    }
+    if (!SameData(serial->GetOutput(), threaded->GetOutput(), exact))
+    {
+      cerr << "Error: " << name << " on a " << input->GetClassName()
+           << (pass ? " with an unnamed array" : "") << endl;
+      return false;
+    }
+
+    // The output does not depend on the number of threads
+    if (!vtkTest::SameOutputsWithThreads(threaded.GetPointer()))
+    {
+      cerr << "Error: " << name << " on a " << input->GetClassName()
+           << " with one thread" << endl;
+      return false;
+    }
+
+    // Inputs with unnamed arrays are processed serially
+    if (pass == 0)
+    {
+      copy.TakeReference(input->NewInstance());
+      copy->DeepCopy(input);
+      vtkNew<vtkDoubleArray> unnamedPointArray;
+      unnamedPointArray->DeepCopy(copy->GetPointData()->GetArray("Scalars"));
+      unnamedPointArray->SetName(NULL);
+      copy->GetPointData()->AddArray(unnamedPointArray.GetPointer());
+      vtkNew<vtkDoubleArray> unnamedCellArray;
+      unnamedCellArray->DeepCopy(copy->GetCellData()->GetArray("Scalars"));
+      unnamedCellArray->SetName(NULL);
+      copy->GetCellData()->AddArray(unnamedCellArray.GetPointer());
+      input = copy;
+      exact = true;
+    }
+  }
+  return true;
+}
+
+}
+
+int TestCellDataToPointDataThreaded(int, char *[])
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid.GetPointer(), 9);
+  vtkNew<vtkPolyData> surface;
+  MakeSurface(surface.GetPointer(), 30);
+  vtkNew<vtkImageData> volume;
+  MakeVolume(volume.GetPointer(), 12);
+
+  vtkDataSet *inputs[3] =
+    { grid.GetPointer(), surface.GetPointer(), volume.GetPointer() };
+  for (int i = 0; i < 3; ++i)
+  {
+    if (!TestFilter<vtkCellDataToPointData>(inputs[i], i != 0,
+                                            "vtkCellDataToPointData") ||
+        !TestFilter<vtkPointDataToCellData>(inputs[i], true,
+                                            "vtkPointDataToCellData"))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
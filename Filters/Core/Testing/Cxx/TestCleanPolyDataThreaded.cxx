@@ -0,0 +1,284 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCleanPolyDataThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded cleaning of polydata merges the same points and
+// produces the same cells as the serial one, and that its output does not
+// depend on the number of threads.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCleanPolyData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataComparison.h"
+
+#include <cmath>
+
+namespace
+{
+
+// Insert the point of a bumpy surface, moved by a small offset depending
+// on its instance
+vtkIdType InsertPoint(vtkPoints *points, int x, int y, double jitter)
+{
+  double z = 0.1 * ((x * y) % 5);
+  double offset = jitter * ((points->GetNumberOfPoints() % 7) - 3) / 3.0;
+  return points->InsertNextPoint(x + offset, y - offset, z + offset);
+}
+
+// A triangle soup of a n x n surface, each triangle with its own points,
+// plus degenerate cells of all types
+void MakeSoup(vtkPolyData *soup, int n, double jitter)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      vtkIdType tri1[3] = { InsertPoint(points.GetPointer(), i, j, jitter),
+                            InsertPoint(points.GetPointer(), i + 1, j, jitter),
+                            InsertPoint(points.GetPointer(), i + 1, j + 1, jitter) };
+      vtkIdType tri2[3] = { InsertPoint(points.GetPointer(), i, j, jitter),
+                            InsertPoint(points.GetPointer(), i + 1, j + 1, jitter),
+                            InsertPoint(points.GetPointer(), i, j + 1, jitter) };
+      polys->InsertNextCell(3, tri1);
+      polys->InsertNextCell(3, tri2);
+    }
+  }
+
+  // A triangle becoming a line, a quad becoming a triangle
+  vtkIdType tri[3] = { InsertPoint(points.GetPointer(), 0, 0, jitter),
+                       InsertPoint(points.GetPointer(), 1, 0, jitter),
+                       InsertPoint(points.GetPointer(), 0, 0, jitter) };
+  polys->InsertNextCell(3, tri);
+  vtkIdType quad[4] = { InsertPoint(points.GetPointer(), 2, 2, jitter),
+                        InsertPoint(points.GetPointer(), 3, 2, jitter),
+                        InsertPoint(points.GetPointer(), 3, 2, jitter),
+                        InsertPoint(points.GetPointer(), 2, 3, jitter) };
+  polys->InsertNextCell(4, quad);
+
+  // A strip becoming a triangle, another one staying a strip
+  vtkIdType strip1[4] = { InsertPoint(points.GetPointer(), 4, 4, jitter),
+                          InsertPoint(points.GetPointer(), 5, 4, jitter),
+                          InsertPoint(points.GetPointer(), 5, 4, jitter),
+                          InsertPoint(points.GetPointer(), 5, 5, jitter) };
+  strips->InsertNextCell(4, strip1);
+  vtkIdType strip2[5] = { InsertPoint(points.GetPointer(), 1, 1, jitter),
+                          InsertPoint(points.GetPointer(), 2, 1, jitter),
+                          InsertPoint(points.GetPointer(), 1, 2, jitter),
+                          InsertPoint(points.GetPointer(), 2, 2, jitter),
+                          InsertPoint(points.GetPointer(), 1, 3, jitter) };
+  strips->InsertNextCell(5, strip2);
+
+  // A line becoming a vertex, and a polyline
+  vtkIdType line[2] = { InsertPoint(points.GetPointer(), 3, 3, jitter),
+                        InsertPoint(points.GetPointer(), 3, 3, jitter) };
+  lines->InsertNextCell(2, line);
+  vtkIdType polyline[4] = { InsertPoint(points.GetPointer(), 0, 1, jitter),
+                            InsertPoint(points.GetPointer(), 0, 2, jitter),
+                            InsertPoint(points.GetPointer(), 0, 2, jitter),
+                            InsertPoint(points.GetPointer(), 0, 3, jitter) };
+  lines->InsertNextCell(4, polyline);
+
+  // A vertex, and an unused point
+  vtkIdType vert = InsertPoint(points.GetPointer(), 6, 6, jitter);
+  verts->InsertNextCell(1, &vert);
+  InsertPoint(points.GetPointer(), 7, 7, jitter);
+
+  soup->SetPoints(points.GetPointer());
+  soup->SetVerts(verts.GetPointer());
+  soup->SetLines(lines.GetPointer());
+  soup->SetPolys(polys.GetPointer());
+  soup->SetStrips(strips.GetPointer());
+
+  vtkNew<vtkDoubleArray> pointValues;
+  pointValues->SetName("PointValues");
+  pointValues->SetNumberOfTuples(soup->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < soup->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    soup->GetPoint(i, x);
+    pointValues->SetValue(i, floor(x[0] + 0.5) + 10 * floor(x[1] + 0.5));
+  }
+  soup->GetPointData()->SetScalars(pointValues.GetPointer());
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(soup->GetNumberOfCells());
+  for (vtkIdType i = 0; i < soup->GetNumberOfCells(); ++i)
+  {
+    cellIds->SetValue(i, static_cast<int>(i));
+  }
+  soup->GetCellData()->AddArray(cellIds.GetPointer());
+}
+
+// Both outputs have the same cells in the same order, with points at the
+// same place (within tol) and with the same values
+bool SameCleaning(vtkPolyData *serial, vtkPolyData *threaded, double tol)
+{
+  if (serial->GetNumberOfPoints() != threaded->GetNumberOfPoints() ||
+      serial->GetNumberOfVerts() != threaded->GetNumberOfVerts() ||
+      serial->GetNumberOfLines() != threaded->GetNumberOfLines() ||
+      serial->GetNumberOfPolys() != threaded->GetNumberOfPolys() ||
+      serial->GetNumberOfStrips() != threaded->GetNumberOfStrips())
+  {
+    cerr << "Error: different outputs " << serial->GetNumberOfPoints()
+         << " " << threaded->GetNumberOfPoints() << " points, "
+         << serial->GetNumberOfCells() << " "
+         << threaded->GetNumberOfCells() << " cells" << endl;
+    return false;
+  }
+
+  vtkDataArray *serialIds = serial->GetCellData()->GetArray("CellIds");
+  vtkDataArray *threadedIds = threaded->GetCellData()->GetArray("CellIds");
+  vtkDataArray *serialValues =
+    serial->GetPointData()->GetArray("PointValues");
+  vtkDataArray *threadedValues =
+    threaded->GetPointData()->GetArray("PointValues");
+  vtkNew<vtkIdList> serialPts;
+  vtkNew<vtkIdList> threadedPts;
+  for (vtkIdType c = 0; c < serial->GetNumberOfCells(); ++c)
+  {
+    serial->GetCellPoints(c, serialPts.GetPointer());
+    threaded->GetCellPoints(c, threadedPts.GetPointer());
+    if (serialIds->GetComponent(c, 0) != threadedIds->GetComponent(c, 0) ||
+        serial->GetCellType(c) != threaded->GetCellType(c) ||
+        serialPts->GetNumberOfIds() != threadedPts->GetNumberOfIds())
+    {
+      cerr << "Error: different cell " << c << endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < serialPts->GetNumberOfIds(); ++i)
+    {
+      double x[3], y[3];
+      serial->GetPoint(serialPts->GetId(i), x);
+      threaded->GetPoint(threadedPts->GetId(i), y);
+      if (fabs(x[0] - y[0]) > tol || fabs(x[1] - y[1]) > tol ||
+          fabs(x[2] - y[2]) > tol ||
+          serialValues->GetComponent(serialPts->GetId(i), 0) !=
+          threadedValues->GetComponent(threadedPts->GetId(i), 0))
+      {
+        cerr << "Error: different points in cell " << c << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}
+
+int TestCleanPolyDataThreaded(int, char *[])
+{
+  // Merging of coincident points
+  vtkNew<vtkPolyData> soup;
+  MakeSoup(soup.GetPointer(), 30, 0.0);
+
+  vtkNew<vtkCleanPolyData> serial;
+  serial->SetInputData(soup.GetPointer());
+  serial->Update();
+
+  vtkNew<vtkCleanPolyData> threaded;
+  threaded->SetInputData(soup.GetPointer());
+  threaded->ThreadedOn();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Update();
+  });
+
+  if (threaded->GetOutput()->GetNumberOfPoints() != 31 * 31 ||
+      !SameCleaning(serial->GetOutput(), threaded->GetOutput(), 0.0))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Without merging, only the unused point is removed
+  serial->PointMergingOff();
+  serial->Update();
+  threaded->PointMergingOff();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Update();
+  });
+  if (threaded->GetOutput()->GetNumberOfPoints() !=
+      soup->GetNumberOfPoints() - 1 ||
+      !SameCleaning(serial->GetOutput(), threaded->GetOutput(), 0.0))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Merging within a tolerance, without degenerate strips conversion
+  vtkNew<vtkPolyData> jitteredSoup;
+  MakeSoup(jitteredSoup.GetPointer(), 30, 0.001);
+  serial->SetInputData(jitteredSoup.GetPointer());
+  serial->PointMergingOn();
+  serial->ToleranceIsAbsoluteOn();
+  serial->SetAbsoluteTolerance(0.005);
+  serial->ConvertStripsToPolysOff();
+  serial->Update();
+  threaded->SetInputData(jitteredSoup.GetPointer());
+  threaded->PointMergingOn();
+  threaded->ToleranceIsAbsoluteOn();
+  threaded->SetAbsoluteTolerance(0.005);
+  threaded->ConvertStripsToPolysOff();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Update();
+  });
+  if (threaded->GetOutput()->GetNumberOfPoints() != 31 * 31 ||
+      !SameCleaning(serial->GetOutput(), threaded->GetOutput(), 0.005))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Merging with several threads gives the points and cells of a single
+  // thread
+  vtkNew<vtkPolyData> reference;
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]()
+  {
+    threaded->Modified();
+    threaded->Update();
+  });
+  reference->DeepCopy(threaded->GetOutput());
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Modified();
+    threaded->Update();
+  });
+  vtkPolyData *output = threaded->GetOutput();
+  if (!vtkTest::SameArrays(reference->GetPoints()->GetData(),
+                           output->GetPoints()->GetData()) ||
+      !vtkTest::SameCells(reference->GetPolys(), output->GetPolys()) ||
+      !vtkTest::SameCells(reference->GetStrips(), output->GetStrips()) ||
+      !vtkTest::SameAttributes(reference->GetPointData(),
+                               output->GetPointData()) ||
+      !vtkTest::SameAttributes(reference->GetCellData(),
+                               output->GetCellData()))
+  {
+    cerr << "Error: output depends on the number of threads" << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
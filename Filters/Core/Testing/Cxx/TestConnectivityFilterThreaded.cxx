@@ -0,0 +1,346 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConnectivityFilterThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the parallel labeling of the connectivity filters extracts the
+// same regions as the serial traversal, for all the extraction modes. The
+// output points are numbered differently, so the cells are compared through
+// the coordinates and the data of their points.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkConnectivityFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataConnectivityFilter.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataComparison.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+
+double Field(double x, double y, double z)
+{
+  return std::sin(0.9 * x) * std::cos(0.7 * y) + 0.3 * std::sin(1.3 * z);
+}
+
+// A fragmented surface: quads of a grid, some of them removed, with lines
+// and vertices here and there
+void MakeSurface(vtkPolyData *surface, int n)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  for (int j = 0; j <= n; ++j)
+  {
+    for (int i = 0; i <= n; ++i)
+    {
+      points->InsertNextPoint(i, j, 0.1 * ((i * j) % 7));
+      scalars->InsertNextValue(Field(i, j, 0.0));
+    }
+  }
+  surface->SetPoints(points.GetPointer());
+  surface->GetPointData()->SetScalars(scalars.GetPointer());
+
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      vtkIdType p0 = j * (n + 1) + i;
+      vtkIdType quad[4] = { p0, p0 + 1, p0 + n + 2, p0 + n + 1 };
+      int code = (i * 7 + j * 13 + (i * j) % 5) % 11;
+      if (code < 6)
+      {
+        polys->InsertNextCell(4, quad);
+      }
+      else if (code == 6)
+      {
+        lines->InsertNextCell(2, quad);
+      }
+      else if (code == 7)
+      {
+        verts->InsertNextCell(1, quad + 2);
+      }
+    }
+  }
+  surface->SetVerts(verts.GetPointer());
+  surface->SetLines(lines.GetPointer());
+  surface->SetPolys(polys.GetPointer());
+}
+
+void MakeVolume(vtkImageData *volume, int n)
+{
+  volume->SetDimensions(n, n, n);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(volume->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < volume->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    volume->GetPoint(i, x);
+    scalars->SetValue(i, Field(x[0], x[1], x[2]));
+  }
+  volume->GetPointData()->SetScalars(scalars.GetPointer());
+}
+
+bool SameTuples(vtkDataArray *a1, vtkIdType i1, vtkDataArray *a2, vtkIdType i2)
+{
+  for (int c = 0; c < a1->GetNumberOfComponents(); ++c)
+  {
+    if (a1->GetComponent(i1, c) != a2->GetComponent(i2, c))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameOutputs(vtkDataSet *serial, vtkDataSet *threaded, bool cellRegionIds)
+{
+  vtkIdType numCells = serial->GetNumberOfCells();
+  if (numCells < 1 || numCells != threaded->GetNumberOfCells() ||
+      serial->GetNumberOfPoints() != threaded->GetNumberOfPoints())
+  {
+    cerr << "Error: different outputs " << numCells << " "
+         << threaded->GetNumberOfCells() << " cells, "
+         << serial->GetNumberOfPoints() << " "
+         << threaded->GetNumberOfPoints() << " points" << endl;
+    return false;
+  }
+  vtkPointData *pd1 = serial->GetPointData();
+  vtkPointData *pd2 = threaded->GetPointData();
+  vtkCellData *cd1 = serial->GetCellData();
+  vtkCellData *cd2 = threaded->GetCellData();
+  if (pd1->GetNumberOfArrays() != pd2->GetNumberOfArrays() ||
+      cd1->GetNumberOfArrays() != cd2->GetNumberOfArrays())
+  {
+    cerr << "Error: different arrays" << endl;
+    return false;
+  }
+  vtkNew<vtkIdList> pts1;
+  vtkNew<vtkIdList> pts2;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    serial->GetCellPoints(cellId, pts1.GetPointer());
+    threaded->GetCellPoints(cellId, pts2.GetPointer());
+    if (serial->GetCellType(cellId) != threaded->GetCellType(cellId) ||
+        pts1->GetNumberOfIds() != pts2->GetNumberOfIds())
+    {
+      cerr << "Error: different cell " << cellId << endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < pts1->GetNumberOfIds(); ++i)
+    {
+      double x1[3], x2[3];
+      serial->GetPoint(pts1->GetId(i), x1);
+      threaded->GetPoint(pts2->GetId(i), x2);
+      if (x1[0] != x2[0] || x1[1] != x2[1] || x1[2] != x2[2])
+      {
+        cerr << "Error: different points in cell " << cellId << endl;
+        return false;
+      }
+      for (int a = 0; a < pd1->GetNumberOfArrays(); ++a)
+      {
+        vtkDataArray *a1 = pd1->GetArray(a);
+        vtkDataArray *a2 = pd2->GetArray(a1->GetName());
+        if (!a2 || !SameTuples(a1, pts1->GetId(i), a2, pts2->GetId(i)))
+        {
+          cerr << "Error: different point array " << a1->GetName() << endl;
+          return false;
+        }
+      }
+    }
+    for (int a = 0; a < cd1->GetNumberOfArrays(); ++a)
+    {
+      vtkDataArray *a1 = cd1->GetArray(a);
+      vtkDataArray *a2 = cd2->GetArray(a1->GetName());
+      // The serial filter leaves the cell region ids of the cells not
+      // visited uninitialized
+      if (!cellRegionIds && !strcmp(a1->GetName(), "RegionId"))
+      {
+        continue;
+      }
+      if (!a2 || !SameTuples(a1, cellId, a2, cellId))
+      {
+        cerr << "Error: different cell array " << a1->GetName() << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// The output of the threaded filters does not depend on the traversal, so
+// runs with different numbers of threads number it the same way
+bool SameLabeling(vtkDataSet *ds1, vtkDataSet *ds2)
+{
+  vtkPolyData *pd1 = vtkPolyData::SafeDownCast(ds1);
+  vtkPolyData *pd2 = vtkPolyData::SafeDownCast(ds2);
+  vtkUnstructuredGrid *ug1 = vtkUnstructuredGrid::SafeDownCast(ds1);
+  vtkUnstructuredGrid *ug2 = vtkUnstructuredGrid::SafeDownCast(ds2);
+  bool sameCells = pd1 && pd2 ?
+    vtkTest::SameArrays(pd1->GetPoints()->GetData(),
+                        pd2->GetPoints()->GetData()) &&
+    vtkTest::SameCells(pd1->GetVerts(), pd2->GetVerts()) &&
+    vtkTest::SameCells(pd1->GetLines(), pd2->GetLines()) &&
+    vtkTest::SameCells(pd1->GetPolys(), pd2->GetPolys()) &&
+    vtkTest::SameCells(pd1->GetStrips(), pd2->GetStrips()) :
+    ug1 && ug2 &&
+    vtkTest::SameArrays(ug1->GetPoints()->GetData(),
+                        ug2->GetPoints()->GetData()) &&
+    vtkTest::SameArrays(ug1->GetCellTypesArray(), ug2->GetCellTypesArray()) &&
+    vtkTest::SameCells(ug1->GetCells(), ug2->GetCells());
+  if (!sameCells)
+  {
+    cerr << "Error: different points or cells" << endl;
+    return false;
+  }
+  return vtkTest::SameAttributes(ds1->GetPointData(), ds2->GetPointData()) &&
+         vtkTest::SameAttributes(ds1->GetCellData(), ds2->GetCellData());
+}
+
+template <class TFilter>
+void Configure(TFilter *filter, int mode, bool scalars)
+{
+  filter->SetExtractionMode(mode);
+  filter->ColorRegionsOn();
+  filter->SetScalarConnectivity(scalars);
+  filter->SetScalarRange(-0.2, 0.6);
+  filter->InitializeSeedList();
+  filter->InitializeSpecifiedRegionList();
+  if (mode == VTK_EXTRACT_SPECIFIED_REGIONS)
+  {
+    filter->AddSpecifiedRegion(0);
+    filter->AddSpecifiedRegion(4);
+    filter->AddSpecifiedRegion(9);
+  }
+  else if (mode == VTK_EXTRACT_POINT_SEEDED_REGIONS)
+  {
+    filter->AddSeed(5);
+    filter->AddSeed(407);
+  }
+  else if (mode == VTK_EXTRACT_CELL_SEEDED_REGIONS)
+  {
+    filter->AddSeed(12);
+    filter->AddSeed(300);
+  }
+  else if (mode == VTK_EXTRACT_CLOSEST_POINT_REGION)
+  {
+    filter->SetClosestPoint(7.2, 11.6, 3.1);
+  }
+}
+
+template <class TFilter>
+bool TestFilter(TFilter *serial, TFilter *threaded, const char *name)
+{
+  for (int mode = VTK_EXTRACT_POINT_SEEDED_REGIONS;
+       mode <= VTK_EXTRACT_CLOSEST_POINT_REGION; ++mode)
+  {
+    for (int scalars = 0; scalars < 2; ++scalars)
+    {
+      Configure(serial, mode, scalars != 0);
+      Configure(threaded, mode, scalars != 0);
+      serial->Update();
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+      {
+        threaded->Update();
+      });
+      bool seeded = mode == VTK_EXTRACT_POINT_SEEDED_REGIONS ||
+                    mode == VTK_EXTRACT_CELL_SEEDED_REGIONS ||
+                    mode == VTK_EXTRACT_CLOSEST_POINT_REGION;
+      if (serial->GetNumberOfExtractedRegions() !=
+          threaded->GetNumberOfExtractedRegions() ||
+          !SameOutputs(serial->GetOutput(), threaded->GetOutput(), !seeded))
+      {
+        cerr << "Error: " << name << " " << serial->GetExtractionModeAsString()
+             << (scalars ? " with scalar connectivity" : "") << endl;
+        return false;
+      }
+
+      // The regions labeled by 4 threads are the ones of a single thread
+      vtkSmartPointer<vtkDataSet> reference;
+      reference.TakeReference(threaded->GetOutput()->NewInstance());
+      reference->DeepCopy(threaded->GetOutput());
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]()
+      {
+        threaded->Modified();
+        threaded->Update();
+      });
+      if (!SameLabeling(reference, threaded->GetOutput()))
+      {
+        cerr << "Error: " << name << " " << serial->GetExtractionModeAsString()
+             << " with one thread" << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}
+
+int TestConnectivityFilterThreaded(int, char *[])
+{
+  vtkNew<vtkPolyData> surface;
+  MakeSurface(surface.GetPointer(), 40);
+  vtkNew<vtkImageData> volume;
+  MakeVolume(volume.GetPointer(), 24);
+
+  vtkNew<vtkPolyDataConnectivityFilter> polySerial;
+  vtkNew<vtkPolyDataConnectivityFilter> polyThreaded;
+  polySerial->SetInputData(surface.GetPointer());
+  polyThreaded->SetInputData(surface.GetPointer());
+  polyThreaded->ThreadedOn();
+  if (!TestFilter(polySerial.GetPointer(), polyThreaded.GetPointer(),
+                  "vtkPolyDataConnectivityFilter"))
+  {
+    return EXIT_FAILURE;
+  }
+  polySerial->FullScalarConnectivityOn();
+  polyThreaded->FullScalarConnectivityOn();
+  if (!TestFilter(polySerial.GetPointer(), polyThreaded.GetPointer(),
+                  "vtkPolyDataConnectivityFilter (full scalar connectivity)"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  vtkDataSet *inputs[2] = { volume.GetPointer(), surface.GetPointer() };
+  for (int i = 0; i < 2; ++i)
+  {
+    vtkNew<vtkConnectivityFilter> serial;
+    vtkNew<vtkConnectivityFilter> threaded;
+    serial->SetInputData(inputs[i]);
+    threaded->SetInputData(inputs[i]);
+    threaded->ThreadedOn();
+    if (!TestFilter(serial.GetPointer(), threaded.GetPointer(),
+                    "vtkConnectivityFilter"))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
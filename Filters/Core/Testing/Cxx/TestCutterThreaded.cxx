@@ -0,0 +1,187 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCutterThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded cutting of unstructured grids produces the same
+// points, triangles and attributes as the serial one, with and without a
+// scalar tree.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCutter.h"
+#include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPlane.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSphere.h"
+#include "vtkTestDataComparison.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+namespace
+{
+
+// A lattice grid with point scalars and vectors, and cell ids
+void MakeGrid(vtkUnstructuredGrid *grid, int n)
+{
+  vtkTest::MakeLatticeGrid(grid, n);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  for (vtkIdType ptId = 0; ptId < grid->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    grid->GetPoint(ptId, x);
+    scalars->InsertNextValue(std::sin(0.7 * x[0]) + 0.2 * x[1] * x[2]);
+    vectors->InsertNextTuple3(x[0] - x[1], x[1] * x[2], 0.5 * x[0]);
+  }
+  grid->GetPointData()->SetScalars(scalars.GetPointer());
+  grid->GetPointData()->SetVectors(vectors.GetPointer());
+
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("Ids");
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+  {
+    ids->InsertNextValue(static_cast<int>(cellId % 17));
+  }
+  grid->GetCellData()->AddArray(ids.GetPointer());
+}
+
+bool SameCuts(vtkPolyData *serial, vtkPolyData *threaded)
+{
+  if (serial->GetNumberOfCells() < 10 ||
+      serial->GetNumberOfPoints() != threaded->GetNumberOfPoints() ||
+      serial->GetNumberOfCells() != threaded->GetNumberOfCells())
+  {
+    cerr << "Error: different outputs " << serial->GetNumberOfCells() << " "
+         << threaded->GetNumberOfCells() << " cells, "
+         << serial->GetNumberOfPoints() << " "
+         << threaded->GetNumberOfPoints() << " points" << endl;
+    return false;
+  }
+  if (!vtkTest::SameArrays(serial->GetPoints()->GetData(),
+                           threaded->GetPoints()->GetData()) ||
+      !vtkTest::SameCells(serial->GetPolys(), threaded->GetPolys()))
+  {
+    cerr << "Error: different triangles" << endl;
+    return false;
+  }
+  return vtkTest::SameAttributes(serial->GetPointData(),
+                                 threaded->GetPointData(), 1.0e-12) &&
+         vtkTest::SameAttributes(serial->GetCellData(),
+                                 threaded->GetCellData());
+}
+
+}
+
+int TestCutterThreaded(int, char *[])
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid.GetPointer(), 12);
+
+  // A plane through the points of the lattice, an oblique plane and a
+  // sphere cut at several values. The sphere values are not those of lattice
+  // points: the serial locator may not merge the nearly equal points that
+  // different cells create there.
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(4.0, 0.0, 0.0);
+  plane->SetNormal(1.0, 0.0, 0.0);
+  vtkNew<vtkPlane> obliquePlane;
+  obliquePlane->SetOrigin(5.3, 6.1, 4.7);
+  obliquePlane->SetNormal(0.3, 1.0, -0.6);
+  vtkNew<vtkSphere> sphere;
+  sphere->SetCenter(6.2, 5.9, 6.4);
+  sphere->SetRadius(4.1);
+
+  for (int config = 0; config < 12; ++config)
+  {
+    vtkNew<vtkCutter> serial;
+    vtkNew<vtkCutter> threaded;
+    threaded->ThreadedOn();
+    threaded->SetUseScalarTree(config % 2);
+    vtkCutter *cutters[2] = { serial.GetPointer(), threaded.GetPointer() };
+    for (int c = 0; c < 2; ++c)
+    {
+      cutters[c]->SetInputData(grid.GetPointer());
+      cutters[c]->SetGenerateCutScalars((config / 2) % 2);
+      switch (config / 4)
+      {
+        case 0:
+          cutters[c]->SetCutFunction(plane.GetPointer());
+          cutters[c]->GenerateValues(3, -2.0, 2.0);
+          break;
+        case 1:
+          cutters[c]->SetCutFunction(obliquePlane.GetPointer());
+          break;
+        default:
+          cutters[c]->SetCutFunction(sphere.GetPointer());
+          cutters[c]->GenerateValues(4, -9.873, 11.537);
+          break;
+      }
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+      {
+        cutters[c]->Update();
+      });
+    }
+    if (!SameCuts(serial->GetOutput(), threaded->GetOutput()))
+    {
+      cerr << "Error: configuration " << config << endl;
+      return EXIT_FAILURE;
+    }
+
+    // Cutting again, with moved values, reuses the scalar tree
+    serial->SetValue(0, 0.5);
+    threaded->SetValue(0, 0.5);
+    serial->Update();
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+    {
+      threaded->Update();
+    });
+    if (!SameCuts(serial->GetOutput(), threaded->GetOutput()))
+    {
+      cerr << "Error: configuration " << config << " with moved values"
+           << endl;
+      return EXIT_FAILURE;
+    }
+
+    // The cut of 4 threads is the cut of a single thread
+    if (!vtkTest::SameOutputsWithThreads(threaded.GetPointer(), 1.0e-12))
+    {
+      cerr << "Error: configuration " << config << " with one thread" << endl;
+      return EXIT_FAILURE;
+    }
+
+    // When sorting by cell, the same triangles are produced
+    vtkIdType numCells = threaded->GetOutput()->GetNumberOfCells();
+    vtkIdType numPts = threaded->GetOutput()->GetNumberOfPoints();
+    threaded->SetSortByToSortByCell();
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+    {
+      threaded->Update();
+    });
+    if (threaded->GetOutput()->GetNumberOfCells() != numCells ||
+        threaded->GetOutput()->GetNumberOfPoints() != numPts)
+    {
+      cerr << "Error: configuration " << config << " sorted by cell" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
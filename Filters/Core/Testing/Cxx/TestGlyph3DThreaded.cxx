@@ -0,0 +1,221 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGlyph3DThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded generation of the glyphs produces the same
+// points, cells and attributes as the serial one.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataComparison.h"
+#include "vtkTransform.h"
+
+namespace
+{
+
+// Input points with scalars, vectors and an extra array to copy
+void MakeInput(vtkPolyData *input, int n)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("Ids");
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        double x[3] = { 1.0 * i, 1.0 * j, 1.0 * k };
+        points->InsertNextPoint(x);
+        scalars->InsertNextValue(0.1 * (i + j) - 0.05 * k);
+        // Some vectors are aligned with x, or null
+        double v[3] = { x[1] - x[2], (i % 3) * x[0], (j % 2) * x[2] };
+        vectors->InsertNextTuple(v);
+        ids->InsertNextValue(i - j + k);
+      }
+    }
+  }
+  input->SetPoints(points.GetPointer());
+  input->GetPointData()->SetScalars(scalars.GetPointer());
+  input->GetPointData()->SetVectors(vectors.GetPointer());
+  input->GetPointData()->AddArray(ids.GetPointer());
+}
+
+// A pyramid with normals and texture coordinates
+void MakePyramid(vtkPolyData *source)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> normals;
+  normals->SetNumberOfComponents(3);
+  vtkNew<vtkFloatArray> tcoords;
+  tcoords->SetNumberOfComponents(2);
+  double pts[5][3] = { { 0.0, -0.2, -0.2 }, { 0.0, 0.2, -0.2 },
+                       { 0.0, 0.2, 0.2 }, { 0.0, -0.2, 0.2 },
+                       { 0.5, 0.0, 0.0 } };
+  for (int i = 0; i < 5; ++i)
+  {
+    points->InsertNextPoint(pts[i]);
+    double n[3] = { pts[i][0] - 0.1, pts[i][1], pts[i][2] };
+    normals->InsertNextTuple(n);
+    tcoords->InsertNextTuple2(0.2 * i, 1.0 - 0.2 * i);
+  }
+  source->SetPoints(points.GetPointer());
+  source->GetPointData()->SetNormals(normals.GetPointer());
+  source->GetPointData()->SetTCoords(tcoords.GetPointer());
+
+  vtkNew<vtkCellArray> polys;
+  vtkIdType quad[4] = { 0, 3, 2, 1 };
+  polys->InsertNextCell(4, quad);
+  for (vtkIdType i = 0; i < 4; ++i)
+  {
+    vtkIdType tri[3] = { i, (i + 1) % 4, 4 };
+    polys->InsertNextCell(3, tri);
+  }
+  source->SetPolys(polys.GetPointer());
+}
+
+bool SameGlyphs(vtkPolyData *serial, vtkPolyData *threaded)
+{
+  if (serial->GetNumberOfPoints() < 100 ||
+      serial->GetNumberOfPoints() != threaded->GetNumberOfPoints() ||
+      serial->GetNumberOfCells() != threaded->GetNumberOfCells())
+  {
+    cerr << "Error: different outputs " << serial->GetNumberOfCells() << " "
+         << threaded->GetNumberOfCells() << " cells, "
+         << serial->GetNumberOfPoints() << " "
+         << threaded->GetNumberOfPoints() << " points" << endl;
+    return false;
+  }
+  if (!vtkTest::SameArrays(serial->GetPoints()->GetData(),
+                           threaded->GetPoints()->GetData()) ||
+      !vtkTest::SameCells(serial->GetPolys(), threaded->GetPolys()) ||
+      !vtkTest::SameCells(serial->GetLines(), threaded->GetLines()))
+  {
+    cerr << "Error: different glyphs" << endl;
+    return false;
+  }
+  return vtkTest::SameAttributes(serial->GetPointData(),
+                                 threaded->GetPointData()) &&
+         vtkTest::SameAttributes(serial->GetCellData(),
+                                 threaded->GetCellData());
+}
+
+}
+
+int TestGlyph3DThreaded(int, char *[])
+{
+  vtkNew<vtkPolyData> input;
+  MakeInput(input.GetPointer(), 12);
+  vtkNew<vtkPolyData> pyramid;
+  MakePyramid(pyramid.GetPointer());
+
+  // A line source, as the default glyph
+  vtkNew<vtkPolyData> line;
+  vtkNew<vtkPoints> linePts;
+  linePts->InsertNextPoint(0.0, 0.0, 0.0);
+  linePts->InsertNextPoint(1.0, 0.0, 0.0);
+  line->SetPoints(linePts.GetPointer());
+  vtkNew<vtkCellArray> lines;
+  vtkIdType lineIds[2] = { 0, 1 };
+  lines->InsertNextCell(2, lineIds);
+  line->SetLines(lines.GetPointer());
+
+  vtkNew<vtkTransform> sourceTransform;
+  sourceTransform->RotateZ(30.0);
+  sourceTransform->Translate(0.1, 0.0, 0.0);
+
+  for (int config = 0; config < 6; ++config)
+  {
+    vtkNew<vtkGlyph3D> serial;
+    vtkNew<vtkGlyph3D> threaded;
+    threaded->ThreadedOn();
+    vtkGlyph3D *glyphs[2] = { serial.GetPointer(), threaded.GetPointer() };
+    for (int t = 0; t < 2; ++t)
+    {
+      glyphs[t]->SetInputData(input.GetPointer());
+      glyphs[t]->SetSourceData(config == 5 ? line.GetPointer()
+                                           : pyramid.GetPointer());
+      glyphs[t]->GeneratePointIdsOn();
+      glyphs[t]->FillCellDataOn();
+      switch (config)
+      {
+        case 0:
+          glyphs[t]->SetScaleModeToScaleByScalar();
+          glyphs[t]->SetColorModeToColorByScale();
+          break;
+        case 1:
+          glyphs[t]->SetScaleModeToScaleByVector();
+          glyphs[t]->SetColorModeToColorByVector();
+          glyphs[t]->SetSourceTransform(sourceTransform.GetPointer());
+          break;
+        case 2:
+          glyphs[t]->SetScaleModeToScaleByVectorComponents();
+          glyphs[t]->SetColorModeToColorByScalar();
+          glyphs[t]->ClampingOn();
+          glyphs[t]->SetRange(0.1, 0.8);
+          break;
+        case 3:
+          glyphs[t]->SetScaleModeToDataScalingOff();
+          glyphs[t]->SetScaleFactor(0.5);
+          glyphs[t]->OrientOff();
+          break;
+        case 4:
+          glyphs[t]->SetVectorModeToVectorRotationOff();
+          glyphs[t]->ScalingOff();
+          break;
+        default:
+          glyphs[t]->SetScaleFactor(0.3);
+          break;
+      }
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+      {
+        glyphs[t]->Update();
+      });
+    }
+    if (!SameGlyphs(serial->GetOutput(), threaded->GetOutput()))
+    {
+      cerr << "Error: configuration " << config << endl;
+      return EXIT_FAILURE;
+    }
+
+    // The glyphs generated by 4 threads are the ones of a single thread
+    vtkNew<vtkPolyData> reference;
+    reference->DeepCopy(threaded->GetOutput());
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]()
+    {
+      threaded->Modified();
+      threaded->Update();
+    });
+    if (!SameGlyphs(reference.GetPointer(), threaded->GetOutput()))
+    {
+      cerr << "Error: configuration " << config << " with one thread" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormalsThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded computation of normals splits the same points and
+// computes the same normals as the serial one, and that its output does not
+// depend on the number of threads.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataComparison.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// A n x n folded surface with creases, made of triangles, quads and strips
+// with mixed orientations, plus a non-manifold fin
+void MakeSurface(vtkPolyData *surface, int n)
+{
+  vtkNew<vtkPoints> points;
+  int np = n + 1;
+  for (int j = 0; j < np; ++j)
+  {
+    for (int i = 0; i < np; ++i)
+    {
+      double z = std::fabs(static_cast<double>((i % 8) - 4)) +
+        0.3 * std::sin(0.7 * j) + (j > n / 2 ? 0.5 * (j - n / 2) : 0.0);
+      points->InsertNextPoint(i, j, z);
+    }
+  }
+  points->InsertNextPoint(0.5, 0.5, 5.0);
+
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+  for (int j = 0; j < n; ++j)
+  {
+    if (j % 4 == 3)
+    {
+      strips->InsertNextCell(2 * np);
+      for (int i = 0; i < np; ++i)
+      {
+        strips->InsertCellPoint(i + np * (j + 1));
+        strips->InsertCellPoint(i + np * j);
+      }
+      continue;
+    }
+    for (int i = 0; i < n; ++i)
+    {
+      vtkIdType p = i + np * j;
+      if ((i + j) % 3 == 0)
+      {
+        vtkIdType quad[4] = { p, p + 1, p + np + 1, p + np };
+        if (i % 5 == 1)
+        {
+          std::swap(quad[1], quad[3]);
+        }
+        polys->InsertNextCell(4, quad);
+      }
+      else
+      {
+        vtkIdType tri1[3] = { p, p + 1, p + np };
+        vtkIdType tri2[3] = { p + 1, p + np + 1, p + np };
+        if (i % 7 == 2)
+        {
+          std::swap(tri2[1], tri2[2]);
+        }
+        polys->InsertNextCell(3, tri1);
+        polys->InsertNextCell(3, tri2);
+      }
+    }
+  }
+  vtkIdType fin[3] = { 0, np + 1, np * np };
+  polys->InsertNextCell(3, fin);
+
+  surface->SetPoints(points.GetPointer());
+  surface->SetPolys(polys.GetPointer());
+  surface->SetStrips(strips.GetPointer());
+
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(points->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+  {
+    scalars->SetValue(i, static_cast<double>(i));
+  }
+  surface->GetPointData()->SetScalars(scalars.GetPointer());
+}
+
+bool SameOutputs(vtkPolyData *serial, vtkPolyData *threaded)
+{
+  return vtkTest::SameArrays(serial->GetPoints()->GetData(),
+                             threaded->GetPoints()->GetData()) &&
+    vtkTest::SameCells(serial->GetPolys(), threaded->GetPolys()) &&
+    vtkTest::SameAttributes(serial->GetPointData(),
+                            threaded->GetPointData()) &&
+    vtkTest::SameAttributes(serial->GetCellData(), threaded->GetCellData());
+}
+
+}
+
+int TestPolyDataNormalsThreaded(int, char *[])
+{
+  vtkNew<vtkPolyData> surface;
+  MakeSurface(surface.GetPointer(), 30);
+
+  vtkNew<vtkPolyDataNormals> serial;
+  serial->SetInputData(surface.GetPointer());
+  serial->ComputeCellNormalsOn();
+
+  vtkNew<vtkPolyDataNormals> threaded;
+  threaded->SetInputData(surface.GetPointer());
+  threaded->ComputeCellNormalsOn();
+  threaded->ThreadedOn();
+
+  for (int config = 0; config < 8; ++config)
+  {
+    int splitting = config & 1;
+    int consistency = (config >> 1) & 1;
+    int flipNormals = (config >> 2) & 1;
+    serial->SetSplitting(splitting);
+    serial->SetConsistency(consistency);
+    serial->SetFlipNormals(flipNormals);
+    serial->Update();
+    threaded->SetSplitting(splitting);
+    threaded->SetConsistency(consistency);
+    threaded->SetFlipNormals(flipNormals);
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+    {
+      threaded->Update();
+    });
+
+    if (splitting &&
+        serial->GetOutput()->GetNumberOfPoints() <=
+        surface->GetNumberOfPoints())
+    {
+      cerr << "Error: no points split" << endl;
+      return EXIT_FAILURE;
+    }
+    if (!SameOutputs(serial->GetOutput(), threaded->GetOutput()))
+    {
+      cerr << "Error: different outputs with splitting " << splitting
+           << ", consistency " << consistency
+           << ", flip normals " << flipNormals << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Splitting with several threads gives the output of a single thread
+  threaded->SplittingOn();
+  threaded->ConsistencyOn();
+  threaded->FlipNormalsOff();
+  vtkNew<vtkPolyData> reference;
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]()
+  {
+    threaded->Modified();
+    threaded->Update();
+  });
+  reference->DeepCopy(threaded->GetOutput());
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Modified();
+    threaded->Update();
+  });
+  if (!SameOutputs(reference.GetPointer(), threaded->GetOutput()))
+  {
+    cerr << "Error: output depends on the number of threads" << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
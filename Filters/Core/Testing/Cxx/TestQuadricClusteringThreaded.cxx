@@ -0,0 +1,207 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricClusteringThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded clustering produces the same points, cells and
+// cell data as the serial one, for vertices, lines, polygons and strips.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkIntArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricClustering.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataComparison.h"
+
+#include <cmath>
+
+namespace
+{
+
+// A noisy wavy surface of quads and triangles, with a hole, a strip along
+// one of its sides, a polyline and vertices
+void MakeSurface(vtkPolyData *surface, int n)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(7);
+  vtkNew<vtkPoints> points;
+  for (int j = 0; j <= n; ++j)
+  {
+    for (int i = 0; i <= n; ++i)
+    {
+      random->Next();
+      double noise = 0.1 * (random->GetValue() - 0.5);
+      points->InsertNextPoint(i, j, 3.0 * std::sin(0.2 * i) *
+                              std::cos(0.1 * j) + noise);
+    }
+  }
+
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      if (std::abs(2 * i - n) < n / 5 && std::abs(2 * j - n) < n / 3)
+      {
+        continue;
+      }
+      vtkIdType p0 = j * (n + 1) + i;
+      vtkIdType quad[4] = { p0, p0 + 1, p0 + n + 2, p0 + n + 1 };
+      if ((i + j) % 3)
+      {
+        polys->InsertNextCell(4, quad);
+      }
+      else
+      {
+        vtkIdType tri1[3] = { p0, p0 + 1, p0 + n + 2 };
+        vtkIdType tri2[3] = { p0, p0 + n + 2, p0 + n + 1 };
+        polys->InsertNextCell(3, tri1);
+        polys->InsertNextCell(3, tri2);
+      }
+    }
+  }
+
+  vtkNew<vtkCellArray> strips;
+  strips->InsertNextCell(2 * (n + 1));
+  for (int i = 0; i <= n; ++i)
+  {
+    strips->InsertCellPoint(points->InsertNextPoint(i, -1.0, 0.3 * i));
+    strips->InsertCellPoint(points->InsertNextPoint(i, -3.0, 0.2 * i));
+  }
+
+  vtkNew<vtkCellArray> lines;
+  lines->InsertNextCell(n + 1);
+  for (int i = 0; i <= n; ++i)
+  {
+    random->Next();
+    lines->InsertCellPoint(points->InsertNextPoint(
+      i, n + 2.0 + random->GetValue(), 0.0));
+  }
+  // A degenerate segment
+  lines->InsertNextCell(2);
+  lines->InsertCellPoint(0);
+  lines->InsertCellPoint(0);
+
+  vtkNew<vtkCellArray> verts;
+  for (int i = 0; i < n; i += 3)
+  {
+    vtkIdType ptId = points->InsertNextPoint(i + 0.5, n + 5.0, 1.0);
+    verts->InsertNextCell(1, &ptId);
+    ptId = i * (n + 2);
+    verts->InsertNextCell(1, &ptId);
+  }
+
+  surface->SetPoints(points.GetPointer());
+  surface->SetVerts(verts.GetPointer());
+  surface->SetLines(lines.GetPointer());
+  surface->SetPolys(polys.GetPointer());
+  surface->SetStrips(strips.GetPointer());
+
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("Ids");
+  for (vtkIdType cellId = 0; cellId < surface->GetNumberOfCells(); ++cellId)
+  {
+    ids->InsertNextValue(static_cast<int>(cellId));
+  }
+  surface->GetCellData()->AddArray(ids.GetPointer());
+}
+
+bool SameOutputs(vtkPolyData *serial, vtkPolyData *threaded)
+{
+  if (serial->GetNumberOfPolys() < 10 ||
+      !vtkTest::SameCells(serial->GetVerts(), threaded->GetVerts()) ||
+      !vtkTest::SameCells(serial->GetLines(), threaded->GetLines()) ||
+      !vtkTest::SameCells(serial->GetPolys(), threaded->GetPolys()) ||
+      !vtkTest::SameArrays(serial->GetPoints()->GetData(),
+                           threaded->GetPoints()->GetData()))
+  {
+    cerr << "Error: different cells " << serial->GetNumberOfCells() << " "
+         << threaded->GetNumberOfCells() << ", points "
+         << serial->GetNumberOfPoints() << " "
+         << threaded->GetNumberOfPoints() << endl;
+    return false;
+  }
+  return vtkTest::SameAttributes(serial->GetCellData(),
+                                 threaded->GetCellData());
+}
+
+}
+
+int TestQuadricClusteringThreaded(int, char *[])
+{
+  vtkNew<vtkPolyData> surface;
+  MakeSurface(surface.GetPointer(), 80);
+
+  for (int config = 0; config < 16; ++config)
+  {
+    vtkNew<vtkQuadricClustering> serial;
+    vtkNew<vtkQuadricClustering> threaded;
+    threaded->ThreadedOn();
+    vtkQuadricClustering *filters[2] =
+      { serial.GetPointer(), threaded.GetPointer() };
+    for (int f = 0; f < 2; ++f)
+    {
+      filters[f]->SetInputData(surface.GetPointer());
+      filters[f]->SetNumberOfDivisions(23, 17, 5);
+      filters[f]->AutoAdjustNumberOfDivisionsOff();
+      filters[f]->SetUseInternalTriangles(config % 2);
+      filters[f]->SetPreventDuplicateCells((config / 2) % 2);
+      filters[f]->SetCopyCellData((config / 4) % 2);
+      filters[f]->SetUseFeatureEdges(config / 8);
+      filters[f]->SetUseFeaturePoints(config / 8);
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+      {
+        filters[f]->Update();
+      });
+    }
+    if (!SameOutputs(serial->GetOutput(), threaded->GetOutput()))
+    {
+      cerr << "Error: configuration " << config << endl;
+      return EXIT_FAILURE;
+    }
+
+    // The clusters of 4 threads are the ones of a single thread
+    vtkNew<vtkPolyData> reference;
+    reference->DeepCopy(threaded->GetOutput());
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]()
+    {
+      threaded->Modified();
+      threaded->Update();
+    });
+    if (!SameOutputs(reference.GetPointer(), threaded->GetOutput()))
+    {
+      cerr << "Error: configuration " << config << " with one thread" << endl;
+      return EXIT_FAILURE;
+    }
+
+    // The input points are not computed in parallel, but the cells are
+    serial->UseInputPointsOn();
+    threaded->UseInputPointsOn();
+    serial->Update();
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+    {
+      threaded->Update();
+    });
+    if (!SameOutputs(serial->GetOutput(), threaded->GetOutput()))
+    {
+      cerr << "Error: configuration " << config << " using input points"
+           << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,209 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricDecimationThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded decimation reaches the target reduction with an
+// error comparable to the serial one, produces a valid mesh and does not
+// depend on the number of threads.
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricDecimation.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataComparison.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+double Height(double x, double y)
+{
+  return 2.0 * std::sin(0.2 * x) * std::cos(0.15 * y) + 0.01 * x * y;
+}
+
+// A wavy height field of triangles, with a hole in its middle
+void MakeSurface(vtkPolyData *surface, int n, int dataType)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(5);
+  vtkNew<vtkPoints> points;
+  points->SetDataType(dataType);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  for (int j = 0; j <= n; ++j)
+  {
+    for (int i = 0; i <= n; ++i)
+    {
+      // Jitter the points in the plane to avoid ties between the costs
+      random->Next();
+      double x = i + 0.2 * (random->GetValue() - 0.5);
+      random->Next();
+      double y = j + 0.2 * (random->GetValue() - 0.5);
+      points->InsertNextPoint(x, y, Height(x, y));
+      scalars->InsertNextValue(x);
+    }
+  }
+  surface->SetPoints(points.GetPointer());
+  surface->GetPointData()->SetScalars(scalars.GetPointer());
+
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      if (std::abs(2 * i - n) < n / 4 && std::abs(2 * j - n) < n / 5)
+      {
+        continue;
+      }
+      vtkIdType p0 = j * (n + 1) + i;
+      vtkIdType tri1[3] = { p0, p0 + 1, p0 + n + 2 };
+      vtkIdType tri2[3] = { p0, p0 + n + 2, p0 + n + 1 };
+      polys->InsertNextCell(3, tri1);
+      polys->InsertNextCell(3, tri2);
+    }
+  }
+  surface->SetPolys(polys.GetPointer());
+}
+
+// The mean distance of the points to the height field, or -1 if the mesh
+// is not valid
+double MeanError(vtkPolyData *mesh)
+{
+  vtkIdType numPts = mesh->GetNumberOfPoints();
+  std::vector<int> used(numPts, 0);
+  vtkCellArray *polys = mesh->GetPolys();
+  vtkIdType npts, *pts;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); )
+  {
+    if (npts != 3 || pts[0] == pts[1] || pts[0] == pts[2] ||
+        pts[1] == pts[2])
+    {
+      return -1.0;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      if (pts[i] < 0 || pts[i] >= numPts)
+      {
+        return -1.0;
+      }
+      used[pts[i]] = 1;
+    }
+  }
+  double error = 0.0;
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    if (!used[ptId])
+    {
+      return -1.0;
+    }
+    double x[3];
+    mesh->GetPoint(ptId, x);
+    error += std::fabs(x[2] - Height(x[0], x[1]));
+  }
+  return numPts > 0 ? error / numPts : -1.0;
+}
+
+bool SameMeshes(vtkPolyData *mesh1, vtkPolyData *mesh2)
+{
+  return vtkTest::SameArrays(mesh1->GetPoints()->GetData(),
+                             mesh2->GetPoints()->GetData()) &&
+         vtkTest::SameCells(mesh1->GetPolys(), mesh2->GetPolys()) &&
+         vtkTest::SameAttributes(mesh1->GetPointData(),
+                                 mesh2->GetPointData());
+}
+
+}
+
+int TestQuadricDecimationThreaded(int, char *[])
+{
+  const double targets[3] = { 0.3, 0.75, 0.95 };
+  for (int config = 0; config < 6; ++config)
+  {
+    vtkNew<vtkPolyData> surface;
+    MakeSurface(surface.GetPointer(), 60,
+                config % 2 ? VTK_DOUBLE : VTK_FLOAT);
+    double target = targets[config / 2];
+
+    vtkNew<vtkQuadricDecimation> serial;
+    vtkNew<vtkQuadricDecimation> threaded;
+    threaded->ThreadedOn();
+    vtkQuadricDecimation *decimators[2] =
+      { serial.GetPointer(), threaded.GetPointer() };
+    for (int d = 0; d < 2; ++d)
+    {
+      decimators[d]->SetInputData(surface.GetPointer());
+      decimators[d]->SetTargetReduction(target);
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+      {
+        decimators[d]->Update();
+      });
+    }
+
+    // The target is reached, the last pass only collapsing the edges
+    // needed, and the mesh is as close to the surface as the serial one
+    vtkPolyData *output = threaded->GetOutput();
+    double serialError = MeanError(serial->GetOutput());
+    double threadedError = MeanError(output);
+    vtkIdType numTris = surface->GetNumberOfPolys();
+    if (threaded->GetActualReduction() < target ||
+        threaded->GetActualReduction() > target + 0.01 ||
+        output->GetNumberOfPolys() != numTris -
+        static_cast<vtkIdType>(threaded->GetActualReduction() * numTris + 0.5) ||
+        threadedError < 0.0 || threadedError > 2.0 * serialError + 1.0e-3)
+    {
+      cerr << "Error: configuration " << config << ": reduction "
+           << threaded->GetActualReduction() << " (serial "
+           << serial->GetActualReduction() << "), " << output->GetNumberOfPolys()
+           << " triangles, mean error " << threadedError << " (serial "
+           << serialError << ")" << endl;
+      return EXIT_FAILURE;
+    }
+
+    // The decimation of 4 threads is the one of a single thread
+    vtkNew<vtkPolyData> reference;
+    reference->DeepCopy(output);
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]()
+    {
+      threaded->Modified();
+      threaded->Update();
+    });
+    if (!SameMeshes(reference.GetPointer(), threaded->GetOutput()))
+    {
+      cerr << "Error: configuration " << config << " with one thread" << endl;
+      return EXIT_FAILURE;
+    }
+
+    // The attribute error metric is computed serially
+    serial->AttributeErrorMetricOn();
+    threaded->AttributeErrorMetricOn();
+    serial->Update();
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+    {
+      threaded->Update();
+    });
+    if (!SameMeshes(serial->GetOutput(), threaded->GetOutput()))
+    {
+      cerr << "Error: configuration " << config << " with attributes" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,215 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSmoothPolyDataFilterThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded (Jacobi) smoothing iterations keep the fixed
+// points, smooth the surface as the serial (in place) iterations do, and do
+// not depend on the number of threads.
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataComparison.h"
+#include "vtkSmoothPolyDataFilter.h"
+
+#include <cmath>
+
+namespace
+{
+
+// A noisy wavy surface of triangles, with a polyline and vertices
+void MakeSurface(vtkPolyData *surface, int n, int dataType)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(3);
+  vtkNew<vtkPoints> points;
+  points->SetDataType(dataType);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  for (int j = 0; j <= n; ++j)
+  {
+    for (int i = 0; i <= n; ++i)
+    {
+      random->Next();
+      double noise = 0.2 * (random->GetValue() - 0.5);
+      points->InsertNextPoint(i, j, std::sin(0.4 * i) * std::cos(0.3 * j) +
+                              noise);
+      scalars->InsertNextValue(i + j);
+    }
+  }
+  surface->SetPoints(points.GetPointer());
+  surface->GetPointData()->SetScalars(scalars.GetPointer());
+
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      vtkIdType p0 = j * (n + 1) + i;
+      vtkIdType tri1[3] = { p0, p0 + 1, p0 + n + 2 };
+      vtkIdType tri2[3] = { p0, p0 + n + 2, p0 + n + 1 };
+      polys->InsertNextCell(3, tri1);
+      polys->InsertNextCell(3, tri2);
+    }
+  }
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> verts;
+  vtkIdType first = points->GetNumberOfPoints();
+  lines->InsertNextCell(n);
+  for (int i = 0; i < n; ++i)
+  {
+    random->Next();
+    lines->InsertCellPoint(points->InsertNextPoint(
+      i, -2.0 + 0.3 * random->GetValue(), 0.0));
+    scalars->InsertNextValue(-i);
+  }
+  vtkIdType vert[2] = { first, (n / 2) * (n + 2) };
+  verts->InsertNextCell(2, vert);
+  surface->SetVerts(verts.GetPointer());
+  surface->SetLines(lines.GetPointer());
+  surface->SetPolys(polys.GetPointer());
+}
+
+// The largest distance between the points of the outputs
+double MaxDistance(vtkPolyData *output1, vtkPolyData *output2)
+{
+  double maxDist = 0.0;
+  for (vtkIdType i = 0; i < output1->GetNumberOfPoints(); ++i)
+  {
+    double x1[3], x2[3];
+    output1->GetPoint(i, x1);
+    output2->GetPoint(i, x2);
+    maxDist = std::max(maxDist,
+      std::sqrt(vtkMath::Distance2BetweenPoints(x1, x2)));
+  }
+  return maxDist;
+}
+
+bool TestSmoothing(vtkPolyData *surface, int config)
+{
+  vtkNew<vtkSmoothPolyDataFilter> serial;
+  vtkNew<vtkSmoothPolyDataFilter> threaded;
+  threaded->ThreadedOn();
+  vtkSmoothPolyDataFilter *filters[2] =
+    { serial.GetPointer(), threaded.GetPointer() };
+  for (int f = 0; f < 2; ++f)
+  {
+    filters[f]->SetInputData(surface);
+    filters[f]->SetRelaxationFactor(0.1);
+    filters[f]->GenerateErrorScalarsOn();
+    switch (config)
+    {
+      case 0:
+        break;
+      case 1:
+        filters[f]->BoundarySmoothingOff();
+        filters[f]->GenerateErrorVectorsOn();
+        break;
+      case 2:
+        filters[f]->FeatureEdgeSmoothingOn();
+        filters[f]->SetFeatureAngle(20.0);
+        filters[f]->SetOutputPointsPrecision(vtkAlgorithm::DOUBLE_PRECISION);
+        break;
+      default:
+        filters[f]->SetNumberOfIterations(200);
+        filters[f]->SetConvergence(0.3);
+        break;
+    }
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+    {
+      filters[f]->Update();
+    });
+  }
+  vtkPolyData *output1 = serial->GetOutput();
+  vtkPolyData *output2 = threaded->GetOutput();
+  if (output1->GetNumberOfPoints() != output2->GetNumberOfPoints() ||
+      output1->GetPoints()->GetDataType() !=
+      output2->GetPoints()->GetDataType() ||
+      !output2->GetPointData()->GetScalars() ||
+      (output1->GetPointData()->GetVectors() == NULL) !=
+      (output2->GetPointData()->GetVectors() == NULL))
+  {
+    cerr << "Error: different outputs" << endl;
+    return false;
+  }
+
+  // The points do not move more with one kind of iterations than with the
+  // other, and the fixed points do not move
+  double maxDist = MaxDistance(output1, output2);
+  if (maxDist > 0.05)
+  {
+    cerr << "Error: the smoothed points differ by " << maxDist << endl;
+    return false;
+  }
+  vtkIdType fixedPts[3] = { (surface->GetNumberOfPoints() - 1),
+                            (15 * 32), 0 };
+  for (int i = 0; i < 3; ++i)
+  {
+    double x1[3], x2[3];
+    surface->GetPoint(fixedPts[i], x1);
+    output2->GetPoint(fixedPts[i], x2);
+    if (x1[0] != x2[0] || x1[1] != x2[1] || x1[2] != x2[2])
+    {
+      cerr << "Error: the fixed point " << fixedPts[i] << " moved" << endl;
+      return false;
+    }
+  }
+
+  // The smoothing of 4 threads above is the one of a single thread
+  vtkNew<vtkPolyData> reference;
+  reference->DeepCopy(output2);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]()
+  {
+    threaded->Modified();
+    threaded->Update();
+  });
+  if (!vtkTest::SameArrays(reference->GetPoints()->GetData(),
+                           threaded->GetOutput()->GetPoints()->GetData()) ||
+      !vtkTest::SameAttributes(reference->GetPointData(),
+                               threaded->GetOutput()->GetPointData()))
+  {
+    cerr << "Error: different smoothing with one thread" << endl;
+    return false;
+  }
+  return true;
+}
+
+}
+
+int TestSmoothPolyDataFilterThreaded(int, char *[])
+{
+  int dataTypes[2] = { VTK_FLOAT, VTK_DOUBLE };
+  for (int t = 0; t < 2; ++t)
+  {
+    vtkNew<vtkPolyData> surface;
+    MakeSurface(surface.GetPointer(), 30, dataTypes[t]);
+    for (int config = 0; config < 4; ++config)
+    {
+      if (!TestSmoothing(surface.GetPointer(), config))
+      {
+        cerr << "Error: configuration " << config << " with "
+             << vtkImageScalarTypeNameMacro(dataTypes[t]) << " points"
+             << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
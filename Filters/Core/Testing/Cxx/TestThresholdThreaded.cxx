@@ -0,0 +1,188 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThresholdThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded threshold extracts the same cells as the serial
+// one, in the same order, and that its output does not depend on the number
+// of threads.
+
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataComparison.h"
+#include "vtkThreshold.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+namespace
+{
+
+// A lattice grid of hexahedra and tetrahedra, plus a few 2D, 1D, 0D and
+// empty cells, with two-component point scalars and the ids of the cells
+void MakeGrid(vtkUnstructuredGrid *grid, int n)
+{
+  const int cellTypes[2] = { VTK_HEXAHEDRON, VTK_TETRA };
+  vtkTest::MakeLatticeGrid(grid, n, cellTypes, 2);
+  vtkTest::AddLatticeLowerCells(grid, n);
+  for (int i = 0; i < n; ++i)
+  {
+    grid->InsertNextCell(VTK_EMPTY_CELL, 0, NULL);
+  }
+
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  pointScalars->SetNumberOfComponents(2);
+  pointScalars->SetNumberOfTuples(grid->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    grid->GetPoint(i, x);
+    pointScalars->SetComponent(i, 0, std::sin(x[0]) + x[1] - 0.5 * x[2]);
+    pointScalars->SetComponent(i, 1, x[0] * x[2] - x[1]);
+  }
+  grid->GetPointData()->SetScalars(pointScalars.GetPointer());
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(grid->GetNumberOfCells());
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+  {
+    cellIds->SetValue(i, static_cast<int>(i));
+  }
+  grid->GetCellData()->AddArray(cellIds.GetPointer());
+}
+
+// The cells are the same, in the same order, if they have the same types,
+// the same input ids and the same points with the same scalars
+bool SameCells(vtkUnstructuredGrid *serial, vtkUnstructuredGrid *threaded)
+{
+  if (serial->GetNumberOfCells() != threaded->GetNumberOfCells() ||
+      serial->GetNumberOfPoints() != threaded->GetNumberOfPoints())
+  {
+    cerr << "Error: different outputs " << serial->GetNumberOfCells()
+         << " " << threaded->GetNumberOfCells() << " cells, "
+         << serial->GetNumberOfPoints() << " "
+         << threaded->GetNumberOfPoints() << " points" << endl;
+    return false;
+  }
+
+  vtkDataArray *serialIds = serial->GetCellData()->GetArray("CellIds");
+  vtkDataArray *threadedIds = threaded->GetCellData()->GetArray("CellIds");
+  vtkDataArray *serialScalars =
+    serial->GetPointData()->GetArray("PointScalars");
+  vtkDataArray *threadedScalars =
+    threaded->GetPointData()->GetArray("PointScalars");
+  vtkNew<vtkIdList> serialPts;
+  vtkNew<vtkIdList> threadedPts;
+  for (vtkIdType c = 0; c < serial->GetNumberOfCells(); ++c)
+  {
+    serial->GetCellPoints(c, serialPts.GetPointer());
+    threaded->GetCellPoints(c, threadedPts.GetPointer());
+    if (serial->GetCellType(c) != threaded->GetCellType(c) ||
+        serialIds->GetComponent(c, 0) != threadedIds->GetComponent(c, 0) ||
+        serialPts->GetNumberOfIds() != threadedPts->GetNumberOfIds())
+    {
+      cerr << "Error: different cell " << c << endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < serialPts->GetNumberOfIds(); ++i)
+    {
+      vtkIdType serialId = serialPts->GetId(i);
+      vtkIdType threadedId = threadedPts->GetId(i);
+      double x1[3], x2[3];
+      serial->GetPoint(serialId, x1);
+      threaded->GetPoint(threadedId, x2);
+      if (x1[0] != x2[0] || x1[1] != x2[1] || x1[2] != x2[2] ||
+          serialScalars->GetComponent(serialId, 1) !=
+          threadedScalars->GetComponent(threadedId, 1))
+      {
+        cerr << "Error: different points in cell " << c << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}
+
+int TestThresholdThreaded(int, char *[])
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid.GetPointer(), 12);
+
+  vtkNew<vtkThreshold> serial;
+  serial->SetInputData(grid.GetPointer());
+  vtkNew<vtkThreshold> threaded;
+  threaded->SetInputData(grid.GetPointer());
+  threaded->ThreadedOn();
+
+  // Point scalars, with all, any or the continuous range of the scalars,
+  // for the selected component or all of them
+  for (int config = 0; config < 6; ++config)
+  {
+    vtkThreshold *filters[2] = { serial.GetPointer(), threaded.GetPointer() };
+    for (int f = 0; f < 2; ++f)
+    {
+      filters[f]->ThresholdBetween(2.0, 7.5);
+      filters[f]->SetAllScalars(config % 3 == 0);
+      filters[f]->SetUseContinuousCellRange(config % 3 == 2);
+      filters[f]->SetComponentMode(config < 3 ?
+                                   VTK_COMPONENT_MODE_USE_SELECTED :
+                                   VTK_COMPONENT_MODE_USE_ANY);
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+      {
+        filters[f]->Update();
+      });
+    }
+    if (serial->GetOutput()->GetNumberOfCells() == 0 ||
+        !SameCells(serial->GetOutput(), threaded->GetOutput()))
+    {
+      cerr << "Error: with point scalars, configuration " << config << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Cell scalars
+  serial->SetInputArrayToProcess(0, 0, 0,
+                                 vtkDataObject::FIELD_ASSOCIATION_CELLS,
+                                 "CellIds");
+  serial->ThresholdByLower(500);
+  serial->Update();
+  threaded->SetInputArrayToProcess(0, 0, 0,
+                                   vtkDataObject::FIELD_ASSOCIATION_CELLS,
+                                   "CellIds");
+  threaded->ThresholdByLower(500);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Update();
+  });
+  if (serial->GetOutput()->GetNumberOfCells() == 0 ||
+      !SameCells(serial->GetOutput(), threaded->GetOutput()))
+  {
+    cerr << "Error: with cell scalars" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The cells extracted by several threads are the ones of a single thread
+  if (!vtkTest::SameOutputsWithThreads(threaded.GetPointer()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestWindowedSincPolyDataFilterThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded smoothing iterations of the windowed sinc filter
+// produce the same points as the serial ones.
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataComparison.h"
+#include "vtkWindowedSincPolyDataFilter.h"
+
+#include <cmath>
+
+namespace
+{
+
+// A noisy wavy surface of triangles, with a polyline and vertices
+void MakeSurface(vtkPolyData *surface, int n, int dataType)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(3);
+  vtkNew<vtkPoints> points;
+  points->SetDataType(dataType);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  for (int j = 0; j <= n; ++j)
+  {
+    for (int i = 0; i <= n; ++i)
+    {
+      random->Next();
+      double noise = 0.2 * (random->GetValue() - 0.5);
+      points->InsertNextPoint(i, j, std::sin(0.4 * i) * std::cos(0.3 * j) +
+                              noise);
+      scalars->InsertNextValue(i + j);
+    }
+  }
+  surface->SetPoints(points.GetPointer());
+  surface->GetPointData()->SetScalars(scalars.GetPointer());
+
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      vtkIdType p0 = j * (n + 1) + i;
+      vtkIdType tri1[3] = { p0, p0 + 1, p0 + n + 2 };
+      vtkIdType tri2[3] = { p0, p0 + n + 2, p0 + n + 1 };
+      polys->InsertNextCell(3, tri1);
+      polys->InsertNextCell(3, tri2);
+    }
+  }
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> verts;
+  vtkIdType first = points->GetNumberOfPoints();
+  lines->InsertNextCell(n);
+  for (int i = 0; i < n; ++i)
+  {
+    random->Next();
+    lines->InsertCellPoint(points->InsertNextPoint(
+      i, -2.0 + 0.3 * random->GetValue(), 0.0));
+    scalars->InsertNextValue(-i);
+  }
+  vtkIdType vert[2] = { first, (n / 2) * (n + 2) };
+  verts->InsertNextCell(2, vert);
+  surface->SetVerts(verts.GetPointer());
+  surface->SetLines(lines.GetPointer());
+  surface->SetPolys(polys.GetPointer());
+}
+
+bool SameSmoothing(vtkPolyData *serial, vtkPolyData *threaded)
+{
+  if (!vtkTest::SameArrays(serial->GetPoints()->GetData(),
+                           threaded->GetPoints()->GetData()))
+  {
+    cerr << "Error: different points" << endl;
+    return false;
+  }
+  return vtkTest::SameAttributes(serial->GetPointData(),
+                                 threaded->GetPointData());
+}
+
+}
+
+int TestWindowedSincPolyDataFilterThreaded(int, char *[])
+{
+  vtkNew<vtkPolyData> surface;
+  MakeSurface(surface.GetPointer(), 30, VTK_FLOAT);
+
+  for (int config = 0; config < 5; ++config)
+  {
+    vtkNew<vtkWindowedSincPolyDataFilter> serial;
+    vtkNew<vtkWindowedSincPolyDataFilter> threaded;
+    threaded->ThreadedOn();
+    vtkWindowedSincPolyDataFilter *filters[2] =
+      { serial.GetPointer(), threaded.GetPointer() };
+    for (int f = 0; f < 2; ++f)
+    {
+      filters[f]->SetInputData(surface.GetPointer());
+      switch (config)
+      {
+        case 0:
+          break;
+        case 1:
+          filters[f]->BoundarySmoothingOff();
+          filters[f]->GenerateErrorScalarsOn();
+          break;
+        case 2:
+          filters[f]->FeatureEdgeSmoothingOn();
+          filters[f]->SetFeatureAngle(20.0);
+          filters[f]->GenerateErrorVectorsOn();
+          break;
+        case 3:
+          filters[f]->NormalizeCoordinatesOn();
+          filters[f]->SetNumberOfIterations(37);
+          filters[f]->SetPassBand(0.01);
+          break;
+        default:
+          filters[f]->SetNumberOfIterations(5);
+          break;
+      }
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+      {
+        filters[f]->Update();
+      });
+    }
+    if (!SameSmoothing(serial->GetOutput(), threaded->GetOutput()))
+    {
+      cerr << "Error: configuration " << config << endl;
+      return EXIT_FAILURE;
+    }
+
+    // A single thread smooths as the 4 threads above
+    vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]()
+    {
+      threaded->Modified();
+      threaded->Update();
+    });
+    if (!SameSmoothing(serial->GetOutput(), threaded->GetOutput()))
+    {
+      cerr << "Error: configuration " << config << " with one thread" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
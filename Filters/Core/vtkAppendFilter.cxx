@@ -14,24 +14,35 @@
 =========================================================================*/
 #include "vtkAppendFilter.h"
 
+#include "vtkArrayDispatch.h"
+#include "vtkArrayListTemplate.h"
+#include "vtkAssume.h"
 #include "vtkBoundingBox.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSetAttributes.h"
 #include "vtkDataSetCollection.h"
 #include "vtkExecutive.h"
+#include "vtkIdTypeArray.h"
 #include "vtkIncrementalOctreePointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <cstring>
 #include <set>
 #include <string>
+#include <vector>
 
 vtkStandardNewMacro(vtkAppendFilter);
 
@@ -41,6 +52,7 @@ vtkAppendFilter::vtkAppendFilter()
   this->InputList = NULL;
   this->MergePoints = 0;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->Threaded = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -104,6 +116,267 @@ vtkDataSetCollection *vtkAppendFilter::GetInputList()
   return this->InputList;
 }
 
+//----------------------------------------------------------------------------
+namespace {
+struct vtkAppendFilterCopyWorker
+{
+  vtkIdType DstStart;
+  vtkIdType NumTuples;
+
+  vtkAppendFilterCopyWorker(vtkIdType dstStart, vtkIdType numTuples)
+    : DstStart(dstStart), NumTuples(numTuples)
+  {}
+
+  template <typename Array1T, typename Array2T>
+  void operator()(Array1T *dest, Array2T *src)
+  {
+    vtkDataArrayAccessor<Array1T> d(dest);
+    vtkDataArrayAccessor<Array2T> s(src);
+    VTK_ASSUME(src->GetNumberOfComponents() == dest->GetNumberOfComponents());
+
+    const int numComps = src->GetNumberOfComponents();
+
+    for (vtkIdType t = 0; t < this->NumTuples; ++t)
+    {
+      for (int c = 0; c < numComps; ++c)
+      {
+        d.Set(t + this->DstStart, c, s.Get(t, c));
+      }
+    }
+  }
+};
+
+// Copy the first n tuples of src to the tuples of dest, which are already
+// allocated, starting at dstStart.
+void vtkAppendFilterCopyTuples(vtkAbstractArray *dest, vtkAbstractArray *src,
+                               vtkIdType dstStart, vtkIdType n)
+{
+  vtkDataArray *destDA = vtkArrayDownCast<vtkDataArray>(dest);
+  vtkDataArray *srcDA = vtkArrayDownCast<vtkDataArray>(src);
+  if (!destDA || !srcDA) // String array, etc
+  {
+    for (vtkIdType t = 0; t < n; ++t)
+    {
+      dest->SetTuple(dstStart + t, t, src);
+    }
+    return;
+  }
+
+  vtkAppendFilterCopyWorker worker(dstStart, n);
+  if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(destDA, srcDA,
+                                                         worker))
+  {
+    worker(destDA, srcDA);
+  }
+}
+
+// The number of connectivity entries of the cells of each input
+struct vtkAppendFilterCountConnectivity
+{
+  std::vector<vtkDataSet*> &Inputs;
+  std::vector<vtkIdType> &Sizes;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  vtkAppendFilterCountConnectivity(std::vector<vtkDataSet*> &inputs,
+                                   std::vector<vtkIdType> &sizes)
+    : Inputs(inputs), Sizes(sizes)
+  {}
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPoints = this->CellPoints.Local();
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      vtkDataSet *dataSet = this->Inputs[idx];
+      vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
+      if (ug)
+      {
+        this->Sizes[idx] = ug->GetCells() ?
+          ug->GetCells()->GetNumberOfConnectivityEntries() : 0;
+        continue;
+      }
+      vtkIdType size = 0;
+      vtkIdType numCells = dataSet->GetNumberOfCells();
+      for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+      {
+        dataSet->GetCellPoints(cellId, cellPoints);
+        size += 1 + cellPoints->GetNumberOfIds();
+      }
+      this->Sizes[idx] = size;
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Each input copies its points and cells to its own range of the output
+struct vtkAppendFilterAppendGeometry
+{
+  std::vector<vtkDataSet*> &Inputs;
+  std::vector<vtkIdType> &PtOffsets;
+  std::vector<vtkIdType> &CellOffsets;
+  std::vector<vtkIdType> &ConnOffsets;
+  vtkPoints *NewPts;
+  vtkIdType *Connectivity;
+  unsigned char *Types;
+  vtkIdType *Locations;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  vtkAppendFilterAppendGeometry(std::vector<vtkDataSet*> &inputs,
+                                std::vector<vtkIdType> &ptOffsets,
+                                std::vector<vtkIdType> &cellOffsets,
+                                std::vector<vtkIdType> &connOffsets)
+    : Inputs(inputs), PtOffsets(ptOffsets), CellOffsets(cellOffsets),
+      ConnOffsets(connOffsets), NewPts(NULL), Connectivity(NULL),
+      Types(NULL), Locations(NULL)
+  {}
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPoints = this->CellPoints.Local();
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      vtkDataSet *dataSet = this->Inputs[idx];
+      vtkIdType ptOffset = this->PtOffsets[idx];
+      vtkIdType cellOffset = this->CellOffsets[idx];
+      vtkIdType connOffset = this->ConnOffsets[idx];
+      vtkIdType numPts = dataSet->GetNumberOfPoints();
+      vtkIdType numCells = dataSet->GetNumberOfCells();
+
+      // copy points
+      vtkPointSet *ps = vtkPointSet::SafeDownCast(dataSet);
+      if (ps && ps->GetPoints())
+      {
+        vtkAppendFilterCopyTuples(this->NewPts->GetData(),
+                                  ps->GetPoints()->GetData(), ptOffset,
+                                  numPts);
+      }
+      else
+      {
+        double x[3];
+        for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+        {
+          dataSet->GetPoint(ptId, x);
+          this->NewPts->SetPoint(ptOffset + ptId, x);
+        }
+      }
+
+      // copy cells
+      vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
+      if (ug && numCells > 0)
+      {
+        memcpy(this->Types + cellOffset,
+               ug->GetCellTypesArray()->GetPointer(0), numCells);
+        const vtkIdType *locations =
+          ug->GetCellLocationsArray()->GetPointer(0);
+        for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+        {
+          this->Locations[cellOffset + cellId] = connOffset +
+            locations[cellId];
+        }
+        vtkCellArray *cells = ug->GetCells();
+        const vtkIdType *pSrc = cells->GetPointer();
+        const vtkIdType *pEnd = pSrc + cells->GetNumberOfConnectivityEntries();
+        vtkIdType *pDest = this->Connectivity + connOffset;
+        while (pSrc < pEnd)
+        {
+          vtkIdType npts = *pSrc++;
+          *pDest++ = npts;
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            *pDest++ = ptOffset + *pSrc++;
+          }
+        }
+        continue;
+      }
+      vtkIdType *pDest = this->Connectivity + connOffset;
+      for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+      {
+        dataSet->GetCellPoints(cellId, cellPoints);
+        this->Types[cellOffset + cellId] =
+          static_cast<unsigned char>(dataSet->GetCellType(cellId));
+        this->Locations[cellOffset + cellId] = pDest - this->Connectivity;
+        vtkIdType npts = cellPoints->GetNumberOfIds();
+        *pDest++ = npts;
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          *pDest++ = ptOffset + cellPoints->GetId(i);
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Each input copies its arrays to its own range of the output arrays
+struct vtkAppendFilterAppendArrays
+{
+  std::vector<vtkDataSet*> &Inputs;
+  std::vector<vtkIdType> &Offsets;
+  const std::set<std::string> &DataArrayNames;
+  int AttributesType;
+  vtkDataSetAttributes *OutputData;
+
+  vtkAppendFilterAppendArrays(std::vector<vtkDataSet*> &inputs,
+                              std::vector<vtkIdType> &offsets,
+                              const std::set<std::string> &dataArrayNames,
+                              int attributesType,
+                              vtkDataSetAttributes *outputData)
+    : Inputs(inputs), Offsets(offsets), DataArrayNames(dataArrayNames),
+      AttributesType(attributesType), OutputData(outputData)
+  {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      vtkDataSetAttributes* inputData =
+        this->Inputs[idx]->GetAttributes(this->AttributesType);
+      vtkIdType offset = this->Offsets[idx];
+      for (std::set<std::string>::const_iterator it =
+           this->DataArrayNames.begin(); it != this->DataArrayNames.end();
+           ++it)
+      {
+        const char* arrayName = it->c_str();
+        vtkAbstractArray* srcArray = inputData->GetAbstractArray(arrayName);
+        vtkAbstractArray* dstArray =
+          this->OutputData->GetAbstractArray(arrayName);
+        vtkAppendFilterCopyTuples(dstArray, srcArray, offset,
+                                  srcArray->GetNumberOfTuples());
+      }
+
+      // Copy the attributes whose array name is NULL
+      for (int attribute = 0;
+           attribute < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attribute)
+      {
+        vtkAbstractArray* srcArray = inputData->GetAbstractAttribute(attribute);
+        vtkAbstractArray* dstArray =
+          this->OutputData->GetAbstractAttribute(attribute);
+        if (srcArray && !srcArray->GetName() &&
+            dstArray && !dstArray->GetName())
+        {
+          vtkAppendFilterCopyTuples(dstArray, srcArray, offset,
+                                    srcArray->GetNumberOfTuples());
+        }
+      }
+    }
+  }
+};
+} // end anon namespace
+
 //----------------------------------------------------------------------------
 // Append data sets into single unstructured grid
 int vtkAppendFilter::RequestData(
@@ -166,8 +439,44 @@ int vtkAppendFilter::RequestData(
     return 1;
   }
 
+  // Merged points and polyhedra are appended serially
+  bool threaded = this->Threaded && !reallyMergePoints;
+  inputs->InitTraversal(iter);
+  while (threaded && (dataSet = inputs->GetNextDataSet(iter)))
+  {
+    vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
+    if (ug && ug->GetFaces())
+    {
+      threaded = false;
+    }
+  }
+
+  // A single non-empty unstructured grid is passed through, when its points
+  // have the requested precision
+  if (threaded && inputs->GetNumberOfItems() == 1)
+  {
+    vtkUnstructuredGrid *ug =
+      vtkUnstructuredGrid::SafeDownCast(inputs->GetItemAsObject(0));
+    if (ug && ug->GetPoints())
+    {
+      int dataType = ug->GetPoints()->GetDataType();
+      if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION ||
+          (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION &&
+           dataType == VTK_FLOAT) ||
+          (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION &&
+           dataType == VTK_DOUBLE))
+      {
+        output->ShallowCopy(ug);
+        return 1;
+      }
+    }
+  }
+
   // Now we can allocate memory
-  output->Allocate(totalNumCells);
+  if (!threaded)
+  {
+    output->Allocate(totalNumCells);
+  }
 
   vtkSmartPointer<vtkPoints> newPts = vtkSmartPointer<vtkPoints>::New();
 
@@ -208,15 +517,8 @@ int vtkAppendFilter::RequestData(
     newPts->SetNumberOfPoints(totalNumPts);
   }
 
-  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
-  ptIds->Allocate(VTK_CELL_SIZE);
-  vtkSmartPointer<vtkIdList> newPtIds = vtkSmartPointer<vtkIdList>::New();
-  newPtIds->Allocate(VTK_CELL_SIZE);
-
-  vtkIdType twentieth = (totalNumPts + totalNumCells)/20 + 1;
-
   // For optionally merging duplicate points
-  vtkIdType* globalIndices = new vtkIdType[totalNumPts];
+  vtkIdType* globalIndices = threaded ? NULL : new vtkIdType[totalNumPts];
   vtkSmartPointer<vtkIncrementalOctreePointLocator> ptInserter;
   if (reallyMergePoints)
   {
@@ -240,6 +542,52 @@ int vtkAppendFilter::RequestData(
     ptInserter->InitPointInsertion(newPts, outputBounds);
   }
 
+  if (threaded)
+  {
+    this->ThreadedAppendGeometry(inputs, newPts, output);
+    this->UpdateProgress(0.5);
+  }
+  else
+  {
+    this->AppendGeometry(inputs, newPts, ptInserter, globalIndices,
+                         totalNumPts + totalNumCells, output);
+  }
+
+  // Now copy the array data
+  this->AppendArrays(
+    vtkDataObject::POINT, inputVector, globalIndices, output, newPts->GetNumberOfPoints());
+  this->UpdateProgress(0.75);
+  this->AppendArrays(vtkDataObject::CELL, inputVector, NULL, output, output->GetNumberOfCells());
+  this->UpdateProgress(1.0);
+
+  // Update ourselves and release memory
+  output->SetPoints(newPts);
+  output->Squeeze();
+
+  delete[] globalIndices;
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkAppendFilter::AppendGeometry(vtkDataSetCollection* inputs,
+                                     vtkPoints* newPts,
+                                     vtkIncrementalOctreePointLocator* ptInserter,
+                                     vtkIdType* globalIndices,
+                                     vtkIdType totalNumberOfElements,
+                                     vtkUnstructuredGrid* output)
+{
+  vtkCollectionSimpleIterator iter;
+  vtkDataSet* dataSet = 0;
+  bool reallyMergePoints = (ptInserter != NULL);
+
+  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
+  ptIds->Allocate(VTK_CELL_SIZE);
+  vtkSmartPointer<vtkIdList> newPtIds = vtkSmartPointer<vtkIdList>::New();
+  newPtIds->Allocate(VTK_CELL_SIZE);
+
+  vtkIdType twentieth = totalNumberOfElements/20 + 1;
+
   // append the blocks / pieces in terms of the geoemetry and topology
   vtkIdType count = 0;
   vtkIdType ptOffset = 0;
@@ -319,22 +667,70 @@ int vtkAppendFilter::RequestData(
     }
     ptOffset += dataSetNumPts;
   }
+}
 
+//----------------------------------------------------------------------------
+void vtkAppendFilter::ThreadedAppendGeometry(vtkDataSetCollection* inputs,
+                                             vtkPoints* newPts,
+                                             vtkUnstructuredGrid* output)
+{
+  std::vector<vtkDataSet*> dataSets;
+  vtkCollectionSimpleIterator iter;
+  inputs->InitTraversal(iter);
+  vtkDataSet* dataSet = NULL;
+  vtkNew<vtkIdList> cellPoints;
+  while ((dataSet = inputs->GetNextDataSet(iter)))
+  {
+    // Build the cells of the input before they are accessed in parallel
+    if (dataSet->GetNumberOfCells() > 0)
+    {
+      dataSet->GetCellPoints(0, cellPoints.GetPointer());
+      dataSet->GetCellType(0);
+    }
+    dataSets.push_back(dataSet);
+  }
 
-  // Now copy the array data
-  this->AppendArrays(
-    vtkDataObject::POINT, inputVector, globalIndices, output, newPts->GetNumberOfPoints());
-  this->UpdateProgress(0.75);
-  this->AppendArrays(vtkDataObject::CELL, inputVector, NULL, output, output->GetNumberOfCells());
-  this->UpdateProgress(1.0);
-
-  // Update ourselves and release memory
-  output->SetPoints(newPts);
-  output->Squeeze();
-
-  delete[] globalIndices;
+  const vtkIdType numInputs = static_cast<vtkIdType>(dataSets.size());
+  std::vector<vtkIdType> connSizes(numInputs);
+  vtkAppendFilterCountConnectivity count(dataSets, connSizes);
+  vtkSMPTools::For(0, numInputs, count);
+
+  // The start of each input in the output
+  std::vector<vtkIdType> ptOffsets(numInputs);
+  std::vector<vtkIdType> cellOffsets(numInputs);
+  std::vector<vtkIdType> connOffsets(numInputs);
+  vtkIdType numPts = 0;
+  vtkIdType numCells = 0;
+  vtkIdType connSize = 0;
+  for (vtkIdType idx = 0; idx < numInputs; ++idx)
+  {
+    ptOffsets[idx] = numPts;
+    cellOffsets[idx] = numCells;
+    connOffsets[idx] = connSize;
+    numPts += dataSets[idx]->GetNumberOfPoints();
+    numCells += dataSets[idx]->GetNumberOfCells();
+    connSize += connSizes[idx];
+  }
 
-  return 1;
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(connSize);
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(numCells);
+  vtkNew<vtkIdTypeArray> locations;
+  locations->SetNumberOfValues(numCells);
+
+  vtkAppendFilterAppendGeometry append(dataSets, ptOffsets, cellOffsets,
+                                       connOffsets);
+  append.NewPts = newPts;
+  append.Connectivity = connectivity->GetPointer(0);
+  append.Types = types->GetPointer(0);
+  append.Locations = locations->GetPointer(0);
+  vtkSMPTools::For(0, numInputs, append);
+
+  vtkNew<vtkCellArray> cells;
+  cells->SetCells(numCells, connectivity.GetPointer());
+  output->SetCells(types.GetPointer(), locations.GetPointer(),
+                   cells.GetPointer());
 }
 
 //----------------------------------------------------------------------------
@@ -567,6 +963,28 @@ void vtkAppendFilter::AppendArrays(int attributesType,
   //////////////////////////////////////////////////////////////
   // Phase 4 - Copy data
   //////////////////////////////////////////////////////////////
+
+  // Without merged points, each input is copied to its own range of tuples.
+  // Bit arrays cannot be written concurrently.
+  if (this->Threaded && !globalIds && !ArrayList::HasBitArrays(outputData))
+  {
+    std::vector<vtkDataSet*> dataSets;
+    std::vector<vtkIdType> offsets;
+    vtkIdType numElements = 0;
+    inputs->InitTraversal(iter);
+    while ((dataSet = inputs->GetNextDataSet(iter)))
+    {
+      dataSets.push_back(dataSet);
+      offsets.push_back(numElements);
+      numElements += attributesType == vtkDataObject::POINT ?
+        dataSet->GetNumberOfPoints() : dataSet->GetNumberOfCells();
+    }
+    vtkAppendFilterAppendArrays append(dataSets, offsets, dataArrayNames,
+                                       attributesType, outputData);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(dataSets.size()), append);
+    return;
+  }
+
   vtkIdType offset = 0;
   inputs->InitTraversal(iter);
   while ((dataSet = inputs->GetNextDataSet(iter)))
@@ -665,4 +1083,5 @@ void vtkAppendFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "MergePoints:" << (this->MergePoints?"On":"Off") << "\n";
   os << indent << "OutputPointsPrecision: "
      << this->OutputPointsPrecision << "\n";
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
@@ -35,6 +35,8 @@
 
 class vtkDataSetAttributes;
 class vtkDataSetCollection;
+class vtkIncrementalOctreePointLocator;
+class vtkPoints;
 
 class VTKFILTERSCORE_EXPORT vtkAppendFilter : public vtkUnstructuredGridAlgorithm
 {
@@ -92,6 +94,23 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   //@}
 
+  //@{
+  /**
+   * Set/Get whether the inputs are appended in parallel, with vtkSMPTools,
+   * when the points are not merged. The output sizes are computed first,
+   * then each input copies its points, cells and arrays to its own range of
+   * the output with typed loops. A single non-empty unstructured grid is
+   * shallow copied to the output, unless its points have to be converted to
+   * another precision. This pass-through keeps the field data and all the
+   * arrays of the grid, whereas the serial append only copies the arrays
+   * that all the inputs share. Inputs with polyhedra or bit arrays are
+   * appended serially. Default is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
 protected:
   vtkAppendFilter();
   ~vtkAppendFilter() VTK_OVERRIDE;
@@ -111,6 +130,7 @@ protected:
   int MergePoints;
 
   int OutputPointsPrecision;
+  int Threaded;
 
 private:
   vtkAppendFilter(const vtkAppendFilter&) VTK_DELETE_FUNCTION;
@@ -125,6 +145,22 @@ private:
                     vtkIdType* globalIds,
                     vtkUnstructuredGrid* output,
                     vtkIdType totalNumberOfElements);
+
+  // Append the points and cells of the inputs one after the other. The
+  // points are merged when ptInserter is not NULL, and globalIndices
+  // receives the output id of each input point.
+  void AppendGeometry(vtkDataSetCollection* inputs,
+                      vtkPoints* newPts,
+                      vtkIncrementalOctreePointLocator* ptInserter,
+                      vtkIdType* globalIndices,
+                      vtkIdType totalNumberOfElements,
+                      vtkUnstructuredGrid* output);
+
+  // Append the points and cells of the inputs in parallel, without merging
+  // the points. The inputs must not have polyhedra.
+  void ThreadedAppendGeometry(vtkDataSetCollection* inputs,
+                              vtkPoints* newPts,
+                              vtkUnstructuredGrid* output);
 };
 
 
@@ -16,6 +16,7 @@
 
 #include "vtkAssume.h"
 #include "vtkArrayDispatch.h"
+#include "vtkArrayListTemplate.h"
 #include "vtkAlgorithmOutput.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
@@ -26,11 +27,13 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTrivialProducer.h"
 
 #include <cassert>
 #include <cstdlib>
+#include <vector>
 
 vtkStandardNewMacro(vtkAppendPolyData);
 
@@ -40,6 +43,7 @@ vtkAppendPolyData::vtkAppendPolyData()
   this->ParallelStreaming = 0;
   this->UserManagedInputs = 0;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->Threaded = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -127,19 +131,213 @@ void vtkAppendPolyData::SetInputConnectionByNumber(int num,
   this->SetNthInputConnection(0, num, input);
 }
 
+//----------------------------------------------------------------------------
+namespace {
+struct AppendDataWorker
+{
+  vtkIdType DstStart;
+  vtkIdType SrcStart;
+  vtkIdType NumTuples;
+
+  AppendDataWorker(vtkIdType dstStart, vtkIdType srcStart,
+                   vtkIdType numTuples)
+    : DstStart(dstStart), SrcStart(srcStart), NumTuples(numTuples)
+  {}
+
+  template <typename Array1T, typename Array2T>
+  void operator()(Array1T *dest, Array2T *src)
+  {
+    vtkDataArrayAccessor<Array1T> d(dest);
+    vtkDataArrayAccessor<Array2T> s(src);
+    VTK_ASSUME(src->GetNumberOfComponents() == dest->GetNumberOfComponents());
+
+    const int numComps = src->GetNumberOfComponents();
+
+    for (vtkIdType t = 0; t < this->NumTuples; ++t)
+    {
+      for (int c = 0; c < numComps; ++c)
+      {
+        d.Set(t + this->DstStart, c, s.Get(t + this->SrcStart, c));
+      }
+    }
+  }
+};
+
+// Copy n tuples of src to the tuples of dest, which are already allocated,
+// starting at dstStart.
+void vtkAppendPolyDataCopyTuples(vtkAbstractArray *dest, vtkAbstractArray *src,
+                                 vtkIdType dstStart, vtkIdType n,
+                                 vtkIdType srcStart)
+{
+  vtkDataArray *destDA = vtkArrayDownCast<vtkDataArray>(dest);
+  vtkDataArray *srcDA = vtkArrayDownCast<vtkDataArray>(src);
+  if (!destDA || !srcDA) // String array, etc
+  {
+    for (vtkIdType t = 0; t < n; ++t)
+    {
+      dest->SetTuple(dstStart + t, srcStart + t, src);
+    }
+    return;
+  }
+
+  AppendDataWorker worker(dstStart, srcStart, n);
+  if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(destDA, srcDA,
+                                                         worker))
+  {
+    worker(destDA, srcDA);
+  }
+}
+
+// The parallel version of vtkDataSetAttributes::CopyData() with field lists
+void vtkAppendPolyDataCopyFields(vtkDataSetAttributes::FieldList &list,
+                                 vtkDataSetAttributes *outDSA,
+                                 vtkDataSetAttributes *inDSA, int idx,
+                                 vtkIdType dstStart, vtkIdType n,
+                                 vtkIdType srcStart)
+{
+  for (int i = 0; i < list.GetNumberOfFields(); ++i)
+  {
+    if (list.GetFieldIndex(i) >= 0 && list.GetDSAIndex(idx, i) >= 0)
+    {
+      vtkAppendPolyDataCopyTuples(
+        outDSA->GetAbstractArray(list.GetFieldIndex(i)),
+        inDSA->GetAbstractArray(list.GetDSAIndex(idx, i)),
+        dstStart, n, srcStart);
+    }
+  }
+}
+
+// Copy the connectivity of src to pDest, offsetting the point ids. Returns
+// the next pointer in pDest.
+vtkIdType *vtkAppendPolyDataCopyCells(vtkIdType *pDest, vtkCellArray *src,
+                                      vtkIdType offset)
+{
+  vtkIdType *pSrc, *end, *pNum;
+
+  if (src == NULL)
+  {
+    return pDest;
+  }
+
+  pSrc = src->GetPointer();
+  end = pSrc + src->GetNumberOfConnectivityEntries();
+  pNum = pSrc;
+
+  while (pSrc < end)
+  {
+    if (pSrc == pNum)
+    {
+      // move cell pointer to next cell
+      pNum += 1+*pSrc;
+      // copy the number of cells
+      *pDest++ = *pSrc++;
+    }
+    else
+    {
+      // offset the point index
+      *pDest++ = offset + *pSrc++;
+    }
+  }
+
+  return pDest;
+}
+
+// Each input is appended to its own range of points, cells, connectivity
+// entries and tuples, whose starts are computed beforehand.
+struct vtkAppendPolyDataFunctor
+{
+  vtkPolyData **Inputs;
+  vtkDataSetAttributes::FieldList *PtList;
+  vtkDataSetAttributes::FieldList *CellList;
+  vtkPointData *OutputPD;
+  vtkCellData *OutputCD;
+  vtkDataArray *NewPts;
+  vtkDataArray *NewPtAttributes[vtkDataSetAttributes::NUM_ATTRIBUTES];
+  // The verts, lines, polys and strips of the output
+  vtkIdType *Cells[4];
+
+  // The starts of each input, and its index in the field lists (-1 when
+  // the input has no points or no cells)
+  std::vector<vtkIdType> PtOffsets;
+  std::vector<vtkIdType> CellOffsets[4];
+  std::vector<vtkIdType> ConnOffsets[4];
+  std::vector<int> PDIndices;
+  std::vector<int> CDIndices;
+
+  vtkAppendPolyDataFunctor(int numInputs)
+    : PtOffsets(numInputs), PDIndices(numInputs), CDIndices(numInputs)
+  {
+    for (int k = 0; k < 4; ++k)
+    {
+      this->CellOffsets[k].resize(numInputs);
+      this->ConnOffsets[k].resize(numInputs);
+    }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      vtkPolyData *ds = this->Inputs[idx];
+      vtkIdType ptOffset = this->PtOffsets[idx];
+      if (this->PDIndices[idx] >= 0)
+      {
+        vtkPointData *inPD = ds->GetPointData();
+        vtkIdType numPts = ds->GetNumberOfPoints();
+        vtkAppendPolyDataCopyTuples(this->NewPts, ds->GetPoints()->GetData(),
+                                    ptOffset, numPts, 0);
+        for (int attr = 0; attr < vtkDataSetAttributes::NUM_ATTRIBUTES;
+             ++attr)
+        {
+          if (this->NewPtAttributes[attr])
+          {
+            vtkAppendPolyDataCopyTuples(this->NewPtAttributes[attr],
+                                        inPD->GetAttribute(attr),
+                                        ptOffset, numPts, 0);
+          }
+        }
+        vtkAppendPolyDataCopyFields(*this->PtList, this->OutputPD, inPD,
+                                    this->PDIndices[idx], ptOffset, numPts,
+                                    0);
+      }
+
+      if (this->CDIndices[idx] >= 0)
+      {
+        vtkCellData *inCD = ds->GetCellData();
+        vtkCellArray *inCells[4] =
+          { ds->GetVerts(), ds->GetLines(), ds->GetPolys(), ds->GetStrips() };
+        vtkIdType numCells[4] =
+          { ds->GetNumberOfVerts(), ds->GetNumberOfLines(),
+            ds->GetNumberOfPolys(), ds->GetNumberOfStrips() };
+        vtkIdType srcStart = 0;
+        for (int k = 0; k < 4; ++k)
+        {
+          vtkAppendPolyDataCopyCells(this->Cells[k] + this->ConnOffsets[k][idx],
+                                     inCells[k], ptOffset);
+          vtkAppendPolyDataCopyFields(*this->CellList, this->OutputCD, inCD,
+                                      this->CDIndices[idx],
+                                      this->CellOffsets[k][idx], numCells[k],
+                                      srcStart);
+          srcStart += numCells[k];
+        }
+      }
+    }
+  }
+};
+} // end anon namespace
+
 //----------------------------------------------------------------------------
 int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
     vtkPolyData* inputs[], int numInputs)
 {
   int idx;
   vtkPolyData *ds;
-  vtkPoints  *inPts;
   vtkPoints *newPts;
-  vtkCellArray *inVerts, *newVerts;
-  vtkCellArray *inLines, *newLines;
-  vtkCellArray *inPolys, *newPolys;
+  vtkCellArray *newVerts;
+  vtkCellArray *newLines;
+  vtkCellArray *newPolys;
   vtkIdType sizePolys, numPolys;
-  vtkCellArray *inStrips, *newStrips;
+  vtkCellArray *newStrips;
   vtkIdType numPts, numCells;
   vtkPointData *inPD = NULL;
   vtkCellData *inCD = NULL;
@@ -154,6 +352,37 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
 
   vtkDebugMacro(<<"Appending polydata");
 
+  // A single non-empty input is passed through, when its points have the
+  // requested precision
+  if (this->Threaded)
+  {
+    vtkPolyData *nonEmpty = NULL;
+    int numNonEmpty = 0;
+    for (idx = 0; idx < numInputs; ++idx)
+    {
+      ds = inputs[idx];
+      if (ds != NULL &&
+          (ds->GetNumberOfPoints() > 0 || ds->GetNumberOfCells() > 0))
+      {
+        nonEmpty = ds;
+        ++numNonEmpty;
+      }
+    }
+    if (numNonEmpty == 1 && nonEmpty->GetPoints())
+    {
+      int dataType = nonEmpty->GetPoints()->GetDataType();
+      if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION ||
+          (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION &&
+           dataType == VTK_FLOAT) ||
+          (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION &&
+           dataType == VTK_DOUBLE))
+      {
+        output->ShallowCopy(nonEmpty);
+        return 1;
+      }
+    }
+  }
+
   // loop over all data sets, checking to see what point data is available.
   numPts = 0;
   numCells = 0;
@@ -416,6 +645,194 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
   outputPD->CopyAllocate(ptList,numPts);
   outputCD->CopyAllocate(cellList,numCells);
 
+  vtkDataArray *newPtAttributes[vtkDataSetAttributes::NUM_ATTRIBUTES] = {};
+  newPtAttributes[vtkDataSetAttributes::SCALARS] = newPtScalars;
+  newPtAttributes[vtkDataSetAttributes::VECTORS] = newPtVectors;
+  newPtAttributes[vtkDataSetAttributes::NORMALS] = newPtNormals;
+  newPtAttributes[vtkDataSetAttributes::TCOORDS] = newPtTCoords;
+  newPtAttributes[vtkDataSetAttributes::TENSORS] = newPtTensors;
+
+  // Bit arrays cannot be appended in parallel. The point attributes are
+  // instances of the attributes of inPD, the last input with points.
+  bool threaded = this->Threaded && !ArrayList::HasBitArrays(outputPD) &&
+    !ArrayList::HasBitArrays(outputCD) &&
+    (!inPD || !ArrayList::HasBitArrays(inPD));
+
+  if (threaded)
+  {
+    // The arrays are assigned in place
+    for (int i = 0; i < outputPD->GetNumberOfArrays(); ++i)
+    {
+      outputPD->GetAbstractArray(i)->SetNumberOfTuples(numPts);
+    }
+    for (int i = 0; i < outputCD->GetNumberOfArrays(); ++i)
+    {
+      outputCD->GetAbstractArray(i)->SetNumberOfTuples(numCells);
+    }
+
+    // The start of each input in the output
+    vtkAppendPolyDataFunctor functor(numInputs);
+    functor.Inputs = inputs;
+    functor.PtList = &ptList;
+    functor.CellList = &cellList;
+    functor.OutputPD = outputPD;
+    functor.OutputCD = outputCD;
+    functor.NewPts = newPts->GetData();
+    for (int attr = 0; attr < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attr)
+    {
+      functor.NewPtAttributes[attr] = newPtAttributes[attr];
+    }
+    functor.Cells[0] = pVerts;
+    functor.Cells[1] = pLines;
+    functor.Cells[2] = pPolys;
+    functor.Cells[3] = pStrips;
+    vtkIdType ptOffset = 0;
+    vtkIdType cellOffsets[4] =
+      { 0, numVerts, numVerts + numLines, numVerts + numLines + numPolys };
+    vtkIdType connOffsets[4] = { 0, 0, 0, 0 };
+    countPD = countCD = 0;
+    for (idx = 0; idx < numInputs; ++idx)
+    {
+      ds = inputs[idx];
+      functor.PtOffsets[idx] = ptOffset;
+      functor.PDIndices[idx] = -1;
+      functor.CDIndices[idx] = -1;
+      for (int k = 0; k < 4; ++k)
+      {
+        functor.CellOffsets[k][idx] = cellOffsets[k];
+        functor.ConnOffsets[k][idx] = connOffsets[k];
+      }
+      if (ds == NULL)
+      {
+        continue;
+      }
+      if (ds->GetNumberOfPoints() > 0)
+      {
+        functor.PDIndices[idx] = countPD++;
+        ptOffset += ds->GetNumberOfPoints();
+      }
+      if (ds->GetNumberOfCells() > 0)
+      {
+        functor.CDIndices[idx] = countCD++;
+        vtkCellArray *inCells[4] =
+          { ds->GetVerts(), ds->GetLines(), ds->GetPolys(), ds->GetStrips() };
+        cellOffsets[0] += ds->GetNumberOfVerts();
+        cellOffsets[1] += ds->GetNumberOfLines();
+        cellOffsets[2] += ds->GetNumberOfPolys();
+        cellOffsets[3] += ds->GetNumberOfStrips();
+        for (int k = 0; k < 4; ++k)
+        {
+          if (inCells[k])
+          {
+            connOffsets[k] += inCells[k]->GetNumberOfConnectivityEntries();
+          }
+        }
+      }
+    }
+
+    vtkSMPTools::For(0, numInputs, functor);
+  }
+  else
+  {
+    vtkCellArray *newCells[4] = { newVerts, newLines, newPolys, newStrips };
+    this->AppendInputs(output, inputs, numInputs, ptList, cellList, newPts,
+                       newPtAttributes, newCells);
+  }
+
+  // Update ourselves and release memory
+  //
+  output->SetPoints(newPts);
+  newPts->Delete();
+
+  if (newPtScalars)
+  {
+    output->GetPointData()->SetScalars(newPtScalars);
+    newPtScalars->Delete();
+  }
+  if (newPtNormals)
+  {
+    output->GetPointData()->SetNormals(newPtNormals);
+    newPtNormals->Delete();
+  }
+  if (newPtVectors)
+  {
+    output->GetPointData()->SetVectors(newPtVectors);
+    newPtVectors->Delete();
+  }
+  if (newPtTCoords)
+  {
+    output->GetPointData()->SetTCoords(newPtTCoords);
+    newPtTCoords->Delete();
+  }
+  if (newPtTensors)
+  {
+    output->GetPointData()->SetTensors(newPtTensors);
+    newPtTensors->Delete();
+  }
+
+  if ( newVerts->GetNumberOfCells() > 0 )
+  {
+    output->SetVerts(newVerts);
+  }
+  newVerts->Delete();
+
+  if ( newLines->GetNumberOfCells() > 0 )
+  {
+    output->SetLines(newLines);
+  }
+  newLines->Delete();
+
+  if ( newPolys->GetNumberOfCells() > 0 )
+  {
+    output->SetPolys(newPolys);
+  }
+  newPolys->Delete();
+
+  if ( newStrips->GetNumberOfCells() > 0 )
+  {
+    output->SetStrips(newStrips);
+  }
+  newStrips->Delete();
+
+  // When all optimizations are complete, this squeeze will be unnecessary.
+  // (But it does not seem to cost much.)
+  output->Squeeze();
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkAppendPolyData::AppendInputs(vtkPolyData *output,
+                                     vtkPolyData* inputs[], int numInputs,
+                                     vtkDataSetAttributes::FieldList &ptList,
+                                     vtkDataSetAttributes::FieldList &cellList,
+                                     vtkPoints *newPts,
+                                     vtkDataArray *newPtAttributes[],
+                                     vtkCellArray *newCells[4])
+{
+  int idx;
+  vtkPolyData *ds;
+  vtkPoints *inPts;
+  vtkCellArray *inVerts, *inLines, *inPolys, *inStrips;
+  vtkIdType numPts, numCells;
+  vtkPointData *inPD;
+  vtkCellData *inCD;
+  vtkPointData *outputPD = output->GetPointData();
+  vtkCellData *outputCD = output->GetCellData();
+  vtkDataArray *newPtScalars = newPtAttributes[vtkDataSetAttributes::SCALARS];
+  vtkDataArray *newPtVectors = newPtAttributes[vtkDataSetAttributes::VECTORS];
+  vtkDataArray *newPtNormals = newPtAttributes[vtkDataSetAttributes::NORMALS];
+  vtkDataArray *newPtTCoords = newPtAttributes[vtkDataSetAttributes::TCOORDS];
+  vtkDataArray *newPtTensors = newPtAttributes[vtkDataSetAttributes::TENSORS];
+  vtkIdType *pVerts = newCells[0]->GetPointer();
+  vtkIdType *pLines = newCells[1]->GetPointer();
+  vtkIdType *pPolys = newCells[2]->GetPointer();
+  vtkIdType *pStrips = newCells[3]->GetPointer();
+  vtkIdType numVerts = newCells[0]->GetNumberOfCells();
+  vtkIdType numLines = newCells[1]->GetNumberOfCells();
+  vtkIdType numPolys = newCells[2]->GetNumberOfCells();
+  int countPD, countCD;
+
   // loop over all input sets
   vtkIdType ptOffset = 0;
   vtkIdType vertOffset = 0;
@@ -510,67 +927,6 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
       ptOffset += numPts;
     }
   }
-
-  // Update ourselves and release memory
-  //
-  output->SetPoints(newPts);
-  newPts->Delete();
-
-  if (newPtScalars)
-  {
-    output->GetPointData()->SetScalars(newPtScalars);
-    newPtScalars->Delete();
-  }
-  if (newPtNormals)
-  {
-    output->GetPointData()->SetNormals(newPtNormals);
-    newPtNormals->Delete();
-  }
-  if (newPtVectors)
-  {
-    output->GetPointData()->SetVectors(newPtVectors);
-    newPtVectors->Delete();
-  }
-  if (newPtTCoords)
-  {
-    output->GetPointData()->SetTCoords(newPtTCoords);
-    newPtTCoords->Delete();
-  }
-  if (newPtTensors)
-  {
-    output->GetPointData()->SetTensors(newPtTensors);
-    newPtTensors->Delete();
-  }
-
-  if ( newVerts->GetNumberOfCells() > 0 )
-  {
-    output->SetVerts(newVerts);
-  }
-  newVerts->Delete();
-
-  if ( newLines->GetNumberOfCells() > 0 )
-  {
-    output->SetLines(newLines);
-  }
-  newLines->Delete();
-
-  if ( newPolys->GetNumberOfCells() > 0 )
-  {
-    output->SetPolys(newPolys);
-  }
-  newPolys->Delete();
-
-  if ( newStrips->GetNumberOfCells() > 0 )
-  {
-    output->SetStrips(newStrips);
-  }
-  newStrips->Delete();
-
-  // When all optimizations are complete, this squeeze will be unnecessary.
-  // (But it does not seem to cost much.)
-  output->Squeeze();
-
-  return 1;
 }
 
 //----------------------------------------------------------------------------
@@ -688,37 +1044,9 @@ void vtkAppendPolyData::PrintSelf(ostream& os, vtkIndent indent)
   os << "UserManagedInputs:" << (this->UserManagedInputs?"On":"Off") << endl;
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision
      << endl;
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
 
-//----------------------------------------------------------------------------
-namespace {
-struct AppendDataWorker
-{
-  vtkIdType Offset;
-
-  AppendDataWorker(vtkIdType offset) : Offset(offset) {}
-
-  template <typename Array1T, typename Array2T>
-  void operator()(Array1T *dest, Array2T *src)
-  {
-    vtkDataArrayAccessor<Array1T> d(dest);
-    vtkDataArrayAccessor<Array2T> s(src);
-    VTK_ASSUME(src->GetNumberOfComponents() == dest->GetNumberOfComponents());
-
-    const vtkIdType numTuples = src->GetNumberOfTuples();
-    const int numComps = src->GetNumberOfComponents();
-
-    for (vtkIdType t = 0; t < numTuples; ++t)
-    {
-      for (int c = 0; c < numComps; ++c)
-      {
-        d.Set(t + this->Offset, c, s.Get(t, c));
-      }
-    }
-  }
-};
-} // end anon namespace
-
 //----------------------------------------------------------------------------
 void vtkAppendPolyData::AppendData(vtkDataArray *dest, vtkDataArray *src,
                                    vtkIdType offset)
@@ -728,7 +1056,7 @@ void vtkAppendPolyData::AppendData(vtkDataArray *dest, vtkDataArray *src,
   assert("Destination array has enough tuples." &&
          src->GetNumberOfTuples() + offset <= dest->GetNumberOfTuples());
 
-  AppendDataWorker worker(offset);
+  AppendDataWorker worker(offset, 0, src->GetNumberOfTuples());
   if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(dest, src, worker))
   {
     // Use vtkDataArray API when fast-path dispatch fails.
@@ -741,34 +1069,7 @@ void vtkAppendPolyData::AppendData(vtkDataArray *dest, vtkDataArray *src,
 vtkIdType *vtkAppendPolyData::AppendCells(vtkIdType *pDest, vtkCellArray *src,
                                           vtkIdType offset)
 {
-  vtkIdType *pSrc, *end, *pNum;
-
-  if (src == NULL)
-  {
-    return pDest;
-  }
-
-  pSrc = src->GetPointer();
-  end = pSrc + src->GetNumberOfConnectivityEntries();
-  pNum = pSrc;
-
-  while (pSrc < end)
-  {
-    if (pSrc == pNum)
-    {
-      // move cell pointer to next cell
-      pNum += 1+*pSrc;
-      // copy the number of cells
-      *pDest++ = *pSrc++;
-    }
-    else
-    {
-      // offset the point index
-      *pDest++ = offset + *pSrc++;
-    }
-  }
-
-  return pDest;
+  return vtkAppendPolyDataCopyCells(pDest, src, offset);
 }
 
 //----------------------------------------------------------------------------
@@ -33,6 +33,7 @@
 
 #include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkPolyDataAlgorithm.h"
+#include "vtkDataSetAttributes.h" // For FieldList
 
 class vtkCellArray;
 class vtkDataArray;
@@ -115,6 +116,22 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Set/Get whether the inputs are appended in parallel, with vtkSMPTools.
+   * The output sizes are computed first, then each input copies its points,
+   * cells and arrays to its own range of the output with typed loops. A
+   * single non-empty input is shallow copied to the output, unless its
+   * points have to be converted to another precision. Unlike the serial
+   * append, this pass-through keeps the field data and all the arrays of
+   * the input, not only the ones copied by the field lists. Inputs with bit
+   * arrays are appended serially. Default is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
   int ExecuteAppend(vtkPolyData* output,
     vtkPolyData* inputs[], int numInputs);
 
@@ -125,6 +142,7 @@ protected:
   // Flag for selecting parallel streaming behavior
   int ParallelStreaming;
   int OutputPointsPrecision;
+  int Threaded;
 
   // Usual data generation method
   int RequestData(vtkInformation *,
@@ -133,6 +151,14 @@ protected:
                           vtkInformationVector **, vtkInformationVector *) VTK_OVERRIDE;
   int FillInputPortInformation(int, vtkInformation *) VTK_OVERRIDE;
 
+  // Append the inputs one after the other to the allocated points, point
+  // attributes, cells and field data of the output.
+  void AppendInputs(vtkPolyData *output, vtkPolyData* inputs[], int numInputs,
+                    vtkDataSetAttributes::FieldList &ptList,
+                    vtkDataSetAttributes::FieldList &cellList,
+                    vtkPoints *newPts, vtkDataArray *newPtAttributes[],
+                    vtkCellArray *newCells[4]);
+
   // An efficient templated way to append data.
   void AppendData(vtkDataArray *dest, vtkDataArray *src, vtkIdType offset);
 
@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkCellDataToPointData.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkDataSet.h"
@@ -22,8 +23,14 @@
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkImageData.h"
 #include "vtkPointData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinks.h"
+#include "vtkStructuredData.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnstructuredGrid.h"
@@ -35,11 +42,66 @@
 
 vtkStandardNewMacro(vtkCellDataToPointData);
 
+namespace
+{
+
+// Average the cell data of the cells using each point, taken from static
+// links, or from the dimensions of structured data when there are no links
+struct vtkCellDataToPointDataAverage
+{
+  ArrayList *Arrays;
+  vtkStaticCellLinks *Links;
+  int *Dimensions;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  void Initialize()
+  {
+    this->CellIds.Local()->Allocate(8);
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkIdList *cellIds = this->CellIds.Local();
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      vtkIdType numCells;
+      const vtkIdType *cells;
+      if (this->Links)
+      {
+        numCells = this->Links->GetNumberOfCells(ptId);
+        cells = this->Links->GetCells(ptId);
+      }
+      else
+      {
+        vtkStructuredData::GetPointCells(ptId, cellIds, this->Dimensions);
+        numCells = cellIds->GetNumberOfIds();
+        cells = cellIds->GetPointer(0);
+      }
+
+      if (numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT)
+      {
+        this->Arrays->Average(static_cast<int>(numCells), cells, ptId);
+      }
+      else
+      {
+        this->Arrays->AssignNullValue(ptId);
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+}
+
 //----------------------------------------------------------------------------
 // Instantiate object so that cell data is not passed to output.
 vtkCellDataToPointData::vtkCellDataToPointData()
 {
   this->PassCellData = 0;
+  this->Threaded = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -58,8 +120,11 @@ int vtkCellDataToPointData::RequestData(
 
   vtkDebugMacro(<<"Mapping cell data to point data");
 
+  bool threaded = this->Threaded &&
+    ArrayList::HasNamedDataArrays(input->GetCellData());
+
   // Special traversal algorithm for unstructured grid
-  if (input->IsA("vtkUnstructuredGrid"))
+  if (!threaded && input->IsA("vtkUnstructuredGrid"))
   {
     return this->RequestDataForUnstructuredGrid(0, inputVector, outputVector);
   }
@@ -88,6 +153,10 @@ int vtkCellDataToPointData::RequestData(
   {
     this->interpolatePointDataWithMask(sGrid, output);
   }
+  else if (threaded)
+  {
+    this->ThreadedInterpolatePointData(input, output);
+  }
   else
   {
     this->interpolatePointData(input, output);
@@ -109,6 +178,7 @@ void vtkCellDataToPointData::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "Pass Cell Data: " << (this->PassCellData ? "On\n" : "Off\n");
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
@@ -314,6 +384,54 @@ void vtkCellDataToPointData::interpolatePointData(vtkDataSet *input,
   }
 }
 
+void vtkCellDataToPointData::ThreadedInterpolatePointData(vtkDataSet *input,
+                                                          vtkDataSet *output)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+
+  vtkCellData *inCD = input->GetCellData();
+  vtkPointData *outPD = output->GetPointData();
+
+  // The arrays passed from the input point data are left as they are
+  ArrayList arrays;
+  for (int i = 0; i < outPD->GetNumberOfArrays(); ++i)
+  {
+    if (vtkDataArray *array = outPD->GetArray(i))
+    {
+      arrays.ExcludeArray(array);
+    }
+  }
+  outPD->InterpolateAllocate(inCD,numPts);
+  arrays.AddArrays(numPts, inCD, outPD, 0.0, false);
+
+  int dimensions[3] = { 0, 0, 0 };
+  vtkSmartPointer<vtkStaticCellLinks> links;
+  if (vtkImageData *image = vtkImageData::SafeDownCast(input))
+  {
+    image->GetDimensions(dimensions);
+  }
+  else if (vtkRectilinearGrid *rGrid = vtkRectilinearGrid::SafeDownCast(input))
+  {
+    rGrid->GetDimensions(dimensions);
+  }
+  else if (vtkStructuredGrid *sGrid = vtkStructuredGrid::SafeDownCast(input))
+  {
+    sGrid->GetDimensions(dimensions);
+  }
+  else
+  {
+    links = vtkSmartPointer<vtkStaticCellLinks>::New();
+    links->BuildLinks(input);
+  }
+
+  vtkCellDataToPointDataAverage average;
+  average.Arrays = &arrays;
+  average.Links = links;
+  average.Dimensions = dimensions;
+  vtkSMPTools::For(0, numPts, average);
+  this->UpdateProgress(1.0);
+}
+
 void vtkCellDataToPointData::interpolatePointDataWithMask(
     vtkStructuredGrid *input, vtkDataSet *output)
 {
@@ -58,6 +58,22 @@ public:
   vtkBooleanMacro(PassCellData,int);
   //@}
 
+  //@{
+  /**
+   * Set/Get whether the point data is computed in parallel, with
+   * vtkSMPTools. The cells using each point are found through
+   * vtkStaticCellLinks, or directly for structured data, and all the arrays
+   * of a point are averaged at once. The values are those of the serial
+   * interpolation of datasets other than unstructured grids; for these the
+   * serial filter accumulates in the type of each array instead. Inputs
+   * whose cell data has unnamed or non-numeric arrays, and structured grids
+   * with blanked cells, are processed serially. Default is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
 protected:
   vtkCellDataToPointData();
   ~vtkCellDataToPointData() VTK_OVERRIDE {}
@@ -76,7 +92,11 @@ protected:
   void interpolatePointDataWithMask(vtkStructuredGrid *input,
                                     vtkDataSet *output);
 
+  // Same as interpolatePointData(), in parallel.
+  void ThreadedInterpolatePointData(vtkDataSet *input, vtkDataSet *output);
+
   int PassCellData;
+  int Threaded;
 private:
   vtkCellDataToPointData(const vtkCellDataToPointData&) VTK_DELETE_FUNCTION;
   void operator=(const vtkCellDataToPointData&) VTK_DELETE_FUNCTION;
@@ -14,17 +14,25 @@
 =========================================================================*/
 #include "vtkCleanPolyData.h"
 
+#include "vtkArrayListTemplate.h"
+#include "vtkAtomic.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMergePoints.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkCleanPolyData);
 
 //---------------------------------------------------------------------------
@@ -46,6 +54,7 @@ vtkCleanPolyData::vtkCleanPolyData()
   this->Locator = NULL;
   this->PieceInvariant = 1;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->Threaded = 0;
 }
 
 //--------------------------------------------------------------------------
@@ -138,6 +147,10 @@ int vtkCleanPolyData::RequestData(
     vtkDebugMacro(<<"No data to Operate On!");
     return 1;
   }
+  if ( this->Threaded && this->ThreadedClean(input, output) )
+  {
+    return 1;
+  }
   vtkIdType *updatedPts = new vtkIdType[input->GetMaxCellSize()];
 
   vtkIdType numNewPts;
@@ -594,6 +607,428 @@ int vtkCleanPolyData::RequestData(
   return 1;
 }
 
+//--------------------------------------------------------------------------
+// Threaded cleaning. The points, once operated on, are merged with a static
+// point locator, and the kept points are numbered in the order of the input
+// points. The cells are then renumbered in batches, each batch taken from a
+// single input cell array. A first pass counts the output cells of each
+// batch in each output cell array, and a second one writes them in place.
+namespace
+{
+
+const vtkIdType vtkCleanPolyDataBatchSize = 1024;
+
+// The cell arrays, as indices into the batch counts
+enum
+{
+  vtkCleanPolyDataVerts = 0,
+  vtkCleanPolyDataLines,
+  vtkCleanPolyDataPolys,
+  vtkCleanPolyDataStrips
+};
+
+struct vtkCleanPolyDataBatch
+{
+  int InputType; // the input cell array
+  vtkIdType FirstCell; // the input id of the first cell
+  vtkIdType NumberOfCells;
+  const vtkIdType *Cells; // the connectivity of the first cell
+  vtkIdType NumberOfOutputCells[4];
+  vtkIdType ConnectivitySize[4];
+  vtkIdType CellOffset[4]; // location of the output cells in each array
+  vtkIdType ConnectivityOffset[4];
+};
+
+// Apply OperateOnPoint() to all the input points
+struct vtkCleanPolyDataOperateOnPoints
+{
+  vtkCleanPolyData *Filter;
+  vtkPoints *InPoints;
+  vtkPoints *OutPoints;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3], newx[3];
+    for (; ptId < endPtId; ++ptId)
+    {
+      this->InPoints->GetPoint(ptId, x);
+      this->Filter->OperateOnPoint(x, newx);
+      this->OutPoints->SetPoint(ptId, newx);
+    }
+  }
+};
+
+// The merged points of the cells, and the cell array they go to, as in
+// vtkCleanPolyData::RequestData()
+struct vtkCleanPolyDataCells
+{
+  vtkCleanPolyDataBatch *Batches;
+  const vtkIdType *MergeMap;
+  int ConvertLinesToPoints;
+  int ConvertPolysToLines;
+  int ConvertStripsToPolys;
+
+  // Return the output cell array of a cell, or -1 if it is removed
+  int CleanCell(int inputType, vtkIdType npts, const vtkIdType *pts,
+                vtkIdType *updatedPts, vtkIdType &numNewPts) const
+  {
+    numNewPts = 0;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      vtkIdType ptId = this->MergeMap[pts[i]];
+      if (inputType == vtkCleanPolyDataVerts || i == 0 ||
+          ptId != updatedPts[numNewPts-1])
+      {
+        updatedPts[numNewPts++] = ptId;
+      }
+    }
+
+    switch (inputType)
+    {
+      case vtkCleanPolyDataVerts:
+        return numNewPts > 0 ? vtkCleanPolyDataVerts : -1;
+      case vtkCleanPolyDataLines:
+        break;
+      case vtkCleanPolyDataPolys:
+        if (numNewPts > 2 && updatedPts[0] == updatedPts[numNewPts-1])
+        {
+          numNewPts--;
+        }
+        if (numNewPts > 2 || !this->ConvertPolysToLines)
+        {
+          return vtkCleanPolyDataPolys;
+        }
+        break;
+      default:
+        if (numNewPts > 3 || !this->ConvertStripsToPolys)
+        {
+          return vtkCleanPolyDataStrips;
+        }
+        if (numNewPts == 3 || !this->ConvertPolysToLines)
+        {
+          return vtkCleanPolyDataPolys;
+        }
+        break;
+    }
+    if (numNewPts > 1 || !this->ConvertLinesToPoints)
+    {
+      return vtkCleanPolyDataLines;
+    }
+    return numNewPts == 1 ? vtkCleanPolyDataVerts : -1;
+  }
+};
+
+// Count the output cells of the batches, and mark the kept points
+struct vtkCleanPolyDataCountCells : public vtkCleanPolyDataCells
+{
+  vtkAtomic<vtkIdType> *Used;
+
+  void operator()(vtkIdType batchId, vtkIdType endBatchId)
+  {
+    std::vector<vtkIdType> updatedPts;
+    for (; batchId < endBatchId; ++batchId)
+    {
+      vtkCleanPolyDataBatch &batch = this->Batches[batchId];
+      std::fill_n(batch.NumberOfOutputCells, 4, 0);
+      std::fill_n(batch.ConnectivitySize, 4, 0);
+      const vtkIdType *cell = batch.Cells;
+      for (vtkIdType c = 0; c < batch.NumberOfCells; ++c)
+      {
+        vtkIdType npts = *cell++;
+        if (static_cast<vtkIdType>(updatedPts.size()) < npts)
+        {
+          updatedPts.resize(npts);
+        }
+        vtkIdType numNewPts;
+        int type = this->CleanCell(batch.InputType, npts, cell,
+                                   updatedPts.data(), numNewPts);
+        // Even the points of the removed cells are kept
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          vtkAtomic<vtkIdType> &used = this->Used[this->MergeMap[cell[i]]];
+          if (!used)
+          {
+            used = 1;
+          }
+        }
+        if (type >= 0)
+        {
+          batch.NumberOfOutputCells[type]++;
+          batch.ConnectivitySize[type] += numNewPts + 1;
+        }
+        cell += npts;
+      }
+    }
+  }
+};
+
+// Write the output cells of the batches, and copy their data
+struct vtkCleanPolyDataBuildCells : public vtkCleanPolyDataCells
+{
+  const vtkIdType *NewIds;
+  vtkIdType *Connectivity[4];
+  vtkIdType FirstOutputCell[4];
+  ArrayList *CellArrays;
+
+  void operator()(vtkIdType batchId, vtkIdType endBatchId)
+  {
+    std::vector<vtkIdType> updatedPts;
+    for (; batchId < endBatchId; ++batchId)
+    {
+      const vtkCleanPolyDataBatch &batch = this->Batches[batchId];
+      vtkIdType cellIds[4], locations[4];
+      std::copy(batch.CellOffset, batch.CellOffset + 4, cellIds);
+      std::copy(batch.ConnectivityOffset, batch.ConnectivityOffset + 4,
+                locations);
+      const vtkIdType *cell = batch.Cells;
+      for (vtkIdType c = 0; c < batch.NumberOfCells; ++c)
+      {
+        vtkIdType npts = *cell++;
+        if (static_cast<vtkIdType>(updatedPts.size()) < npts)
+        {
+          updatedPts.resize(npts);
+        }
+        vtkIdType numNewPts;
+        int type = this->CleanCell(batch.InputType, npts, cell,
+                                   updatedPts.data(), numNewPts);
+        if (type >= 0)
+        {
+          vtkIdType *newCell = this->Connectivity[type] + locations[type];
+          *newCell++ = numNewPts;
+          for (vtkIdType i = 0; i < numNewPts; ++i)
+          {
+            newCell[i] = this->NewIds[updatedPts[i]];
+          }
+          locations[type] += numNewPts + 1;
+          this->CellArrays->Copy(batch.FirstCell + c,
+                                 this->FirstOutputCell[type] + cellIds[type]++);
+        }
+        cell += npts;
+      }
+    }
+  }
+};
+
+// Copy the kept points and their data
+struct vtkCleanPolyDataCopyPoints
+{
+  vtkAtomic<vtkIdType> *Used;
+  const vtkIdType *NewIds;
+  vtkPoints *InPoints;
+  vtkPoints *OutPoints;
+  ArrayList *PointArrays;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for (; ptId < endPtId; ++ptId)
+    {
+      if (this->Used[ptId])
+      {
+        vtkIdType newId = this->NewIds[ptId];
+        this->InPoints->GetPoint(ptId, x);
+        this->OutPoints->SetPoint(newId, x);
+        this->PointArrays->Copy(ptId, newId);
+      }
+    }
+  }
+};
+
+}
+
+//--------------------------------------------------------------------------
+// Threaded version of RequestData(). Returns 0 if the input has to be
+// cleaned by the serial code.
+int vtkCleanPolyData::ThreadedClean(vtkPolyData *input, vtkPolyData *output)
+{
+  vtkPoints *inPts = input->GetPoints();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPointData *inputPD = input->GetPointData();
+  vtkCellData *inputCD = input->GetCellData();
+
+  // The attributes are copied by array lists
+  if ( !ArrayList::HasNamedDataArrays(inputPD) ||
+       !ArrayList::HasNamedDataArrays(inputCD) )
+  {
+    return 0;
+  }
+
+  // Split the cells into batches, in the order of the input cells
+  vtkCellArray *inCells[4] = { input->GetVerts(), input->GetLines(),
+                               input->GetPolys(), input->GetStrips() };
+  std::vector<vtkCleanPolyDataBatch> batches;
+  vtkIdType inCellID = 0;
+  int type;
+  for (type = 0; type < 4; type++)
+  {
+    vtkIdType numCells = inCells[type]->GetNumberOfCells();
+    const vtkIdType *cell = inCells[type]->GetPointer();
+    for (vtkIdType c = 0; c < numCells; c++, cell += *cell + 1)
+    {
+      if ( c % vtkCleanPolyDataBatchSize == 0 )
+      {
+        vtkCleanPolyDataBatch batch;
+        batch.InputType = type;
+        batch.FirstCell = inCellID + c;
+        batch.NumberOfCells = std::min(vtkCleanPolyDataBatchSize,
+                                       numCells - c);
+        batch.Cells = cell;
+        batches.push_back(batch);
+      }
+    }
+    inCellID += numCells;
+  }
+  if ( batches.empty() )
+  {
+    return 0;
+  }
+  vtkIdType numBatches = static_cast<vtkIdType>(batches.size());
+
+  // Operate on the points, and merge them
+  vtkPoints *mappedPts = vtkPoints::New(VTK_DOUBLE);
+  mappedPts->SetNumberOfPoints(numPts);
+  vtkCleanPolyDataOperateOnPoints operate = { this, inPts, mappedPts };
+  vtkSMPTools::For(0, numPts, operate);
+
+  std::vector<vtkIdType> mergeMap(numPts);
+  if ( this->PointMerging )
+  {
+    vtkPolyData *mappedInput = vtkPolyData::New();
+    mappedInput->SetPoints(mappedPts);
+    vtkStaticPointLocator *locator = vtkStaticPointLocator::New();
+    locator->SetDataSet(mappedInput);
+    locator->BuildLocator();
+    locator->MergePoints(this->ToleranceIsAbsolute ? this->AbsoluteTolerance :
+                         this->Tolerance*input->GetLength(), &mergeMap[0]);
+    locator->Delete();
+    mappedInput->Delete();
+  }
+  else
+  {
+    for (vtkIdType i = 0; i < numPts; i++)
+    {
+      mergeMap[i] = i;
+    }
+  }
+
+  // Count the output cells, and number the kept points in their order
+  vtkAtomic<vtkIdType> *used = new vtkAtomic<vtkIdType>[numPts];
+  vtkCleanPolyDataCountCells countCells;
+  countCells.Batches = &batches[0];
+  countCells.MergeMap = &mergeMap[0];
+  countCells.ConvertLinesToPoints = this->ConvertLinesToPoints;
+  countCells.ConvertPolysToLines = this->ConvertPolysToLines;
+  countCells.ConvertStripsToPolys = this->ConvertStripsToPolys;
+  countCells.Used = used;
+  vtkSMPTools::For(0, numBatches, 1, countCells);
+
+  std::vector<vtkIdType> newIds(numPts);
+  vtkSMPTools::ExclusiveScan(used, used + numPts, newIds.begin(),
+                             static_cast<vtkIdType>(0));
+  vtkIdType numNewPts = newIds[numPts-1] + used[numPts-1];
+
+  vtkIdType numOutCells[4] = { 0, 0, 0, 0 };
+  vtkIdType connSize[4] = { 0, 0, 0, 0 };
+  for (vtkIdType b = 0; b < numBatches; b++)
+  {
+    for (type = 0; type < 4; type++)
+    {
+      batches[b].CellOffset[type] = numOutCells[type];
+      batches[b].ConnectivityOffset[type] = connSize[type];
+      numOutCells[type] += batches[b].NumberOfOutputCells[type];
+      connSize[type] += batches[b].ConnectivitySize[type];
+    }
+  }
+
+  // Copy the kept points
+  vtkPoints *newPts = inPts->NewInstance();
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    newPts->SetDataType(inPts->GetDataType());
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
+  newPts->SetNumberOfPoints(numNewPts);
+
+  vtkPointData *outputPD = output->GetPointData();
+  outputPD->CopyAllocate(inputPD, numNewPts);
+  ArrayList pointArrays;
+  pointArrays.AddArrays(numNewPts, inputPD, outputPD, 0.0, false);
+
+  vtkCleanPolyDataCopyPoints copyPoints = { used, &newIds[0], mappedPts,
+                                            newPts, &pointArrays };
+  vtkSMPTools::For(0, numPts, copyPoints);
+  delete [] used;
+  mappedPts->Delete();
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+
+  // Renumber the cells. The output cells are ordered verts, lines, polys
+  // and strips, as the cell data.
+  vtkIdType numCells = 0;
+  vtkIdTypeArray *newConnectivity[4];
+  vtkCleanPolyDataBuildCells buildCells;
+  buildCells.Batches = &batches[0];
+  buildCells.MergeMap = &mergeMap[0];
+  buildCells.ConvertLinesToPoints = this->ConvertLinesToPoints;
+  buildCells.ConvertPolysToLines = this->ConvertPolysToLines;
+  buildCells.ConvertStripsToPolys = this->ConvertStripsToPolys;
+  buildCells.NewIds = &newIds[0];
+  for (type = 0; type < 4; type++)
+  {
+    newConnectivity[type] = vtkIdTypeArray::New();
+    newConnectivity[type]->SetNumberOfValues(connSize[type]);
+    buildCells.Connectivity[type] = newConnectivity[type]->GetPointer(0);
+    buildCells.FirstOutputCell[type] = numCells;
+    numCells += numOutCells[type];
+  }
+
+  vtkCellData *outputCD = output->GetCellData();
+  outputCD->CopyAllocate(inputCD, numCells);
+  ArrayList cellArrays;
+  cellArrays.AddArrays(numCells, inputCD, outputCD, 0.0, false);
+  buildCells.CellArrays = &cellArrays;
+  vtkSMPTools::For(0, numBatches, 1, buildCells);
+
+  for (type = 0; type < 4; type++)
+  {
+    if ( numOutCells[type] > 0 )
+    {
+      vtkCellArray *newCells = vtkCellArray::New();
+      newCells->SetCells(numOutCells[type], newConnectivity[type]);
+      switch (type)
+      {
+        case vtkCleanPolyDataVerts:
+          output->SetVerts(newCells);
+          break;
+        case vtkCleanPolyDataLines:
+          output->SetLines(newCells);
+          break;
+        case vtkCleanPolyDataPolys:
+          output->SetPolys(newCells);
+          break;
+        default:
+          output->SetStrips(newCells);
+          break;
+      }
+      newCells->Delete();
+    }
+    newConnectivity[type]->Delete();
+  }
+
+  vtkDebugMacro(<<"Removed "
+                << numPts - numNewPts << " points");
+
+  return 1;
+}
+
 //--------------------------------------------------------------------------
 // Method manages creation of locators. It takes into account the potential
 // change of tolerance (zero to non-zero).
@@ -675,6 +1110,8 @@ void vtkCleanPolyData::PrintSelf(ostream& os, vtkIndent indent)
      << (this->PieceInvariant ? "On\n" : "Off\n");
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision
      << "\n";
+  os << indent << "Threaded: "
+     << (this->Threaded ? "On\n" : "Off\n");
 }
 
 //--------------------------------------------------------------------------
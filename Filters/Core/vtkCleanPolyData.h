@@ -197,6 +197,22 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Turn on/off threaded cleaning. When on, the points are merged in
+   * parallel by a vtkStaticPointLocator, and the cells are renumbered in
+   * parallel; the Locator is not used. A point merges into the point with
+   * the lowest id within tolerance, and the kept points are ordered as in
+   * the input, so the output does not depend on the number of threads but
+   * its points may be ordered differently than with the serial code.
+   * OperateOnPoint() is invoked from several threads. Inputs with unnamed
+   * attribute arrays are cleaned serially. Default is Off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
 protected:
   vtkCleanPolyData();
  ~vtkCleanPolyData() VTK_OVERRIDE;
@@ -205,6 +221,12 @@ protected:
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) VTK_OVERRIDE;
   int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *) VTK_OVERRIDE;
 
+  /**
+   * Clean the input in parallel. Returns 0 if it has to be cleaned
+   * serially.
+   */
+  int ThreadedClean(vtkPolyData *input, vtkPolyData *output);
+
   int   PointMerging;
   double Tolerance;
   double AbsoluteTolerance;
@@ -216,6 +238,7 @@ protected:
 
   int PieceInvariant;
   int OutputPointsPrecision;
+  int Threaded;
 private:
   vtkCleanPolyData(const vtkCleanPolyData&) VTK_DELETE_FUNCTION;
   void operator=(const vtkCleanPolyData&) VTK_DELETE_FUNCTION;
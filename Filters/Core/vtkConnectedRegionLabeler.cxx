@@ -0,0 +1,478 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectedRegionLabeler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkConnectedRegionLabeler.h"
+
+#include "vtkCellPointsCursor.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkIdList.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+
+typedef std::atomic<vtkIdType> vtkAtomicId;
+
+//----------------------------------------------------------------------------
+// Concurrent union-find. A point is not part of any set until it is added.
+// Roots are always linked below smaller ids, so the parent of a point is
+// never larger than the point and the root of a set is its smallest point.
+vtkIdType vtkConnectedRegionFind(vtkAtomicId *parents, vtkIdType x)
+{
+  for (;;)
+  {
+    vtkIdType p = parents[x].load();
+    if ( p == x )
+    {
+      return x;
+    }
+    vtkIdType gp = parents[p].load();
+    if ( gp != p )
+    {
+      // Path halving: failing is harmless, another thread moved x up
+      parents[x].compare_exchange_weak(p, gp);
+    }
+    x = gp;
+  }
+}
+
+void vtkConnectedRegionUnion(vtkAtomicId *parents, vtkIdType x, vtkIdType y)
+{
+  for (;;)
+  {
+    x = vtkConnectedRegionFind(parents, x);
+    y = vtkConnectedRegionFind(parents, y);
+    if ( x == y )
+    {
+      return;
+    }
+    if ( x < y )
+    {
+      std::swap(x, y);
+    }
+    vtkIdType root = x;
+    if ( parents[x].compare_exchange_strong(root, y) )
+    {
+      return;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Decide which cells are reached from their neighbors, and merge the points
+// of these cells.
+struct vtkConnectedRegionMergeCells
+{
+  vtkSMPThreadLocal<vtkCellPointsCursor> Cursors;
+  vtkDataArray *Scalars;
+  const double *Range;
+  bool AllScalars;
+  vtkAtomicId *Parents;
+  vtkIdType *CellComponents;
+
+  vtkConnectedRegionMergeCells(const vtkCellPointsCursor &cursor) :
+    Cursors(cursor)
+  {
+  }
+
+  // The serial traversal gathers the scalars in a float array, so they are
+  // compared as floats.
+  bool IsConnected(vtkIdType npts, const vtkIdType *pts)
+  {
+    double range[2] = {VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX};
+    for (vtkIdType i=0; i < npts; i++)
+    {
+      double s = static_cast<float>(this->Scalars->GetComponent(pts[i], 0));
+      if ( s < range[0] )
+      {
+        range[0] = s;
+      }
+      if ( s > range[1] )
+      {
+        range[1] = s;
+      }
+    }
+    if ( this->AllScalars )
+    {
+      return range[0] >= this->Range[0] && range[1] <= this->Range[1];
+    }
+    return range[1] >= this->Range[0] && range[0] <= this->Range[1];
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkCellPointsCursor &cursor = this->Cursors.Local();
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; cellId++ )
+    {
+      vtkIdType npts = cursor.GetCellPoints(cellId, pts);
+      if ( npts < 1 )
+      {
+        this->CellComponents[cellId] = -2;
+        continue;
+      }
+      if ( this->Scalars && !this->IsConnected(npts, pts) )
+      {
+        this->CellComponents[cellId] = -1;
+        continue;
+      }
+      this->CellComponents[cellId] = pts[0];
+      for (vtkIdType i=0; i < npts; i++)
+      {
+        vtkIdType unset = -1;
+        this->Parents[pts[i]].compare_exchange_strong(unset, pts[i]);
+      }
+      for (vtkIdType i=1; i < npts; i++)
+      {
+        vtkConnectedRegionUnion(this->Parents, pts[0], pts[i]);
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Once all the unions are done, point every point to its root.
+struct vtkConnectedRegionFlattenPoints
+{
+  vtkAtomicId *Parents;
+  vtkIdType *PointComponents;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ptId++ )
+    {
+      this->PointComponents[ptId] = this->Parents[ptId].load() < 0 ? -1 :
+        vtkConnectedRegionFind(this->Parents, ptId);
+    }
+  }
+};
+
+struct vtkConnectedRegionFlattenCells
+{
+  const vtkIdType *PointComponents;
+  vtkIdType *CellComponents;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; cellId++ )
+    {
+      vtkIdType ptId = this->CellComponents[cellId];
+      if ( ptId >= 0 )
+      {
+        this->CellComponents[cellId] = this->PointComponents[ptId];
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Flag the cells using a seed point.
+struct vtkConnectedRegionFindSeedCells
+{
+  vtkSMPThreadLocal<vtkCellPointsCursor> Cursors;
+  const unsigned char *SeedPoints;
+  unsigned char *SeedCells;
+
+  vtkConnectedRegionFindSeedCells(const vtkCellPointsCursor &cursor) :
+    Cursors(cursor)
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkCellPointsCursor &cursor = this->Cursors.Local();
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; cellId++ )
+    {
+      vtkIdType npts = cursor.GetCellPoints(cellId, pts);
+      for (vtkIdType i=0; i < npts; i++)
+      {
+        if ( this->SeedPoints[pts[i]] )
+        {
+          this->SeedCells[cellId] = 1;
+          break;
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Keep for each point the smallest region of the labeled cells using it.
+struct vtkConnectedRegionPointRegions
+{
+  vtkSMPThreadLocal<vtkCellPointsCursor> Cursors;
+  const vtkIdType *Regions;
+  vtkAtomicId *PointRegions;
+
+  vtkConnectedRegionPointRegions(const vtkCellPointsCursor &cursor) :
+    Cursors(cursor)
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkCellPointsCursor &cursor = this->Cursors.Local();
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; cellId++ )
+    {
+      vtkIdType region = this->Regions[cellId];
+      if ( region < 0 )
+      {
+        continue;
+      }
+      vtkIdType npts = cursor.GetCellPoints(cellId, pts);
+      for (vtkIdType i=0; i < npts; i++)
+      {
+        vtkAtomicId &pointRegion = this->PointRegions[pts[i]];
+        vtkIdType current = pointRegion.load();
+        while ( region < current &&
+                !pointRegion.compare_exchange_weak(current, region) )
+        {
+        }
+      }
+    }
+  }
+};
+
+}
+
+//----------------------------------------------------------------------------
+vtkConnectedRegionLabeler::vtkConnectedRegionLabeler(vtkDataSet *input,
+                                                     vtkDataArray *scalars,
+                                                     const double range[2],
+                                                     bool allScalars) :
+  Input(input),
+  NumberOfCells(input->GetNumberOfCells()),
+  NumberOfPoints(input->GetNumberOfPoints()),
+  PointComponents(input->GetNumberOfPoints()),
+  CellComponents(input->GetNumberOfCells())
+{
+  vtkCellPointsCursor cursor(input);
+  vtkAtomicId *parents = new vtkAtomicId[this->NumberOfPoints];
+  vtkSMPTools::Fill(parents, parents + this->NumberOfPoints, -1);
+
+  vtkConnectedRegionMergeCells merge(cursor);
+  merge.Scalars = scalars;
+  merge.Range = range;
+  merge.AllScalars = allScalars;
+  merge.Parents = parents;
+  merge.CellComponents = this->NumberOfCells > 0 ? &this->CellComponents[0] : NULL;
+  vtkSMPTools::For(0, this->NumberOfCells, merge);
+
+  vtkConnectedRegionFlattenPoints flattenPoints;
+  flattenPoints.Parents = parents;
+  flattenPoints.PointComponents =
+    this->NumberOfPoints > 0 ? &this->PointComponents[0] : NULL;
+  vtkSMPTools::For(0, this->NumberOfPoints, flattenPoints);
+  delete [] parents;
+
+  vtkConnectedRegionFlattenCells flattenCells;
+  flattenCells.PointComponents = flattenPoints.PointComponents;
+  flattenCells.CellComponents = merge.CellComponents;
+  vtkSMPTools::For(0, this->NumberOfCells, flattenCells);
+}
+
+//----------------------------------------------------------------------------
+vtkConnectedRegionLabeler::~vtkConnectedRegionLabeler()
+{
+}
+
+//----------------------------------------------------------------------------
+bool vtkConnectedRegionLabeler::IsSupported(vtkDataSet *input)
+{
+  switch ( input->GetDataObjectType() )
+  {
+    case VTK_POLY_DATA:
+    case VTK_IMAGE_DATA:
+    case VTK_STRUCTURED_POINTS:
+    case VTK_UNIFORM_GRID:
+    case VTK_STRUCTURED_GRID:
+    case VTK_RECTILINEAR_GRID:
+      return true;
+    case VTK_UNSTRUCTURED_GRID:
+    {
+      vtkUnstructuredGrid *ugrid = static_cast<vtkUnstructuredGrid*>(input);
+      return ugrid->GetCells() && ugrid->GetCellLocationsArray() &&
+             ugrid->GetCellTypesArray();
+    }
+    default:
+      return false;
+  }
+}
+
+//----------------------------------------------------------------------------
+// This follows the serial traversal: the cells are visited in order, a cell
+// not labeled yet starts a new region, which takes the components reached
+// from it. A cell reached from its neighbors brings its whole component, but
+// a cell that is not can only be in the region it starts.
+void vtkConnectedRegionLabeler::LabelAllRegions(
+  vtkIdType *regions, std::vector<vtkIdType> &regionSizes)
+{
+  std::vector<vtkIdType> componentRegions(this->NumberOfPoints, -1);
+  vtkCellPointsCursor cursor(this->Input);
+  const vtkIdType *pts;
+
+  regionSizes.clear();
+  for (vtkIdType cellId=0; cellId < this->NumberOfCells; cellId++)
+  {
+    vtkIdType component = this->CellComponents[cellId];
+    vtkIdType region;
+    if ( component >= 0 )
+    {
+      region = componentRegions[component];
+      if ( region < 0 )
+      {
+        region = componentRegions[component] =
+          static_cast<vtkIdType>(regionSizes.size());
+        regionSizes.push_back(0);
+      }
+    }
+    else
+    {
+      region = static_cast<vtkIdType>(regionSizes.size());
+      regionSizes.push_back(0);
+      if ( component == -1 )
+      {
+        vtkIdType npts = cursor.GetCellPoints(cellId, pts);
+        for (vtkIdType i=0; i < npts; i++)
+        {
+          vtkIdType neighbors = this->PointComponents[pts[i]];
+          if ( neighbors >= 0 && componentRegions[neighbors] < 0 )
+          {
+            componentRegions[neighbors] = region;
+          }
+        }
+      }
+    }
+    regions[cellId] = region;
+    regionSizes[region]++;
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectedRegionLabeler::LabelSeededRegion(
+  vtkIdList *seedPoints, vtkIdList *seedCells, vtkIdType *regions)
+{
+  vtkCellPointsCursor cursor(this->Input);
+  std::vector<unsigned char> seeds(this->NumberOfCells, 0);
+  if ( this->NumberOfCells < 1 )
+  {
+    return 0;
+  }
+
+  if ( seedPoints && seedPoints->GetNumberOfIds() > 0 )
+  {
+    std::vector<unsigned char> seedPts(this->NumberOfPoints, 0);
+    for (vtkIdType i=0; i < seedPoints->GetNumberOfIds(); i++)
+    {
+      vtkIdType ptId = seedPoints->GetId(i);
+      if ( ptId >= 0 && ptId < this->NumberOfPoints )
+      {
+        seedPts[ptId] = 1;
+      }
+    }
+    vtkConnectedRegionFindSeedCells findSeeds(cursor);
+    findSeeds.SeedPoints = &seedPts[0];
+    findSeeds.SeedCells = &seeds[0];
+    vtkSMPTools::For(0, this->NumberOfCells, findSeeds);
+  }
+  if ( seedCells )
+  {
+    for (vtkIdType i=0; i < seedCells->GetNumberOfIds(); i++)
+    {
+      vtkIdType cellId = seedCells->GetId(i);
+      if ( cellId >= 0 && cellId < this->NumberOfCells )
+      {
+        seeds[cellId] = 1;
+      }
+    }
+  }
+
+  // The seeds reach the components of their points
+  std::vector<unsigned char> seededComponents(this->NumberOfPoints, 0);
+  const vtkIdType *pts;
+  for (vtkIdType cellId=0; cellId < this->NumberOfCells; cellId++)
+  {
+    if ( seeds[cellId] )
+    {
+      vtkIdType npts = cursor.GetCellPoints(cellId, pts);
+      for (vtkIdType i=0; i < npts; i++)
+      {
+        if ( this->PointComponents[pts[i]] >= 0 )
+        {
+          seededComponents[this->PointComponents[pts[i]]] = 1;
+        }
+      }
+    }
+  }
+
+  vtkIdType numCellsInRegion = 0;
+  for (vtkIdType cellId=0; cellId < this->NumberOfCells; cellId++)
+  {
+    vtkIdType component = this->CellComponents[cellId];
+    if ( seeds[cellId] || (component >= 0 && seededComponents[component]) )
+    {
+      regions[cellId] = 0;
+      numCellsInRegion++;
+    }
+    else
+    {
+      regions[cellId] = -1;
+    }
+  }
+  return numCellsInRegion;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectedRegionLabeler::MapPoints(const vtkIdType *regions,
+                                               vtkIdType *pointMap,
+                                               vtkIdType *pointRegions)
+{
+  if ( this->NumberOfPoints < 1 )
+  {
+    return 0;
+  }
+  vtkAtomicId *minRegions = new vtkAtomicId[this->NumberOfPoints];
+  vtkSMPTools::Fill(minRegions, minRegions + this->NumberOfPoints, VTK_ID_MAX);
+
+  vtkCellPointsCursor cursor(this->Input);
+  vtkConnectedRegionPointRegions pointRegionsFunctor(cursor);
+  pointRegionsFunctor.Regions = regions;
+  pointRegionsFunctor.PointRegions = minRegions;
+  vtkSMPTools::For(0, this->NumberOfCells, pointRegionsFunctor);
+
+  vtkIdType numNewPts = 0;
+  for (vtkIdType ptId=0; ptId < this->NumberOfPoints; ptId++)
+  {
+    vtkIdType region = minRegions[ptId].load();
+    if ( region == VTK_ID_MAX )
+    {
+      pointMap[ptId] = -1;
+    }
+    else
+    {
+      pointMap[ptId] = numNewPts;
+      pointRegions[numNewPts++] = region;
+    }
+  }
+  delete [] minRegions;
+  return numNewPts;
+}
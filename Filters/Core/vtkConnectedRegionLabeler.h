@@ -0,0 +1,107 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectedRegionLabeler.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkConnectedRegionLabeler
+ * @brief   A utility class labeling connected regions in parallel
+ *
+ * This is a utility class used by the connectivity filters to label the
+ * regions of cells connected through their points, using vtkSMPTools.
+ * The cells are first merged into components with a concurrent union-find
+ * over their point ids (with atomic path compression). The regions are then
+ * numbered as the wave-front traversal of the filters numbers them, so that
+ * the labels do not depend on the number of threads.
+ *
+ * With scalar connectivity, a cell is only reached from its neighbors if
+ * its point scalars satisfy the scalar range criterion, while the cell
+ * starting a region always belongs to it, as in the serial traversal.
+ * @sa
+ * vtkConnectivityFilter vtkPolyDataConnectivityFilter
+*/
+
+#ifndef vtkConnectedRegionLabeler_h
+#define vtkConnectedRegionLabeler_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkType.h" // For vtkIdType
+
+#include <vector> // For a member variable
+
+class vtkDataArray;
+class vtkDataSet;
+class vtkIdList;
+
+class VTKFILTERSCORE_EXPORT vtkConnectedRegionLabeler
+{
+public:
+  /**
+   * Merge the cells of the dataset into components. If scalars is not
+   * NULL, only the cells whose point scalars (first component) lie in the
+   * range are reached from their neighbors: all of them if allScalars is
+   * true, any of them otherwise. The dataset must be supported.
+   */
+  vtkConnectedRegionLabeler(vtkDataSet *input, vtkDataArray *scalars,
+                            const double range[2], bool allScalars);
+  ~vtkConnectedRegionLabeler();
+
+  /**
+   * Return whether the cells of this dataset can be labeled in parallel.
+   */
+  static bool IsSupported(vtkDataSet *input);
+
+  /**
+   * Label every cell with the number of its region in regions, regions
+   * being numbered in the order of their first cell. The number of cells
+   * of each region is returned in regionSizes.
+   */
+  void LabelAllRegions(vtkIdType *regions,
+                       std::vector<vtkIdType> &regionSizes);
+
+  /**
+   * Label with 0 the cells of the region grown from the seed cells (and the
+   * cells using the seed points), and the other cells with -1. Invalid seed
+   * ids are ignored. Returns the number of cells in the region.
+   */
+  vtkIdType LabelSeededRegion(vtkIdList *seedPoints, vtkIdList *seedCells,
+                              vtkIdType *regions);
+
+  /**
+   * Number the points used by the labeled cells (regions[cellId] >= 0) in
+   * increasing point id order into pointMap (-1 for the other points), and
+   * give each of them the smallest region of the cells using it in
+   * pointRegions, which is indexed by the new point ids. Returns the number
+   * of points used.
+   */
+  vtkIdType MapPoints(const vtkIdType *regions, vtkIdType *pointMap,
+                      vtkIdType *pointRegions);
+
+private:
+  vtkConnectedRegionLabeler(const vtkConnectedRegionLabeler&) VTK_DELETE_FUNCTION;
+  vtkConnectedRegionLabeler& operator=(const vtkConnectedRegionLabeler&) VTK_DELETE_FUNCTION;
+
+  vtkDataSet *Input;
+  vtkIdType NumberOfCells;
+  vtkIdType NumberOfPoints;
+
+  // For each point used by a connected cell, the smallest point id of its
+  // component, -1 for the other points
+  std::vector<vtkIdType> PointComponents;
+
+  // For each cell, the component of its points if it is reached from its
+  // neighbors, -1 if it is not, -2 if it has no points
+  std::vector<vtkIdType> CellComponents;
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkConnectedRegionLabeler.h
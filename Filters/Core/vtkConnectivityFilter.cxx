@@ -16,6 +16,7 @@
 
 #include "vtkCell.h"
 #include "vtkCellData.h"
+#include "vtkConnectedRegionLabeler.h"
 #include "vtkDataSet.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
@@ -28,6 +29,10 @@
 #include "vtkPoints.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+
+#include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkConnectivityFilter);
 
@@ -57,6 +62,7 @@ vtkConnectivityFilter::vtkConnectivityFilter()
   this->NewCellScalars = 0;
 
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->Threaded = 0;
 }
 
 vtkConnectivityFilter::~vtkConnectivityFilter()
@@ -184,7 +190,12 @@ int vtkConnectivityFilter::RequestData(
   this->PointIds = vtkIdList::New();
   this->PointIds->Allocate(8, VTK_CELL_SIZE);
 
-  if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+  if ( this->Threaded && vtkConnectedRegionLabeler::IsSupported(input) )
+  {
+    largestRegionId =
+      static_cast<int>(this->ThreadedTraverseAndMark(input));
+  }
+  else if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
   { //visit all cells marking with region number
@@ -524,6 +535,79 @@ void vtkConnectivityFilter::TraverseAndMark (vtkDataSet *input)
   return;
 }
 
+// Label the regions like TraverseAndMark() does, but in parallel. Visited,
+// PointMap and the region ids are filled for the cell extraction in
+// RequestData(), the output points being numbered in input order.
+vtkIdType vtkConnectivityFilter::ThreadedTraverseAndMark(vtkDataSet *input)
+{
+  vtkIdType largestRegionId = 0;
+  vtkConnectedRegionLabeler labeler(input, this->InScalars,
+                                    this->ScalarRange, false);
+  this->UpdateProgress(0.5);
+
+  if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+       this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
+       this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
+  {
+    std::vector<vtkIdType> regionSizes;
+    labeler.LabelAllRegions(this->Visited, regionSizes);
+    vtkIdType maxCellsInRegion = 0;
+    this->RegionNumber = static_cast<vtkIdType>(regionSizes.size());
+    this->RegionSizes->SetNumberOfValues(this->RegionNumber);
+    for (vtkIdType i=0; i < this->RegionNumber; i++)
+    {
+      this->RegionSizes->SetValue(i, regionSizes[i]);
+      if ( regionSizes[i] > maxCellsInRegion )
+      {
+        maxCellsInRegion = regionSizes[i];
+        largestRegionId = i;
+      }
+    }
+  }
+  else // regions have been seeded, everything considered in same region
+  {
+    vtkNew<vtkIdList> seedPoints;
+    vtkIdList *seedCells = NULL;
+    if ( this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS )
+    {
+      seedPoints->DeepCopy(this->Seeds);
+    }
+    else if ( this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS )
+    {
+      seedCells = this->Seeds;
+    }
+    else
+    {//loop over points, find closest one
+      double minDist2, dist2, x[3];
+      vtkIdType i, minId = 0, numPts = input->GetNumberOfPoints();
+      for (minDist2=VTK_DOUBLE_MAX, i=0; i<numPts; i++)
+      {
+        input->GetPoint(i,x);
+        dist2 = vtkMath::Distance2BetweenPoints(x,this->ClosestPoint);
+        if ( dist2 < minDist2 )
+        {
+          minId = i;
+          minDist2 = dist2;
+        }
+      }
+      seedPoints->InsertNextId(minId);
+    }
+    this->NumCellsInRegion = labeler.LabelSeededRegion(
+      seedPoints.GetPointer(), seedCells, this->Visited);
+    this->RegionSizes->InsertValue(this->RegionNumber,this->NumCellsInRegion);
+  }
+
+  this->PointNumber = labeler.MapPoints(this->Visited, this->PointMap,
+                                        this->NewScalars->GetPointer(0));
+  // Only the extracted points have a region id
+  this->NewScalars->SetNumberOfTuples(this->PointNumber);
+  std::copy(this->Visited, this->Visited + input->GetNumberOfCells(),
+            this->NewCellScalars->GetPointer(0));
+  this->UpdateProgress(0.9);
+
+  return largestRegionId;
+}
+
 // Obtain the number of connected regions.
 int vtkConnectivityFilter::GetNumberOfExtractedRegions()
 {
@@ -597,5 +681,6 @@ void vtkConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Scalar Range: (" << range[0] << ", " << range[1] << ")\n";
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision
      << "\n";
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
 
@@ -181,6 +181,23 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the parallel labeling of the regions (using vtkSMPTools).
+   * The cells are merged into components by a concurrent union-find over
+   * their points instead of the serial wave-front traversal, for all the
+   * extraction modes and with scalar connectivity. The regions, their
+   * sizes and the extracted cells are the same as with the serial
+   * traversal, but the output points are numbered in increasing input
+   * point id order instead of traversal order. Inputs whose cells cannot be
+   * accessed from several threads are processed serially. By default this
+   * is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
 protected:
   vtkConnectivityFilter();
   ~vtkConnectivityFilter() VTK_OVERRIDE;
@@ -203,6 +220,12 @@ protected:
 
   void TraverseAndMark(vtkDataSet *input);
 
+  // Label the regions in parallel instead of TraverseAndMark(). Returns the
+  // largest region.
+  vtkIdType ThreadedTraverseAndMark(vtkDataSet *input);
+
+  int Threaded;
+
 private:
   // used to support algorithm execution
   vtkFloatArray *CellScalars;
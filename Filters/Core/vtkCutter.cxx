@@ -15,10 +15,12 @@
 #include "vtkCutter.h"
 
 #include "vtkArrayDispatch.h"
+#include "vtkArrayListTemplate.h"
 #include "vtkAssume.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
+#include "vtkCellPointsCursor.h"
 #include "vtkContourValues.h"
 #include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
@@ -26,24 +28,35 @@
 #include "vtkFloatArray.h"
 #include "vtkGenericCell.h"
 #include "vtkGridSynchronizedTemplates3D.h"
+#include "vtkHexahedron.h"
 #include "vtkImageData.h"
 #include "vtkImplicitFunction.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMarchingCubesTriangleCases.h"
 #include "vtkMergePoints.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
+#include "vtkScalarTree.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkSpanSpace.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates3D.h"
 #include "vtkSynchronizedTemplatesCutter3D.h"
+#include "vtkTetra.h"
+#include "vtkUnstructuredGrid.h"
 #include "vtkUnstructuredGridBase.h"
+#include "vtkVoxel.h"
+#include "vtkWedge.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkTimerLog.h"
@@ -52,10 +65,13 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <vector>
 
 vtkStandardNewMacro(vtkCutter);
 vtkCxxSetObjectMacro(vtkCutter,CutFunction,vtkImplicitFunction);
 vtkCxxSetObjectMacro(vtkCutter,Locator,vtkIncrementalPointLocator)
+vtkCxxSetObjectMacro(vtkCutter,ScalarTree,vtkScalarTree)
 
 //----------------------------------------------------------------------------
 // Construct with user-specified implicit function; initial value of 0.0; and
@@ -69,6 +85,9 @@ vtkCutter::vtkCutter(vtkImplicitFunction *cf)
   this->Locator = NULL;
   this->GenerateTriangles = 1;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->Threaded = 0;
+  this->UseScalarTree = 0;
+  this->ScalarTree = NULL;
 
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
   this->SynchronizedTemplatesCutter3D = vtkSynchronizedTemplatesCutter3D::New();
@@ -82,6 +101,7 @@ vtkCutter::~vtkCutter()
   this->ContourValues->Delete();
   this->SetCutFunction(NULL);
   this->SetLocator(NULL);
+  this->SetScalarTree(NULL);
 
   this->SynchronizedTemplates3D->Delete();
   this->SynchronizedTemplatesCutter3D->Delete();
@@ -404,7 +424,11 @@ int vtkCutter::RequestData(
            input->GetDataObjectType() == VTK_UNSTRUCTURED_GRID)
   {
     vtkDebugMacro(<< "Executing Unstructured Grid Cutter");
-    this->UnstructuredGridCutter(input, output);
+    if ( !(this->Threaded &&
+           this->ThreadedUnstructuredGridCutter(input, output)) )
+    {
+      this->UnstructuredGridCutter(input, output);
+    }
   }
   else
   {
@@ -1014,6 +1038,721 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   output->Squeeze();
 }
 
+namespace
+{
+
+// Number of consecutive candidate cells cut by a task. The output does not
+// depend on it.
+const vtkIdType vtkCutterBatchSize = 1024;
+
+// A point created on the edge (V1, V2) of a cell, at the parametric
+// coordinate T from V1. As with vtkMergePoints, the points are identified by
+// their coordinates X, rounded to the precision of the output points. Index
+// is the rank of the point among those of all the batches.
+struct vtkCutterEdge
+{
+  double    X[3];
+  vtkIdType Index;
+  vtkIdType V1;
+  vtkIdType V2;
+  double    T;
+
+  bool SamePoint(const vtkCutterEdge &other) const
+  {
+    return this->X[0] == other.X[0] && this->X[1] == other.X[1] &&
+           this->X[2] == other.X[2];
+  }
+
+  bool operator<(const vtkCutterEdge &other) const
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      if (this->X[i] != other.X[i])
+      {
+        return this->X[i] < other.X[i];
+      }
+    }
+    return this->Index < other.Index;
+  }
+};
+
+// The output of a batch of cells: the triangles, as indices into the points
+// created by the batch, and their input cells
+struct vtkCutterBatch
+{
+  std::vector<vtkIdType>     Triangles;
+  std::vector<vtkIdType>     CellIds;
+  std::vector<vtkCutterEdge> Edges;
+
+  // Offsets of the batch in the output
+  vtkIdType CellOffset;
+  vtkIdType EdgeOffset;
+
+  vtkCutterBatch() : CellOffset(0), EdgeOffset(0) {}
+};
+
+//----------------------------------------------------------------------------
+// Whether the cells of a type are cut by the case tables
+bool vtkCutterCanCut(int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_TETRA:
+    case VTK_HEXAHEDRON:
+    case VTK_VOXEL:
+    case VTK_WEDGE:
+    case VTK_PYRAMID:
+      return true;
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+// Flag the cells cut by a contour value, among the cells of the batches of a
+// scalar tree
+struct vtkCutterFlagTreeCells
+{
+  vtkSMPThreadLocal<vtkCellPointsCursor> Cursors;
+  vtkScalarTree *Tree;
+  const double  *Scalars;
+  double         Value;
+  unsigned char *Flags;
+
+  vtkCutterFlagTreeCells(const vtkCellPointsCursor &cursor,
+                         vtkScalarTree *tree, const double *scalars,
+                         double value, unsigned char *flags)
+    : Cursors(cursor), Tree(tree), Scalars(scalars), Value(value),
+      Flags(flags)
+  {
+  }
+
+  void operator()(vtkIdType batchId, vtkIdType endBatchId)
+  {
+    vtkCellPointsCursor &cursor = this->Cursors.Local();
+    const vtkIdType *pts;
+    for ( ; batchId < endBatchId; ++batchId)
+    {
+      vtkIdType numCells;
+      const vtkIdType *cells = this->Tree->GetCellBatch(batchId, numCells);
+      for (vtkIdType i = 0; i < numCells; ++i)
+      {
+        vtkIdType npts = cursor.GetCellPoints(cells[i], pts);
+        double sMin = VTK_DOUBLE_MAX;
+        double sMax = -VTK_DOUBLE_MAX;
+        for (vtkIdType j = 0; j < npts; ++j)
+        {
+          double s = this->Scalars[pts[j]];
+          sMin = std::min(sMin, s);
+          sMax = std::max(sMax, s);
+        }
+        if (this->Value >= sMin && this->Value <= sMax)
+        {
+          this->Flags[cells[i]] = 1;
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Gather the flagged cells in increasing id order
+struct vtkCutterGatherCells
+{
+  const unsigned char *Flags;
+  const vtkIdType     *Offsets;
+  vtkIdType           *Cells;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      if (this->Flags[cellId])
+      {
+        this->Cells[this->Offsets[cellId]] = cellId;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Cut the batches of cells with the contour values, as the Contour() method
+// of the cells does
+class vtkCutterCutCells
+{
+public:
+  vtkCutterCutCells(const vtkCellPointsCursor &cursor, vtkPoints *inPts,
+                    bool floatPoints, const double *scalars,
+                    const double *values, int numValues,
+                    const vtkIdType *cells, vtkIdType numCells,
+                    vtkCutterBatch *batches)
+    : Cursors(cursor), InPts(inPts), FloatPoints(floatPoints),
+      Scalars(scalars), Values(values),
+      NumberOfValues(numValues), Cells(cells), NumberOfCells(numCells),
+      Batches(batches)
+  {
+  }
+
+  void operator()(vtkIdType batchId, vtkIdType endBatchId)
+  {
+    vtkCellPointsCursor &cursor = this->Cursors.Local();
+    for ( ; batchId < endBatchId; ++batchId)
+    {
+      vtkCutterBatch &batch = this->Batches[batchId];
+      vtkIdType i = batchId * vtkCutterBatchSize;
+      vtkIdType end = std::min(i + vtkCutterBatchSize, this->NumberOfCells);
+      for ( ; i < end; ++i)
+      {
+        this->CutCell(cursor, this->Cells ? this->Cells[i] : i, batch);
+      }
+    }
+  }
+
+private:
+  vtkSMPThreadLocal<vtkCellPointsCursor> Cursors;
+  vtkPoints       *InPts;
+  bool             FloatPoints;
+  const double    *Scalars;
+  const double    *Values;
+  int              NumberOfValues;
+  const vtkIdType *Cells;
+  vtkIdType        NumberOfCells;
+  vtkCutterBatch  *Batches;
+
+  void CutCell(vtkCellPointsCursor &cursor, vtkIdType cellId,
+               vtkCutterBatch &batch)
+  {
+    const vtkIdType *pts = NULL;
+    vtkIdType npts = cursor.GetCellPoints(cellId, pts);
+    int cellType = cursor.GetCellType(cellId);
+
+    double s[8];
+    double sMin = VTK_DOUBLE_MAX;
+    double sMax = -VTK_DOUBLE_MAX;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      s[i] = this->Scalars[pts[i]];
+      sMin = std::min(sMin, s[i]);
+      sMax = std::max(sMax, s[i]);
+    }
+
+    for (int v = 0; v < this->NumberOfValues; ++v)
+    {
+      double value = this->Values[v];
+      if (value >= sMin && value <= sMax)
+      {
+        this->CutCellWithValue(cellId, cellType, npts, pts, s, value, batch);
+      }
+    }
+  }
+
+  void CutCellWithValue(vtkIdType cellId, int cellType, vtkIdType npts,
+                        const vtkIdType *pts, const double *s, double value,
+                        vtkCutterBatch &batch)
+  {
+    // The voxels are cut by the marching cubes cases, through the hexahedron
+    // ordering of their points, and interpolate their edges in the order of
+    // their points. The other cells interpolate from the point of smaller
+    // value.
+    static const int voxelMap[8] = { 0, 1, 3, 2, 4, 5, 7, 6 };
+    int index = 0;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      double si = (cellType == VTK_VOXEL ? s[voxelMap[i]] : s[i]);
+      if (si >= value)
+      {
+        index |= (1 << i);
+      }
+    }
+
+    const int *edge = NULL;
+    switch (cellType)
+    {
+      case VTK_TETRA:
+        edge = vtkTetra::GetTriangleCases(index);
+        break;
+      case VTK_WEDGE:
+        edge = vtkWedge::GetTriangleCases(index);
+        break;
+      case VTK_PYRAMID:
+        edge = vtkPyramid::GetTriangleCases(index);
+        break;
+      default:
+        edge = vtkMarchingCubesTriangleCases::GetCases()[index].edges;
+        break;
+    }
+
+    // The points of the cell are merged right away, as a degenerate triangle
+    // is skipped
+    size_t firstEdge = batch.Edges.size();
+    for ( ; edge[0] > -1; edge += 3)
+    {
+      vtkIdType tri[3];
+      for (int i = 0; i < 3; ++i)
+      {
+        const int *vert = NULL;
+        switch (cellType)
+        {
+          case VTK_TETRA:
+            vert = vtkTetra::GetEdgeArray(edge[i]);
+            break;
+          case VTK_HEXAHEDRON:
+            vert = vtkHexahedron::GetEdgeArray(edge[i]);
+            break;
+          case VTK_VOXEL:
+            vert = vtkVoxel::GetEdgeArray(edge[i]);
+            break;
+          case VTK_WEDGE:
+            vert = vtkWedge::GetEdgeArray(edge[i]);
+            break;
+          default:
+            vert = vtkPyramid::GetEdgeArray(edge[i]);
+            break;
+        }
+
+        int v1 = vert[0];
+        int v2 = vert[1];
+        double t;
+        if (cellType == VTK_VOXEL)
+        {
+          t = (value - s[v1]) / (s[v2] - s[v1]);
+        }
+        else
+        {
+          double deltaScalar = s[v2] - s[v1];
+          if (deltaScalar <= 0)
+          {
+            std::swap(v1, v2);
+            deltaScalar = -deltaScalar;
+          }
+          t = (deltaScalar == 0.0 ? 0.0 : (value - s[v1]) / deltaScalar);
+        }
+
+        vtkCutterEdge point;
+        point.V1 = pts[v1];
+        point.V2 = pts[v2];
+        point.T = t;
+        point.Index = 0;
+        double x1[3], x2[3];
+        this->InPts->GetPoint(point.V1, x1);
+        this->InPts->GetPoint(point.V2, x2);
+        for (int j = 0; j < 3; ++j)
+        {
+          point.X[j] = x1[j] + t * (x2[j] - x1[j]);
+          if (this->FloatPoints)
+          {
+            point.X[j] = static_cast<float>(point.X[j]);
+          }
+        }
+
+        size_t e = firstEdge;
+        while (e < batch.Edges.size() && !batch.Edges[e].SamePoint(point))
+        {
+          ++e;
+        }
+        if (e == batch.Edges.size())
+        {
+          batch.Edges.push_back(point);
+        }
+        tri[i] = static_cast<vtkIdType>(e);
+      }
+
+      // Skip the degenerate triangles
+      if (tri[0] != tri[1] && tri[0] != tri[2] && tri[1] != tri[2])
+      {
+        batch.Triangles.insert(batch.Triangles.end(), tri, tri + 3);
+        batch.CellIds.push_back(cellId);
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Gather the points of the batches, ranked in the order of their creation
+struct vtkCutterGatherEdges
+{
+  vtkCutterBatch *Batches;
+  vtkCutterEdge  *Edges;
+
+  void operator()(vtkIdType batchId, vtkIdType endBatchId)
+  {
+    for ( ; batchId < endBatchId; ++batchId)
+    {
+      const vtkCutterBatch &batch = this->Batches[batchId];
+      for (size_t e = 0; e < batch.Edges.size(); ++e)
+      {
+        vtkCutterEdge &edge = this->Edges[batch.EdgeOffset + e];
+        edge = batch.Edges[e];
+        edge.Index = batch.EdgeOffset + static_cast<vtkIdType>(e);
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Flag the first of the sorted points that are the same
+struct vtkCutterFlagEdges
+{
+  const vtkCutterEdge *Edges;
+  vtkIdType *Firsts;
+
+  void operator()(vtkIdType i, vtkIdType end)
+  {
+    for ( ; i < end; ++i)
+    {
+      this->Firsts[i] =
+        (i == 0 || !this->Edges[i].SamePoint(this->Edges[i-1])) ? 1 : 0;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Record the first sorted point of each merged point (MergedIds counts the
+// merged points up to each sorted point), and flag its rank of creation,
+// which numbers the merged points as the serial locator does
+struct vtkCutterFirstEdges
+{
+  const vtkCutterEdge *Edges;
+  const vtkIdType *Firsts;
+  const vtkIdType *MergedIds;
+  vtkIdType *MergedEdges;
+  vtkIdType *Created;
+
+  void operator()(vtkIdType i, vtkIdType end)
+  {
+    for ( ; i < end; ++i)
+    {
+      if (this->Firsts[i])
+      {
+        this->MergedEdges[this->MergedIds[i] - 1] = i;
+        this->Created[this->Edges[i].Index] = 1;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Map the points of the batches to the output points
+struct vtkCutterMapEdges
+{
+  const vtkCutterEdge *Edges;
+  const vtkIdType *MergedIds;
+  const vtkIdType *MergedEdges;
+  const vtkIdType *CreatedIds;
+  vtkIdType *EdgePointIds;
+
+  void operator()(vtkIdType i, vtkIdType end)
+  {
+    for ( ; i < end; ++i)
+    {
+      const vtkCutterEdge &first =
+        this->Edges[this->MergedEdges[this->MergedIds[i] - 1]];
+      this->EdgePointIds[this->Edges[i].Index] = this->CreatedIds[first.Index];
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Interpolate the output points from the first point of each merged point
+struct vtkCutterInterpolateEdges
+{
+  const vtkCutterEdge *Edges;
+  const vtkIdType *MergedEdges;
+  const vtkIdType *CreatedIds;
+  vtkPoints *OutPts;
+  ArrayList *Arrays;
+
+  void operator()(vtkIdType i, vtkIdType end)
+  {
+    for ( ; i < end; ++i)
+    {
+      const vtkCutterEdge &edge = this->Edges[this->MergedEdges[i]];
+      vtkIdType ptId = this->CreatedIds[edge.Index];
+      this->OutPts->SetPoint(ptId, edge.X);
+      this->Arrays->InterpolateEdge(edge.V1, edge.V2, edge.T, ptId);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Fill the output triangles and their data
+struct vtkCutterBuildCells
+{
+  const vtkCutterBatch *Batches;
+  const vtkIdType *EdgePointIds;
+  vtkIdType *Connectivity;
+  ArrayList *Arrays;
+
+  void operator()(vtkIdType batchId, vtkIdType endBatchId)
+  {
+    for ( ; batchId < endBatchId; ++batchId)
+    {
+      const vtkCutterBatch &batch = this->Batches[batchId];
+      vtkIdType cellId = batch.CellOffset;
+      vtkIdType *conn = this->Connectivity + 4 * cellId;
+      for (size_t c = 0; c < batch.CellIds.size(); ++c, ++cellId)
+      {
+        *conn++ = 3;
+        for (int i = 0; i < 3; ++i)
+        {
+          *conn++ = this->EdgePointIds
+            [batch.EdgeOffset + batch.Triangles[3 * c + i]];
+        }
+        this->Arrays->Copy(batch.CellIds[c], cellId);
+      }
+    }
+  }
+};
+
+}
+
+//----------------------------------------------------------------------------
+int vtkCutter::ThreadedUnstructuredGridCutter(vtkDataSet *input,
+                                              vtkPolyData *output)
+{
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(input);
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType numPts = input->GetNumberOfPoints();
+
+  // The cells need to be handled by the case tables, and the attributes by
+  // the array lists
+  if ( !grid || !grid->GetCellTypesArray() || numCells < 1 ||
+       !this->GenerateTriangles ||
+       !ArrayList::HasNamedDataArrays(input->GetPointData()) ||
+       !ArrayList::HasNamedDataArrays(input->GetCellData()) )
+  {
+    return 0;
+  }
+  const unsigned char *types = grid->GetCellTypesArray()->GetPointer(0);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    if ( !vtkCutterCanCut(types[cellId]) )
+    {
+      return 0;
+    }
+  }
+
+  // The points are merged by their coordinates in the output precision
+  vtkPoints *inPts = grid->GetPoints();
+  int pointsType = inPts->GetDataType();
+  if ( this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION )
+  {
+    pointsType = VTK_FLOAT;
+  }
+  else if ( this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION )
+  {
+    pointsType = VTK_DOUBLE;
+  }
+  if ( pointsType != VTK_FLOAT && pointsType != VTK_DOUBLE )
+  {
+    return 0;
+  }
+
+  int numContours = this->ContourValues->GetNumberOfContours();
+  double *contourValues = this->ContourValues->GetValues();
+
+  // The values of the cut function at the points. With a scalar tree, they
+  // are kept with the tree as long as the input and the cut function do not
+  // change.
+  vtkSmartPointer<vtkDoubleArray> cutScalars;
+  int useScalarTree = this->UseScalarTree;
+  if ( useScalarTree )
+  {
+    if ( this->ScalarTree == NULL )
+    {
+      // Larger batches than the default lower the overhead of the threaded
+      // traversal of the candidate cells
+      vtkSpanSpace *spanSpace = vtkSpanSpace::New();
+      spanSpace->SetBatchSize(100);
+      this->ScalarTree = spanSpace;
+    }
+    cutScalars = vtkArrayDownCast<vtkDoubleArray>(
+      this->ScalarTree->GetScalars());
+    if ( !cutScalars || this->ScalarTree->GetDataSet() != input ||
+         cutScalars->GetNumberOfTuples() != numPts ||
+         this->ScalarTree->GetMTime() < input->GetMTime() ||
+         this->ScalarTree->GetMTime() < this->CutFunction->GetMTime() )
+    {
+      cutScalars = NULL;
+    }
+  }
+  if ( !cutScalars )
+  {
+    cutScalars = vtkSmartPointer<vtkDoubleArray>::New();
+    cutScalars->SetNumberOfTuples(numPts);
+    this->CutFunction->EvaluateFunction(inPts->GetData(), cutScalars);
+    if ( useScalarTree )
+    {
+      this->ScalarTree->SetDataSet(input);
+      this->ScalarTree->SetScalars(cutScalars);
+    }
+  }
+  const double *scalars = cutScalars->GetPointer(0);
+
+  // A scalar tree cannot be built over constant values
+  if ( useScalarTree )
+  {
+    double range[2];
+    cutScalars->GetRange(range);
+    useScalarTree = (range[1] > range[0]);
+  }
+
+  // Cut the batches of candidate cells. When sorting by cell, each contour
+  // value is processed in turn.
+  vtkCellPointsCursor cursor(grid);
+  std::vector<vtkCutterBatch> batches;
+  int numPasses = (this->SortBy == VTK_SORT_BY_CELL ? numContours : 1);
+  for (int pass = 0; pass < numPasses; ++pass)
+  {
+    const double *values =
+      contourValues + (this->SortBy == VTK_SORT_BY_CELL ? pass : 0);
+    int numValues = (this->SortBy == VTK_SORT_BY_CELL ? 1 : numContours);
+
+    // The candidate cells are all the cells, or those of the scalar tree
+    // batches that the values cut, in increasing id order
+    std::vector<vtkIdType> candidates;
+    vtkIdType numCandidates = numCells;
+    if ( useScalarTree )
+    {
+      std::vector<unsigned char> flags(numCells, 0);
+      for (int v = 0; v < numValues; ++v)
+      {
+        this->ScalarTree->InitTraversal(values[v]);
+        vtkIdType numTreeBatches = this->ScalarTree->GetNumberOfCellBatches();
+        vtkCutterFlagTreeCells flagCells(cursor, this->ScalarTree, scalars,
+                                         values[v], &flags[0]);
+        vtkSMPTools::For(0, numTreeBatches, flagCells);
+      }
+      std::vector<vtkIdType> offsets(numCells);
+      vtkSMPTools::ExclusiveScan(flags.begin(), flags.end(), offsets.begin(),
+                                 static_cast<vtkIdType>(0));
+      numCandidates = offsets[numCells - 1] + flags[numCells - 1];
+      candidates.resize(numCandidates);
+      if ( numCandidates > 0 )
+      {
+        vtkCutterGatherCells gatherCells =
+          { &flags[0], &offsets[0], &candidates[0] };
+        vtkSMPTools::For(0, numCells, gatherCells);
+      }
+    }
+
+    vtkIdType numBatches =
+      (numCandidates + vtkCutterBatchSize - 1) / vtkCutterBatchSize;
+    std::vector<vtkCutterBatch> passBatches(numBatches);
+    if ( numBatches > 0 )
+    {
+      vtkCutterCutCells cutCells(cursor, inPts, pointsType == VTK_FLOAT,
+        scalars, values, numValues,
+        useScalarTree ? &candidates[0] : NULL, numCandidates, &passBatches[0]);
+      vtkSMPTools::For(0, numBatches, 1, cutCells);
+    }
+    batches.insert(batches.end(),
+                   std::make_move_iterator(passBatches.begin()),
+                   std::make_move_iterator(passBatches.end()));
+    this->UpdateProgress(0.5 * (pass + 1) / numPasses);
+  }
+
+  // Place the outputs of the batches in their order
+  vtkIdType numBatches = static_cast<vtkIdType>(batches.size());
+  vtkIdType numTris = 0;
+  vtkIdType numEdges = 0;
+  for (vtkIdType i = 0; i < numBatches; ++i)
+  {
+    batches[i].CellOffset = numTris;
+    batches[i].EdgeOffset = numEdges;
+    numTris += static_cast<vtkIdType>(batches[i].CellIds.size());
+    numEdges += static_cast<vtkIdType>(batches[i].Edges.size());
+  }
+
+  // Merge the points created with the same coordinates. Sorted, they are
+  // consecutive; the merged points are then numbered in the order of their
+  // first creation, as the serial locator numbers them.
+  std::vector<vtkCutterEdge> edges(numEdges);
+  std::vector<vtkIdType> edgePointIds(numEdges);
+  std::vector<vtkIdType> mergedEdges;
+  std::vector<vtkIdType> createdIds(numEdges);
+  vtkIdType numOutPts = 0;
+  if ( numEdges > 0 )
+  {
+    vtkCutterGatherEdges gatherEdges = { &batches[0], &edges[0] };
+    vtkSMPTools::For(0, numBatches, 1, gatherEdges);
+    vtkSMPTools::Sort(edges.begin(), edges.end());
+
+    std::vector<vtkIdType> firsts(numEdges);
+    std::vector<vtkIdType> mergedIds(numEdges);
+    vtkCutterFlagEdges flagEdges = { &edges[0], &firsts[0] };
+    vtkSMPTools::For(0, numEdges, flagEdges);
+    vtkSMPTools::InclusiveScan(firsts.begin(), firsts.end(),
+                               mergedIds.begin());
+    numOutPts = mergedIds[numEdges - 1];
+
+    mergedEdges.resize(numOutPts);
+    std::vector<vtkIdType> created(numEdges, 0);
+    vtkCutterFirstEdges firstEdges = { &edges[0], &firsts[0], &mergedIds[0],
+                                       &mergedEdges[0], &created[0] };
+    vtkSMPTools::For(0, numEdges, firstEdges);
+    vtkSMPTools::ExclusiveScan(created.begin(), created.end(),
+                               createdIds.begin(), static_cast<vtkIdType>(0));
+
+    vtkCutterMapEdges mapEdges = { &edges[0], &mergedIds[0],
+      &mergedEdges[0], &createdIds[0], &edgePointIds[0] };
+    vtkSMPTools::For(0, numEdges, mapEdges);
+  }
+  this->UpdateProgress(0.75);
+
+  // The output points and their data
+  vtkPoints *newPoints = vtkPoints::New();
+  newPoints->SetDataType(pointsType);
+  newPoints->SetNumberOfPoints(numOutPts);
+
+  vtkSmartPointer<vtkPointData> inPD = input->GetPointData();
+  if ( this->GenerateCutScalars )
+  {
+    inPD = vtkSmartPointer<vtkPointData>::New();
+    inPD->ShallowCopy(input->GetPointData());
+    inPD->SetScalars(cutScalars);
+  }
+  vtkPointData *outPD = output->GetPointData();
+  outPD->InterpolateAllocate(inPD, numOutPts);
+  ArrayList pointArrays;
+  pointArrays.AddArrays(numOutPts, inPD, outPD, 0.0, false);
+  if ( this->GenerateCutScalars )
+  {
+    // The cut scalars are not named: pair them explicitly
+    vtkDoubleArray *outScalars =
+      vtkArrayDownCast<vtkDoubleArray>(outPD->GetScalars());
+    outScalars->SetNumberOfTuples(numOutPts);
+    CreateArrayPair(&pointArrays, cutScalars->GetPointer(0),
+                    outScalars->GetPointer(0), numOutPts, 1,
+                    static_cast<vtkDataArray*>(outScalars), 0.0);
+  }
+  if ( numOutPts > 0 )
+  {
+    vtkCutterInterpolateEdges interpolateEdges = { &edges[0],
+      &mergedEdges[0], &createdIds[0], newPoints, &pointArrays };
+    vtkSMPTools::For(0, numOutPts, interpolateEdges);
+  }
+  output->SetPoints(newPoints);
+  newPoints->Delete();
+
+  // The output triangles and their data
+  vtkCellData *outCD = output->GetCellData();
+  outCD->CopyAllocate(input->GetCellData(), numTris);
+  if ( numTris > 0 )
+  {
+    ArrayList cellArrays;
+    cellArrays.AddArrays(numTris, input->GetCellData(), outCD, 0.0, false);
+    vtkCellArray *newPolys = vtkCellArray::New();
+    vtkCutterBuildCells buildCells = { &batches[0], &edgePointIds[0],
+      newPolys->WritePointer(numTris, 4 * numTris), &cellArrays };
+    vtkSMPTools::For(0, numBatches, 1, buildCells);
+    output->SetPolys(newPolys);
+    newPolys->Delete();
+  }
+
+  output->Squeeze();
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 // Specify a spatial locator for merging points. By default,
 // an instance of vtkMergePoints is used.
@@ -1069,4 +1808,16 @@ void vtkCutter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
+
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
+  os << indent << "Use Scalar Tree: "
+     << (this->UseScalarTree ? "On\n" : "Off\n");
+  if ( this->ScalarTree )
+  {
+    os << indent << "Scalar Tree: " << this->ScalarTree << "\n";
+  }
+  else
+  {
+    os << indent << "Scalar Tree: (none)\n";
+  }
 }
@@ -55,6 +55,7 @@
 
 class vtkImplicitFunction;
 class vtkIncrementalPointLocator;
+class vtkScalarTree;
 class vtkSynchronizedTemplates3D;
 class vtkSynchronizedTemplatesCutter3D;
 class vtkGridSynchronizedTemplates3D;
@@ -223,6 +224,47 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   //@}
 
+  //@{
+  /**
+   * Set/Get whether unstructured grids are cut in parallel, with
+   * vtkSMPTools. The cells are cut in batches, each batch keeping its
+   * triangles and the points it creates, and the points of all the batches
+   * are merged through a parallel sort of their coordinates, which replaces
+   * the Locator. When sorting by value, the output is identical to the
+   * serial one. When sorting by cell, the triangles are sorted by contour
+   * value, then by cell. In both cases the output does not depend on the
+   * number of threads. Only grids of tetrahedra, hexahedra, voxels, wedges
+   * and pyramids, with named attribute arrays, are cut in parallel, and only
+   * when GenerateTriangles is on; other inputs are cut serially.
+   * Default is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
+  //@{
+  /**
+   * Enable the use of a scalar tree to find the cells cut by the contour
+   * values, when unstructured grids are cut in parallel. The tree is built
+   * on the values of the cut function, and is kept as long as the input
+   * and the cut function do not change: this speeds up repeated cuts with
+   * moving contour values. Default is off.
+   */
+  vtkSetMacro(UseScalarTree,int);
+  vtkGetMacro(UseScalarTree,int);
+  vtkBooleanMacro(UseScalarTree,int);
+  //@}
+
+  //@{
+  /**
+   * Specify the instance of vtkScalarTree to use. If not specified
+   * and UseScalarTree is enabled, then a vtkSpanSpace will be used.
+   */
+  virtual void SetScalarTree(vtkScalarTree*);
+  vtkGetObjectMacro(ScalarTree,vtkScalarTree);
+  //@}
+
 protected:
   vtkCutter(vtkImplicitFunction *cf=NULL);
   ~vtkCutter() VTK_OVERRIDE;
@@ -231,6 +273,13 @@ protected:
   int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *) VTK_OVERRIDE;
   int FillInputPortInformation(int port, vtkInformation *info) VTK_OVERRIDE;
   void UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output);
+
+  /**
+   * Cut an unstructured grid in parallel, as UnstructuredGridCutter() does
+   * serially. Returns 0, without any output, if the grid cannot be cut in
+   * parallel.
+   */
+  int ThreadedUnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output);
   void DataSetCutter(vtkDataSet *input, vtkPolyData *output);
   void StructuredPointsCutter(vtkDataSet *, vtkPolyData *,
                               vtkInformation *, vtkInformationVector **,
@@ -250,6 +299,9 @@ protected:
   vtkContourValues *ContourValues;
   int GenerateCutScalars;
   int OutputPointsPrecision;
+  int Threaded;
+  int UseScalarTree;
+  vtkScalarTree *ScalarTree;
 private:
   vtkCutter(const vtkCutter&) VTK_DELETE_FUNCTION;
   void operator=(const vtkCutter&) VTK_DELETE_FUNCTION;
@@ -14,6 +14,8 @@
 =========================================================================*/
 #include "vtkGlyph3D.h"
 
+#include "vtkArrayListTemplate.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkFloatArray.h"
@@ -22,10 +24,13 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -33,6 +38,10 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
@@ -59,6 +68,7 @@ vtkGlyph3D::vtkGlyph3D()
   this->SetNumberOfInputPorts(2);
   this->FillCellData = 0;
   this->SourceTransform = 0;
+  this->Threaded = 0;
 
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
@@ -133,6 +143,13 @@ bool vtkGlyph3D::Execute(
     return true;
   }
 
+  if ( this->Threaded && this->IndexMode == VTK_INDEXING_OFF &&
+       this->ThreadedExecute(input, sourceVector, output,
+                             inSScalars, inVectors) )
+  {
+    return true;
+  }
+
   // this is used to respect blanking specified on uniform grids.
   vtkUniformGrid* inputUG = vtkUniformGrid::SafeDownCast(input);
 
@@ -732,6 +749,601 @@ bool vtkGlyph3D::Execute(
   return true;
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+
+// The glyph cells are written kind by kind into the vertex, line, polygon
+// and strip arrays of the output. This returns the array where a source cell
+// goes, or -1 if the output cell would not have the type of the source cell
+// once rebuilt from these arrays.
+int vtkGlyph3DCellArrayIndex(int cellType, vtkIdType npts)
+{
+  switch (cellType)
+  {
+    case VTK_VERTEX:
+      return npts == 1 ? 0 : -1;
+    case VTK_POLY_VERTEX:
+      return npts > 1 ? 0 : -1;
+    case VTK_LINE:
+      return npts == 2 ? 1 : -1;
+    case VTK_POLY_LINE:
+      return npts > 2 ? 1 : -1;
+    case VTK_TRIANGLE:
+      return npts == 3 ? 2 : -1;
+    case VTK_QUAD:
+      return npts == 4 ? 2 : -1;
+    case VTK_POLYGON:
+      return npts > 4 ? 2 : -1;
+    case VTK_TRIANGLE_STRIP:
+      return npts > 2 ? 3 : -1;
+    default:
+      return -1;
+  }
+}
+
+}
+
+//----------------------------------------------------------------------------
+// Generate the glyphs of a range of input points. Each visible input point
+// has a glyph index, from which the location of its points and cells in the
+// output arrays is known, so the glyphs are written independently.
+struct vtkGlyph3DInstanceGlyphs
+{
+  vtkGlyph3D *Self;
+  vtkDataSet *Input;
+  const vtkIdType *GlyphIds;
+  vtkDataArray *ScaleScalars;
+  vtkDataArray *Array3D;
+  double Den;
+
+  // The source glyph, with the source transform applied to its points
+  vtkIdType NumSourcePts;
+  const double *SourcePts;
+  const double *SourceNormals;
+  const float *SourceTCoords;
+  int NumTCoordComps;
+  const vtkIdType *SourceCells[4];
+  vtkIdType SourceCellsSize[4];
+  vtkIdType NumSourceCells[4];
+  vtkIdType CellOffsets[4];
+
+  // The output arrays
+  float *Points;
+  float *Scalars;
+  bool ScalarsFromScale;
+  float *Vectors;
+  float *Normals;
+  float *TCoords;
+  vtkIdType *PointIds;
+  vtkIdType *Cells[4];
+  ArrayList *ColorArrays;
+  ArrayList *PointArrays;
+  ArrayList *CellArrays;
+
+  vtkSMPThreadLocalObject<vtkTransform> Transform;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkGlyph3D *self = this->Self;
+    vtkTransform *trans = this->Transform.Local();
+    vtkIdType numSourcePts = this->NumSourcePts;
+    double x[3], v[3], vNew[3], vMag = 0.0;
+    double scalex, scaley, scalez, nmatrix[4][4];
+
+    for ( ; ptId < endPtId; ptId++ )
+    {
+      vtkIdType glyphId = this->GlyphIds[ptId];
+      if ( glyphId < 0 )
+      {
+        continue;
+      }
+      vtkIdType ptIncr = glyphId * numSourcePts;
+
+      // Get the scale and the orientation of the glyph, as in Execute()
+      scalex = scaley = scalez = 1.0;
+      if ( this->ScaleScalars )
+      {
+        double s = this->ScaleScalars->GetComponent(ptId, 0);
+        if ( self->ScaleMode == VTK_SCALE_BY_SCALAR ||
+             self->ScaleMode == VTK_DATA_SCALING_OFF )
+        {
+          scalex = scaley = scalez = s;
+        }
+      }
+      if ( this->Array3D )
+      {
+        v[0] = v[1] = v[2] = 0.0;
+        this->Array3D->GetTuple(ptId, v);
+        vMag = vtkMath::Norm(v);
+        if ( self->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS )
+        {
+          scalex = v[0];
+          scaley = v[1];
+          scalez = v[2];
+        }
+        else if ( self->ScaleMode == VTK_SCALE_BY_VECTOR )
+        {
+          scalex = scaley = scalez = vMag;
+        }
+      }
+      if ( self->Clamping )
+      {
+        const double *range = self->Range;
+        scalex = (scalex < range[0] ? range[0] :
+                  (scalex > range[1] ? range[1] : scalex));
+        scalex = (scalex - range[0]) / this->Den;
+        scaley = (scaley < range[0] ? range[0] :
+                  (scaley > range[1] ? range[1] : scaley));
+        scaley = (scaley - range[0]) / this->Den;
+        scalez = (scalez < range[0] ? range[0] :
+                  (scalez > range[1] ? range[1] : scalez));
+        scalez = (scalez - range[0]) / this->Den;
+      }
+
+      trans->Identity();
+      this->Input->GetPoint(ptId, x);
+      trans->Translate(x[0], x[1], x[2]);
+      if ( this->Array3D )
+      {
+        float *vectors = this->Vectors + 3*ptIncr;
+        for (vtkIdType i=0; i < numSourcePts; i++, vectors += 3)
+        {
+          vectors[0] = static_cast<float>(v[0]);
+          vectors[1] = static_cast<float>(v[1]);
+          vectors[2] = static_cast<float>(v[2]);
+        }
+        if ( self->Orient && vMag > 0.0 )
+        {
+          if ( v[1] == 0.0 && v[2] == 0.0 )
+          {
+            if ( v[0] < 0 )
+            {
+              trans->RotateWXYZ(180.0,0,1,0);
+            }
+          }
+          else
+          {
+            vNew[0] = (v[0]+vMag) / 2.0;
+            vNew[1] = v[1] / 2.0;
+            vNew[2] = v[2] / 2.0;
+            trans->RotateWXYZ(180.0,vNew[0],vNew[1],vNew[2]);
+          }
+        }
+      }
+
+      if ( this->TCoords )
+      {
+        memcpy(this->TCoords + this->NumTCoordComps*ptIncr,
+               this->SourceTCoords,
+               this->NumTCoordComps*numSourcePts*sizeof(float));
+      }
+
+      if ( this->Scalars )
+      {
+        float value = static_cast<float>(this->ScalarsFromScale ? scalex : vMag);
+        std::fill_n(this->Scalars + ptIncr, numSourcePts, value);
+      }
+      else if ( this->ColorArrays )
+      {
+        for (vtkIdType i=0; i < numSourcePts; i++)
+        {
+          this->ColorArrays->Copy(ptId, ptIncr+i);
+        }
+      }
+
+      if ( self->Scaling )
+      {
+        if ( self->ScaleMode == VTK_DATA_SCALING_OFF )
+        {
+          scalex = scaley = scalez = self->ScaleFactor;
+        }
+        else
+        {
+          scalex *= self->ScaleFactor;
+          scaley *= self->ScaleFactor;
+          scalez *= self->ScaleFactor;
+        }
+        if ( scalex == 0.0 )
+        {
+          scalex = 1.0e-10;
+        }
+        if ( scaley == 0.0 )
+        {
+          scaley = 1.0e-10;
+        }
+        if ( scalez == 0.0 )
+        {
+          scalez = 1.0e-10;
+        }
+        trans->Scale(scalex,scaley,scalez);
+      }
+
+      // Transform the points and normals the way vtkLinearTransform does
+      double (*matrix)[4] = trans->GetMatrix()->Element;
+      const double *p = this->SourcePts;
+      float *newPt = this->Points + 3*ptIncr;
+      for (vtkIdType i=0; i < numSourcePts; i++, p += 3, newPt += 3)
+      {
+        newPt[0] = static_cast<float>(
+          matrix[0][0]*p[0]+matrix[0][1]*p[1]+matrix[0][2]*p[2]+matrix[0][3]);
+        newPt[1] = static_cast<float>(
+          matrix[1][0]*p[0]+matrix[1][1]*p[1]+matrix[1][2]*p[2]+matrix[1][3]);
+        newPt[2] = static_cast<float>(
+          matrix[2][0]*p[0]+matrix[2][1]*p[1]+matrix[2][2]*p[2]+matrix[2][3]);
+      }
+      if ( this->Normals )
+      {
+        vtkMatrix4x4::DeepCopy(*nmatrix,trans->GetMatrix());
+        vtkMatrix4x4::Invert(*nmatrix,*nmatrix);
+        vtkMatrix4x4::Transpose(*nmatrix,*nmatrix);
+        const double *n = this->SourceNormals;
+        float *newN = this->Normals + 3*ptIncr;
+        for (vtkIdType i=0; i < numSourcePts; i++, n += 3, newN += 3)
+        {
+          newN[0] = static_cast<float>(
+            nmatrix[0][0]*n[0] + nmatrix[0][1]*n[1] + nmatrix[0][2]*n[2]);
+          newN[1] = static_cast<float>(
+            nmatrix[1][0]*n[0] + nmatrix[1][1]*n[1] + nmatrix[1][2]*n[2]);
+          newN[2] = static_cast<float>(
+            nmatrix[2][0]*n[0] + nmatrix[2][1]*n[1] + nmatrix[2][2]*n[2]);
+          vtkMath::Normalize(newN);
+        }
+      }
+
+      for (vtkIdType i=0; i < numSourcePts; i++)
+      {
+        this->PointArrays->Copy(ptId, ptIncr+i);
+      }
+      if ( this->PointIds )
+      {
+        std::fill_n(this->PointIds + ptIncr, numSourcePts, ptId);
+      }
+
+      // Copy the topology, offsetting the point ids
+      for (int k=0; k < 4; k++)
+      {
+        vtkIdType size = this->SourceCellsSize[k];
+        if ( size == 0 )
+        {
+          continue;
+        }
+        const vtkIdType *src = this->SourceCells[k];
+        vtkIdType *dst = this->Cells[k] + glyphId*size;
+        for (vtkIdType j=0; j < size; )
+        {
+          vtkIdType npts = src[j];
+          dst[j++] = npts;
+          for (vtkIdType i=0; i < npts; i++, j++)
+          {
+            dst[j] = src[j] + ptIncr;
+          }
+        }
+        if ( this->CellArrays )
+        {
+          vtkIdType cellId = this->CellOffsets[k] +
+            glyphId*this->NumSourceCells[k];
+          for (vtkIdType i=0; i < this->NumSourceCells[k]; i++)
+          {
+            this->CellArrays->Copy(ptId, cellId+i);
+          }
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+int vtkGlyph3D::ThreadedExecute(
+  vtkDataSet* input,
+  vtkInformationVector* sourceVector,
+  vtkPolyData* output,
+  vtkDataArray *inSScalars,
+  vtkDataArray *inVectors)
+{
+  vtkPolyData *source = this->GetSource(0, sourceVector);
+  vtkIdType numPts = input->GetNumberOfPoints();
+  if ( !source || !source->GetPoints() || numPts < 1 )
+  {
+    return 0;
+  }
+  vtkIdType numSourcePts = source->GetNumberOfPoints();
+  vtkIdType numSourceCells = source->GetNumberOfCells();
+  vtkPointData *pd = input->GetPointData();
+  vtkDataArray *inNormals = this->GetInputArrayToProcess(2, input);
+  vtkDataArray *inCScalars = this->GetInputArrayToProcess(3, input);
+  if ( inCScalars == NULL )
+  {
+    inCScalars = inSScalars;
+  }
+  vtkDataArray *array3D = NULL;
+  if ( this->VectorMode == VTK_USE_VECTOR )
+  {
+    array3D = inVectors;
+  }
+  else if ( this->VectorMode == VTK_USE_NORMAL )
+  {
+    array3D = inNormals;
+  }
+  vtkDataArray *sourceNormals = source->GetPointData()->GetNormals();
+  vtkDataArray *sourceTCoords = source->GetPointData()->GetTCoords();
+  bool colorByScalar = this->ColorMode == VTK_COLOR_BY_SCALAR && inCScalars;
+  if ( numSourcePts < 1 ||
+       (array3D && array3D->GetNumberOfComponents() > 3) ||
+       (sourceNormals && (sourceNormals->GetNumberOfComponents() != 3 ||
+                          (sourceNormals->GetDataType() != VTK_FLOAT &&
+                           sourceNormals->GetDataType() != VTK_DOUBLE))) ||
+       (sourceTCoords && sourceTCoords->GetNumberOfComponents() > 3) ||
+       (colorByScalar && (!inCScalars->GetName() ||
+                          inCScalars->GetDataType() == VTK_BIT)) ||
+       !ArrayList::HasNamedDataArrays(pd) )
+  {
+    return 0;
+  }
+
+  // The source cells are copied from the cell arrays, check that they keep
+  // their type
+  vtkCellArray *sourceCells[4] = { source->GetVerts(), source->GetLines(),
+                                   source->GetPolys(), source->GetStrips() };
+  vtkIdType npts, *pts;
+  for (vtkIdType cellId=0; cellId < numSourceCells; cellId++)
+  {
+    source->GetCellPoints(cellId, npts, pts);
+    if ( vtkGlyph3DCellArrayIndex(source->GetCellType(cellId), npts) < 0 )
+    {
+      return 0;
+    }
+  }
+  if ( sourceCells[0]->GetNumberOfCells() + sourceCells[1]->GetNumberOfCells() +
+       sourceCells[2]->GetNumberOfCells() + sourceCells[3]->GetNumberOfCells() !=
+       numSourceCells )
+  {
+    return 0;
+  }
+
+  vtkDebugMacro(<<"Generating glyphs in parallel");
+
+  // Find the points to glyph. IsPointVisible() is virtual and may not be
+  // thread safe, so this is done serially.
+  vtkUniformGrid* inputUG = vtkUniformGrid::SafeDownCast(input);
+  unsigned char* inGhostLevels = NULL;
+  vtkDataArray* temp = pd->GetArray(vtkDataSetAttributes::GhostArrayName());
+  if ( temp && temp->GetDataType() == VTK_UNSIGNED_CHAR &&
+       temp->GetNumberOfComponents() == 1 )
+  {
+    inGhostLevels = static_cast<vtkUnsignedCharArray *>(temp)->GetPointer(0);
+  }
+  std::vector<vtkIdType> glyphIds(numPts);
+  vtkIdType numGlyphs = 0;
+  for (vtkIdType ptId=0; ptId < numPts; ptId++)
+  {
+    if ( (inGhostLevels &&
+          inGhostLevels[ptId] & vtkDataSetAttributes::DUPLICATEPOINT) ||
+         (inputUG && !inputUG->IsPointVisible(ptId)) ||
+         !this->IsPointVisible(input, ptId) )
+    {
+      glyphIds[ptId] = -1;
+    }
+    else
+    {
+      glyphIds[ptId] = numGlyphs++;
+    }
+  }
+  double x[3];
+  input->GetPoint(0, x); // build any cached geometry before threading
+
+  vtkGlyph3DInstanceGlyphs glypher;
+  glypher.Self = this;
+  glypher.Input = input;
+  glypher.GlyphIds = &glyphIds[0];
+  glypher.ScaleScalars = inSScalars;
+  glypher.Array3D = array3D;
+  glypher.Den = this->Range[1] - this->Range[0];
+  if ( glypher.Den == 0.0 )
+  {
+    glypher.Den = 1.0;
+  }
+
+  // Prepare the source glyph once
+  vtkNew<vtkPoints> sourcePts;
+  sourcePts->SetDataTypeToDouble();
+  if ( this->SourceTransform )
+  {
+    this->SourceTransform->TransformPoints(source->GetPoints(),
+                                           sourcePts.GetPointer());
+  }
+  else
+  {
+    sourcePts->SetNumberOfPoints(numSourcePts);
+    for (vtkIdType i=0; i < numSourcePts; i++)
+    {
+      sourcePts->SetPoint(i, source->GetPoint(i));
+    }
+  }
+  glypher.NumSourcePts = numSourcePts;
+  glypher.SourcePts =
+    static_cast<double *>(sourcePts->GetData()->GetVoidPointer(0));
+  std::vector<double> normals;
+  if ( sourceNormals )
+  {
+    normals.resize(3*numSourcePts);
+    for (vtkIdType i=0; i < numSourcePts; i++)
+    {
+      sourceNormals->GetTuple(i, &normals[3*i]);
+    }
+  }
+  glypher.SourceNormals = normals.empty() ? NULL : &normals[0];
+  std::vector<float> tcoords;
+  glypher.NumTCoordComps = 0;
+  if ( sourceTCoords )
+  {
+    int numComps = sourceTCoords->GetNumberOfComponents();
+    double tc[3];
+    tcoords.resize(numComps*numSourcePts);
+    for (vtkIdType i=0; i < numSourcePts; i++)
+    {
+      sourceTCoords->GetTuple(i, tc);
+      for (int j=0; j < numComps; j++)
+      {
+        tcoords[numComps*i+j] = static_cast<float>(tc[j]);
+      }
+    }
+    glypher.NumTCoordComps = numComps;
+  }
+  glypher.SourceTCoords = tcoords.empty() ? NULL : &tcoords[0];
+
+  // Allocate the output, every glyph has the same size
+  vtkIdType numNewPts = numGlyphs*numSourcePts;
+  vtkIdType numNewCells = numGlyphs*numSourceCells;
+  vtkPointData* outputPD = output->GetPointData();
+  vtkCellData* outputCD = output->GetCellData();
+
+  vtkPoints *newPts = vtkPoints::New();
+  newPts->SetNumberOfPoints(numNewPts);
+  glypher.Points = static_cast<float *>(newPts->GetData()->GetVoidPointer(0));
+  output->SetPoints(newPts);
+  newPts->Delete();
+
+  vtkIdType cellOffset = 0;
+  for (int k=0; k < 4; k++)
+  {
+    glypher.SourceCells[k] = sourceCells[k]->GetPointer();
+    glypher.SourceCellsSize[k] = sourceCells[k]->GetNumberOfConnectivityEntries();
+    glypher.NumSourceCells[k] = sourceCells[k]->GetNumberOfCells();
+    glypher.CellOffsets[k] = cellOffset;
+    glypher.Cells[k] = NULL;
+    cellOffset += numGlyphs*glypher.NumSourceCells[k];
+    if ( glypher.NumSourceCells[k] > 0 )
+    {
+      vtkCellArray *cells = vtkCellArray::New();
+      glypher.Cells[k] =
+        cells->WritePointer(numGlyphs*glypher.NumSourceCells[k],
+                            numGlyphs*glypher.SourceCellsSize[k]);
+      switch (k)
+      {
+        case 0: output->SetVerts(cells); break;
+        case 1: output->SetLines(cells); break;
+        case 2: output->SetPolys(cells); break;
+        default: output->SetStrips(cells); break;
+      }
+      cells->Delete();
+    }
+  }
+
+  outputPD->CopyVectorsOff();
+  outputPD->CopyNormalsOff();
+  outputPD->CopyTCoordsOff();
+  outputPD->CopyAllocate(pd, numNewPts);
+  ArrayList pointArrays;
+  pointArrays.AddArrays(numNewPts, pd, outputPD, 0.0, false);
+  glypher.PointArrays = &pointArrays;
+  ArrayList cellArrays;
+  glypher.CellArrays = NULL;
+  if ( this->FillCellData )
+  {
+    outputCD->CopyAllocate(pd, numNewCells);
+    cellArrays.AddArrays(numNewCells, pd, outputCD, 0.0, false);
+    glypher.CellArrays = &cellArrays;
+  }
+
+  glypher.PointIds = NULL;
+  if ( this->GeneratePointIds )
+  {
+    vtkIdTypeArray *pointIds = vtkIdTypeArray::New();
+    pointIds->SetName(this->PointIdsName);
+    pointIds->SetNumberOfTuples(numNewPts);
+    outputPD->AddArray(pointIds);
+    glypher.PointIds = pointIds->GetPointer(0);
+    pointIds->Delete();
+  }
+
+  vtkDataArray *newScalars = NULL;
+  ArrayList colorArrays;
+  glypher.Scalars = NULL;
+  glypher.ScalarsFromScale = false;
+  glypher.ColorArrays = NULL;
+  if ( colorByScalar )
+  {
+    vtkStdString name(inCScalars->GetName());
+    newScalars = colorArrays.AddArrayPair(numNewPts, inCScalars, name,
+                                          0.0, false);
+    glypher.ColorArrays = &colorArrays;
+  }
+  else if ( (this->ColorMode == VTK_COLOR_BY_SCALE && inSScalars) ||
+            (this->ColorMode == VTK_COLOR_BY_VECTOR && array3D) )
+  {
+    vtkFloatArray *scalars = vtkFloatArray::New();
+    scalars->SetNumberOfTuples(numNewPts);
+    if ( this->ColorMode == VTK_COLOR_BY_VECTOR )
+    {
+      scalars->SetName("VectorMagnitude");
+    }
+    else if ( this->ScaleMode == VTK_SCALE_BY_SCALAR )
+    {
+      scalars->SetName(inSScalars->GetName());
+      glypher.ScalarsFromScale = true;
+    }
+    else
+    {
+      scalars->SetName("GlyphScale");
+      glypher.ScalarsFromScale = true;
+    }
+    glypher.Scalars = scalars->GetPointer(0);
+    newScalars = scalars;
+  }
+  if ( newScalars )
+  {
+    int idx = outputPD->AddArray(newScalars);
+    outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+    if ( glypher.Scalars )
+    {
+      newScalars->Delete();
+    }
+  }
+
+  glypher.Vectors = NULL;
+  if ( array3D )
+  {
+    vtkFloatArray *newVectors = vtkFloatArray::New();
+    newVectors->SetNumberOfComponents(3);
+    newVectors->SetNumberOfTuples(numNewPts);
+    newVectors->SetName("GlyphVector");
+    glypher.Vectors = newVectors->GetPointer(0);
+    outputPD->SetVectors(newVectors);
+    newVectors->Delete();
+  }
+
+  glypher.Normals = NULL;
+  if ( sourceNormals )
+  {
+    vtkFloatArray *newNormals = vtkFloatArray::New();
+    newNormals->SetNumberOfComponents(3);
+    newNormals->SetNumberOfTuples(numNewPts);
+    newNormals->SetName("Normals");
+    glypher.Normals = newNormals->GetPointer(0);
+    outputPD->SetNormals(newNormals);
+    newNormals->Delete();
+  }
+
+  glypher.TCoords = NULL;
+  if ( sourceTCoords )
+  {
+    vtkFloatArray *newTCoords = vtkFloatArray::New();
+    newTCoords->SetNumberOfComponents(glypher.NumTCoordComps);
+    newTCoords->SetNumberOfTuples(numNewPts);
+    newTCoords->SetName("TCoords");
+    glypher.TCoords = newTCoords->GetPointer(0);
+    outputPD->SetTCoords(newTCoords);
+    newTCoords->Delete();
+  }
+
+  this->UpdateProgress(0.0);
+  vtkSMPTools::For(0, numPts, glypher);
+  this->UpdateProgress(1.0);
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 // Specify a source object at a specified table location.
 void vtkGlyph3D::SetSourceConnection(int id, vtkAlgorithmOutput* algOutput)
@@ -879,6 +1491,7 @@ void vtkGlyph3D::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Fill Cell Data: " << (this->FillCellData ? "On\n" : "Off\n");
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 
   os << indent << "SourceTransform: ";
   if (this->SourceTransform)
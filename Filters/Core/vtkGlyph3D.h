@@ -104,6 +104,7 @@ class vtkTransform;
 
 class VTKFILTERSCORE_EXPORT vtkGlyph3D : public vtkPolyDataAlgorithm
 {
+friend struct vtkGlyph3DInstanceGlyphs;
 public:
   vtkTypeMacro(vtkGlyph3D,vtkPolyDataAlgorithm);
   void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
@@ -308,6 +309,24 @@ public:
    */
   vtkMTimeType GetMTime() VTK_OVERRIDE;
 
+  //@{
+  /**
+   * Turn on/off the threaded generation of the glyphs (using vtkSMPTools).
+   * When indexing is off, the number of glyphs is counted first, and the
+   * transformed glyph points, the cells and the attributes are then written
+   * in parallel into preallocated arrays. The glyph points and their
+   * attributes are the same as in the serial output. The glyph cells are
+   * grouped by kind (vertices, lines, polygons and strips), as in any
+   * polydata built from cell arrays, so their order only differs from the
+   * serial output when the source has cells of several kinds. Sources with
+   * cells whose type would change (e.g. pixels) and attributes with unnamed
+   * arrays are processed serially. By default this is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
 protected:
   vtkGlyph3D();
   ~vtkGlyph3D() VTK_OVERRIDE;
@@ -334,6 +353,14 @@ protected:
                        vtkDataArray *inVectors);
   //@}
 
+  // Threaded version of Execute(). Returns 0 if the glyphs have to be
+  // generated by the serial code.
+  int ThreadedExecute(vtkDataSet* input,
+                      vtkInformationVector* sourceVector,
+                      vtkPolyData* output,
+                      vtkDataArray *inSScalars,
+                      vtkDataArray *inVectors);
+
   vtkPolyData **Source; // Geometry to copy to each point
   int Scaling; // Determine whether scaling of geometry is performed
   int ScaleMode; // Scale by scalar value or vector magnitude
@@ -348,6 +375,7 @@ protected:
   int FillCellData; // whether to fill output cell data
   char *PointIdsName;
   vtkTransform* SourceTransform;
+  int Threaded; // whether to generate the glyphs in parallel
 
 private:
   vtkGlyph3D(const vtkGlyph3D&) VTK_DELETE_FUNCTION;
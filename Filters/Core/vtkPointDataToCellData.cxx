@@ -19,14 +19,18 @@
 #include <limits>
 #include <vector>
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellData.h"
 #include "vtkDataArray.h"
 #include "vtkDataSet.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #define VTK_EPSILON 1.e-6
 
@@ -148,6 +152,41 @@ vtkIdType Histogram::IndexOfLargestBin()
   return std::max_element(this->Bins.begin(), it2, BinCountCmp)->Index;
 }
 
+// Average the point data of the points of each cell
+struct vtkPointDataToCellDataAverage
+{
+  vtkDataSet *Input;
+  ArrayList *Arrays;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *pointIds = this->PointIds.Local();
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      this->Input->GetCellPoints(cellId, pointIds);
+      vtkIdType numPts = pointIds->GetNumberOfIds();
+      if (numPts > 0)
+      {
+        this->Arrays->Average(static_cast<int>(numPts),
+                              pointIds->GetPointer(0), cellId);
+      }
+      else
+      {
+        this->Arrays->AssignNullValue(cellId);
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
 }
 
 
@@ -159,6 +198,7 @@ vtkPointDataToCellData::vtkPointDataToCellData()
 {
   this->PassPointData = 0;
   this->CategoricalData = 0;
+  this->Threaded = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -232,53 +272,57 @@ int vtkPointDataToCellData::RequestData(
   output->GetCellData()->PassData(input->GetCellData());
   output->GetCellData()->CopyFieldOff(vtkDataSetAttributes::GhostArrayName());
 
-  // notice that inPD and outCD are vtkPointData and vtkCellData; respectively.
-  // It's weird, but it works.
-  outCD->InterpolateAllocate(inPD,numCells);
-
-  int abort=0;
-  vtkIdType progressInterval=numCells/20 + 1;
-  for (cellId=0; cellId < numCells && !abort; cellId++)
+  if ( !(this->Threaded && !this->CategoricalData &&
+         this->ThreadedInterpolateCellData(input, output)) )
   {
-    if ( !(cellId % progressInterval) )
+    // notice that inPD and outCD are vtkPointData and vtkCellData;
+    // respectively. It's weird, but it works.
+    outCD->InterpolateAllocate(inPD,numCells);
+
+    int abort=0;
+    vtkIdType progressInterval=numCells/20 + 1;
+    for (cellId=0; cellId < numCells && !abort; cellId++)
     {
-      this->UpdateProgress((double)cellId/numCells);
-      abort = GetAbortExecute();
-    }
+      if ( !(cellId % progressInterval) )
+      {
+        this->UpdateProgress((double)cellId/numCells);
+        abort = GetAbortExecute();
+      }
 
-    input->GetCellPoints(cellId, cellPts);
-    numPts = cellPts->GetNumberOfIds();
+      input->GetCellPoints(cellId, cellPts);
+      numPts = cellPts->GetNumberOfIds();
 
-    if (numPts == 0)
-    {
-      continue;
-    }
+      if (numPts == 0)
+      {
+        continue;
+      }
 
-    // If we aren't dealing with categorical data...
-    if (!(this->CategoricalData))
-    {
-      // ...then we simply provide each point with an equal weight value and
-      // interpolate.
-      weight = 1.0 / numPts;
-      for (ptId=0; ptId < numPts; ptId++)
+      // If we aren't dealing with categorical data...
+      if (!(this->CategoricalData))
       {
-        weights[ptId] = weight;
+        // ...then we simply provide each point with an equal weight value and
+        // interpolate.
+        weight = 1.0 / numPts;
+        for (ptId=0; ptId < numPts; ptId++)
+        {
+          weights[ptId] = weight;
+        }
+        outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
       }
-      outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
-    }
-    else
-    {
-      // ...otherwise, we populate a histogram from the scalar values at each
-      // point, and then select the bin with the most elements.
-      hist.Reset(numPts);
-      for (ptId=0; ptId < numPts; ptId++)
+      else
       {
-        pointId = cellPts->GetId(ptId);
-        hist.Fill(pointId,
-                  input->GetPointData()->GetScalars()->GetTuple1(pointId));
+        // ...otherwise, we populate a histogram from the scalar values at each
+        // point, and then select the bin with the most elements.
+        hist.Reset(numPts);
+        for (ptId=0; ptId < numPts; ptId++)
+        {
+          pointId = cellPts->GetId(ptId);
+          hist.Fill(pointId,
+                    input->GetPointData()->GetScalars()->GetTuple1(pointId));
+        }
+
+        outCD->CopyData(inPD, hist.IndexOfLargestBin(), cellId);
       }
-
-      outCD->CopyData(inPD, hist.IndexOfLargestBin(), cellId);
     }
   }
 
@@ -295,10 +339,48 @@ int vtkPointDataToCellData::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkPointDataToCellData::ThreadedInterpolateCellData(vtkDataSet *input,
+                                                        vtkDataSet *output)
+{
+  vtkPointData *inPD = input->GetPointData();
+  if (!ArrayList::HasNamedDataArrays(inPD))
+  {
+    return 0;
+  }
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkCellData *outCD = output->GetCellData();
+
+  // The arrays passed from the input cell data are left as they are
+  ArrayList arrays;
+  for (int i = 0; i < outCD->GetNumberOfArrays(); ++i)
+  {
+    if (vtkDataArray *array = outCD->GetArray(i))
+    {
+      arrays.ExcludeArray(array);
+    }
+  }
+  outCD->InterpolateAllocate(inPD,numCells);
+  arrays.AddArrays(numCells, inPD, outCD, 0.0, false);
+
+  // GetCellPoints() is thread safe once called from a single thread
+  vtkNew<vtkIdList> cellPts;
+  input->GetCellPoints(0, cellPts.GetPointer());
+
+  vtkPointDataToCellDataAverage average;
+  average.Input = input;
+  average.Arrays = &arrays;
+  vtkSMPTools::For(0, numCells, average);
+  this->UpdateProgress(1.0);
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkPointDataToCellData::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "Pass Point Data: " << (this->PassPointData ? "On\n" : "Off\n");
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
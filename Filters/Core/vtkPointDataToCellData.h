@@ -67,6 +67,19 @@ public:
   vtkBooleanMacro(CategoricalData,int);
   //@}
 
+  //@{
+  /**
+   * Set/Get whether the cell data is computed in parallel, with
+   * vtkSMPTools, all the arrays of a cell being averaged at once. The values
+   * are those of the serial filter. Categorical data, and inputs whose point
+   * data has unnamed or non-numeric arrays, are processed serially. Default
+   * is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
 protected:
   vtkPointDataToCellData();
   ~vtkPointDataToCellData() VTK_OVERRIDE {}
@@ -75,8 +88,15 @@ protected:
                   vtkInformationVector** inputVector,
                   vtkInformationVector* outputVector) VTK_OVERRIDE;
 
+  /**
+   * Average the point data of the cells in parallel. Returns 0, without any
+   * output cell data, if the point data cannot be processed in parallel.
+   */
+  int ThreadedInterpolateCellData(vtkDataSet *input, vtkDataSet *output);
+
   int PassPointData;
   int CategoricalData;
+  int Threaded;
 private:
   vtkPointDataToCellData(const vtkPointDataToCellData&) VTK_DELETE_FUNCTION;
   void operator=(const vtkPointDataToCellData&) VTK_DELETE_FUNCTION;
@@ -17,17 +17,20 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkConnectedRegionLabeler.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 
 #include <algorithm> // for fill_n
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataConnectivityFilter);
 
@@ -58,6 +61,7 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
   this->VisitedPointIds = vtkIdList::New();
 
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->Threaded = 0;
 }
 
 vtkPolyDataConnectivityFilter::~vtkPolyDataConnectivityFilter()
@@ -131,11 +135,18 @@ int vtkPolyDataConnectivityFilter::RequestData(
     }
   }
 
-  // Build cell structure
+  // Build cell structure. The parallel labeling does not need the links.
   //
   this->Mesh = vtkPolyData::New();
   this->Mesh->CopyStructure(input);
-  this->Mesh->BuildLinks();
+  if ( this->Threaded )
+  {
+    this->Mesh->BuildCells();
+  }
+  else
+  {
+    this->Mesh->BuildLinks();
+  }
   this->UpdateProgress(0.10);
 
   // Remove all visited point ids
@@ -186,7 +197,11 @@ int vtkPolyDataConnectivityFilter::RequestData(
   this->PointIds = vtkIdList::New();
   this->PointIds->Allocate(8, VTK_CELL_SIZE);
 
-  if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+  if ( this->Threaded )
+  {
+    largestRegionId = this->ThreadedTraverseAndMark();
+  }
+  else if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
   { //visit all cells marking with region number
@@ -509,6 +524,80 @@ void vtkPolyDataConnectivityFilter::TraverseAndMark ()
   return;
 }
 
+// --------------------------------------------------------------------------
+// Label the regions like TraverseAndMark() does, but in parallel. Visited,
+// PointMap and the region ids are filled for the cell extraction in
+// RequestData(), the output points being numbered in input order.
+vtkIdType vtkPolyDataConnectivityFilter::ThreadedTraverseAndMark()
+{
+  vtkIdType largestRegionId = 0;
+  vtkConnectedRegionLabeler labeler(this->Mesh, this->InScalars,
+                                    this->ScalarRange,
+                                    this->FullScalarConnectivity != 0);
+  this->UpdateProgress(0.5);
+
+  if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+       this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
+       this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
+  {
+    std::vector<vtkIdType> regionSizes;
+    labeler.LabelAllRegions(this->Visited, regionSizes);
+    vtkIdType maxCellsInRegion = 0;
+    this->RegionNumber = static_cast<vtkIdType>(regionSizes.size());
+    this->RegionSizes->SetNumberOfValues(this->RegionNumber);
+    for (vtkIdType i=0; i < this->RegionNumber; i++)
+    {
+      this->RegionSizes->SetValue(i, regionSizes[i]);
+      if ( regionSizes[i] > maxCellsInRegion )
+      {
+        maxCellsInRegion = regionSizes[i];
+        largestRegionId = i;
+      }
+    }
+  }
+  else // regions have been seeded, everything considered in same region
+  {
+    vtkNew<vtkIdList> seedPoints;
+    vtkIdList *seedCells = NULL;
+    if ( this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS )
+    {
+      seedPoints->DeepCopy(this->Seeds);
+    }
+    else if ( this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS )
+    {
+      seedCells = this->Seeds;
+    }
+    else
+    {//loop over points, find closest one
+      vtkPoints *inPts = this->Mesh->GetPoints();
+      double minDist2, dist2, x[3];
+      vtkIdType i, minId = 0, numPts = inPts->GetNumberOfPoints();
+      for (minDist2=VTK_DOUBLE_MAX, i=0; i<numPts; i++)
+      {
+        inPts->GetPoint(i,x);
+        dist2 = vtkMath::Distance2BetweenPoints(x,this->ClosestPoint);
+        if ( dist2 < minDist2 )
+        {
+          minId = i;
+          minDist2 = dist2;
+        }
+      }
+      seedPoints->InsertNextId(minId);
+    }
+    this->NumCellsInRegion = labeler.LabelSeededRegion(
+      seedPoints.GetPointer(), seedCells, this->Visited);
+    this->RegionSizes->InsertValue(this->RegionNumber,this->NumCellsInRegion);
+  }
+
+  this->PointNumber = labeler.MapPoints(this->Visited, this->PointMap,
+    vtkArrayDownCast<vtkIdTypeArray>(this->NewScalars)->GetPointer(0));
+  // Only the extracted points have a region id
+  this->NewScalars->SetNumberOfTuples(this->PointNumber);
+  this->UpdateProgress(0.9);
+
+  return largestRegionId;
+}
+
 // --------------------------------------------------------------------------
 int vtkPolyDataConnectivityFilter::IsScalarConnected( vtkIdType cellId )
 {
@@ -661,4 +750,5 @@ void vtkPolyDataConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
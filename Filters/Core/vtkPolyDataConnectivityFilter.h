@@ -221,6 +221,22 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the parallel labeling of the regions (using vtkSMPTools).
+   * The cells are merged into components by a concurrent union-find over
+   * their points instead of the serial wave-front traversal, for all the
+   * extraction modes and with scalar connectivity. The regions, their
+   * sizes and the extracted cells are the same as with the serial
+   * traversal, but the output points (and the visited point ids) are
+   * numbered in increasing input point id order instead of traversal order.
+   * By default this is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
 protected:
   vtkPolyDataConnectivityFilter();
   ~vtkPolyDataConnectivityFilter() VTK_OVERRIDE;
@@ -246,6 +262,10 @@ protected:
 
   void TraverseAndMark();
 
+  // Label the regions in parallel instead of TraverseAndMark(). Returns the
+  // largest region.
+  vtkIdType ThreadedTraverseAndMark();
+
   // used to support algorithm execution
   vtkDataArray *CellScalars;
   vtkIdList *NeighborCellPointIds;
@@ -265,6 +285,7 @@ protected:
 
   int MarkVisitedPointIds;
   int OutputPointsPrecision;
+  int Threaded;
 
 private:
   vtkPolyDataConnectivityFilter(const vtkPolyDataConnectivityFilter&) VTK_DELETE_FUNCTION;
@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkPolyDataNormals.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
@@ -26,9 +27,13 @@
 #include "vtkPolygon.h"
 #include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPTools.h"
 
 #include "vtkNew.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkPolyDataNormals);
 
 // Construct with feature angle=30, splitting and consistency turned on,
@@ -46,6 +51,7 @@ vtkPolyDataNormals::vtkPolyDataNormals()
   // some internal data
   this->NumFlips = 0;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->Threaded = 0;
   this->Wave = 0;
   this->Wave2 = 0;
   this->CellIds = 0;
@@ -60,6 +66,388 @@ vtkPolyDataNormals::vtkPolyDataNormals()
 #define VTK_CELL_NOT_VISITED     0
 #define VTK_CELL_VISITED         1
 
+//----------------------------------------------------------------------------
+// Threaded computation of the normals. The polygon normals are computed in
+// parallel. When splitting, the cells around each point are gathered in
+// parallel into the regions MarkAndSplit() finds, stored along the links of
+// the point; the new points are then numbered by a scan as the serial code
+// numbers them, and the polygons are updated in parallel. The point normals
+// are gathered through the links in the order of the cells, which gives the
+// same sums as the serial accumulation.
+namespace
+{
+
+struct vtkPolyDataNormalsMesh
+{
+  vtkPolyData *OldMesh; // with links, for the topological queries
+  vtkPolyData *NewMesh; // with the polygons being updated
+  vtkIdType NumberOfPoints;
+  const float *PolyNormals;
+  double CosAngle;
+  std::vector<vtkIdType> RegionOffsets; // regions of the cells of a point
+  std::vector<int> Regions; // region of each cell around each point
+  std::vector<vtkIdType> NumberOfNewPoints; // created by each point
+  std::vector<vtkIdType> NewPointOffsets;
+  std::vector<vtkIdType> Map; // the points the new points duplicate
+
+  // The output id of a point in its i-th cell
+  vtkIdType GetPointId(vtkIdType ptId, int i) const
+  {
+    if ( this->Regions.empty() )
+    {
+      return ptId;
+    }
+    int region = this->Regions[this->RegionOffsets[ptId] + i];
+    return region == 0 ? ptId :
+      this->NumberOfPoints + this->NewPointOffsets[ptId] + region - 1;
+  }
+
+  // Whether a cell uses a point
+  bool UsesPoint(vtkIdType cellId, vtkIdType ptId) const
+  {
+    vtkIdType npts, *pts;
+    this->OldMesh->GetCellPoints(cellId, npts, pts);
+    return std::find(pts, pts + npts, ptId) != pts + npts;
+  }
+
+  // The points of a cell next to a point. If nei is one of them, return the
+  // other one.
+  void GetNeighborPoints(vtkIdType cellId, vtkIdType ptId, vtkIdType nei,
+                         vtkIdType neiPt[2]) const
+  {
+    vtkIdType npts, *pts, spot;
+    this->OldMesh->GetCellPoints(cellId, npts, pts);
+    for (spot=0; spot < npts; spot++)
+    {
+      if ( pts[spot] == ptId )
+      {
+        break;
+      }
+    }
+    if ( spot == 0 )
+    {
+      neiPt[0] = pts[spot+1];
+      neiPt[1] = pts[npts-1];
+    }
+    else if ( spot == (npts-1) )
+    {
+      neiPt[0] = pts[spot-1];
+      neiPt[1] = pts[0];
+    }
+    else
+    {
+      neiPt[0] = pts[spot+1];
+      neiPt[1] = pts[spot-1];
+    }
+    if ( neiPt[0] == nei )
+    {
+      neiPt[0] = neiPt[1];
+    }
+  }
+
+  // Set the region of a cell around a point, at each of its uses
+  void SetRegion(int ncells, const vtkIdType *cells, int *regions,
+                 vtkIdType cellId, int region) const
+  {
+    for (int i=0; i < ncells; i++)
+    {
+      if ( cells[i] == cellId )
+      {
+        regions[i] = region;
+      }
+    }
+  }
+
+  // Mark the regions of the cells around a point as MarkAndSplit() does, and
+  // return their number
+  int MarkRegions(vtkIdType ptId, int ncells, const vtkIdType *cells,
+                  int *regions) const
+  {
+    std::fill_n(regions, ncells, -1);
+    int numRegions = 0;
+    for (int j=0; j < ncells; j++)
+    {
+      if ( regions[j] >= 0 )
+      {
+        continue;
+      }
+      this->SetRegion(ncells, cells, regions, cells[j], numRegions);
+
+      vtkIdType neiPt[2];
+      this->GetNeighborPoints(cells[j], ptId, -1, neiPt);
+      for (int i=0; i < 2; i++) //for each of the two edges of the seed cell
+      {
+        int c = j;
+        vtkIdType nei = neiPt[i];
+        while ( c >= 0 ) //while we can grow this region
+        {
+          // The edge neighbors of the cell are the other cells around the
+          // point using the edge point
+          int numNeighbors = 0, neighbor = -1;
+          for (int k=0; k < ncells; k++)
+          {
+            if ( cells[k] != cells[c] && this->UsesPoint(cells[k], nei) )
+            {
+              numNeighbors++;
+              neighbor = k;
+            }
+          }
+          if ( numNeighbors == 1 && regions[neighbor] < 0 )
+          {
+            const float *thisNormal = this->PolyNormals + 3*cells[c];
+            const float *neiNormal = this->PolyNormals + 3*cells[neighbor];
+            double dot = static_cast<double>(thisNormal[0])*neiNormal[0] +
+              static_cast<double>(thisNormal[1])*neiNormal[1] +
+              static_cast<double>(thisNormal[2])*neiNormal[2];
+            if ( dot > this->CosAngle )
+            {
+              this->SetRegion(ncells, cells, regions, cells[neighbor],
+                              numRegions);
+              c = neighbor;
+              vtkIdType nextPt[2];
+              this->GetNeighborPoints(cells[c], ptId, nei, nextPt);
+              nei = nextPt[0];
+            }
+            else
+            {
+              c = -1; //separated by edge angle
+            }
+          }
+          else
+          {
+            c = -1; //separated by previous visit, boundary, or non-manifold
+          }
+        }
+      }
+      numRegions++;
+    }
+    return numRegions;
+  }
+};
+
+// Compute the polygon normals
+struct vtkPolyDataNormalsComputePolyNormals
+{
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  float *PolyNormals;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdType npts, *pts;
+    double n[3];
+    for ( ; cellId < endCellId; cellId++ )
+    {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+      float *polyNormal = this->PolyNormals + 3*cellId;
+      polyNormal[0] = static_cast<float>(n[0]);
+      polyNormal[1] = static_cast<float>(n[1]);
+      polyNormal[2] = static_cast<float>(n[2]);
+    }
+  }
+};
+
+// Count the cells around the points
+struct vtkPolyDataNormalsCountCells
+{
+  vtkPolyDataNormalsMesh *Mesh;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    unsigned short ncells;
+    vtkIdType *cells;
+    for ( ; ptId < endPtId; ptId++ )
+    {
+      this->Mesh->OldMesh->GetPointCells(ptId, ncells, cells);
+      this->Mesh->RegionOffsets[ptId] = ncells;
+    }
+  }
+};
+
+// Mark the regions around the points, and count the new points
+struct vtkPolyDataNormalsMarkRegions
+{
+  vtkPolyDataNormalsMesh *Mesh;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    unsigned short ncells;
+    vtkIdType *cells;
+    for ( ; ptId < endPtId; ptId++ )
+    {
+      this->Mesh->OldMesh->GetPointCells(ptId, ncells, cells);
+      int *regions = &this->Mesh->Regions[0] + this->Mesh->RegionOffsets[ptId];
+      int numRegions = 1;
+      if ( ncells > 1 )
+      {
+        numRegions = this->Mesh->MarkRegions(ptId, ncells, cells, regions);
+      }
+      else
+      {
+        std::fill_n(regions, ncells, 0);
+      }
+      this->Mesh->NumberOfNewPoints[ptId] = numRegions - 1;
+    }
+  }
+};
+
+// Replace the split points in the polygons
+struct vtkPolyDataNormalsReplacePoints
+{
+  vtkPolyDataNormalsMesh *Mesh;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdType npts, *pts;
+    unsigned short ncells;
+    vtkIdType *cells;
+    for ( ; cellId < endCellId; cellId++ )
+    {
+      this->Mesh->NewMesh->GetCellPoints(cellId, npts, pts);
+      for (vtkIdType i=0; i < npts; i++)
+      {
+        this->Mesh->OldMesh->GetPointCells(pts[i], ncells, cells);
+        int j = static_cast<int>(std::find(cells, cells + ncells, cellId) -
+                                 cells);
+        pts[i] = this->Mesh->GetPointId(pts[i], j);
+      }
+    }
+  }
+};
+
+// Map the new points to the points they duplicate
+struct vtkPolyDataNormalsMapPoints
+{
+  vtkPolyDataNormalsMesh *Mesh;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ptId++ )
+    {
+      std::fill_n(&this->Mesh->Map[0] + this->Mesh->NewPointOffsets[ptId],
+                  this->Mesh->NumberOfNewPoints[ptId], ptId);
+    }
+  }
+};
+
+// Copy the points, and their attributes
+struct vtkPolyDataNormalsCopyPoints
+{
+  vtkPolyDataNormalsMesh *Mesh;
+  vtkPoints *InPoints;
+  vtkPoints *OutPoints;
+  ArrayList *Arrays;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for ( ; ptId < endPtId; ptId++ )
+    {
+      vtkIdType oldId = ptId < this->Mesh->NumberOfPoints ? ptId :
+        this->Mesh->Map[ptId - this->Mesh->NumberOfPoints];
+      this->InPoints->GetPoint(oldId, x);
+      this->OutPoints->SetPoint(ptId, x);
+      if ( this->Arrays )
+      {
+        this->Arrays->Copy(oldId, ptId);
+      }
+    }
+  }
+};
+
+// Gather the normals of the cells around the points
+struct vtkPolyDataNormalsAccumulateNormals
+{
+  vtkPolyDataNormalsMesh *Mesh;
+  float *Normals;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    unsigned short ncells;
+    vtkIdType *cells;
+    for ( ; ptId < endPtId; ptId++ )
+    {
+      this->Mesh->OldMesh->GetPointCells(ptId, ncells, cells);
+      for (int i=0; i < ncells; i++)
+      {
+        float *normal = this->Normals + 3*this->Mesh->GetPointId(ptId, i);
+        const float *polyNormal = this->Mesh->PolyNormals + 3*cells[i];
+        normal[0] += polyNormal[0];
+        normal[1] += polyNormal[1];
+        normal[2] += polyNormal[2];
+      }
+    }
+  }
+};
+
+// Normalize the point normals
+struct vtkPolyDataNormalsNormalize
+{
+  float *Normals;
+  double FlipDirection;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ptId++ )
+    {
+      float *normal = this->Normals + 3*ptId;
+      const double length = sqrt(normal[0] * normal[0] +
+                                 normal[1] * normal[1] +
+                                 normal[2] * normal[2]) * this->FlipDirection;
+      if (length != 0.0)
+      {
+        normal[0] /= length;
+        normal[1] /= length;
+        normal[2] /= length;
+      }
+    }
+  }
+};
+
+// Split the points on sharp edges, and return the number of output points
+vtkIdType vtkPolyDataNormalsSplit(vtkPolyDataNormalsMesh &mesh)
+{
+  vtkIdType numPts = mesh.NumberOfPoints;
+  vtkIdType numPolys = mesh.NewMesh->GetNumberOfCells();
+
+  mesh.RegionOffsets.resize(numPts);
+  vtkPolyDataNormalsCountCells countCells = { &mesh };
+  vtkSMPTools::For(0, numPts, countCells);
+  vtkIdType numUses = mesh.RegionOffsets[numPts-1];
+  vtkSMPTools::ExclusiveScan(mesh.RegionOffsets.begin(),
+                             mesh.RegionOffsets.end(),
+                             mesh.RegionOffsets.begin(),
+                             static_cast<vtkIdType>(0));
+  numUses += mesh.RegionOffsets[numPts-1];
+
+  mesh.Regions.resize(numUses);
+  mesh.NumberOfNewPoints.resize(numPts);
+  vtkPolyDataNormalsMarkRegions markRegions = { &mesh };
+  vtkSMPTools::For(0, numPts, markRegions);
+
+  mesh.NewPointOffsets.resize(numPts);
+  vtkSMPTools::ExclusiveScan(mesh.NumberOfNewPoints.begin(),
+                             mesh.NumberOfNewPoints.end(),
+                             mesh.NewPointOffsets.begin(),
+                             static_cast<vtkIdType>(0));
+  vtkIdType numSplitPts = mesh.NewPointOffsets[numPts-1] +
+    mesh.NumberOfNewPoints[numPts-1];
+
+  if ( numSplitPts > 0 )
+  {
+    vtkPolyDataNormalsReplacePoints replacePoints = { &mesh };
+    vtkSMPTools::For(0, numPolys, replacePoints);
+    mesh.Map.resize(numSplitPts);
+    vtkPolyDataNormalsMapPoints mapPoints = { &mesh };
+    vtkSMPTools::For(0, numPts, mapPoints);
+  }
+
+  return numPts + numSplitPts;
+}
+
+}
+
 // Generate normals for polygon meshes
 int vtkPolyDataNormals::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -346,19 +734,35 @@ int vtkPolyDataNormals::RequestData(
   this->PolyNormals->SetName("Normals");
   this->PolyNormals->SetNumberOfTuples(numPolys);
 
-  for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
-       cellId++ )
+  vtkPolyDataNormalsMesh mesh;
+  mesh.OldMesh = this->OldMesh;
+  mesh.NewMesh = this->NewMesh;
+  mesh.NumberOfPoints = numPts;
+  mesh.PolyNormals = this->PolyNormals->GetPointer(0);
+  mesh.CosAngle = 0.0;
+
+  if ( this->Threaded )
+  {
+    vtkPolyDataNormalsComputePolyNormals computePolyNormals =
+      { this->NewMesh, inPts, this->PolyNormals->GetPointer(0) };
+    vtkSMPTools::For(0, numPolys, computePolyNormals);
+  }
+  else
   {
-    if ((cellId % 1000) == 0)
+    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
+         cellId++ )
     {
-      this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
-      if (this->GetAbortExecute())
+      if ((cellId % 1000) == 0)
       {
-        break;
+        this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
+        if (this->GetAbortExecute())
+        {
+          break;
+        }
       }
+      vtkPolygon::ComputeNormal(inPts, npts, pts, n);
+      this->PolyNormals->SetTuple(cellId,n);
     }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(cellId,n);
   }
 
   // Split mesh if sharp features
@@ -372,19 +776,27 @@ int vtkPolyDataNormals::RequestData(
     //  Splitting will create new points.  We have to create index array
     // to map new points into old points.
     //
-    this->Map = vtkIdList::New();
-    this->Map->SetNumberOfIds(numPts);
-    for (vtkIdType i=0; i < numPts; i++)
+    if ( this->Threaded )
     {
-      this->Map->SetId(i,i);
+      mesh.CosAngle = this->CosAngle;
+      numNewPts = vtkPolyDataNormalsSplit(mesh);
     }
-
-    for (ptId=0; ptId < numPts; ptId++)
+    else
     {
-      this->MarkAndSplit(ptId);
-    }//for all input points
+      this->Map = vtkIdList::New();
+      this->Map->SetNumberOfIds(numPts);
+      for (vtkIdType i=0; i < numPts; i++)
+      {
+        this->Map->SetId(i,i);
+      }
 
-    numNewPts = this->Map->GetNumberOfIds();
+      for (ptId=0; ptId < numPts; ptId++)
+      {
+        this->MarkAndSplit(ptId);
+      }//for all input points
+
+      numNewPts = this->Map->GetNumberOfIds();
+    }
 
     vtkDebugMacro(<<"Created " << numNewPts-numPts << " new points");
 
@@ -418,13 +830,37 @@ int vtkPolyDataNormals::RequestData(
     }
 
     newPts->SetNumberOfPoints(numNewPts);
-    for (ptId=0; ptId < numNewPts; ptId++)
+    if ( this->Threaded )
     {
-      oldId = this->Map->GetId(ptId);
-      newPts->SetPoint(ptId,inPts->GetPoint(oldId));
-      outPD->CopyData(pd,oldId,ptId);
+      // The attributes are copied in parallel if array lists can copy them
+      ArrayList arrays;
+      bool copyArrays = ArrayList::HasNamedDataArrays(pd);
+      if ( copyArrays )
+      {
+        arrays.AddArrays(numNewPts, pd, outPD, 0.0, false);
+      }
+      vtkPolyDataNormalsCopyPoints copyPoints =
+        { &mesh, inPts, newPts, copyArrays ? &arrays : NULL };
+      vtkSMPTools::For(0, numNewPts, copyPoints);
+      if ( !copyArrays )
+      {
+        for (ptId=0; ptId < numNewPts; ptId++)
+        {
+          oldId = (ptId < numPts ? ptId : mesh.Map[ptId-numPts]);
+          outPD->CopyData(pd,oldId,ptId);
+        }
+      }
+    }
+    else
+    {
+      for (ptId=0; ptId < numNewPts; ptId++)
+      {
+        oldId = this->Map->GetId(ptId);
+        newPts->SetPoint(ptId,inPts->GetPoint(oldId));
+        outPD->CopyData(pd,oldId,ptId);
+      }
+      this->Map->Delete();
     }
-    this->Map->Delete();
   } //splitting
 
   else //no splitting, so no new points
@@ -459,7 +895,15 @@ int vtkPolyDataNormals::RequestData(
 
   float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
 
-  if (this->ComputePointNormals)
+  if (this->ComputePointNormals && this->Threaded)
+  {
+    // Gather the polygon normals through the links of the input points
+    vtkPolyDataNormalsAccumulateNormals accumulateNormals = { &mesh, fNormals };
+    vtkSMPTools::For(0, numPts, accumulateNormals);
+    vtkPolyDataNormalsNormalize normalize = { fNormals, flipDirection };
+    vtkSMPTools::For(0, numNewPts, normalize);
+  }
+  else if (this->ComputePointNormals)
   {
     for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);
          ++cellId)
@@ -776,5 +1220,6 @@ void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
      << (this->NonManifoldTraversal ? "On\n" : "Off\n");
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
 
@@ -173,6 +173,20 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the threaded computation of the normals (using vtkSMPTools).
+   * The polygon normals, the splitting of sharp edges and the point normals
+   * are then computed in parallel, giving the same output as the serial
+   * computation; the consistency and auto orientation traversals remain
+   * serial. The point data is copied in parallel when all its arrays are
+   * named data arrays. By default this is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
 protected:
   vtkPolyDataNormals();
   ~vtkPolyDataNormals() VTK_OVERRIDE {}
@@ -190,6 +204,7 @@ protected:
   int ComputeCellNormals;
   int NumFlips;
   int OutputPointsPrecision;
+  int Threaded;
 
 private:
   vtkIdList *Wave;
@@ -24,10 +24,15 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkTimerLog.h"
 #include "vtkTriangle.h"
 #include <vtksys/hash_set.hxx> // keep track of inserted triangles
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 vtkStandardNewMacro(vtkQuadricClustering);
 
 //----------------------------------------------------------------------------
@@ -38,6 +43,249 @@ struct vtkQuadricClusteringIdTypeHash {
 class vtkQuadricClusteringCellSet : public vtksys::hash_set<vtkIdType, vtkQuadricClusteringIdTypeHash> {};
 typedef vtkQuadricClusteringCellSet::iterator vtkQuadricClusteringCellSetIterator;
 
+namespace
+{
+
+// The error function of a vertex is the length (point to vert) squared.
+// We save nine coefficients of the error function cooresponding to:
+// 0: Px^2
+// 1: PxPy
+// 2: PxPz
+// 3: Px
+// 4: Py^2
+// 5: PyPz
+// 6: Py
+// 7: Pz^2
+// 8: Pz
+// We ignore the constant because it disappears with the derivative.
+void vtkQuadricClusteringVertexQuadric(const double pt[3], double q[9])
+{
+  q[0] = 1.0;
+  q[1] = 0.0;
+  q[2] = 0.0;
+  q[3] = -pt[0];
+  q[4] = 1.0;
+  q[5] = 0.0;
+  q[6] = -pt[1];
+  q[7] = 1.0;
+  q[8] = -pt[2];
+}
+
+// The error function of a line segment is the area (squared) of the
+// triangle (seg,pt). Returns the squared length of the segment, the
+// quadric being left unset when it is 0.
+double vtkQuadricClusteringEdgeQuadric(const double pt0[3],
+                                       const double pt1[3], double q[9])
+{
+  double length2, tmp;
+  double d[3];
+  double m[3];  // The mid point of the segement.(p1 or p2 could be used also).
+  double md;    // The dot product of m and d.
+
+  // Compute the direction vector of the segment.
+  d[0] = pt1[0] - pt0[0];
+  d[1] = pt1[1] - pt0[1];
+  d[2] = pt1[2] - pt0[2];
+
+  // Compute the length^2 of the line segement.
+  length2 = d[0]*d[0] + d[1]*d[1] + d[2]*d[2];
+
+  if (length2 == 0.0)
+  { // Coincident points.  Avoid divide by zero.
+    return length2;
+  }
+
+  // Normalize the direction vector.
+  tmp = 1.0 / sqrt(length2);
+  d[0] = d[0] * tmp;
+  d[1] = d[1] * tmp;
+  d[2] = d[2] * tmp;
+
+  // Compute the mid point of the segment.
+  m[0] = 0.5 * (pt1[0] + pt0[0]);
+  m[1] = 0.5 * (pt1[1] + pt0[1]);
+  m[2] = 0.5 * (pt1[2] + pt0[2]);
+
+  // Compute dot(m, d);
+  md = m[0]*d[0] + m[1]*d[1] + m[2]*d[2];
+
+  // Same coefficients as for the vertices.
+  q[0] = length2*(1.0 - d[0]*d[0]);
+  q[1] = -length2*(d[0]*d[1]);
+  q[2] = -length2*(d[0]*d[2]);
+  q[3] = length2*(d[0]*md - m[0]);
+  q[4] = length2*(1.0 - d[1]*d[1]);
+  q[5] = -length2*(d[1]*d[2]);
+  q[6] = length2*(d[1]*md - m[1]);
+  q[7] = length2*(1.0 - d[2]*d[2]);
+  q[8] = length2*(d[2]*md - m[2]);
+
+  return length2;
+}
+
+// The error function of a triangle is the volume (squared) of the
+// tetrahedron formed by the triangle and the point.
+void vtkQuadricClusteringTriangleQuadric(double pt0[3], double pt1[3],
+                                         double pt2[3], double q[9])
+{
+  double quadric4x4[4][4];
+  vtkTriangle::ComputeQuadric(pt0, pt1, pt2, quadric4x4);
+  q[0] = quadric4x4[0][0];
+  q[1] = quadric4x4[0][1];
+  q[2] = quadric4x4[0][2];
+  q[3] = quadric4x4[0][3];
+  q[4] = quadric4x4[1][1];
+  q[5] = quadric4x4[1][2];
+  q[6] = quadric4x4[1][3];
+  q[7] = quadric4x4[2][2];
+  q[8] = quadric4x4[2][3];
+}
+
+// A vertex, line segment or triangle adding its quadric to the bins of its
+// points
+struct vtkQuadricClusteringPrimitive
+{
+  vtkIdType CellId;
+  int NumberOfPoints;
+  vtkIdType PointIds[3];
+};
+
+// Compute the quadrics of the primitives
+struct vtkQuadricClusteringComputeQuadrics
+{
+  vtkPoints *Points;
+  const vtkQuadricClusteringPrimitive *Primitives;
+  double *Quadrics;
+
+  void operator()(vtkIdType primId, vtkIdType endPrimId)
+  {
+    double pts[3][3];
+    for ( ; primId < endPrimId; ++primId )
+    {
+      const vtkQuadricClusteringPrimitive &prim = this->Primitives[primId];
+      for (int i = 0; i < prim.NumberOfPoints; ++i)
+      {
+        this->Points->GetPoint(prim.PointIds[i], pts[i]);
+      }
+      double *q = this->Quadrics + 9*primId;
+      if (prim.NumberOfPoints == 1)
+      {
+        vtkQuadricClusteringVertexQuadric(pts[0], q);
+      }
+      else if (prim.NumberOfPoints == 2)
+      {
+        vtkQuadricClusteringEdgeQuadric(pts[0], pts[1], q);
+      }
+      else
+      {
+        vtkQuadricClusteringTriangleQuadric(pts[0], pts[1], pts[2], q);
+      }
+    }
+  }
+};
+
+}
+
+// Compute the bins of the points
+struct vtkQuadricClusteringHashPoints
+{
+  vtkQuadricClustering *Self;
+  vtkPoints *Points;
+  vtkIdType *BinIds;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      this->Points->GetPoint(ptId, x);
+      this->BinIds[ptId] = this->Self->HashPoint(x);
+    }
+  }
+};
+
+// Add the quadrics of the primitives to the bins. The uses of the bins by
+// the primitives are sorted by bin, then in the order of the primitives, so
+// that each bin is updated by a single thread as Append() updates it.
+struct vtkQuadricClusteringAccumulateQuadrics
+{
+  vtkQuadricClustering *Self;
+  const std::pair<vtkIdType,vtkIdType> *Uses;
+  vtkIdType NumberOfUses;
+  const vtkQuadricClusteringPrimitive *Primitives;
+  const double *Quadrics;
+
+  void operator()(vtkIdType useId, vtkIdType endUseId)
+  {
+    for ( ; useId < endUseId; ++useId )
+    {
+      // Each bin is processed from its first use
+      vtkIdType binId = this->Uses[useId].first;
+      if (useId > 0 && this->Uses[useId-1].first == binId)
+      {
+        continue;
+      }
+      vtkIdType endBinUseId = useId + 1;
+      int dimension = this->Primitives[this->Uses[useId].second / 3].
+        NumberOfPoints - 1;
+      for ( ; endBinUseId < this->NumberOfUses &&
+              this->Uses[endBinUseId].first == binId; ++endBinUseId )
+      {
+        dimension = std::min(dimension, this->Primitives[
+          this->Uses[endBinUseId].second / 3].NumberOfPoints - 1);
+      }
+
+      // Points supercede segments, which supercede triangles
+      vtkQuadricClustering::PointQuadric &binQuadric =
+        this->Self->QuadricArray[binId];
+      if (binQuadric.Dimension < dimension)
+      {
+        continue;
+      }
+      if (binQuadric.Dimension > dimension)
+      {
+        binQuadric.Dimension = dimension;
+        this->Self->InitializeQuadric(binQuadric.Quadric);
+      }
+      for (vtkIdType i = useId; i < endBinUseId; ++i)
+      {
+        vtkIdType primId = this->Uses[i].second / 3;
+        if (this->Primitives[primId].NumberOfPoints - 1 == dimension)
+        {
+          const double *quadric = this->Quadrics + 9*primId;
+          for (int j = 0; j < 9; j++)
+          {
+            binQuadric.Quadric[j] += (quadric[j] * 100000000.0);
+          }
+        }
+      }
+    }
+  }
+};
+
+// Compute the representative points of the bins used by the output
+struct vtkQuadricClusteringRepresentativePoints
+{
+  vtkQuadricClustering *Self;
+  vtkPoints *OutputPoints;
+
+  void operator()(vtkIdType binId, vtkIdType endBinId)
+  {
+    double newPt[3];
+    for ( ; binId < endBinId; ++binId )
+    {
+      vtkQuadricClustering::PointQuadric &binQuadric =
+        this->Self->QuadricArray[binId];
+      if (binQuadric.VertexId != -1)
+      {
+        this->Self->ComputeRepresentativePoint(binQuadric.Quadric, binId,
+                                               newPt);
+        this->OutputPoints->SetPoint(binQuadric.VertexId, newPt);
+      }
+    }
+  }
+};
+
 
 //----------------------------------------------------------------------------
 // Construct with default NumberOfDivisions to 50, DivisionSpacing to 1
@@ -70,6 +318,7 @@ vtkQuadricClustering::vtkQuadricClustering()
   this->UseFeaturePoints = 0;
   this->FeaturePointsAngle = 30.0;
   this->UseInternalTriangles = 1;
+  this->Threaded = 0;
 
   this->UseInputPoints = 0;
 
@@ -340,6 +589,12 @@ void vtkQuadricClustering::Append(vtkPolyData *pd)
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
+  if (this->Threaded)
+  {
+    this->AppendThreaded(pd, output);
+    return;
+  }
+
   inputVerts = pd->GetVerts();
   if (inputVerts)
   {
@@ -481,17 +736,8 @@ void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *p
   }
 
   // Compute the quadric.
-  double quadric[9], quadric4x4[4][4];
-  vtkTriangle::ComputeQuadric(pt0, pt1, pt2, quadric4x4);
-  quadric[0] = quadric4x4[0][0];
-  quadric[1] = quadric4x4[0][1];
-  quadric[2] = quadric4x4[0][2];
-  quadric[3] = quadric4x4[0][3];
-  quadric[4] = quadric4x4[1][1];
-  quadric[5] = quadric4x4[1][2];
-  quadric[6] = quadric4x4[1][3];
-  quadric[7] = quadric4x4[2][2];
-  quadric[8] = quadric4x4[2][3];
+  double quadric[9];
+  vtkQuadricClusteringTriangleQuadric(pt0, pt1, pt2, quadric);
 
   // Add the quadric to each of the three corner bins.
   for (int i = 0; i < 3; ++i)
@@ -645,62 +891,14 @@ void vtkQuadricClustering::AddEdge(vtkIdType *binIds, double *pt0, double *pt1,
                                    vtkPolyData *input, vtkPolyData *output)
 {
   vtkIdType edgePtIds[2];
-  double length2, tmp;
-  double d[3];
-  double m[3];  // The mid point of the segement.(p1 or p2 could be used also).
-  double md;    // The dot product of m and d.
   double q[9];
 
   // Compute quadric for line segment.
-  // Line segment quadric is the area (squared) of the triangle (seg,pt)
-  // Compute the direction vector of the segment.
-  d[0] = pt1[0] - pt0[0];
-  d[1] = pt1[1] - pt0[1];
-  d[2] = pt1[2] - pt0[2];
-
-  // Compute the length^2 of the line segement.
-  length2 = d[0]*d[0] + d[1]*d[1] + d[2]*d[2];
-
-  if (length2 == 0.0)
-  { // Coincident points.  Avoid divide by zero.
+  if (vtkQuadricClusteringEdgeQuadric(pt0, pt1, q) == 0.0)
+  { // Coincident points.
     return;
   }
 
-  // Normalize the direction vector.
-  tmp = 1.0 / sqrt(length2);
-  d[0] = d[0] * tmp;
-  d[1] = d[1] * tmp;
-  d[2] = d[2] * tmp;
-
-  // Compute the mid point of the segment.
-  m[0] = 0.5 * (pt1[0] + pt0[0]);
-  m[1] = 0.5 * (pt1[1] + pt0[1]);
-  m[2] = 0.5 * (pt1[2] + pt0[2]);
-
-  // Compute dot(m, d);
-  md = m[0]*d[0] + m[1]*d[1] + m[2]*d[2];
-
-  // We save nine coefficients of the error function cooresponding to:
-  // 0: Px^2
-  // 1: PxPy
-  // 2: PxPz
-  // 3: Px
-  // 4: Py^2
-  // 5: PyPz
-  // 6: Py
-  // 7: Pz^2
-  // 8: Pz
-  // We ignore the constant because it disappears with the derivative.
-  q[0] = length2*(1.0 - d[0]*d[0]);
-  q[1] = -length2*(d[0]*d[1]);
-  q[2] = -length2*(d[0]*d[2]);
-  q[3] = length2*(d[0]*md - m[0]);
-  q[4] = length2*(1.0 - d[1]*d[1]);
-  q[5] = -length2*(d[1]*d[2]);
-  q[6] = length2*(d[1]*md - m[1]);
-  q[7] = length2*(1.0 - d[2]*d[2]);
-  q[8] = length2*(d[2]*md - m[2]);
-
   for (int i = 0; i < 2; ++i)
   {
     // If the current quadric is from triangles (or not initialized), then clear it out.
@@ -797,27 +995,7 @@ void vtkQuadricClustering::AddVertex(vtkIdType binId, double *pt,
   double q[9];
 
   // Compute quadric for the vertex.
-
-  // We save nine coefficients of the error function cooresponding to:
-  // 0: Px^2
-  // 1: PxPy
-  // 2: PxPz
-  // 3: Px
-  // 4: Py^2
-  // 5: PyPz
-  // 6: Py
-  // 7: Pz^2
-  // 8: Pz
-  // We ignore the constant because it disappears with the derivative.
-  q[0] = 1.0;
-  q[1] = 0.0;
-  q[2] = 0.0;
-  q[3] = -pt[0];
-  q[4] = 1.0;
-  q[5] = 0.0;
-  q[6] = -pt[1];
-  q[7] = 1.0;
-  q[8] = -pt[2];
+  vtkQuadricClusteringVertexQuadric(pt, q);
 
   // If the current quadric is from triangles, edges (or not initialized),
   // then clear it out.
@@ -862,6 +1040,175 @@ void vtkQuadricClustering::AddQuadric(vtkIdType binId, double quadric[9])
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkQuadricClustering::AppendThreaded(vtkPolyData *pd,
+                                          vtkPolyData *output)
+{
+  vtkPoints *inputPoints = pd->GetPoints();
+  vtkIdType numPts = pd->GetNumberOfPoints();
+  if (!inputPoints)
+  {
+    return;
+  }
+
+  std::vector<vtkIdType> binIds(numPts);
+  vtkQuadricClusteringHashPoints hashPoints =
+    { this, inputPoints, binIds.data() };
+  vtkSMPTools::For(0, numPts, hashPoints);
+  this->UpdateProgress(.40);
+
+  // Split the cells into the primitives Append() adds, skipping those it
+  // ignores
+  std::vector<vtkQuadricClusteringPrimitive> prims;
+  vtkCellArray *cellArrays[4] =
+    { pd->GetVerts(), pd->GetLines(), pd->GetPolys(), pd->GetStrips() };
+  vtkIdType cellId = this->InCellCount;
+  for (int type = 0; type < 4; ++type)
+  {
+    vtkCellArray *cells = cellArrays[type];
+    if (!cells)
+    {
+      continue;
+    }
+    vtkIdType numCellPts = 0;
+    vtkIdType *ptIds = 0;
+    for (cells->InitTraversal(); cells->GetNextCell(numCellPts, ptIds);
+         ++cellId)
+    {
+      vtkQuadricClusteringPrimitive prim;
+      prim.CellId = cellId;
+      prim.NumberOfPoints = (type < 2 ? type + 1 : 3);
+      if (type == 0)
+      {
+        for (vtkIdType j = 0; j < numCellPts; ++j)
+        {
+          prim.PointIds[0] = ptIds[j];
+          prims.push_back(prim);
+        }
+        continue;
+      }
+      if (type == 1)
+      {
+        for (vtkIdType j = 1; j < numCellPts; ++j)
+        {
+          double pt0[3], pt1[3], q[9];
+          inputPoints->GetPoint(ptIds[j-1], pt0);
+          inputPoints->GetPoint(ptIds[j], pt1);
+          if (vtkQuadricClusteringEdgeQuadric(pt0, pt1, q) != 0.0)
+          {
+            prim.PointIds[0] = ptIds[j-1];
+            prim.PointIds[1] = ptIds[j];
+            prims.push_back(prim);
+          }
+        }
+        continue;
+      }
+
+      // Polygons are triangulated with a fan, strips flip every other
+      // triangle
+      if (numCellPts < 3)
+      {
+        continue;
+      }
+      int odd = 0;
+      prim.PointIds[0] = ptIds[0];
+      prim.PointIds[1] = ptIds[1];
+      for (vtkIdType j = 2; j < numCellPts; ++j)
+      {
+        if (type == 2)
+        {
+          prim.PointIds[1] = ptIds[j-1];
+        }
+        prim.PointIds[2] = ptIds[j];
+        vtkIdType bin0 = binIds[prim.PointIds[0]];
+        vtkIdType bin1 = binIds[prim.PointIds[1]];
+        vtkIdType bin2 = binIds[prim.PointIds[2]];
+        if (this->UseInternalTriangles ||
+            (bin0 != bin1 && bin0 != bin2 && bin1 != bin2))
+        {
+          prims.push_back(prim);
+        }
+        if (type == 3)
+        {
+          prim.PointIds[odd] = ptIds[j];
+          odd = odd ? 0 : 1;
+        }
+      }
+    }
+  }
+
+  // Add the output cells in order, as Append() does
+  vtkIdType numPrims = static_cast<vtkIdType>(prims.size());
+  std::vector<std::pair<vtkIdType,vtkIdType> > uses;
+  for (vtkIdType primId = 0; primId < numPrims; ++primId)
+  {
+    const vtkQuadricClusteringPrimitive &prim = prims[primId];
+    vtkIdType bins[3], outPtIds[3];
+    bool newVertex = false;
+    for (int i = 0; i < prim.NumberOfPoints; ++i)
+    {
+      bins[i] = binIds[prim.PointIds[i]];
+      uses.push_back(std::make_pair(bins[i], 3*primId + i));
+      if (this->QuadricArray[bins[i]].VertexId == -1)
+      {
+        this->QuadricArray[bins[i]].VertexId = this->NumberOfBinsUsed;
+        this->NumberOfBinsUsed++;
+        newVertex = true;
+      }
+      outPtIds[i] = this->QuadricArray[bins[i]].VertexId;
+    }
+
+    bool newCell = false;
+    if (prim.NumberOfPoints == 1)
+    {
+      newCell = newVertex;
+    }
+    else if (prim.NumberOfPoints == 2)
+    {
+      if (bins[0] != bins[1])
+      {
+        this->OutputLines->InsertNextCell(2, outPtIds);
+        newCell = true;
+      }
+    }
+    else if (bins[0] != bins[1] && bins[0] != bins[2] && bins[1] != bins[2])
+    {
+      newCell = true;
+      if ( this->PreventDuplicateCells )
+      {
+        std::sort(bins, bins + 3);
+        vtkIdType idx = bins[0] + this->NumberOfBins*bins[1] +
+                        this->NumberOfBins*this->NumberOfBins*bins[2];
+        newCell = this->CellSet->insert(idx).second;
+      }
+      if (newCell)
+      {
+        this->OutputTriangleArray->InsertNextCell(3, outPtIds);
+      }
+    }
+    if (newCell && this->CopyCellData)
+    {
+      output->GetCellData()->
+        CopyData(pd->GetCellData(), prim.CellId, this->OutCellCount++);
+    }
+  }
+  this->InCellCount = static_cast<int>(cellId);
+  this->UpdateProgress(.60);
+
+  // Add the quadrics of the primitives to their bins
+  std::vector<double> quadrics(9 * numPrims);
+  vtkQuadricClusteringComputeQuadrics computeQuadrics =
+    { inputPoints, prims.data(), quadrics.data() };
+  vtkSMPTools::For(0, numPrims, computeQuadrics);
+  vtkSMPTools::Sort(uses.begin(), uses.end());
+  vtkQuadricClusteringAccumulateQuadrics accumulateQuadrics =
+    { this, uses.data(), static_cast<vtkIdType>(uses.size()), prims.data(),
+      quadrics.data() };
+  vtkSMPTools::For(0, static_cast<vtkIdType>(uses.size()),
+                   accumulateQuadrics);
+  this->UpdateProgress(.80);
+}
+
 //----------------------------------------------------------------------------
 vtkIdType vtkQuadricClustering::HashPoint(double point[3])
 {
@@ -948,6 +1295,14 @@ void vtkQuadricClustering::EndAppend()
 
   // Compute the representative points for each bin
   outputPoints = vtkPoints::New();
+  if (this->Threaded)
+  {
+    outputPoints->SetNumberOfPoints(this->NumberOfBinsUsed);
+    vtkQuadricClusteringRepresentativePoints representativePoints =
+      { this, outputPoints };
+    vtkSMPTools::For(0, numBuckets, representativePoints);
+    numBuckets = 0;
+  }
   for (vtkIdType i = 0; !abortExecute && i < numBuckets; i++ )
   {
     if (cstep > step)
@@ -1580,5 +1935,6 @@ void vtkQuadricClustering::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Prevent Duplicate Cells : "
      << (this->PreventDuplicateCells ? "On\n" : "Off\n");
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
 
@@ -96,6 +96,9 @@ class vtkQuadricClusteringCellSet;
 
 class VTKFILTERSCORE_EXPORT vtkQuadricClustering : public vtkPolyDataAlgorithm
 {
+friend struct vtkQuadricClusteringHashPoints;
+friend struct vtkQuadricClusteringAccumulateQuadrics;
+friend struct vtkQuadricClusteringRepresentativePoints;
 public:
   //@{
   /**
@@ -255,6 +258,20 @@ public:
   vtkBooleanMacro(PreventDuplicateCells,int);
   //@}
 
+  //@{
+  /**
+   * Specify whether to compute the bins of the points, the quadrics of the
+   * bins and the representative points using vtkSMPTools. The cells and
+   * the ids of the output points are the same as in the serial execution:
+   * the quadrics of each bin are summed in the order of the input cells.
+   * The points are still computed serially when UseInputPoints is on, as
+   * are the feature edge quadrics. Default is off.
+   */
+  vtkSetMacro(Threaded, int);
+  vtkGetMacro(Threaded, int);
+  vtkBooleanMacro(Threaded, int);
+  //@}
+
 protected:
   vtkQuadricClustering();
   ~vtkQuadricClustering() VTK_OVERRIDE;
@@ -319,6 +336,13 @@ protected:
    */
   void AddQuadric(vtkIdType binId, double quadric[9]);
 
+  /**
+   * Threaded version of Append(). The cells are traversed serially to
+   * build the output cells, their quadrics being computed and added to the
+   * bins in parallel.
+   */
+  void AppendThreaded(vtkPolyData *pd, vtkPolyData *output);
+
   /**
    * Find the feature points of a given set of edges.
    * The points returned are (1) those used by only one edge, (2) those
@@ -347,6 +371,7 @@ protected:
   int UseFeatureEdges;
   int UseFeaturePoints;
   int UseInternalTriangles;
+  int Threaded;
 
   int NumberOfXDivisions;
   int NumberOfYDivisions;
@@ -40,6 +40,7 @@
 // toggling on and off sets it to 1 and 0
 
 #include "vtkQuadricDecimation.h"
+#include "vtkAtomic.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkEdgeTable.h"
@@ -53,10 +54,153 @@
 #include "vtkPolyData.h"
 #include "vtkPointData.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 vtkStandardNewMacro(vtkQuadricDecimation);
 
+namespace
+{
+
+// The cost of collapsing an edge whose end points pt1 and pt2 have the sum
+// quad of their quadrics, and the point x that gives this cost (geometric
+// error only)
+double vtkQuadricDecimationGeometricCost(const double *quad,
+                                         const double pt1[3],
+                                         const double pt2[3], double *x)
+{
+  static const double errorNumber = 1e-10;
+  double temp[3], A[3][3], b[3];
+  double cost = 0.0;
+  const double *index;
+  int i, j;
+  double newPoint [4];
+  double v[3],  c, norm, normTemp,  temp2[3];
+
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
+
+  b[0] = -quad[3];
+  b[1] = -quad[6];
+  b[2] = -quad[8];
+
+  norm = vtkMath::Norm(A[0]);
+  normTemp = vtkMath::Norm(A[1]);
+  norm = norm > normTemp ? norm : normTemp;
+  normTemp = vtkMath::Norm(A[2]);
+  norm = norm > normTemp ? norm : normTemp;
+
+  if (fabs(vtkMath::Determinant3x3(A))/(norm*norm*norm) >  errorNumber)
+  {
+    // it would be better to use the normal of the matrix to test singularity??
+    vtkMath::LinearSolve3x3(A, b, x);
+    vtkMath::Multiply3x3(A,x,temp);
+    // error too high, backup plans
+  }
+  else
+  {
+    // cheapest point along the edge
+    v[0] = pt2[0] - pt1[0];
+    v[1] = pt2[1] - pt1[1];
+    v[2] = pt2[2] - pt1[2];
+
+    // equation for the edge pt1 + c * v
+    // attempt least squares fit for c for A*(pt1 + c * v) = b
+    vtkMath::Multiply3x3(A,v,temp2);
+    if (vtkMath::Dot(temp2, temp2) > errorNumber)
+    {
+      vtkMath::Multiply3x3(A,pt1,temp);
+      for (i = 0; i < 3; i++)
+        temp[i] = b[i] - temp[i];
+      c = vtkMath::Dot(temp2, temp) / vtkMath::Dot(temp2, temp2);
+      for (i = 0; i < 3; i++)
+        x[i] = pt1[i]+c*v[i];
+    }
+    else
+    {
+      // use mid point
+      // might want to change to best of mid and end points??
+      for (i = 0; i < 3; i++)
+      {
+        x[i] = 0.5*(pt1[i]+pt2[i]);
+      }
+    }
+  }
+
+  newPoint[0] = x[0];
+  newPoint[1] = x[1];
+  newPoint[2] = x[2];
+  newPoint[3] = 1;
+
+  // Compute the cost
+  // x'*quad*x
+  index = quad;
+  for (i = 0; i < 4; i++)
+  {
+    cost += (*index++)*newPoint[i]*newPoint[i];
+    for (j = i +1; j < 4; j++)
+    {
+      cost += 2.0*(*index++)*newPoint[i]*newPoint[j];
+    }
+  }
+
+  return cost;
+}
+
+// triangle t0, t1, t2 and point x
+// determins if t0 and x are on the same side of the plane defined by
+// t1 and t2, and parallel to the normal of the triangle
+int vtkQuadricDecimationPlaneCheck(const double t0[3], const double t1[3],
+                                   const double t2[3], const double *x)
+{
+  double e0[3], e1[3], n[3], e2[3];
+  double c;
+  int i;
+
+  for (i = 0; i < 3; i++)
+  {
+    e0[i] = t2[i] - t1[i];
+  }
+  for (i = 0; i < 3; i++)
+  {
+    e1[i] = t0[i] - t1[i];
+  }
+
+  // projection of e0 onto e1
+  c = vtkMath::Dot(e0,e1)/(e0[0]*e0[0]+e0[1]*e0[1]+e0[2]*e0[2]);
+  for (i = 0; i < 3; i++)
+  {
+    n[i] = e1[i] - c*e0[i];
+  }
+
+  for ( i = 0; i < 3; i++)
+  {
+    e2[i] = x[i] - t1[i];
+  }
+
+  vtkMath::Normalize(n);
+  vtkMath::Normalize(e2);
+  if (vtkMath::Dot(n, e2) > 1e-5)
+  {
+    return 1;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+}
+
 
 //----------------------------------------------------------------------------
 vtkQuadricDecimation::vtkQuadricDecimation()
@@ -88,6 +232,7 @@ vtkQuadricDecimation::vtkQuadricDecimation()
   this->TensorsWeight = 0.1;
 
   this->ActualReduction = 0.0;
+  this->Threaded = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -216,6 +361,12 @@ int vtkQuadricDecimation::RequestData(
     return 1;
   }
 
+  if (this->Threaded && !this->AttributeErrorMetric &&
+      this->DecimateThreaded(input, output))
+  {
+    return 1;
+  }
+
   polys = vtkCellArray::New();
   points = vtkPoints::New();
   pointData = vtkPointData::New();
@@ -825,15 +976,9 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
 //----------------------------------------------------------------------------
 double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
 {
-  static const double errorNumber = 1e-10;
-  double temp[3], A[3][3], b[3];
   vtkIdType pointIds[2];
-  double cost = 0.0;
-  double *index;
-  int i, j;
-  double newPoint [4];
-  double v[3],  c, norm, normTemp,  temp2[3];
   double pt1[3], pt2[3];
+  int i;
 
   pointIds[0] = this->EndPoint1List->GetId(edgeId);
   pointIds[1] = this->EndPoint2List->GetId(edgeId);
@@ -844,80 +989,9 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
       this->ErrorQuadrics[pointIds[1]].Quadric[i];
   }
 
-  A[0][0] = this->TempQuad[0];
-  A[0][1] = A[1][0] = this->TempQuad[1];
-  A[0][2] = A[2][0] = this->TempQuad[2];
-  A[1][1] = this->TempQuad[4];
-  A[1][2] = A[2][1] = this->TempQuad[5];
-  A[2][2] = this->TempQuad[7];
-
-  b[0] = -this->TempQuad[3];
-  b[1] = -this->TempQuad[6];
-  b[2] = -this->TempQuad[8];
-
-  norm = vtkMath::Norm(A[0]);
-  normTemp = vtkMath::Norm(A[1]);
-  norm = norm > normTemp ? norm : normTemp;
-  normTemp = vtkMath::Norm(A[2]);
-  norm = norm > normTemp ? norm : normTemp;
-
-  if (fabs(vtkMath::Determinant3x3(A))/(norm*norm*norm) >  errorNumber)
-  {
-    // it would be better to use the normal of the matrix to test singularity??
-    vtkMath::LinearSolve3x3(A, b, x);
-    vtkMath::Multiply3x3(A,x,temp);
-    // error too high, backup plans
-  }
-  else
-  {
-    // cheapest point along the edge
-    this->Mesh->GetPoints()->GetPoint(pointIds[0], pt1);
-    this->Mesh->GetPoints()->GetPoint(pointIds[1], pt2);
-    v[0] = pt2[0] - pt1[0];
-    v[1] = pt2[1] - pt1[1];
-    v[2] = pt2[2] - pt1[2];
-
-    // equation for the edge pt1 + c * v
-    // attempt least squares fit for c for A*(pt1 + c * v) = b
-    vtkMath::Multiply3x3(A,v,temp2);
-    if (vtkMath::Dot(temp2, temp2) > errorNumber)
-    {
-      vtkMath::Multiply3x3(A,pt1,temp);
-      for (i = 0; i < 3; i++)
-        temp[i] = b[i] - temp[i];
-      c = vtkMath::Dot(temp2, temp) / vtkMath::Dot(temp2, temp2);
-      for (i = 0; i < 3; i++)
-        x[i] = pt1[i]+c*v[i];
-    }
-    else
-    {
-      // use mid point
-      // might want to change to best of mid and end points??
-      for (i = 0; i < 3; i++)
-      {
-        x[i] = 0.5*(pt1[i]+pt2[i]);
-      }
-    }
-  }
-
-  newPoint[0] = x[0];
-  newPoint[1] = x[1];
-  newPoint[2] = x[2];
-  newPoint[3] = 1;
-
-  // Compute the cost
-  // x'*quad*x
-  index = this->TempQuad;
-  for (i = 0; i < 4; i++)
-  {
-    cost += (*index++)*newPoint[i]*newPoint[i];
-    for (j = i +1; j < 4; j++)
-    {
-      cost += 2.0*(*index++)*newPoint[i]*newPoint[j];
-    }
-  }
-
-  return cost;
+  this->Mesh->GetPoints()->GetPoint(pointIds[0], pt1);
+  this->Mesh->GetPoints()->GetPoint(pointIds[1], pt2);
+  return vtkQuadricDecimationGeometricCost(this->TempQuad, pt1, pt2, x);
 }
 
 
@@ -1219,42 +1293,9 @@ int vtkQuadricDecimation::CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id)
 int vtkQuadricDecimation::TrianglePlaneCheck(const double t0[3],
                                              const double t1[3],
                                              const double t2[3],
-                                             const double *x) {
-  double e0[3], e1[3], n[3], e2[3];
-  double c;
-  int i;
-
-  for (i = 0; i < 3; i++)
-  {
-    e0[i] = t2[i] - t1[i];
-  }
-  for (i = 0; i < 3; i++)
-  {
-    e1[i] = t0[i] - t1[i];
-  }
-
-  // projection of e0 onto e1
-  c = vtkMath::Dot(e0,e1)/(e0[0]*e0[0]+e0[1]*e0[1]+e0[2]*e0[2]);
-  for (i = 0; i < 3; i++)
-  {
-    n[i] = e1[i] - c*e0[i];
-  }
-
-  for ( i = 0; i < 3; i++)
-  {
-    e2[i] = x[i] - t1[i];
-  }
-
-  vtkMath::Normalize(n);
-  vtkMath::Normalize(e2);
-  if (vtkMath::Dot(n, e2) > 1e-5)
-  {
-    return 1;
-  }
-  else
-  {
-    return 0;
-  }
+                                             const double *x)
+{
+  return vtkQuadricDecimationPlaneCheck(t0, t1, t2, x);
 }
 
 int vtkQuadricDecimation::IsGoodPlacement(vtkIdType pt0Id, vtkIdType pt1Id,
@@ -1313,6 +1354,896 @@ const double *x)
 }
 
 
+//----------------------------------------------------------------------------
+// Threaded decimation. The triangles are held in a plain array, the
+// triangles using each point being rebuilt before each pass. A pass finds
+// the cheapest valid collapse of every point, then collapses the edges that
+// are cheaper than all the collapses of the points of their triangles: two
+// such edges never share a triangle, so they are collapsed in parallel.
+namespace
+{
+
+// Return whether the point tri[i] does not appear before i in the triangle
+inline bool vtkQuadricDecimationIsFirstUse(const vtkIdType *tri, int i)
+{
+  return (i < 1 || tri[i] != tri[0]) && (i < 2 || tri[i] != tri[1]);
+}
+
+// Return whether the triangle uses the point
+inline bool vtkQuadricDecimationUses(const vtkIdType *tri, vtkIdType ptId)
+{
+  return tri[0] == ptId || tri[1] == ptId || tri[2] == ptId;
+}
+
+// Return whether the collapse (cost1, ptId1, otherId1) is cheaper than
+// (cost2, ptId2, otherId2), the point ids breaking ties
+inline bool vtkQuadricDecimationIsCheaper(double cost1, vtkIdType ptId1,
+                                          vtkIdType otherId1, double cost2,
+                                          vtkIdType ptId2, vtkIdType otherId2)
+{
+  if (cost1 != cost2)
+  {
+    return cost1 < cost2;
+  }
+  if (ptId1 != ptId2)
+  {
+    return ptId1 < ptId2;
+  }
+  return otherId1 < otherId2;
+}
+
+// The working mesh. Deleted triangles have their point ids set to -1.
+struct vtkQuadricDecimationMesh
+{
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfTriangles;
+  bool FloatPoints;
+  std::vector<double> Points;
+  std::vector<double> Quadrics; // 11 coefficients per point
+  std::vector<vtkIdType> Triangles;
+
+  // The triangles using each point, in ascending order
+  std::vector<vtkIdType> Offsets;
+  std::vector<vtkIdType> Links;
+
+  void BuildLinks();
+
+  vtkIdType GetLinks(vtkIdType ptId, const vtkIdType* &links) const
+  {
+    links = this->Links.data() + this->Offsets[ptId];
+    return this->Offsets[ptId+1] - this->Offsets[ptId];
+  }
+
+  const double *GetPoint(vtkIdType ptId) const
+  {
+    return &this->Points[3*ptId];
+  }
+
+  // Return whether another triangle than triId uses the edge (p1, p2)
+  bool IsBoundaryEdge(vtkIdType triId, vtkIdType p1, vtkIdType p2) const;
+
+  // As vtkQuadricDecimation::ComputeCost(), for the edge (p1, p2)
+  double ComputeCost(vtkIdType p1, vtkIdType p2, double x[3]) const;
+
+  // As vtkQuadricDecimation::IsGoodPlacement()
+  bool IsGoodPlacement(vtkIdType p1, vtkIdType p2, const double x[3]) const;
+
+  // Collapse the edge (ptId, otherId) into ptId, as
+  // vtkQuadricDecimation::CollapseEdge() does: the triangles using the edge
+  // are deleted, as are the triangles of otherId that would duplicate a
+  // triangle of ptId. Returns the number of deleted triangles. The
+  // triangles are only modified if apply is true.
+  vtkIdType Collapse(vtkIdType ptId, vtkIdType otherId, bool apply,
+                     std::vector<std::pair<vtkIdType,vtkIdType> > &edges);
+};
+
+// Count the uses of the points by the remaining triangles
+struct vtkQuadricDecimationCountUses
+{
+  const vtkIdType *Triangles;
+  vtkAtomic<vtkIdType> *Counts;
+
+  void operator()(vtkIdType triId, vtkIdType endTriId)
+  {
+    for ( ; triId < endTriId; ++triId )
+    {
+      const vtkIdType *tri = this->Triangles + 3*triId;
+      for (int i = 0; tri[0] >= 0 && i < 3; ++i)
+      {
+        if (vtkQuadricDecimationIsFirstUse(tri, i))
+        {
+          ++this->Counts[tri[i]];
+        }
+      }
+    }
+  }
+};
+
+// Set the insertion positions of the triangles of each point
+struct vtkQuadricDecimationStartPositions
+{
+  const vtkIdType *Offsets;
+  vtkAtomic<vtkIdType> *Positions;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      this->Positions[ptId] = this->Offsets[ptId];
+    }
+  }
+};
+
+// Insert the triangles in the runs of their points
+struct vtkQuadricDecimationInsertTriangles
+{
+  const vtkIdType *Triangles;
+  vtkAtomic<vtkIdType> *Positions;
+  vtkIdType *Links;
+
+  void operator()(vtkIdType triId, vtkIdType endTriId)
+  {
+    for ( ; triId < endTriId; ++triId )
+    {
+      const vtkIdType *tri = this->Triangles + 3*triId;
+      for (int i = 0; tri[0] >= 0 && i < 3; ++i)
+      {
+        if (vtkQuadricDecimationIsFirstUse(tri, i))
+        {
+          this->Links[this->Positions[tri[i]]++] = triId;
+        }
+      }
+    }
+  }
+};
+
+// Sort the runs, whose order depends on the scheduling of the threads
+struct vtkQuadricDecimationSortRuns
+{
+  const vtkIdType *Offsets;
+  vtkIdType *Links;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      std::sort(this->Links + this->Offsets[ptId],
+                this->Links + this->Offsets[ptId+1]);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+void vtkQuadricDecimationMesh::BuildLinks()
+{
+  vtkIdType numPts = this->NumberOfPoints;
+  vtkAtomic<vtkIdType> *counts = new vtkAtomic<vtkIdType>[numPts];
+  vtkQuadricDecimationCountUses countUses =
+    { &this->Triangles[0], counts };
+  vtkSMPTools::For(0, this->NumberOfTriangles, countUses);
+
+  this->Offsets.resize(numPts + 1);
+  vtkSMPTools::ExclusiveScan(counts, counts + numPts, this->Offsets.begin(),
+                             static_cast<vtkIdType>(0));
+  this->Offsets[numPts] = this->Offsets[numPts-1] + counts[numPts-1];
+  this->Links.resize(this->Offsets[numPts]);
+
+  vtkQuadricDecimationStartPositions startPositions =
+    { &this->Offsets[0], counts };
+  vtkSMPTools::For(0, numPts, startPositions);
+  vtkQuadricDecimationInsertTriangles insertTriangles =
+    { &this->Triangles[0], counts, this->Links.data() };
+  vtkSMPTools::For(0, this->NumberOfTriangles, insertTriangles);
+  delete [] counts;
+
+  // A single thread inserts the triangles in order
+  if ( vtkSMPTools::GetEstimatedNumberOfThreads() > 1 )
+  {
+    vtkQuadricDecimationSortRuns sortRuns =
+      { &this->Offsets[0], this->Links.data() };
+    vtkSMPTools::For(0, numPts, sortRuns);
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkQuadricDecimationMesh::IsBoundaryEdge(vtkIdType triId, vtkIdType p1,
+                                              vtkIdType p2) const
+{
+  const vtkIdType *links;
+  vtkIdType numLinks = this->GetLinks(p1, links);
+  for (vtkIdType i = 0; i < numLinks; ++i)
+  {
+    if (links[i] != triId &&
+        vtkQuadricDecimationUses(&this->Triangles[3*links[i]], p2))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+double vtkQuadricDecimationMesh::ComputeCost(vtkIdType p1, vtkIdType p2,
+                                             double x[3]) const
+{
+  double quad[11];
+  const double *q1 = &this->Quadrics[11*p1];
+  const double *q2 = &this->Quadrics[11*p2];
+  for (int i = 0; i < 11; ++i)
+  {
+    quad[i] = q1[i] + q2[i];
+  }
+  return vtkQuadricDecimationGeometricCost(quad, this->GetPoint(p1),
+                                           this->GetPoint(p2), x);
+}
+
+//----------------------------------------------------------------------------
+bool vtkQuadricDecimationMesh::IsGoodPlacement(vtkIdType p1, vtkIdType p2,
+                                               const double x[3]) const
+{
+  vtkIdType ends[2] = { p1, p2 };
+  for (int e = 0; e < 2; ++e)
+  {
+    const vtkIdType *links;
+    vtkIdType numLinks = this->GetLinks(ends[e], links);
+    for (vtkIdType i = 0; i < numLinks; ++i)
+    {
+      const vtkIdType *tri = &this->Triangles[3*links[i]];
+      if (vtkQuadricDecimationUses(tri, ends[1-e]))
+      {
+        continue;
+      }
+      for (int j = 0; j < 3; ++j)
+      {
+        if (tri[j] == ends[e] &&
+            !vtkQuadricDecimationPlaneCheck(this->GetPoint(tri[j]),
+                                            this->GetPoint(tri[(j+1)%3]),
+                                            this->GetPoint(tri[(j+2)%3]), x))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkQuadricDecimationMesh::Collapse(vtkIdType ptId,
+  vtkIdType otherId, bool apply,
+  std::vector<std::pair<vtkIdType,vtkIdType> > &edges)
+{
+  vtkIdType numDeleted = 0;
+  const vtkIdType *links;
+  vtkIdType numLinks;
+
+  // The triangles using the edge are deleted, the other triangles of ptId
+  // give the edges opposite to it
+  edges.clear();
+  numLinks = this->GetLinks(ptId, links);
+  for (vtkIdType i = 0; i < numLinks; ++i)
+  {
+    vtkIdType *tri = &this->Triangles[3*links[i]];
+    if (vtkQuadricDecimationUses(tri, otherId))
+    {
+      ++numDeleted;
+      if (apply)
+      {
+        tri[0] = tri[1] = tri[2] = -1;
+      }
+    }
+    else
+    {
+      int j = (tri[0] == ptId ? 0 : (tri[1] == ptId ? 1 : 2));
+      edges.push_back(std::make_pair(std::min(tri[(j+1)%3], tri[(j+2)%3]),
+                                     std::max(tri[(j+1)%3], tri[(j+2)%3])));
+    }
+  }
+
+  // The triangles of otherId move to ptId, unless ptId already has the
+  // same triangle
+  numLinks = this->GetLinks(otherId, links);
+  for (vtkIdType i = 0; i < numLinks; ++i)
+  {
+    vtkIdType *tri = &this->Triangles[3*links[i]];
+    if (tri[0] < 0 || vtkQuadricDecimationUses(tri, ptId))
+    {
+      continue;
+    }
+    int j = (tri[0] == otherId ? 0 : (tri[1] == otherId ? 1 : 2));
+    std::pair<vtkIdType,vtkIdType> edge(
+      std::min(tri[(j+1)%3], tri[(j+2)%3]),
+      std::max(tri[(j+1)%3], tri[(j+2)%3]));
+    if (std::find(edges.begin(), edges.end(), edge) != edges.end())
+    {
+      ++numDeleted;
+      if (apply)
+      {
+        tri[0] = tri[1] = tri[2] = -1;
+      }
+    }
+    else
+    {
+      edges.push_back(edge);
+      if (apply)
+      {
+        tri[j] = ptId;
+      }
+    }
+  }
+  return numDeleted;
+}
+
+// Copy the points and the triangles of the input
+struct vtkQuadricDecimationCopyPoints
+{
+  vtkPoints *Points;
+  vtkQuadricDecimationMesh *Mesh;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      this->Points->GetPoint(ptId, &this->Mesh->Points[3*ptId]);
+    }
+  }
+};
+
+struct vtkQuadricDecimationCopyTriangles
+{
+  const vtkIdType *Cells;
+  vtkIdType *Triangles;
+
+  void operator()(vtkIdType triId, vtkIdType endTriId)
+  {
+    for ( ; triId < endTriId; ++triId )
+    {
+      const vtkIdType *cell = this->Cells + 4*triId + 1;
+      vtkIdType *tri = this->Triangles + 3*triId;
+      tri[0] = cell[0];
+      tri[1] = cell[1];
+      tri[2] = cell[2];
+    }
+  }
+};
+
+// The quadric of each point: the quadrics of the planes of its triangles,
+// then of the planes orthogonal to its boundary edges, summed in the order
+// of vtkQuadricDecimation::InitializeQuadrics() and
+// AddBoundaryConstraints()
+struct vtkQuadricDecimationInitializeQuadrics
+{
+  vtkQuadricDecimationMesh *Mesh;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkQuadricDecimationMesh *mesh = this->Mesh;
+    double QEM[11];
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      double *quadric = &mesh->Quadrics[11*ptId];
+      std::fill_n(quadric, 11, 0.0);
+      const vtkIdType *links;
+      vtkIdType numLinks = mesh->GetLinks(ptId, links);
+      for (vtkIdType i = 0; i < numLinks; ++i)
+      {
+        const vtkIdType *tri = &mesh->Triangles[3*links[i]];
+        const double *point0 = mesh->GetPoint(tri[0]);
+        const double *point1 = mesh->GetPoint(tri[1]);
+        const double *point2 = mesh->GetPoint(tri[2]);
+        double tempP1[3], tempP2[3], n[3];
+        for (int j = 0; j < 3; j++)
+        {
+          tempP1[j] = point1[j] - point0[j];
+          tempP2[j] = point2[j] - point0[j];
+        }
+        vtkMath::Cross(tempP1, tempP2, n);
+        double triArea2 = vtkMath::Normalize(n);
+        triArea2 = triArea2 * 0.5;
+        double d = -vtkMath::Dot(n, point0);
+        QEM[0] = n[0] * n[0];
+        QEM[1] = n[0] * n[1];
+        QEM[2] = n[0] * n[2];
+        QEM[3] = d * n[0];
+        QEM[4] = n[1] * n[1];
+        QEM[5] = n[1] * n[2];
+        QEM[6] = d * n[1];
+        QEM[7] = n[2] * n[2];
+        QEM[8] = d * n[2];
+        QEM[9] = d * d;
+        QEM[10] = 1;
+        // The serial code adds the quadric once per use of the point
+        for (int k = 0; k < 3; ++k)
+        {
+          if (tri[k] == ptId)
+          {
+            for (int j = 0; j < 11; j++)
+            {
+              quadric[j] += QEM[j] * triArea2;
+            }
+          }
+        }
+      }
+
+      for (vtkIdType i = 0; i < numLinks; ++i)
+      {
+        const vtkIdType *tri = &mesh->Triangles[3*links[i]];
+        for (int k = 0; k < 3; ++k)
+        {
+          vtkIdType p1 = tri[k];
+          vtkIdType p2 = tri[(k+1)%3];
+          if ((p1 != ptId && p2 != ptId) ||
+              !mesh->IsBoundaryEdge(links[i], p1, p2))
+          {
+            continue;
+          }
+          const double *t0 = mesh->GetPoint(tri[(k+2)%3]);
+          const double *t1 = mesh->GetPoint(p1);
+          const double *t2 = mesh->GetPoint(p2);
+          double e0[3], e1[3], n[3];
+          for (int j = 0; j < 3; j++)
+          {
+            e0[j] = t2[j] - t1[j];
+            e1[j] = t0[j] - t1[j];
+          }
+          double c = vtkMath::Dot(e0,e1)/(e0[0]*e0[0]+e0[1]*e0[1]+e0[2]*e0[2]);
+          for (int j = 0; j < 3; j++)
+          {
+            n[j] = e1[j] - c*e0[j];
+          }
+          vtkMath::Normalize(n);
+          double d = -vtkMath::Dot(n, t1);
+          double w = vtkMath::Norm(e0);
+          QEM[0] = n[0] * n[0];
+          QEM[1] = n[0] * n[1];
+          QEM[2] = n[0] * n[2];
+          QEM[3] = d * n[0];
+          QEM[4] = n[1] * n[1];
+          QEM[5] = n[1] * n[2];
+          QEM[6] = d * n[1];
+          QEM[7] = n[2] * n[2];
+          QEM[8] = d * n[2];
+          QEM[9] = d * d;
+          QEM[10] = 1;
+          for (int j = 0; j < 11; j++)
+          {
+            quadric[j] += QEM[j]*w;
+          }
+          if (p1 == p2)
+          {
+            for (int j = 0; j < 11; j++)
+            {
+              quadric[j] += QEM[j]*w;
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+// The cheapest valid collapse of the edges of each point
+struct vtkQuadricDecimationEvaluatePoints
+{
+  vtkQuadricDecimationMesh *Mesh;
+  double *Costs;
+  vtkIdType *Others;
+  double *Targets;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Neighbors;
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    const vtkQuadricDecimationMesh *mesh = this->Mesh;
+    std::vector<vtkIdType> &neighbors = this->Neighbors.Local();
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      double &cost = this->Costs[ptId];
+      vtkIdType &otherId = this->Others[ptId];
+      double *target = this->Targets + 3*ptId;
+      cost = VTK_DOUBLE_MAX;
+      otherId = -1;
+
+      const vtkIdType *links;
+      vtkIdType numLinks = mesh->GetLinks(ptId, links);
+      neighbors.clear();
+      for (vtkIdType i = 0; i < numLinks; ++i)
+      {
+        const vtkIdType *tri = &mesh->Triangles[3*links[i]];
+        for (int j = 0; j < 3; ++j)
+        {
+          if (tri[j] != ptId)
+          {
+            neighbors.push_back(tri[j]);
+          }
+        }
+      }
+      std::sort(neighbors.begin(), neighbors.end());
+      neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                      neighbors.end());
+
+      // The cost of an edge is computed from its lowest point id, so that
+      // both end points agree on it
+      for (size_t i = 0; i < neighbors.size(); ++i)
+      {
+        vtkIdType p1 = std::min(ptId, neighbors[i]);
+        vtkIdType p2 = std::max(ptId, neighbors[i]);
+        double x[3];
+        double edgeCost = mesh->ComputeCost(p1, p2, x);
+        if (edgeCost < VTK_DOUBLE_MAX &&
+            (otherId < 0 ||
+             vtkQuadricDecimationIsCheaper(edgeCost, p1, p2, cost,
+               std::min(ptId, otherId), std::max(ptId, otherId))) &&
+            mesh->IsGoodPlacement(p1, p2, x))
+        {
+          cost = edgeCost;
+          otherId = neighbors[i];
+          target[0] = x[0];
+          target[1] = x[1];
+          target[2] = x[2];
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Select the edges whose collapse is the cheapest collapse of all the
+// points of their triangles. The collapse is recorded by its lowest point.
+struct vtkQuadricDecimationSelectEdges
+{
+  const vtkQuadricDecimationMesh *Mesh;
+  const double *Costs;
+  const vtkIdType *Others;
+  vtkIdType *Selected;
+
+  bool IsCheaper(vtkIdType ptId, double cost, vtkIdType p1, vtkIdType p2)
+  {
+    vtkIdType otherId = this->Others[ptId];
+    return otherId >= 0 &&
+      vtkQuadricDecimationIsCheaper(this->Costs[ptId],
+        std::min(ptId, otherId), std::max(ptId, otherId), cost, p1, p2);
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      vtkIdType otherId = this->Others[ptId];
+      this->Selected[ptId] = 0;
+      if (otherId < ptId || this->Others[otherId] != ptId)
+      {
+        continue;
+      }
+      double cost = this->Costs[ptId];
+      bool selected = true;
+      vtkIdType ends[2] = { ptId, otherId };
+      for (int e = 0; selected && e < 2; ++e)
+      {
+        const vtkIdType *links;
+        vtkIdType numLinks = this->Mesh->GetLinks(ends[e], links);
+        for (vtkIdType i = 0; selected && i < numLinks; ++i)
+        {
+          const vtkIdType *tri = &this->Mesh->Triangles[3*links[i]];
+          for (int j = 0; selected && j < 3; ++j)
+          {
+            selected = !this->IsCheaper(tri[j], cost, ptId, otherId);
+          }
+        }
+      }
+      this->Selected[ptId] = (selected ? 1 : 0);
+    }
+  }
+};
+
+// Gather the selected collapses
+struct vtkQuadricDecimationGatherEdges
+{
+  const vtkIdType *Selected;
+  const vtkIdType *Positions;
+  vtkIdType *Collapses;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      if (this->Selected[ptId])
+      {
+        this->Collapses[this->Positions[ptId]] = ptId;
+      }
+    }
+  }
+};
+
+// Order the collapses by increasing cost
+struct vtkQuadricDecimationCompareCollapses
+{
+  const double *Costs;
+
+  bool operator()(vtkIdType ptId1, vtkIdType ptId2) const
+  {
+    return this->Costs[ptId1] < this->Costs[ptId2] ||
+      (this->Costs[ptId1] == this->Costs[ptId2] && ptId1 < ptId2);
+  }
+};
+
+// Count the triangles deleted by each collapse, or apply the collapses
+struct vtkQuadricDecimationCollapseEdges
+{
+  vtkQuadricDecimationMesh *Mesh;
+  const vtkIdType *Collapses;
+  const vtkIdType *Others;
+  const double *Targets;
+  vtkIdType *NumberOfDeleted;
+  bool Apply;
+  vtkSMPThreadLocal<std::vector<std::pair<vtkIdType,vtkIdType> > > Edges;
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType i, vtkIdType endI)
+  {
+    vtkQuadricDecimationMesh *mesh = this->Mesh;
+    std::vector<std::pair<vtkIdType,vtkIdType> > &edges = this->Edges.Local();
+    for ( ; i < endI; ++i )
+    {
+      vtkIdType ptId = this->Collapses[i];
+      vtkIdType otherId = this->Others[ptId];
+      if (!this->Apply)
+      {
+        this->NumberOfDeleted[i] =
+          mesh->Collapse(ptId, otherId, false, edges);
+        continue;
+      }
+
+      // Move the point and merge the quadrics, as the points are stored
+      double *x = &mesh->Points[3*ptId];
+      const double *target = this->Targets + 3*ptId;
+      for (int j = 0; j < 3; ++j)
+      {
+        x[j] = (mesh->FloatPoints ?
+                static_cast<float>(target[j]) : target[j]);
+      }
+      double *quadric = &mesh->Quadrics[11*ptId];
+      const double *otherQuadric = &mesh->Quadrics[11*otherId];
+      for (int j = 0; j < 11; ++j)
+      {
+        quadric[j] += otherQuadric[j];
+      }
+      mesh->Collapse(ptId, otherId, true, edges);
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Flag the first use of each remaining point by the remaining triangles,
+// these being numbered in order
+struct vtkQuadricDecimationFlagPoints
+{
+  const vtkQuadricDecimationMesh *Mesh;
+  const vtkIdType *TriangleIds;
+  vtkIdType *FirstUses;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      const vtkIdType *links;
+      if (this->Mesh->GetLinks(ptId, links) > 0)
+      {
+        const vtkIdType *tri = &this->Mesh->Triangles[3*links[0]];
+        int j = (tri[0] == ptId ? 0 : (tri[1] == ptId ? 1 : 2));
+        this->FirstUses[3*this->TriangleIds[links[0]] + j] = 1;
+      }
+    }
+  }
+};
+
+// Copy the remaining points and triangles to the output
+struct vtkQuadricDecimationBuildOutput
+{
+  const vtkQuadricDecimationMesh *Mesh;
+  const vtkIdType *TriangleIds;
+  const vtkIdType *PointIds;
+  vtkPoints *NewPoints;
+  vtkIdType *NewPolys;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      const vtkIdType *links;
+      vtkIdType numLinks = this->Mesh->GetLinks(ptId, links);
+      if (numLinks > 0)
+      {
+        const vtkIdType *tri = &this->Mesh->Triangles[3*links[0]];
+        int j = (tri[0] == ptId ? 0 : (tri[1] == ptId ? 1 : 2));
+        vtkIdType newPtId = this->PointIds[3*this->TriangleIds[links[0]] + j];
+        this->NewPoints->SetPoint(newPtId, this->Mesh->GetPoint(ptId));
+
+        // The point sets its ids in its triangles
+        for (vtkIdType i = 0; i < numLinks; ++i)
+        {
+          tri = &this->Mesh->Triangles[3*links[i]];
+          vtkIdType *newTri = this->NewPolys + 4*this->TriangleIds[links[i]];
+          newTri[0] = 3;
+          for (int k = 0; k < 3; ++k)
+          {
+            if (tri[k] == ptId)
+            {
+              newTri[k+1] = newPtId;
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+}
+
+//----------------------------------------------------------------------------
+int vtkQuadricDecimation::DecimateThreaded(vtkPolyData *input,
+                                           vtkPolyData *output)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numTris = input->GetNumberOfPolys();
+  vtkCellArray *polys = input->GetPolys();
+  if (numPts < 1 || numTris < 1)
+  {
+    return 0;
+  }
+
+  // The working mesh only holds triangles
+  vtkIdType npts, *pts;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); )
+  {
+    if (npts != 3)
+    {
+      return 0;
+    }
+  }
+
+  vtkQuadricDecimationMesh mesh;
+  mesh.NumberOfPoints = numPts;
+  mesh.NumberOfTriangles = numTris;
+  mesh.FloatPoints = (input->GetPoints()->GetDataType() == VTK_FLOAT);
+  mesh.Points.resize(3 * numPts);
+  mesh.Quadrics.resize(11 * numPts);
+  mesh.Triangles.resize(3 * numTris);
+  vtkQuadricDecimationCopyPoints copyPoints = { input->GetPoints(), &mesh };
+  vtkSMPTools::For(0, numPts, copyPoints);
+  vtkQuadricDecimationCopyTriangles copyTriangles =
+    { polys->GetPointer(), &mesh.Triangles[0] };
+  vtkSMPTools::For(0, numTris, copyTriangles);
+
+  vtkDebugMacro(<<"Computing Quadrics");
+  mesh.BuildLinks();
+  vtkQuadricDecimationInitializeQuadrics initializeQuadrics = { &mesh };
+  vtkSMPTools::For(0, numPts, initializeQuadrics);
+  this->UpdateProgress(0.20);
+
+  // Collapse the edges by passes until the desired reduction is reached
+  std::vector<double> costs(numPts);
+  std::vector<vtkIdType> others(numPts);
+  std::vector<double> targets(3 * numPts);
+  std::vector<vtkIdType> selected(numPts);
+  std::vector<vtkIdType> positions(numPts);
+  std::vector<vtkIdType> collapses;
+  std::vector<vtkIdType> numDeleted;
+  vtkIdType numDeletedTris = 0;
+  this->ActualReduction = 0.0;
+  this->NumberOfEdgeCollapses = 0;
+  int abort = 0;
+  for (int pass = 0; !abort && this->ActualReduction < this->TargetReduction;
+       ++pass)
+  {
+    if (pass > 0)
+    {
+      mesh.BuildLinks();
+    }
+    vtkQuadricDecimationEvaluatePoints evaluatePoints;
+    evaluatePoints.Mesh = &mesh;
+    evaluatePoints.Costs = &costs[0];
+    evaluatePoints.Others = &others[0];
+    evaluatePoints.Targets = &targets[0];
+    vtkSMPTools::For(0, numPts, evaluatePoints);
+
+    vtkQuadricDecimationSelectEdges selectEdges =
+      { &mesh, &costs[0], &others[0], &selected[0] };
+    vtkSMPTools::For(0, numPts, selectEdges);
+    vtkSMPTools::ExclusiveScan(selected.begin(), selected.end(),
+                               positions.begin(), static_cast<vtkIdType>(0));
+    vtkIdType numCollapses = positions[numPts-1] + selected[numPts-1];
+    if (numCollapses == 0)
+    {
+      break;
+    }
+    collapses.resize(numCollapses);
+    vtkQuadricDecimationGatherEdges gatherEdges =
+      { &selected[0], &positions[0], &collapses[0] };
+    vtkSMPTools::For(0, numPts, gatherEdges);
+    vtkQuadricDecimationCompareCollapses compare = { &costs[0] };
+    vtkSMPTools::Sort(collapses.begin(), collapses.end(), compare);
+
+    // Only the cheapest collapses are applied in the last pass
+    numDeleted.resize(numCollapses);
+    vtkQuadricDecimationCollapseEdges collapseEdges;
+    collapseEdges.Mesh = &mesh;
+    collapseEdges.Collapses = &collapses[0];
+    collapseEdges.Others = &others[0];
+    collapseEdges.Targets = &targets[0];
+    collapseEdges.NumberOfDeleted = &numDeleted[0];
+    collapseEdges.Apply = false;
+    vtkSMPTools::For(0, numCollapses, collapseEdges);
+    vtkIdType numApplied = 0;
+    while (numApplied < numCollapses &&
+           this->ActualReduction < this->TargetReduction)
+    {
+      numDeletedTris += numDeleted[numApplied++];
+      this->ActualReduction = (double) numDeletedTris / numTris;
+    }
+    collapseEdges.Apply = true;
+    vtkSMPTools::For(0, numApplied, collapseEdges);
+    this->NumberOfEdgeCollapses += numApplied;
+
+    vtkDebugMacro(<<"Pass " << pass << " collapsed " << numApplied
+                  << " edges");
+    this->UpdateProgress(0.20 + 0.75 * this->ActualReduction /
+                         this->TargetReduction);
+    abort = this->GetAbortExecute();
+  }
+
+  vtkDebugMacro(<<"Number Of Edge Collapses: "
+                << this->NumberOfEdgeCollapses);
+
+  // The remaining triangles are output in order, their points being
+  // numbered in the order of their first use, as CopyCells() does
+  mesh.BuildLinks();
+  std::vector<vtkIdType> triangleIds(numTris);
+  for (vtkIdType triId = 0, newTriId = 0; triId < numTris; ++triId)
+  {
+    triangleIds[triId] = newTriId;
+    newTriId += (mesh.Triangles[3*triId] >= 0 ? 1 : 0);
+  }
+  vtkIdType numNewTris = numTris - numDeletedTris;
+  std::vector<vtkIdType> firstUses(3 * numNewTris, 0);
+  std::vector<vtkIdType> pointIds(3 * numNewTris);
+  vtkQuadricDecimationFlagPoints flagPoints =
+    { &mesh, &triangleIds[0], firstUses.data() };
+  vtkSMPTools::For(0, numPts, flagPoints);
+  vtkSMPTools::ExclusiveScan(firstUses.begin(), firstUses.end(),
+                             pointIds.begin(), static_cast<vtkIdType>(0));
+  vtkIdType numNewPts = (numNewTris > 0 ?
+    pointIds[3*numNewTris-1] + firstUses[3*numNewTris-1] : 0);
+
+  output->Reset();
+  vtkPoints *newPoints = vtkPoints::New();
+  newPoints->SetNumberOfPoints(numNewPts);
+  vtkCellArray *newPolys = vtkCellArray::New();
+  vtkQuadricDecimationBuildOutput buildOutput = { &mesh, &triangleIds[0],
+    pointIds.data(), newPoints, newPolys->WritePointer(numNewTris,
+                                                       4 * numNewTris) };
+  vtkSMPTools::For(0, numPts, buildOutput);
+  output->SetPoints(newPoints);
+  newPoints->Delete();
+  output->SetPolys(newPolys);
+  newPolys->Delete();
+
+  return 1;
+}
+
+
 void vtkQuadricDecimation::ComputeNumberOfComponents(void)
 {
   vtkPointData *pd = this->Mesh->GetPointData();
@@ -1439,6 +2370,7 @@ void vtkQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
      << (this->AttributeErrorMetric ? "On\n" : "Off\n");
   os << indent << "Volume Preservation: "
     << (this->VolumePreservation ? "On\n" : "Off\n");
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
   os << indent << "Scalars Attribute: "
      << (this->ScalarsAttribute ? "On\n" : "Off\n");
   os << indent << "Vectors Attribute: "
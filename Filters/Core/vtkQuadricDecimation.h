@@ -148,6 +148,25 @@ public:
   vtkGetMacro(TensorsWeight, double);
   //@}
 
+  //@{
+  /**
+   * Enable/disable the parallel decimation of the triangles with
+   * vtkSMPTools. Instead of collapsing one edge at a time in the order of a
+   * global priority queue, each pass computes the cheapest collapse of every
+   * point and collapses together all the edges that are cheaper than the
+   * edges around them, so that the collapses of a pass modify disjoint sets
+   * of triangles. The passes continue until the target reduction is reached.
+   * The result does not depend on the number of threads, but differs from
+   * the serial decimation since the collapse order is only greedy locally.
+   * Only the geometric error metric is supported: the decimation is serial
+   * when AttributeErrorMetric is on or when a polygon of the input is not a
+   * triangle. Default is off.
+   */
+  vtkSetMacro(Threaded, int);
+  vtkGetMacro(Threaded, int);
+  vtkBooleanMacro(Threaded, int);
+  //@}
+
   //@{
   /**
    * Get the actual reduction. This value is only valid after the
@@ -230,10 +249,18 @@ protected:
    */
   void GetAttributeComponents();
 
+  /**
+   * Decimate the triangles of the input in parallel into the output. Returns
+   * 0 if the input is not supported, in which case the serial decimation is
+   * used.
+   */
+  int DecimateThreaded(vtkPolyData *input, vtkPolyData *output);
+
   double TargetReduction;
   double ActualReduction;
   int   AttributeErrorMetric;
   int   VolumePreservation;
+  int   Threaded;
 
   int ScalarsAttribute;
   int VectorsAttribute;
@@ -25,10 +25,14 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTriangleFilter.h"
 
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 vtkStandardNewMacro(vtkSmoothPolyDataFilter);
 
@@ -130,6 +134,8 @@ vtkSmoothPolyDataFilter::vtkSmoothPolyDataFilter()
 
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
 
+  this->Threaded = 0;
+
   this->SmoothPoints = NULL;
 
   // optional second input
@@ -279,6 +285,176 @@ template<typename T> void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
   vtkDebugWithObjectMacro(params.spdf, << "Performed " << iterationNumber << " smoothing passes");
 }
 
+//----------------------------------------------------------------------------
+// Count the connected vertices of the points that move
+struct vtkSPDF_CountEdges
+{
+  const vtkMeshVertex *Verts;
+  vtkIdType *Counts;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      const vtkMeshVertex &vert = this->Verts[ptId];
+      this->Counts[ptId] = (vert.type != VTK_FIXED_VERTEX && vert.edges ?
+                            vert.edges->GetNumberOfIds() : 0);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Gather the connected vertices of the points that move into a compact
+// array
+struct vtkSPDF_GatherEdges
+{
+  const vtkMeshVertex *Verts;
+  const vtkIdType *Offsets;
+  vtkIdType *Edges;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      vtkIdList *edges = this->Verts[ptId].edges;
+      vtkIdType npts = this->Offsets[ptId + 1] - this->Offsets[ptId];
+      if ( npts > 0 )
+      {
+        std::copy(edges->GetPointer(0), edges->GetPointer(0) + npts,
+                  this->Edges + this->Offsets[ptId]);
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// A Jacobi iteration: move each point toward the mean position of its
+// connected vertices, from the positions of the previous iteration
+template<typename T> struct vtkSPDF_MovePointsFunctor
+{
+  const vtkIdType *Offsets;
+  const vtkIdType *Edges;
+  const T *X;
+  T *XNew;
+  T Factor;
+  vtkSMPThreadLocal<T> MaxDist;
+
+  void Initialize()
+  {
+    this->MaxDist.Local() = 0.0;
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    T &maxDist = this->MaxDist.Local();
+    T deltaX[3], dist;
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      const T *x = this->X + 3 * ptId;
+      T *xNew = this->XNew + 3 * ptId;
+      vtkIdType npts = this->Offsets[ptId + 1] - this->Offsets[ptId];
+      if ( npts > 0 )
+      {
+        const vtkIdType *edges = this->Edges + this->Offsets[ptId];
+        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+        // Compute the mean (cumulated) direction vector
+        for (vtkIdType j = 0; j < npts; ++j)
+        {
+          for (unsigned short k = 0; k < 3; ++k)
+          {
+            deltaX[k] += this->X[3 * edges[j] + k];
+          }
+        }
+        // Move the point
+        for (unsigned short k = 0; k < 3; ++k)
+        {
+          xNew[k] = x[k] + this->Factor * (deltaX[k] / npts - x[k]);
+        }
+        if ((dist = vtkMath::Norm(deltaX)) > maxDist)
+        {
+          maxDist = dist;
+        }
+      }
+      else
+      {
+        xNew[0] = x[0];
+        xNew[1] = x[1];
+        xNew[2] = x[2];
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+//----------------------------------------------------------------------------
+// The iterations of unconstrained smoothing performed in parallel, with two
+// buffers of points
+template<typename T>
+void vtkSPDF_MovePointsThreaded(vtkSPDF_InternalParams<T>& params)
+{
+  vtkIdType numPts = params.numPts;
+  std::vector<vtkIdType> offsets(numPts + 1);
+  vtkSPDF_CountEdges countEdges = { params.vertexPtr, &offsets[0] };
+  vtkSMPTools::For(0, numPts, countEdges);
+  vtkIdType lastCount = offsets[numPts - 1];
+  vtkSMPTools::ExclusiveScan(offsets.begin(), offsets.end() - 1,
+                             offsets.begin(), static_cast<vtkIdType>(0));
+  offsets[numPts] = offsets[numPts - 1] + lastCount;
+
+  std::vector<vtkIdType> edges(offsets[numPts] + 1);
+  vtkSPDF_GatherEdges gatherEdges = { params.vertexPtr, &offsets[0],
+                                      &edges[0] };
+  vtkSMPTools::For(0, numPts, gatherEdges);
+
+  vtkPoints *pts[2] = { params.newPts, params.newPts->NewInstance() };
+  pts[1]->SetDataType(params.newPts->GetDataType());
+  pts[1]->SetNumberOfPoints(numPts);
+  int current = 0;
+
+  int iterationNumber = 0;
+  for (T maxDist = std::numeric_limits<T>::max();
+       maxDist > params.conv && iterationNumber < params.numberOfIterations;
+       ++iterationNumber)
+  {
+    if (iterationNumber && !(iterationNumber % 5))
+    {
+      params.spdf->UpdateProgress(0.5 + 0.5*iterationNumber / params.numberOfIterations);
+      if (params.spdf->GetAbortExecute())
+      {
+        break;
+      }
+    }
+
+    vtkSPDF_MovePointsFunctor<T> movePoints;
+    movePoints.Offsets = &offsets[0];
+    movePoints.Edges = &edges[0];
+    movePoints.X = static_cast<T*>(pts[current]->GetVoidPointer(0));
+    movePoints.XNew = static_cast<T*>(pts[1 - current]->GetVoidPointer(0));
+    movePoints.Factor = params.factor;
+    vtkSMPTools::For(0, numPts, movePoints);
+    current = 1 - current;
+
+    maxDist = 0.0;
+    for (typename vtkSMPThreadLocal<T>::iterator it = movePoints.MaxDist.begin();
+         it != movePoints.MaxDist.end(); ++it)
+    {
+      maxDist = std::max(maxDist, *it);
+    }
+  }
+
+  vtkDebugWithObjectMacro(params.spdf, << "Performed " << iterationNumber << " smoothing passes");
+
+  // The smoothed points end in the points of the caller
+  if ( current == 1 )
+  {
+    params.newPts->SetData(pts[1]->GetData());
+  }
+  pts[1]->Delete();
+}
+
 }// namespace
 
 int vtkSmoothPolyDataFilter::RequestData(
@@ -686,7 +862,14 @@ int vtkSmoothPolyDataFilter::RequestData(
                                               Verts, source, this->SmoothPoints,
                                               w, cellLocator };
 
-    vtkSPDF_MovePoints(params);
+    if (this->Threaded && !source)
+    {
+      vtkSPDF_MovePointsThreaded(params);
+    }
+    else
+    {
+      vtkSPDF_MovePoints(params);
+    }
   }
   else
   {
@@ -695,7 +878,14 @@ int vtkSmoothPolyDataFilter::RequestData(
                                              static_cast<float>(conv), numPts, Verts,
                                              source, this->SmoothPoints, w, cellLocator };
 
-    vtkSPDF_MovePoints(params);
+    if (this->Threaded && !source)
+    {
+      vtkSPDF_MovePointsThreaded(params);
+    }
+    else
+    {
+      vtkSPDF_MovePoints(params);
+    }
   }
 
   if ( source )
@@ -805,4 +995,5 @@ void vtkSmoothPolyDataFilter::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
@@ -215,6 +215,22 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Set/Get whether the smoothing iterations are performed in parallel,
+   * with vtkSMPTools. The connected vertices are gathered once into a
+   * compact array, and each iteration then moves all the points from the
+   * positions of the previous iteration (Jacobi iterations, with two
+   * buffers of points). The serial iterations move the points in place, so
+   * the results differ slightly, but do not depend on the number of
+   * threads. Smoothing constrained to a source surface is always
+   * performed serially. Default is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
 protected:
   vtkSmoothPolyDataFilter();
   ~vtkSmoothPolyDataFilter() VTK_OVERRIDE {}
@@ -232,6 +248,7 @@ protected:
   int GenerateErrorScalars;
   int GenerateErrorVectors;
   int OutputPointsPrecision;
+  int Threaded;
 
   vtkSmoothPoints *SmoothPoints;
 private:
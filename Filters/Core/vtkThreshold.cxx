@@ -14,9 +14,13 @@
 =========================================================================*/
 #include "vtkThreshold.h"
 
+#include "vtkArrayListTemplate.h"
+#include "vtkAtomic.h"
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
@@ -24,8 +28,12 @@
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMath.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
 
 #include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkThreshold);
 
@@ -47,6 +55,7 @@ vtkThreshold::vtkThreshold()
                                vtkDataSetAttributes::SCALARS);
 
   this->UseContinuousCellRange = 0;
+  this->Threaded = 0;
 }
 
 vtkThreshold::~vtkThreshold()
@@ -133,6 +142,17 @@ int vtkThreshold::RequestData(
     return 1;
   }
 
+  // are we using pointScalars?
+  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
+  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
+
+  if ( this->Threaded &&
+       this->ThreadedThreshold(vtkUnstructuredGrid::SafeDownCast(input),
+                               inScalars, usePointScalars, output) )
+  {
+    return 1;
+  }
+
   outPD->CopyGlobalIdsOn();
   outPD->CopyAllocate(pd);
   outCD->CopyGlobalIdsOn();
@@ -176,10 +196,6 @@ int vtkThreshold::RequestData(
 
   newCellPts = vtkIdList::New();
 
-  // are we using pointScalars?
-  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
-  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
-
   // Check that the scalars of each cell satisfy the threshold criterion
   for (cellId=0; cellId < input->GetNumberOfCells(); cellId++)
   {
@@ -187,38 +203,8 @@ int vtkThreshold::RequestData(
     cellPts = cell->GetPointIds();
     numCellPts = cell->GetNumberOfPoints();
 
-    if ( usePointScalars )
-    {
-      if (this->AllScalars)
-      {
-        keepCell = 1;
-        for ( i=0; keepCell && (i < numCellPts); i++)
-        {
-          ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents( inScalars, ptId );
-        }
-      }
-      else
-      {
-        if(!this->UseContinuousCellRange)
-        {
-          keepCell = 0;
-          for ( i=0; (!keepCell) && (i < numCellPts); i++)
-          {
-            ptId = cellPts->GetId(i);
-            keepCell = this->EvaluateComponents( inScalars, ptId );
-          }
-        }
-        else
-        {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
-        }
-      }
-    }
-    else //use cell scalars
-    {
-      keepCell = this->EvaluateComponents( inScalars, cellId );
-    }
+    keepCell = this->EvaluateCellScalars(inScalars, usePointScalars, cellId,
+                                         cellPts);
 
     if (  numCellPts > 0 && keepCell )
     {
@@ -266,6 +252,273 @@ int vtkThreshold::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// Threaded extraction of the cells. The cells are evaluated in parallel,
+// marking the points of the kept cells; scans then number the output cells,
+// their connectivity and the output points, so that the output can be
+// written in parallel.
+
+// Evaluate the cells, and mark the points used by the kept cells
+struct vtkThresholdEvaluateCells
+{
+  vtkThreshold *Self;
+  vtkUnstructuredGrid *Input;
+  vtkDataArray *Scalars;
+  bool UsePointScalars;
+  vtkIdType *Kept;
+  vtkIdType *ConnectivitySizes;
+  vtkAtomic<vtkIdType> *Used;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *cellPts = this->CellPoints.Local();
+    for ( ; cellId < endCellId; cellId++ )
+    {
+      this->Input->GetCellPoints(cellId, cellPts);
+      vtkIdType numCellPts = cellPts->GetNumberOfIds();
+      if ( numCellPts > 0 &&
+           this->Self->EvaluateCellScalars(this->Scalars,
+                                           this->UsePointScalars,
+                                           cellId, cellPts) )
+      {
+        this->Kept[cellId] = 1;
+        this->ConnectivitySizes[cellId] = numCellPts + 1;
+        for (vtkIdType i=0; i < numCellPts; i++)
+        {
+          vtkAtomic<vtkIdType> &used = this->Used[cellPts->GetId(i)];
+          if ( !used )
+          {
+            used = 1;
+          }
+        }
+      }
+      else
+      {
+        this->Kept[cellId] = 0;
+        this->ConnectivitySizes[cellId] = 0;
+      }
+    }
+  }
+};
+
+namespace
+{
+
+// Write the kept cells, and copy their data
+struct vtkThresholdBuildCells
+{
+  vtkUnstructuredGrid *Input;
+  const vtkIdType *Kept;
+  const vtkIdType *NewCellIds;
+  const vtkIdType *NewLocations;
+  const vtkIdType *PointMap;
+  vtkIdType *Connectivity;
+  vtkIdType *Locations;
+  unsigned char *Types;
+  ArrayList *CellArrays;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdType npts, *pts;
+    for ( ; cellId < endCellId; cellId++ )
+    {
+      if ( !this->Kept[cellId] )
+      {
+        continue;
+      }
+      vtkIdType newCellId = this->NewCellIds[cellId];
+      vtkIdType loc = this->NewLocations[cellId];
+      this->Input->GetCellPoints(cellId, npts, pts);
+      vtkIdType *newCell = this->Connectivity + loc;
+      *newCell++ = npts;
+      for (vtkIdType i=0; i < npts; i++)
+      {
+        newCell[i] = this->PointMap[pts[i]];
+      }
+      this->Locations[newCellId] = loc;
+      this->Types[newCellId] =
+        static_cast<unsigned char>(this->Input->GetCellType(cellId));
+      this->CellArrays->Copy(cellId, newCellId);
+    }
+  }
+};
+
+// Copy the used points, and their data
+struct vtkThresholdCopyPoints
+{
+  vtkAtomic<vtkIdType> *Used;
+  const vtkIdType *PointMap;
+  vtkPoints *InPoints;
+  vtkPoints *OutPoints;
+  ArrayList *PointArrays;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for ( ; ptId < endPtId; ptId++ )
+    {
+      if ( this->Used[ptId] )
+      {
+        vtkIdType newId = this->PointMap[ptId];
+        this->InPoints->GetPoint(ptId, x);
+        this->OutPoints->SetPoint(newId, x);
+        this->PointArrays->Copy(ptId, newId);
+      }
+    }
+  }
+};
+
+}
+
+//----------------------------------------------------------------------------
+int vtkThreshold::ThreadedThreshold(vtkUnstructuredGrid *input,
+                                    vtkDataArray *inScalars,
+                                    bool usePointScalars,
+                                    vtkUnstructuredGrid *output)
+{
+  if ( !input || input->GetNumberOfPoints() < 1 || input->GetFaces() ||
+       input->GetNumberOfCells() < 1 )
+  {
+    return 0;
+  }
+  vtkPointData *pd=input->GetPointData(), *outPD=output->GetPointData();
+  vtkCellData *cd=input->GetCellData(), *outCD=output->GetCellData();
+  if ( !ArrayList::HasNamedDataArrays(pd) ||
+       !ArrayList::HasNamedDataArrays(cd) )
+  {
+    return 0;
+  }
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numCells = input->GetNumberOfCells();
+
+  // Evaluate the cells
+  std::vector<vtkIdType> kept(numCells);
+  std::vector<vtkIdType> connSizes(numCells);
+  vtkAtomic<vtkIdType> *used = new vtkAtomic<vtkIdType>[numPts];
+  vtkThresholdEvaluateCells evaluateCells;
+  evaluateCells.Self = this;
+  evaluateCells.Input = input;
+  evaluateCells.Scalars = inScalars;
+  evaluateCells.UsePointScalars = usePointScalars;
+  evaluateCells.Kept = &kept[0];
+  evaluateCells.ConnectivitySizes = &connSizes[0];
+  evaluateCells.Used = used;
+  vtkSMPTools::For(0, numCells, evaluateCells);
+
+  // Number the kept cells, their connectivity and the used points
+  std::vector<vtkIdType> newCellIds(numCells);
+  vtkSMPTools::ExclusiveScan(kept.begin(), kept.end(), newCellIds.begin(),
+                             static_cast<vtkIdType>(0));
+  vtkIdType numNewCells = newCellIds[numCells-1] + kept[numCells-1];
+  std::vector<vtkIdType> newLocations(numCells);
+  vtkSMPTools::ExclusiveScan(connSizes.begin(), connSizes.end(),
+                             newLocations.begin(), static_cast<vtkIdType>(0));
+  vtkIdType connSize = newLocations[numCells-1] + connSizes[numCells-1];
+  std::vector<vtkIdType> pointMap(numPts);
+  vtkSMPTools::ExclusiveScan(used, used + numPts, pointMap.begin(),
+                             static_cast<vtkIdType>(0));
+  vtkIdType numNewPts = pointMap[numPts-1] + used[numPts-1];
+
+  // Copy the used points
+  vtkPoints *newPoints = vtkPoints::New();
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    newPoints->SetDataType(input->GetPoints()->GetDataType());
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPoints->SetDataType(VTK_FLOAT);
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPoints->SetDataType(VTK_DOUBLE);
+  }
+  newPoints->SetNumberOfPoints(numNewPts);
+
+  outPD->CopyGlobalIdsOn();
+  outPD->CopyAllocate(pd, numNewPts);
+  ArrayList pointArrays;
+  pointArrays.AddArrays(numNewPts, pd, outPD, 0.0, false);
+  vtkThresholdCopyPoints copyPoints = { used, &pointMap[0], input->GetPoints(),
+                                        newPoints, &pointArrays };
+  vtkSMPTools::For(0, numPts, copyPoints);
+  delete [] used;
+
+  // Write the kept cells
+  vtkIdTypeArray *connectivity = vtkIdTypeArray::New();
+  connectivity->SetNumberOfValues(connSize);
+  vtkIdTypeArray *locations = vtkIdTypeArray::New();
+  locations->SetNumberOfValues(numNewCells);
+  vtkUnsignedCharArray *types = vtkUnsignedCharArray::New();
+  types->SetNumberOfValues(numNewCells);
+
+  outCD->CopyGlobalIdsOn();
+  outCD->CopyAllocate(cd, numNewCells);
+  ArrayList cellArrays;
+  cellArrays.AddArrays(numNewCells, cd, outCD, 0.0, false);
+  vtkThresholdBuildCells buildCells = { input, &kept[0], &newCellIds[0],
+                                        &newLocations[0], &pointMap[0],
+                                        connectivity->GetPointer(0),
+                                        locations->GetPointer(0),
+                                        types->GetPointer(0), &cellArrays };
+  vtkSMPTools::For(0, numCells, buildCells);
+
+  vtkCellArray *cells = vtkCellArray::New();
+  cells->SetCells(numNewCells, connectivity);
+  output->SetPoints(newPoints);
+  output->SetCells(types, locations, cells);
+  newPoints->Delete();
+  connectivity->Delete();
+  locations->Delete();
+  types->Delete();
+  cells->Delete();
+
+  vtkDebugMacro(<< "Extracted " << numNewCells << " number of cells.");
+
+  return 1;
+}
+
+// Check that the scalars of a cell satisfy the threshold criterion
+int vtkThreshold::EvaluateCellScalars( vtkDataArray *scalars,
+                                       bool usePointScalars,
+                                       vtkIdType cellId, vtkIdList *cellPts )
+{
+  int keepCell;
+  int numCellPts = cellPts->GetNumberOfIds();
+  if ( usePointScalars )
+  {
+    if (this->AllScalars)
+    {
+      keepCell = 1;
+      for ( int i=0; keepCell && (i < numCellPts); i++)
+      {
+        keepCell = this->EvaluateComponents( scalars, cellPts->GetId(i) );
+      }
+    }
+    else
+    {
+      if(!this->UseContinuousCellRange)
+      {
+        keepCell = 0;
+        for ( int i=0; (!keepCell) && (i < numCellPts); i++)
+        {
+          keepCell = this->EvaluateComponents( scalars, cellPts->GetId(i) );
+        }
+      }
+      else
+      {
+        keepCell = this->EvaluateCell(scalars, cellPts, numCellPts);
+      }
+    }
+  }
+  else //use cell scalars
+  {
+    keepCell = this->EvaluateComponents( scalars, cellId );
+  }
+  return keepCell;
+}
+
 int vtkThreshold::EvaluateCell( vtkDataArray *scalars,vtkIdList* cellPts, int numCellPts )
 {
   int c(0);
@@ -450,4 +703,5 @@ void vtkThreshold::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
   os << indent << "Use Continuous Cell Range: "<<this->UseContinuousCellRange<<endl;
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
@@ -51,9 +51,11 @@
 
 class vtkDataArray;
 class vtkIdList;
+class vtkUnstructuredGrid;
 
 class VTKFILTERSCORE_EXPORT vtkThreshold : public vtkUnstructuredGridAlgorithm
 {
+friend struct vtkThresholdEvaluateCells;
 public:
   static vtkThreshold *New();
   vtkTypeMacro(vtkThreshold,vtkUnstructuredGridAlgorithm);
@@ -183,6 +185,22 @@ public:
   int GetOutputPointsPrecision() const;
   //@}
 
+  //@{
+  /**
+   * Turn on/off the threaded extraction of the cells (using vtkSMPTools).
+   * When the input is an unstructured grid without polyhedra, the cells are
+   * then evaluated in parallel, the kept cells and points are numbered by
+   * scans, and the output is written with its attributes in parallel. The
+   * output has the same cells in the same order as the serial output, but
+   * its points follow the order of the input points. Other inputs, and
+   * attributes with unnamed arrays, are processed serially. By default
+   * this is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
 protected:
   vtkThreshold();
   ~vtkThreshold() VTK_OVERRIDE;
@@ -201,6 +219,7 @@ protected:
   int    SelectedComponent;
   int OutputPointsPrecision;
   int UseContinuousCellRange;
+  int Threaded;
 
   int (vtkThreshold::*ThresholdFunction)(double s);
 
@@ -212,6 +231,14 @@ protected:
   int EvaluateComponents( vtkDataArray *scalars, vtkIdType id );
   int EvaluateCell( vtkDataArray *scalars, vtkIdList* cellPts, int numCellPts );
   int EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts );
+  int EvaluateCellScalars( vtkDataArray *scalars, bool usePointScalars,
+                           vtkIdType cellId, vtkIdList *cellPts );
+
+  // Threaded version of RequestData(). Returns 0 if the input has to be
+  // processed by the serial code.
+  int ThreadedThreshold(vtkUnstructuredGrid *input, vtkDataArray *inScalars,
+                        bool usePointScalars, vtkUnstructuredGrid *output);
+
 private:
   vtkThreshold(const vtkThreshold&) VTK_DELETE_FUNCTION;
   void operator=(const vtkThreshold&) VTK_DELETE_FUNCTION;
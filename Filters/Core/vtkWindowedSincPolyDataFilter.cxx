@@ -24,9 +24,13 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 #include "vtkTriangleFilter.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkWindowedSincPolyDataFilter);
 
 // Construct object with number of iterations 20; passband .1;
@@ -50,6 +54,8 @@ vtkWindowedSincPolyDataFilter::vtkWindowedSincPolyDataFilter()
   this->GenerateErrorVectors = 0;
 
   this->NormalizeCoordinates = 0;
+
+  this->Threaded = 0;
 }
 
 #define VTK_SIMPLE_VERTEX 0
@@ -64,6 +70,232 @@ typedef struct _vtkMeshVertex
   vtkIdList *edges; // connected edges (list of connected point ids)
 } vtkMeshVertex, *vtkMeshVertexPtr;
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Count the connected vertices of the points
+struct vtkWindowedSincCountEdges
+{
+  const vtkMeshVertex *Verts;
+  vtkIdType *Counts;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      vtkIdList *edges = this->Verts[ptId].edges;
+      this->Counts[ptId] = (edges ? edges->GetNumberOfIds() : 0);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Gather the connected vertices of the points into a compact array
+struct vtkWindowedSincGatherEdges
+{
+  const vtkMeshVertex *Verts;
+  const vtkIdType *Offsets;
+  vtkIdType *Edges;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      vtkIdList *edges = this->Verts[ptId].edges;
+      if ( edges )
+      {
+        std::copy(edges->GetPointer(0),
+                  edges->GetPointer(0) + edges->GetNumberOfIds(),
+                  this->Edges + this->Offsets[ptId]);
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// The first iteration: X1 = X0 - 0.5 laplacian(X0) and X3 = c0 X0 + c1 X1,
+// with the arithmetic of the serial iteration
+struct vtkWindowedSincFirstIteration
+{
+  const vtkMeshVertex *Verts;
+  const vtkIdType *Offsets;
+  const vtkIdType *Edges;
+  const float *X0;
+  float *X1;
+  float *X3;
+  double C0;
+  double C1;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3], deltaX[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      const float *x0 = this->X0 + 3 * ptId;
+      float *x1 = this->X1 + 3 * ptId;
+      float *x3 = this->X3 + 3 * ptId;
+      vtkIdType npts = this->Offsets[ptId + 1] - this->Offsets[ptId];
+      if ( npts > 0 )
+      {
+        const vtkIdType *edges = this->Edges + this->Offsets[ptId];
+        int k;
+        for (k = 0; k < 3; k++)
+        {
+          x[k] = x0[k];
+          deltaX[k] = 0.0;
+        }
+        for (vtkIdType j = 0; j < npts; j++)
+        {
+          const float *y = this->X0 + 3 * edges[j];
+          for (k = 0; k < 3; k++)
+          {
+            deltaX[k] += (x[k] - static_cast<double>(y[k])) / npts;
+          }
+        }
+        for (k = 0; k < 3; k++)
+        {
+          deltaX[k] = x[k] - 0.5*deltaX[k];
+          x1[k] = static_cast<float>(deltaX[k]);
+          x3[k] = (this->Verts[ptId].type == VTK_FIXED_VERTEX ? x0[k] :
+                   static_cast<float>(this->C0*x[k] + this->C1*deltaX[k]));
+        }
+      }
+      else
+      {
+        for (int k = 0; k < 3; k++)
+        {
+          x1[k] = 0.0f;
+          x3[k] = x0[k];
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// The following iterations: X2 = (X1 - X0) + (X1 - laplacian(X1)) and
+// X3 = X3 + c X2. X1 is null for the points that cannot move.
+struct vtkWindowedSincIteration
+{
+  const vtkMeshVertex *Verts;
+  const vtkIdType *Offsets;
+  const vtkIdType *Edges;
+  const float *X0;
+  const float *X1;
+  float *X2;
+  float *X3;
+  double C;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double p_x1[3], deltaX[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      float *x2 = this->X2 + 3 * ptId;
+      vtkIdType npts = this->Offsets[ptId + 1] - this->Offsets[ptId];
+      if ( npts > 0 )
+      {
+        const vtkIdType *edges = this->Edges + this->Offsets[ptId];
+        const float *x0 = this->X0 + 3 * ptId;
+        float *x3 = this->X3 + 3 * ptId;
+        int k;
+        for (k = 0; k < 3; k++)
+        {
+          p_x1[k] = this->X1[3 * ptId + k];
+          deltaX[k] = 0.0;
+        }
+        for (vtkIdType j = 0; j < npts; j++)
+        {
+          const float *y = this->X1 + 3 * edges[j];
+          for (k = 0; k < 3; k++)
+          {
+            deltaX[k] += (p_x1[k] - static_cast<double>(y[k])) / npts;
+          }
+        }
+        bool fixed = (this->Verts[ptId].type == VTK_FIXED_VERTEX);
+        for (k = 0; k < 3; k++)
+        {
+          deltaX[k] = p_x1[k] - x0[k] + p_x1[k] - deltaX[k];
+          x2[k] = static_cast<float>(deltaX[k]);
+          if ( !fixed )
+          {
+            x3[k] = static_cast<float>(x3[k] + this->C * deltaX[k]);
+          }
+        }
+      }
+      else
+      {
+        x2[0] = x2[1] = x2[2] = 0.0f;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Perform the iterations of the smoothing in parallel. The connected
+// vertices are gathered once in a compact array. Returns the number of the
+// last iteration started.
+int vtkWindowedSincSmooth(vtkWindowedSincPolyDataFilter *self,
+                          const vtkMeshVertex *verts, vtkIdType numPts,
+                          vtkPoints *newPts[4], const double *c,
+                          int numIterations)
+{
+  std::vector<vtkIdType> offsets(numPts + 1);
+  vtkWindowedSincCountEdges countEdges = { verts, &offsets[0] };
+  vtkSMPTools::For(0, numPts, countEdges);
+  vtkIdType lastCount = offsets[numPts - 1];
+  vtkSMPTools::ExclusiveScan(offsets.begin(), offsets.end() - 1,
+                             offsets.begin(), static_cast<vtkIdType>(0));
+  offsets[numPts] = offsets[numPts - 1] + lastCount;
+
+  std::vector<vtkIdType> edges(offsets[numPts] + 1);
+  vtkWindowedSincGatherEdges gatherEdges = { verts, &offsets[0], &edges[0] };
+  vtkSMPTools::For(0, numPts, gatherEdges);
+
+  float *x[4];
+  for (int i = 0; i < 4; i++)
+  {
+    x[i] = static_cast<float*>(newPts[i]->GetVoidPointer(0));
+  }
+  int zero = 0, one = 1, two = 2, three = 3;
+
+  vtkWindowedSincFirstIteration first = { verts, &offsets[0], &edges[0],
+    x[zero], x[one], x[three], c[0], c[1] };
+  vtkSMPTools::For(0, numPts, first);
+
+  int iterationNumber;
+  for ( iterationNumber=2;
+        iterationNumber <= numIterations;
+        iterationNumber++ )
+  {
+    if ( iterationNumber && !(iterationNumber % 5) )
+    {
+      self->UpdateProgress (0.5 + 0.5*iterationNumber/numIterations);
+      if (self->GetAbortExecute())
+      {
+        break;
+      }
+    }
+
+    vtkWindowedSincIteration iteration = { verts, &offsets[0], &edges[0],
+      x[zero], x[one], x[two], x[three], c[iterationNumber] };
+    vtkSMPTools::For(0, numPts, iteration);
+
+    zero = (1+zero)%3;
+    one = (1+one)%3;
+    two = (1+two)%3;
+  }
+
+  for (int i = 0; i < 4; i++)
+  {
+    newPts[i]->Modified();
+  }
+  return iterationNumber;
+}
+
+}
+
 int vtkWindowedSincPolyDataFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **inputVector,
@@ -578,106 +810,51 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     vtkErrorMacro(<< "An optimal offset for the smoothing filter could not be found.  Unpredictable smoothing/shrinkage may result.");
   }
 
-  // first iteration
-  for (i=0; i<numPts; i++)
+  if ( this->Threaded )
   {
-    if ( Verts[i].edges != NULL &&
-         (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-    {
-      // point is allowed to move
-      newPts[zero]->GetPoint(i, x); //use current points
-      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-
-      // calculate the negative of the laplacian
-      for (j=0; j<npts; j++) //for all connected points
-      {
-        newPts[zero]->GetPoint(Verts[i].edges->GetId(j), y);
-        for (k=0; k<3; k++)
-        {
-          deltaX[k] += (x[k] - y[k]) / npts;
-        }
-      }
-      // newPts[one] = newPts[zero] - 0.5 newPts[one]
-      for (k=0; k<3; k++)
-      {
-        deltaX[k] = x[k] - 0.5*deltaX[k];
-      }
-      newPts[one]->SetPoint(i, deltaX);
-
-      // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
-      for (k=0; k < 3; k++)
-      {
-        deltaX[k] = c[0]*x[k] + c[1]*deltaX[k];
-      }
-      if (Verts[i].type == VTK_FIXED_VERTEX)
-      {
-        newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-      }
-      else
-      {
-        newPts[three]->SetPoint(i, deltaX);
-      }
-    }//if can move point
-    else
-    {
-      // point is not allowed to move, just use the old point...
-      // (zero out the Laplacian)
-      newPts[one]->SetPoint(i, zerovector);
-      newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-    }
-  }//for all points
-
-  // for the rest of the iterations
-  for ( iterationNumber=2;
-        iterationNumber <= this->NumberOfIterations;
-        iterationNumber++ )
+    iterationNumber = vtkWindowedSincSmooth(this, Verts, numPts, newPts, c,
+                                            this->NumberOfIterations);
+  }
+  else
   {
-    if ( iterationNumber && !(iterationNumber % 5) )
-    {
-      this->UpdateProgress (0.5 + 0.5*iterationNumber/this->NumberOfIterations);
-      if (this->GetAbortExecute())
-      {
-        break;
-      }
-    }
-
+    // first iteration
     for (i=0; i<numPts; i++)
     {
       if ( Verts[i].edges != NULL &&
            (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
       {
         // point is allowed to move
-        newPts[zero]->GetPoint(i, p_x0); //use current points
-        newPts[one]->GetPoint(i, p_x1);
-
+        newPts[zero]->GetPoint(i, x); //use current points
         deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
 
-        // calculate the negative laplacian of x1
-        for (j=0; j<npts; j++)
+        // calculate the negative of the laplacian
+        for (j=0; j<npts; j++) //for all connected points
         {
-          newPts[one]->GetPoint(Verts[i].edges->GetId(j), y);
+          newPts[zero]->GetPoint(Verts[i].edges->GetId(j), y);
           for (k=0; k<3; k++)
           {
-            deltaX[k] += (p_x1[k] - y[k]) / npts;
+            deltaX[k] += (x[k] - y[k]) / npts;
           }
-        }//for all connected points
-
-        // Taubin:  x2 = (x1 - x0) + (x1 - x2)
+        }
+        // newPts[one] = newPts[zero] - 0.5 newPts[one]
         for (k=0; k<3; k++)
         {
-          deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
+          deltaX[k] = x[k] - 0.5*deltaX[k];
         }
-        newPts[two]->SetPoint(i, deltaX);
+        newPts[one]->SetPoint(i, deltaX);
 
-        // smooth the vertex (x3 = x3 + cj x2)
-        newPts[three]->GetPoint(i, p_x3);
-        for (k=0;k<3;k++)
+        // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
+        for (k=0; k < 3; k++)
         {
-          xNew[k] = p_x3[k] + c[iterationNumber] * deltaX[k];
+          deltaX[k] = c[0]*x[k] + c[1]*deltaX[k];
         }
-        if (Verts[i].type != VTK_FIXED_VERTEX)
+        if (Verts[i].type == VTK_FIXED_VERTEX)
         {
-          newPts[three]->SetPoint(i,xNew);
+          newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
+        }
+        else
+        {
+          newPts[three]->SetPoint(i, deltaX);
         }
       }//if can move point
       else
@@ -685,17 +862,80 @@ int vtkWindowedSincPolyDataFilter::RequestData(
         // point is not allowed to move, just use the old point...
         // (zero out the Laplacian)
         newPts[one]->SetPoint(i, zerovector);
-        newPts[two]->SetPoint(i, zerovector);
+        newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
       }
     }//for all points
 
-    // update the pointers. three is always three. all other pointers
-    // shift by one and wrap.
-    zero = (1+zero)%3;
-    one = (1+one)%3;
-    two = (1+two)%3;
+    // for the rest of the iterations
+    for ( iterationNumber=2;
+          iterationNumber <= this->NumberOfIterations;
+          iterationNumber++ )
+    {
+      if ( iterationNumber && !(iterationNumber % 5) )
+      {
+        this->UpdateProgress (0.5 + 0.5*iterationNumber/this->NumberOfIterations);
+        if (this->GetAbortExecute())
+        {
+          break;
+        }
+      }
+
+      for (i=0; i<numPts; i++)
+      {
+        if ( Verts[i].edges != NULL &&
+             (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
+        {
+          // point is allowed to move
+          newPts[zero]->GetPoint(i, p_x0); //use current points
+          newPts[one]->GetPoint(i, p_x1);
+
+          deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+          // calculate the negative laplacian of x1
+          for (j=0; j<npts; j++)
+          {
+            newPts[one]->GetPoint(Verts[i].edges->GetId(j), y);
+            for (k=0; k<3; k++)
+            {
+              deltaX[k] += (p_x1[k] - y[k]) / npts;
+            }
+          }//for all connected points
+
+          // Taubin:  x2 = (x1 - x0) + (x1 - x2)
+          for (k=0; k<3; k++)
+          {
+            deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
+          }
+          newPts[two]->SetPoint(i, deltaX);
 
-  }//for all iterations or until converge
+          // smooth the vertex (x3 = x3 + cj x2)
+          newPts[three]->GetPoint(i, p_x3);
+          for (k=0;k<3;k++)
+          {
+            xNew[k] = p_x3[k] + c[iterationNumber] * deltaX[k];
+          }
+          if (Verts[i].type != VTK_FIXED_VERTEX)
+          {
+            newPts[three]->SetPoint(i,xNew);
+          }
+        }//if can move point
+        else
+        {
+          // point is not allowed to move, just use the old point...
+          // (zero out the Laplacian)
+          newPts[one]->SetPoint(i, zerovector);
+          newPts[two]->SetPoint(i, zerovector);
+        }
+      }//for all points
+
+      // update the pointers. three is always three. all other pointers
+      // shift by one and wrap.
+      zero = (1+zero)%3;
+      one = (1+one)%3;
+      two = (1+two)%3;
+
+    }//for all iterations or until converge
+  }
 
   // move the iteration count back down so that it matches the
   // actual number of iterations executed
@@ -806,4 +1046,5 @@ void vtkWindowedSincPolyDataFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Nonmanifold Smoothing: " << (this->NonManifoldSmoothing ? "On\n" : "Off\n");
   os << indent << "Generate Error Scalars: " << (this->GenerateErrorScalars ? "On\n" : "Off\n");
   os << indent << "Generate Error Vectors: " << (this->GenerateErrorVectors ? "On\n" : "Off\n");
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
@@ -251,6 +251,20 @@ public:
   vtkBooleanMacro(GenerateErrorVectors,int);
   //@}
 
+  //@{
+  /**
+   * Set/Get whether the smoothing iterations are performed in parallel,
+   * with vtkSMPTools. The connected vertices are gathered once into a
+   * compact array, and each iteration updates all the points from the
+   * buffers of the previous iterations, as the serial iterations do: the
+   * output is identical to the serial one. The analysis of the topology
+   * remains serial. Default is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
  protected:
   vtkWindowedSincPolyDataFilter();
   ~vtkWindowedSincPolyDataFilter() VTK_OVERRIDE {}
@@ -267,6 +281,7 @@ public:
   int GenerateErrorScalars;
   int GenerateErrorVectors;
   int NormalizeCoordinates;
+  int Threaded;
 private:
   vtkWindowedSincPolyDataFilter(const vtkWindowedSincPolyDataFilter&) VTK_DELETE_FUNCTION;
   void operator=(const vtkWindowedSincPolyDataFilter&) VTK_DELETE_FUNCTION;
@@ -0,0 +1,172 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStreamTracerThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded integration of the seeds produces the same
+// streamlines as the serial one, in the same order, with the same
+// attributes.
+
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkStreamTracer.h"
+#include "vtkTestDataComparison.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+
+// A swirling velocity field, with a scalar field to interpolate
+void MakeImage(vtkImageData *image, int n)
+{
+  image->SetDimensions(n, n, n);
+  image->SetOrigin(-1.0, -1.0, -1.0);
+  image->SetSpacing(2.0 / (n - 1), 2.0 / (n - 1), 2.0 / (n - 1));
+
+  vtkNew<vtkDoubleArray> velocity;
+  velocity->SetName("Velocity");
+  velocity->SetNumberOfComponents(3);
+  velocity->SetNumberOfTuples(image->GetNumberOfPoints());
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    image->GetPoint(i, x);
+    velocity->SetTuple3(i, -x[1] + 0.1 * x[2], x[0], 0.2 + 0.3 * x[0] * x[1]);
+    scalars->SetValue(i, x[0] * x[0] + x[1] - x[2]);
+  }
+  image->GetPointData()->SetVectors(velocity.GetPointer());
+  image->GetPointData()->SetScalars(scalars.GetPointer());
+}
+
+// The same grid, as an unstructured grid of voxels
+void MakeGrid(vtkImageData *image, vtkUnstructuredGrid *grid)
+{
+  const int voxel = VTK_VOXEL;
+  int dims[3];
+  image->GetDimensions(dims);
+  vtkTest::MakeLatticeGrid(grid, dims[0] - 1, &voxel, 1);
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    grid->GetPoints()->SetPoint(i, image->GetPoint(i));
+  }
+  grid->GetPointData()->ShallowCopy(image->GetPointData());
+}
+
+// Seeds on a plane across the domain, some of them outside of it
+void MakeSeeds(vtkPolyData *seeds, int n)
+{
+  vtkNew<vtkPoints> points;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      points->InsertNextPoint(-1.1 + 2.2 * i / (n - 1),
+                              -1.1 + 2.2 * j / (n - 1), 0.05 * i - 0.5);
+    }
+  }
+  seeds->SetPoints(points.GetPointer());
+}
+
+bool SameStreamlines(vtkPolyData *serial, vtkPolyData *threaded)
+{
+  if (serial->GetNumberOfLines() < 10 ||
+      serial->GetNumberOfLines() != threaded->GetNumberOfLines() ||
+      serial->GetNumberOfPoints() != threaded->GetNumberOfPoints())
+  {
+    cerr << "Error: different outputs " << serial->GetNumberOfLines() << " "
+         << threaded->GetNumberOfLines() << " lines, "
+         << serial->GetNumberOfPoints() << " "
+         << threaded->GetNumberOfPoints() << " points" << endl;
+    return false;
+  }
+  if (!vtkTest::SameArrays(serial->GetPoints()->GetData(),
+                           threaded->GetPoints()->GetData()) ||
+      !vtkTest::SameCells(serial->GetLines(), threaded->GetLines()))
+  {
+    cerr << "Error: different streamlines" << endl;
+    return false;
+  }
+  if (!threaded->GetPointData()->GetVectors() ||
+      !threaded->GetPointData()->GetScalars())
+  {
+    cerr << "Error: missing attributes" << endl;
+    return false;
+  }
+  return vtkTest::SameAttributes(serial->GetPointData(),
+                                 threaded->GetPointData()) &&
+         vtkTest::SameAttributes(serial->GetCellData(),
+                                 threaded->GetCellData());
+}
+
+}
+
+int TestStreamTracerThreaded(int, char *[])
+{
+  vtkNew<vtkImageData> image;
+  MakeImage(image.GetPointer(), 12);
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(image.GetPointer(), grid.GetPointer());
+  vtkNew<vtkPolyData> seeds;
+  MakeSeeds(seeds.GetPointer(), 40);
+
+  vtkDataSet *inputs[2] = { image.GetPointer(), grid.GetPointer() };
+  for (int config = 0; config < 6; ++config)
+  {
+    vtkNew<vtkStreamTracer> serial;
+    vtkNew<vtkStreamTracer> threaded;
+    threaded->ThreadedOn();
+    vtkStreamTracer *tracers[2] = { serial.GetPointer(), threaded.GetPointer() };
+    for (int t = 0; t < 2; ++t)
+    {
+      tracers[t]->SetInputData(inputs[config % 2]);
+      tracers[t]->SetSourceData(seeds.GetPointer());
+      tracers[t]->SetMaximumPropagation(5.0);
+      tracers[t]->SetIntegrationDirectionToBoth();
+      if (config / 2 == 1)
+      {
+        tracers[t]->SetIntegratorTypeToRungeKutta45();
+      }
+      else if (config / 2 == 2)
+      {
+        tracers[t]->SetInterpolatorTypeToCellLocator();
+        tracers[t]->SetIntegratorTypeToRungeKutta4();
+      }
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+      {
+        tracers[t]->Update();
+      });
+    }
+    if (!SameStreamlines(serial->GetOutput(), threaded->GetOutput()))
+    {
+      cerr << "Error: configuration " << config << endl;
+      return EXIT_FAILURE;
+    }
+
+    // The streamlines integrated by 4 threads are the ones of a single
+    // thread
+    if (!vtkTest::SameOutputsWithThreads(threaded.GetPointer()))
+    {
+      cerr << "Error: configuration " << config << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
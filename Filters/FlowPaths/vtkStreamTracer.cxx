@@ -25,6 +25,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkExecutive.h"
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkIntArray.h"
@@ -45,6 +46,8 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkRungeKutta2.h"
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 
 #include <vector>
@@ -128,6 +131,8 @@ vtkStreamTracer::vtkStreamTracer()
   this->HasMatchingPointAttributes = true;
 
   this->SurfaceStreamlines = false;
+
+  this->Threaded = 0;
 }
 
 vtkStreamTracer::~vtkStreamTracer()
@@ -514,12 +519,19 @@ int vtkStreamTracer::RequestData(
       double propagation = 0;
       vtkIdType numSteps = 0;
       double integrationTime = 0;
-      this->Integrate(input0->GetPointData(), output,
-                      seeds, seedIds,
-                      integrationDirections,
-                      lastPoint, func,
-                      maxCellSize, vecType,vecName,
-                      propagation, numSteps, integrationTime);
+      if ( !this->Threaded ||
+           !this->ThreadedIntegrate(input0->GetPointData(), output,
+                                    seeds, seedIds,
+                                    integrationDirections, func,
+                                    maxCellSize, vecType, vecName) )
+      {
+        this->Integrate(input0->GetPointData(), output,
+                        seeds, seedIds,
+                        integrationDirections,
+                        lastPoint, func,
+                        maxCellSize, vecType,vecName,
+                        propagation, numSteps, integrationTime);
+      }
     }
     func->Delete();
     seeds->Delete();
@@ -666,6 +678,29 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
                                 double& inPropagation,
                                 vtkIdType& inNumSteps,
                                 double &inIntegrationTime)
+{
+  this->IntegrateLines(input0Data, output, seedSource, seedIds,
+                       integrationDirections, lastPoint, func, maxCellSize,
+                       vecType, vecName, inPropagation, inNumSteps,
+                       inIntegrationTime, 0, seedIds->GetNumberOfIds(), false);
+}
+
+void vtkStreamTracer::IntegrateLines(vtkPointData *input0Data,
+                                     vtkPolyData* output,
+                                     vtkDataArray* seedSource,
+                                     vtkIdList* seedIds,
+                                     vtkIntArray* integrationDirections,
+                                     double lastPoint[3],
+                                     vtkAbstractInterpolatedVelocityField* func,
+                                     int maxCellSize,
+                                     int vecType,
+                                     const char *vecName,
+                                     double& inPropagation,
+                                     vtkIdType& inNumSteps,
+                                     double &inIntegrationTime,
+                                     vtkIdType beginLine,
+                                     vtkIdType endLine,
+                                     bool threaded)
 {
   int i;
   vtkIdType numLines = seedIds->GetNumberOfIds();
@@ -791,11 +826,14 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
 
   int shouldAbort = 0;
 
-  for(int currentLine = 0; currentLine < numLines; currentLine++)
+  for(vtkIdType currentLine = beginLine; currentLine < endLine; currentLine++)
   {
 
     double progress = static_cast<double>(currentLine)/numLines;
-    this->UpdateProgress(progress);
+    if (!threaded)
+    {
+      this->UpdateProgress(progress);
+    }
 
     switch (integrationDirections->GetValue(currentLine))
     {
@@ -922,9 +960,12 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
 
       if ( numSteps++ % 1000 == 1 )
       {
-        progress =
-          ( currentLine + propagation / this->MaximumPropagation ) / numLines;
-        this->UpdateProgress(progress);
+        if (!threaded)
+        {
+          progress =
+            ( currentLine + propagation / this->MaximumPropagation ) / numLines;
+          this->UpdateProgress(progress);
+        }
 
         if (this->GetAbortExecute())
         {
@@ -957,7 +998,10 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
         }
         maxStep = stepSize.Interval;
       }
-      this->LastUsedStepSize = stepSize.Interval;
+      if (!threaded)
+      {
+        this->LastUsedStepSize = stepSize.Interval;
+      }
 
       // Calculate the next step using the integrator provided
       // Break if the next point is out of bounds.
@@ -1163,7 +1207,7 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
     {
       // Assign geometry and attributes
       output->SetLines(outputLines);
-      if (this->GenerateNormalsInIntegrate)
+      if (this->GenerateNormalsInIntegrate && !threaded)
       {
         this->GenerateNormals(output, 0, vecName);
       }
@@ -1202,6 +1246,290 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
   return;
 }
 
+//----------------------------------------------------------------------------
+// Threaded integration of the seeds. The seeds are split into batches of
+// consecutive lines, integrated concurrently into separate polydata by
+// IntegrateLines(), each thread using its own copy of the function. The
+// batches are then appended in order, which gives the serial output.
+
+// Integrate batches of seeds
+struct vtkStreamTracerIntegrateBatches
+{
+  vtkStreamTracer *Self;
+  vtkPointData *InputData;
+  vtkDataArray *SeedSource;
+  vtkIdList *SeedIds;
+  vtkIntArray *IntegrationDirections;
+  vtkAbstractInterpolatedVelocityField *Prototype;
+  std::vector<vtkDataSet*> *DataSets;
+  int MaxCellSize;
+  int VecType;
+  const char *VecName;
+  vtkIdType BatchSize;
+  std::vector<vtkSmartPointer<vtkPolyData> > *Outputs;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkAbstractInterpolatedVelocityField> >
+    Functions;
+
+  // Each thread integrates with its own copy of the function, so that the
+  // cached cells and the cell locators are not shared
+  void Initialize()
+  {
+    vtkAbstractInterpolatedVelocityField *func =
+      this->Prototype->NewInstance();
+    func->CopyParameters(this->Prototype);
+    vtkCompositeInterpolatedVelocityField *compositeFunc =
+      vtkCompositeInterpolatedVelocityField::SafeDownCast(func);
+    for (size_t i=0; i < this->DataSets->size(); i++)
+    {
+      compositeFunc->AddDataSet((*this->DataSets)[i]);
+    }
+    func->SelectVectors(this->VecType, this->VecName);
+    this->Functions.Local().TakeReference(func);
+  }
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    vtkAbstractInterpolatedVelocityField *func =
+      this->Functions.Local().GetPointer();
+    vtkIdType numLines = this->SeedIds->GetNumberOfIds();
+    for ( ; batch < endBatch; batch++ )
+    {
+      vtkIdType beginLine = batch * this->BatchSize;
+      vtkIdType endLine = beginLine + this->BatchSize;
+      if ( endLine > numLines )
+      {
+        endLine = numLines;
+      }
+      vtkPolyData *output = vtkPolyData::New();
+      (*this->Outputs)[batch].TakeReference(output);
+      double lastPoint[3];
+      double propagation = 0;
+      vtkIdType numSteps = 0;
+      double integrationTime = 0;
+      this->Self->IntegrateLines(this->InputData, output,
+                                 this->SeedSource, this->SeedIds,
+                                 this->IntegrationDirections,
+                                 lastPoint, func,
+                                 this->MaxCellSize, this->VecType,
+                                 this->VecName, propagation, numSteps,
+                                 integrationTime, beginLine, endLine, true);
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+namespace
+{
+
+// Make sure that the lazily built structures of the dataset (bounds, cells,
+// links and point locator) exist before FindCell() and GetCell() are called
+// from several threads
+void PrepareDataSetForThreads(vtkDataSet *ds, vtkGenericCell *cell)
+{
+  ds->GetLength();
+  if ( ds->GetNumberOfPoints() < 1 || ds->GetNumberOfCells() < 1 )
+  {
+    return;
+  }
+  std::vector<double> weights(ds->GetMaxCellSize() + 1);
+  double x[3], pcoords[3];
+  int subId;
+  ds->GetCell(0, cell);
+  ds->GetPoint(0, x);
+  ds->FindCell(x, 0, cell, -1, 0.0, subId, pcoords, &weights[0]);
+}
+
+// Append the tuples of an array of the batches. The point data arrays are
+// matched by index, since the batches have the same point data arrays in the
+// same order, and the cell data arrays by name, since they only exist in the
+// batches with lines.
+void AppendBatchArrays(
+  vtkDataSetAttributes *outAttributes, vtkAbstractArray *array0, int index,
+  const std::vector<vtkSmartPointer<vtkPolyData> > &batches,
+  bool pointData, vtkIdType numTuples)
+{
+  vtkAbstractArray *array = array0->NewInstance();
+  array->SetName(array0->GetName());
+  array->SetNumberOfComponents(array0->GetNumberOfComponents());
+  array->SetNumberOfTuples(numTuples);
+  vtkIdType offset = 0;
+  for (size_t b=0; b < batches.size(); b++)
+  {
+    vtkAbstractArray *batchArray = pointData ?
+      batches[b]->GetPointData()->GetAbstractArray(index) :
+      batches[b]->GetCellData()->GetAbstractArray(array0->GetName());
+    if ( batchArray && batchArray->GetNumberOfTuples() > 0 )
+    {
+      array->InsertTuples(offset, batchArray->GetNumberOfTuples(), 0,
+                          batchArray);
+      offset += batchArray->GetNumberOfTuples();
+    }
+  }
+  outAttributes->AddArray(array);
+  array->Delete();
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkStreamTracer::ThreadedIntegrate(vtkPointData *input0Data,
+                                       vtkPolyData* output,
+                                       vtkDataArray* seedSource,
+                                       vtkIdList* seedIds,
+                                       vtkIntArray* integrationDirections,
+                                       vtkAbstractInterpolatedVelocityField* func,
+                                       int maxCellSize,
+                                       int vecType,
+                                       const char *vecName)
+{
+  vtkIdType numLines = seedIds->GetNumberOfIds();
+  if ( numLines < 2 || !this->GetIntegrator() ||
+       !this->HasMatchingPointAttributes ||
+       !vtkCompositeInterpolatedVelocityField::SafeDownCast(func) ||
+       ( this->SurfaceStreamlines &&
+         !vtkInterpolatedVelocityField::SafeDownCast(func) ) )
+  {
+    return 0;
+  }
+
+  // The datasets are given to the functions of the threads in the order
+  // used by CheckInputs()
+  std::vector<vtkDataSet*> dataSets;
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(this->InputData->NewIterator());
+  vtkNew<vtkGenericCell> cell;
+  for (iter->GoToFirstItem(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    vtkDataSet *ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+    if ( ds )
+    {
+      PrepareDataSetForThreads(ds, cell.GetPointer());
+      dataSets.push_back(ds);
+    }
+  }
+
+  this->UpdateProgress(0.0);
+
+  // Enough batches to balance streamlines of very different lengths
+  vtkIdType batchSize = numLines / 1024 + 1;
+  vtkIdType numBatches = (numLines + batchSize - 1) / batchSize;
+  std::vector<vtkSmartPointer<vtkPolyData> > batches(numBatches);
+
+  vtkStreamTracerIntegrateBatches integrateBatches;
+  integrateBatches.Self = this;
+  integrateBatches.InputData = input0Data;
+  integrateBatches.SeedSource = seedSource;
+  integrateBatches.SeedIds = seedIds;
+  integrateBatches.IntegrationDirections = integrationDirections;
+  integrateBatches.Prototype = func;
+  integrateBatches.DataSets = &dataSets;
+  integrateBatches.MaxCellSize = maxCellSize;
+  integrateBatches.VecType = vecType;
+  integrateBatches.VecName = vecName;
+  integrateBatches.BatchSize = batchSize;
+  integrateBatches.Outputs = &batches;
+  vtkSMPTools::For(0, numBatches, 1, integrateBatches);
+
+  if ( this->GetAbortExecute() )
+  {
+    return 1;
+  }
+
+  // Append the batches
+  vtkIdType numPts = 0, numCells = 0, connSize = 0;
+  for (vtkIdType b=0; b < numBatches; b++)
+  {
+    numPts += batches[b]->GetNumberOfPoints();
+    numCells += batches[b]->GetNumberOfLines();
+    connSize += batches[b]->GetLines()->GetNumberOfConnectivityEntries();
+  }
+
+  vtkPoints *outputPoints = vtkPoints::New();
+  outputPoints->SetNumberOfPoints(numPts);
+  vtkIdTypeArray *connectivity = vtkIdTypeArray::New();
+  connectivity->SetNumberOfValues(connSize);
+  vtkIdType *conn = connectivity->GetPointer(0);
+  vtkIdType ptOffset = 0;
+  for (vtkIdType b=0; b < numBatches; b++)
+  {
+    vtkPolyData *batch = batches[b];
+    vtkIdType batchNumPts = batch->GetNumberOfPoints();
+    if ( batchNumPts > 0 )
+    {
+      outputPoints->GetData()->InsertTuples(ptOffset, batchNumPts, 0,
+                                            batch->GetPoints()->GetData());
+    }
+    vtkCellArray *lines = batch->GetLines();
+    const vtkIdType *batchConn = lines->GetPointer();
+    const vtkIdType *batchConnEnd =
+      batchConn + lines->GetNumberOfConnectivityEntries();
+    while ( batchConn < batchConnEnd )
+    {
+      vtkIdType npts = *batchConn++;
+      *conn++ = npts;
+      for (vtkIdType i=0; i < npts; i++)
+      {
+        *conn++ = *batchConn++ + ptOffset;
+      }
+    }
+    ptOffset += batchNumPts;
+  }
+  vtkCellArray *outputLines = vtkCellArray::New();
+  outputLines->SetCells(numCells, connectivity);
+  connectivity->Delete();
+
+  // The point data arrays keep the attributes of the input
+  vtkPointData *outputPD = output->GetPointData();
+  vtkPointData *batchPD = batches[0]->GetPointData();
+  for (int i=0; i < batchPD->GetNumberOfArrays(); i++)
+  {
+    AppendBatchArrays(outputPD, batchPD->GetAbstractArray(i), i, batches,
+                      true, numPts);
+    int attributeType = batchPD->IsArrayAnAttribute(i);
+    if ( attributeType >= 0 )
+    {
+      outputPD->SetActiveAttribute(outputPD->GetNumberOfArrays() - 1,
+                                   attributeType);
+    }
+  }
+
+  output->SetPoints(outputPoints);
+  if ( numPts > 1 )
+  {
+    output->SetLines(outputLines);
+    if (this->GenerateNormalsInIntegrate)
+    {
+      this->GenerateNormals(output, 0, vecName);
+    }
+
+    vtkIdType b = 0;
+    while ( b < numBatches && batches[b]->GetNumberOfLines() == 0 )
+    {
+      b++;
+    }
+    if ( b < numBatches )
+    {
+      vtkCellData *batchCD = batches[b]->GetCellData();
+      for (int i=0; i < batchCD->GetNumberOfArrays(); i++)
+      {
+        AppendBatchArrays(output->GetCellData(),
+                          batchCD->GetAbstractArray(i), i, batches,
+                          false, numCells);
+      }
+    }
+  }
+  outputPoints->Delete();
+  outputLines->Delete();
+
+  this->UpdateProgress(1.0);
+
+  output->Squeeze();
+  return 1;
+}
+
 void vtkStreamTracer::GenerateNormals(vtkPolyData* output, double* firstNormal,
                                       const char *vecName)
 {
@@ -1415,6 +1743,7 @@ void vtkStreamTracer::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Vorticity computation: "
      << (this->ComputeVorticity ? " On" : " Off") << endl;
   os << indent << "Rotation scale: " << this->RotationScale << endl;
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
 
 vtkExecutive* vtkStreamTracer::CreateDefaultExecutive()
@@ -96,6 +96,7 @@ class vtkAbstractInterpolatedVelocityField;
 
 class VTKFILTERSFLOWPATHS_EXPORT vtkStreamTracer : public vtkPolyDataAlgorithm
 {
+friend struct vtkStreamTracerIntegrateBatches;
 public:
   vtkTypeMacro(vtkStreamTracer,vtkPolyDataAlgorithm);
   void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
@@ -353,6 +354,23 @@ public:
    */
   void SetInterpolatorType( int interpType );
 
+  //@{
+  /**
+   * Turn on/off the threaded integration of the seeds (using vtkSMPTools).
+   * The seeds are then integrated concurrently in batches, each thread
+   * using its own copy of the velocity field interpolator (with its own
+   * cell cache and cell locators), and the streamlines are assembled in
+   * seed order, as in the serial output. AMR inputs, inputs whose blocks
+   * have different point data arrays, and surface streamlines with a cell
+   * locator interpolator are integrated serially. Progress is only
+   * reported at the start and the end of the integration. By default this
+   * is off.
+   */
+  vtkSetMacro(Threaded,int);
+  vtkGetMacro(Threaded,int);
+  vtkBooleanMacro(Threaded,int);
+  //@}
+
 protected:
 
   vtkStreamTracer();
@@ -383,6 +401,40 @@ protected:
                  double& propagation,
                  vtkIdType& numSteps,
                  double& integrationTime);
+
+  // Integrate the seeds beginLine <= i < endLine of seedIds into output. In
+  // threaded mode, the progress is not reported, LastUsedStepSize is not
+  // updated and the normals are not generated, so that separate batches of
+  // seeds can be integrated concurrently with separate functions.
+  void IntegrateLines(vtkPointData *inputData,
+                      vtkPolyData* output,
+                      vtkDataArray* seedSource,
+                      vtkIdList* seedIds,
+                      vtkIntArray* integrationDirections,
+                      double lastPoint[3],
+                      vtkAbstractInterpolatedVelocityField* func,
+                      int maxCellSize,
+                      int vecType,
+                      const char *vecFieldName,
+                      double& propagation,
+                      vtkIdType& numSteps,
+                      double& integrationTime,
+                      vtkIdType beginLine,
+                      vtkIdType endLine,
+                      bool threaded);
+
+  // Threaded version of Integrate(). Returns 0 if the seeds have to be
+  // integrated by the serial code.
+  int ThreadedIntegrate(vtkPointData *inputData,
+                        vtkPolyData* output,
+                        vtkDataArray* seedSource,
+                        vtkIdList* seedIds,
+                        vtkIntArray* integrationDirections,
+                        vtkAbstractInterpolatedVelocityField* func,
+                        int maxCellSize,
+                        int vecType,
+                        const char *vecFieldName);
+
   double SimpleIntegrate(double seed[3],
                          double lastPoint[3],
                          double stepSize,
@@ -441,6 +493,8 @@ protected:
 
   vtkAbstractInterpolatedVelocityField * InterpolatorPrototype;
 
+  int Threaded;
+
   vtkCompositeDataSet* InputData;
   bool HasMatchingPointAttributes; //does the point data in the multiblocks have the same attributes?
 
@@ -0,0 +1,145 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGradientFilterThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded gradients of unstructured grids and polydata are
+// the same as the serial ones, for point and cell data, with and without
+// the faster approximation.
+
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkGradientFilter.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataComparison.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+namespace
+{
+
+// Point vectors and scalars, cell vectors computed at the first point of
+// each cell
+void AddFields(vtkDataSet *data)
+{
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  for (vtkIdType ptId = 0; ptId < data->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    data->GetPoint(ptId, x);
+    vectors->InsertNextTuple3(std::sin(0.4 * x[0]) * x[2], x[1] * x[2],
+                              std::cos(0.3 * x[1]) - x[0]);
+    scalars->InsertNextValue(static_cast<float>(x[0] * x[1] + x[2]));
+  }
+  data->GetPointData()->AddArray(vectors.GetPointer());
+  data->GetPointData()->AddArray(scalars.GetPointer());
+
+  vtkNew<vtkDoubleArray> cellVectors;
+  cellVectors->SetName("CellVectors");
+  cellVectors->SetNumberOfComponents(3);
+  for (vtkIdType cellId = 0; cellId < data->GetNumberOfCells(); ++cellId)
+  {
+    cellVectors->InsertNextTuple(
+      vectors->GetTuple(data->GetCell(cellId)->GetPointId(0)));
+  }
+  data->GetCellData()->AddArray(cellVectors.GetPointer());
+}
+
+// A lattice grid with fields
+void MakeGrid(vtkUnstructuredGrid *grid, int n)
+{
+  vtkTest::MakeLatticeGrid(grid, n);
+  AddFields(grid);
+}
+
+// A wavy surface with fields
+void MakeSurface(vtkPolyData *surface, int n)
+{
+  vtkTest::MakeWavySurface(surface, n);
+  AddFields(surface);
+}
+
+bool TestInput(vtkDataSet *input, const char *name)
+{
+  // The point vectors, point scalars and cell vectors
+  const int associations[3] = { vtkDataObject::FIELD_ASSOCIATION_POINTS,
+                                vtkDataObject::FIELD_ASSOCIATION_POINTS,
+                                vtkDataObject::FIELD_ASSOCIATION_CELLS };
+  const char *arrays[3] = { "Vectors", "Scalars", "CellVectors" };
+  for (int config = 0; config < 6; ++config)
+  {
+    vtkNew<vtkGradientFilter> serial;
+    vtkNew<vtkGradientFilter> threaded;
+    threaded->ThreadedOn();
+    vtkGradientFilter *filters[2] =
+      { serial.GetPointer(), threaded.GetPointer() };
+    for (int f = 0; f < 2; ++f)
+    {
+      filters[f]->SetInputData(input);
+      filters[f]->SetInputScalars(associations[config / 2],
+                                  arrays[config / 2]);
+      filters[f]->SetFasterApproximation(config % 2);
+      if (config / 2 != 1)
+      {
+        filters[f]->ComputeVorticityOn();
+        filters[f]->ComputeQCriterionOn();
+        filters[f]->ComputeDivergenceOn();
+      }
+      // At least two threads share the points and cells
+      vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+      {
+        filters[f]->Update();
+      });
+    }
+    if (!vtkTest::SameDataSets(serial->GetOutput(), threaded->GetOutput()))
+    {
+      cerr << "Error: " << name << " configuration " << config << endl;
+      return false;
+    }
+
+    // The output does not depend on the number of threads
+    if (!vtkTest::SameOutputsWithThreads(threaded.GetPointer()))
+    {
+      cerr << "Error: " << name << " configuration " << config
+           << " with one thread" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+int TestGradientFilterThreaded(int, char *[])
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid.GetPointer(), 10);
+  vtkNew<vtkPolyData> surface;
+  MakeSurface(surface.GetPointer(), 30);
+
+  if (!TestInput(grid.GetPointer(), "vtkUnstructuredGrid") ||
+      !TestInput(surface.GetPointer(), "vtkPolyData"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
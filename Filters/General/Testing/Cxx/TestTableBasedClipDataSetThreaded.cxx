@@ -0,0 +1,229 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTableBasedClipDataSetThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded clipping of unstructured grids produces the same
+// cells as the serial one, in the order of the input cells, and that its
+// output does not depend on the number of threads.
+
+#include "vtkBitArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPlane.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkTableBasedClipDataSet.h"
+#include "vtkTestDataComparison.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+// A lattice grid with a few 2D, 1D and 0D cells, point scalars and the
+// ids of the cells
+void MakeGrid(vtkUnstructuredGrid *grid, int n)
+{
+  vtkTest::MakeLatticeGrid(grid, n);
+  vtkTest::AddLatticeLowerCells(grid, n);
+
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  pointScalars->SetNumberOfTuples(grid->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    grid->GetPoint(i, x);
+    pointScalars->SetValue(i, x[0] + 2 * x[1] - x[2]);
+  }
+  grid->GetPointData()->SetScalars(pointScalars.GetPointer());
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(grid->GetNumberOfCells());
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+  {
+    cellIds->SetValue(i, static_cast<int>(i));
+  }
+  grid->GetCellData()->AddArray(cellIds.GetPointer());
+}
+
+// An output cell: its input cell, its type, the coordinates and the scalars
+// of its points
+typedef std::vector<double> CellDescription;
+
+void DescribeCells(vtkUnstructuredGrid *grid,
+                   std::vector<CellDescription> &cells)
+{
+  vtkDataArray *cellIds = grid->GetCellData()->GetArray("CellIds");
+  vtkDataArray *scalars = grid->GetPointData()->GetArray("PointScalars");
+  vtkNew<vtkIdList> pts;
+  cells.clear();
+  for (vtkIdType c = 0; c < grid->GetNumberOfCells(); ++c)
+  {
+    CellDescription cell;
+    cell.push_back(cellIds->GetComponent(c, 0));
+    cell.push_back(grid->GetCellType(c));
+    grid->GetCellPoints(c, pts.GetPointer());
+    for (vtkIdType i = 0; i < pts->GetNumberOfIds(); ++i)
+    {
+      double x[3];
+      grid->GetPoint(pts->GetId(i), x);
+      cell.insert(cell.end(), x, x + 3);
+      cell.push_back(scalars->GetComponent(pts->GetId(i), 0));
+    }
+    cells.push_back(cell);
+  }
+}
+
+bool SameCells(vtkUnstructuredGrid *serial, vtkUnstructuredGrid *threaded)
+{
+  if (serial->GetNumberOfCells() == 0 ||
+      serial->GetNumberOfCells() != threaded->GetNumberOfCells() ||
+      serial->GetNumberOfPoints() != threaded->GetNumberOfPoints())
+  {
+    cerr << "Error: different outputs " << serial->GetNumberOfCells()
+         << " " << threaded->GetNumberOfCells() << " cells, "
+         << serial->GetNumberOfPoints() << " "
+         << threaded->GetNumberOfPoints() << " points" << endl;
+    return false;
+  }
+
+  // The threaded output follows the order of the input cells
+  std::vector<CellDescription> serialCells, threadedCells;
+  DescribeCells(serial, serialCells);
+  DescribeCells(threaded, threadedCells);
+  for (size_t c = 1; c < threadedCells.size(); ++c)
+  {
+    if (threadedCells[c][0] < threadedCells[c - 1][0])
+    {
+      cerr << "Error: cells not in input order" << endl;
+      return false;
+    }
+  }
+
+  std::sort(serialCells.begin(), serialCells.end());
+  std::sort(threadedCells.begin(), threadedCells.end());
+  for (size_t c = 0; c < serialCells.size(); ++c)
+  {
+    if (serialCells[c].size() != threadedCells[c].size())
+    {
+      cerr << "Error: different cells" << endl;
+      return false;
+    }
+    for (size_t i = 0; i < serialCells[c].size(); ++i)
+    {
+      if (std::fabs(serialCells[c][i] - threadedCells[c][i]) > 1e-6)
+      {
+        cerr << "Error: different cell " << serialCells[c][0] << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}
+
+int TestTableBasedClipDataSetThreaded(int, char *[])
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid.GetPointer(), 10);
+
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(5.1, 4.3, 4.9);
+  plane->SetNormal(1.0, 0.6, 0.3);
+
+  // Clipping by an implicit function, with both outputs
+  vtkNew<vtkTableBasedClipDataSet> serial;
+  serial->SetInputData(grid.GetPointer());
+  serial->SetClipFunction(plane.GetPointer());
+  serial->GenerateClippedOutputOn();
+  serial->Update();
+
+  vtkNew<vtkTableBasedClipDataSet> threaded;
+  threaded->SetInputData(grid.GetPointer());
+  threaded->SetClipFunction(plane.GetPointer());
+  threaded->GenerateClippedOutputOn();
+  threaded->ThreadedOn();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Update();
+  });
+
+  if (!SameCells(serial->GetOutput(), threaded->GetOutput()) ||
+      !SameCells(serial->GetClippedOutput(), threaded->GetClippedOutput()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Clipping by the point scalars
+  serial->SetClipFunction(NULL);
+  serial->SetValue(7.3);
+  serial->InsideOutOn();
+  serial->Update();
+  threaded->SetClipFunction(NULL);
+  threaded->SetValue(7.3);
+  threaded->InsideOutOn();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Update();
+  });
+
+  if (!SameCells(serial->GetOutput(), threaded->GetOutput()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // The output of several threads is the output of a single one
+  if (!vtkTest::SameOutputsWithThreads(threaded.GetPointer()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // The array lists do not process bit arrays, so inputs with bit arrays
+  // are clipped serially, into the same output
+  vtkNew<vtkBitArray> pointFlags;
+  pointFlags->SetName("PointFlags");
+  pointFlags->SetNumberOfTuples(grid->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); ++i)
+  {
+    pointFlags->SetValue(i, i % 3 == 0);
+  }
+  grid->GetPointData()->AddArray(pointFlags.GetPointer());
+  vtkNew<vtkBitArray> cellFlags;
+  cellFlags->SetName("CellFlags");
+  cellFlags->SetNumberOfTuples(grid->GetNumberOfCells());
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+  {
+    cellFlags->SetValue(i, i % 2);
+  }
+  grid->GetCellData()->AddArray(cellFlags.GetPointer());
+  serial->Update();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Update();
+  });
+  if (!vtkTest::SameDataSets(serial->GetOutput(), threaded->GetOutput()))
+  {
+    cerr << "Error: with bit arrays" << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
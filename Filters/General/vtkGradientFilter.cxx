@@ -25,6 +25,7 @@
 #include "vtkCellDataToPointData.h"
 #include "vtkDataArray.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
@@ -35,11 +36,16 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinks.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <vector>
 
 //-----------------------------------------------------------------------------
@@ -85,7 +91,7 @@ namespace
   void ComputePointGradientsUG(
     vtkDataSet *structure, data_type *array, data_type *gradients,
     int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
-    data_type* divergence);
+    data_type* divergence, bool threaded);
 
   int GetCellParametricData(
     vtkIdType pointId, double pointCoord[3], vtkCell *cell, int & subId,
@@ -95,7 +101,7 @@ namespace
   void ComputeCellGradientsUG(
     vtkDataSet *structure, data_type *array, data_type *gradients,
     int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
-    data_type* divergence);
+    data_type* divergence, bool threaded);
 
   // Functions for image data and structured grids
   template<class Grid, class data_type>
@@ -150,6 +156,7 @@ vtkGradientFilter::vtkGradientFilter()
   this->ComputeDivergence = 0;
   this->ComputeVorticity = 0;
   this->ComputeQCriterion = 0;
+  this->Threaded = 0;
   this->SetInputScalars(vtkDataObject::FIELD_ASSOCIATION_POINTS_THEN_CELLS,
                         vtkDataSetAttributes::SCALARS);
 }
@@ -181,6 +188,7 @@ void vtkGradientFilter::PrintSelf(ostream &os, vtkIndent indent)
   os << indent << "ComputeDivergence:"  << this->ComputeDivergence << endl;
   os << indent << "ComputeVorticity:" << this->ComputeVorticity << endl;
   os << indent << "ComputeQCriterion:" << this->ComputeQCriterion << endl;
+  os << indent << "Threaded:" << this->Threaded << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -412,7 +420,8 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
                            (qCriterion == NULL ? NULL :
                             static_cast<VTK_TT *>(qCriterion->GetVoidPointer(0))),
                            (divergence == NULL ? NULL :
-                            static_cast<VTK_TT *>(divergence->GetVoidPointer(0)))));
+                            static_cast<VTK_TT *>(divergence->GetVoidPointer(0))),
+                           this->Threaded != 0));
       }
       if(gradients)
       {
@@ -480,7 +489,8 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
             (qCriterion == NULL ? NULL :
              static_cast<VTK_TT *>(cellQCriterion->GetVoidPointer(0))),
             (divergence == NULL ? NULL :
-             static_cast<VTK_TT *>(cellDivergence->GetVoidPointer(0)))));
+             static_cast<VTK_TT *>(cellDivergence->GetVoidPointer(0))),
+            this->Threaded != 0));
       }
 
       // We need to convert cell Array to points Array.
@@ -561,7 +571,8 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
                          (qCriterion == NULL ? NULL :
                           static_cast<VTK_TT *>(qCriterion->GetVoidPointer(0))),
                          (divergence == NULL ? NULL :
-                          static_cast<VTK_TT *>(divergence->GetVoidPointer(0)))));
+                          static_cast<VTK_TT *>(divergence->GetVoidPointer(0))),
+                         this->Threaded != 0));
     }
 
     if(gradients)
@@ -754,13 +765,241 @@ int vtkGradientFilter::ComputeRegularGridGradient(
 }
 
 namespace {
+//-----------------------------------------------------------------------------
+  // GetCell() may only be called from several threads once it has been
+  // called from a single one
+  void PrepareThreadedGetCell(vtkDataSet *structure)
+  {
+    if (structure->GetNumberOfCells() > 0)
+    {
+      vtkNew<vtkGenericCell> cell;
+      structure->GetCell(0, cell.GetPointer());
+    }
+  }
+
+//-----------------------------------------------------------------------------
+  // Threaded version of ComputePointGradientsUG(): the cells using each
+  // point come from static links, in increasing id order
+  template<class data_type>
+  struct PointGradientsFunctor
+  {
+    vtkDataSet *Structure;
+    vtkStaticCellLinks *Links;
+    data_type *Array;
+    data_type *Gradients;
+    int NumberOfInputComponents;
+    data_type *Vorticity;
+    data_type *QCriterion;
+    data_type *Divergence;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocal<std::vector<double> > Values;
+    vtkSMPThreadLocal<std::vector<data_type> > G;
+
+    void Initialize()
+    {
+      this->Values.Local().resize(8);
+      this->G.Local().resize(3*this->NumberOfInputComponents);
+    }
+
+    void operator()(vtkIdType point, vtkIdType endPoint)
+    {
+      vtkGenericCell *cell = this->Cell.Local();
+      std::vector<double> &values = this->Values.Local();
+      std::vector<data_type> &g = this->G.Local();
+      int numberOfInputComponents = this->NumberOfInputComponents;
+      int numberOfOutputComponents = 3*numberOfInputComponents;
+
+      for ( ; point < endPoint; point++)
+      {
+        double pointcoords[3];
+        this->Structure->GetPoint(point, pointcoords);
+        vtkIdType numCellNeighbors = this->Links->GetNumberOfCells(point);
+        const vtkIdType *cellsOnPoint = this->Links->GetCells(point);
+
+        std::fill(g.begin(), g.end(), static_cast<data_type>(0));
+        for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
+        {
+          this->Structure->GetCell(cellsOnPoint[neighbor], cell);
+          int subId;
+          double parametricCoord[3];
+          if(GetCellParametricData(point, pointcoords, cell,
+                                   subId, parametricCoord))
+          {
+            int numberOfCellPoints = cell->GetNumberOfPoints();
+            if(static_cast<size_t>(numberOfCellPoints) > values.size())
+            {
+              values.resize(numberOfCellPoints);
+            }
+            for(int inputComponent=0;inputComponent<numberOfInputComponents;
+                inputComponent++)
+            {
+              for (int i = 0; i < numberOfCellPoints; i++)
+              {
+                values[i] = static_cast<double>(
+                  this->Array[cell->GetPointId(i)*numberOfInputComponents+
+                              inputComponent]);
+              }
+
+              double derivative[3];
+              cell->Derivatives(subId, parametricCoord, &values[0], 1,
+                                derivative);
+
+              g[inputComponent*3] += static_cast<data_type>(derivative[0]);
+              g[inputComponent*3+1] += static_cast<data_type>(derivative[1]);
+              g[inputComponent*3+2] += static_cast<data_type>(derivative[2]);
+            }
+          }
+        }
+
+        if (numCellNeighbors > 0)
+        {
+          for(int i=0;i<numberOfOutputComponents;i++)
+          {
+            g[i] /= numCellNeighbors;
+          }
+        }
+
+        if(this->Vorticity)
+        {
+          ComputeVorticityFromGradient(&g[0], this->Vorticity+3*point);
+        }
+        if(this->QCriterion)
+        {
+          ComputeQCriterionFromGradient(&g[0], this->QCriterion+point);
+        }
+        if(this->Divergence)
+        {
+          ComputeDivergenceFromGradient(&g[0], this->Divergence+point);
+        }
+        if(this->Gradients)
+        {
+          std::copy(g.begin(), g.end(),
+                    this->Gradients+point*numberOfOutputComponents);
+        }
+      }
+    }
+
+    void Reduce()
+    {
+    }
+  };
+
+//-----------------------------------------------------------------------------
+  // Threaded version of ComputeCellGradientsUG()
+  template<class data_type>
+  struct CellGradientsFunctor
+  {
+    vtkDataSet *Structure;
+    data_type *Array;
+    data_type *Gradients;
+    int NumberOfInputComponents;
+    data_type *Vorticity;
+    data_type *QCriterion;
+    data_type *Divergence;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocal<std::vector<double> > Values;
+    vtkSMPThreadLocal<std::vector<data_type> > CellGradients;
+
+    void Initialize()
+    {
+      this->Values.Local().resize(8);
+      this->CellGradients.Local().resize(3*this->NumberOfInputComponents);
+    }
+
+    void operator()(vtkIdType cellid, vtkIdType endCellId)
+    {
+      vtkGenericCell *cell = this->Cell.Local();
+      std::vector<double> &values = this->Values.Local();
+      std::vector<data_type> &cellGradients = this->CellGradients.Local();
+      int numberOfInputComponents = this->NumberOfInputComponents;
+
+      for ( ; cellid < endCellId; cellid++)
+      {
+        this->Structure->GetCell(cellid, cell);
+
+        double cellCenter[3];
+        int subId = cell->GetParametricCenter(cellCenter);
+
+        int numpoints = cell->GetNumberOfPoints();
+        if(static_cast<size_t>(numpoints) > values.size())
+        {
+          values.resize(numpoints);
+        }
+        double derivative[3];
+        for(int inputComponent=0;inputComponent<numberOfInputComponents;
+            inputComponent++)
+        {
+          for (int i = 0; i < numpoints; i++)
+          {
+            values[i] = static_cast<double>(
+              this->Array[cell->GetPointId(i)*numberOfInputComponents+
+                          inputComponent]);
+          }
+
+          cell->Derivatives(subId, cellCenter, &values[0], 1, derivative);
+          cellGradients[inputComponent*3] =
+            static_cast<data_type>(derivative[0]);
+          cellGradients[inputComponent*3+1] =
+            static_cast<data_type>(derivative[1]);
+          cellGradients[inputComponent*3+2] =
+            static_cast<data_type>(derivative[2]);
+        }
+        if(this->Gradients)
+        {
+          std::copy(cellGradients.begin(), cellGradients.end(),
+                    this->Gradients+cellid*3*numberOfInputComponents);
+        }
+        if(this->Vorticity)
+        {
+          ComputeVorticityFromGradient(&cellGradients[0],
+                                       this->Vorticity+3*cellid);
+        }
+        if(this->QCriterion)
+        {
+          ComputeQCriterionFromGradient(&cellGradients[0],
+                                        this->QCriterion+cellid);
+        }
+        if(this->Divergence)
+        {
+          ComputeDivergenceFromGradient(&cellGradients[0],
+                                        this->Divergence+cellid);
+        }
+      }
+    }
+
+    void Reduce()
+    {
+    }
+  };
+
 //-----------------------------------------------------------------------------
   template<class data_type>
   void ComputePointGradientsUG(
     vtkDataSet *structure, data_type *array, data_type *gradients,
     int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
-    data_type* divergence)
+    data_type* divergence, bool threaded)
   {
+    // The static links of other datasets list the cells of each point in
+    // decreasing id order, which would change the point gradients
+    if (threaded && (vtkUnstructuredGrid::SafeDownCast(structure) ||
+                     vtkPolyData::SafeDownCast(structure)))
+    {
+      vtkNew<vtkStaticCellLinks> links;
+      links->BuildLinks(structure);
+      PrepareThreadedGetCell(structure);
+      PointGradientsFunctor<data_type> functor;
+      functor.Structure = structure;
+      functor.Links = links.GetPointer();
+      functor.Array = array;
+      functor.Gradients = gradients;
+      functor.NumberOfInputComponents = numberOfInputComponents;
+      functor.Vorticity = vorticity;
+      functor.QCriterion = qCriterion;
+      functor.Divergence = divergence;
+      vtkSMPTools::For(0, structure->GetNumberOfPoints(), functor);
+      return;
+    }
+
     vtkNew<vtkIdList> currentPoint;
     currentPoint->SetNumberOfIds(1);
     vtkNew<vtkIdList> cellsOnPoint;
@@ -885,8 +1124,23 @@ namespace {
     void ComputeCellGradientsUG(
       vtkDataSet *structure, data_type *array, data_type *gradients,
       int numberOfInputComponents, data_type* vorticity,
-      data_type* qCriterion, data_type* divergence)
+      data_type* qCriterion, data_type* divergence, bool threaded)
   {
+    if (threaded)
+    {
+      PrepareThreadedGetCell(structure);
+      CellGradientsFunctor<data_type> functor;
+      functor.Structure = structure;
+      functor.Array = array;
+      functor.Gradients = gradients;
+      functor.NumberOfInputComponents = numberOfInputComponents;
+      functor.Vorticity = vorticity;
+      functor.QCriterion = qCriterion;
+      functor.Divergence = divergence;
+      vtkSMPTools::For(0, structure->GetNumberOfCells(), functor);
+      return;
+    }
+
     vtkIdType numcells = structure->GetNumberOfCells();
     std::vector<double> values(8);
     std::vector<data_type> cellGradients(3*numberOfInputComponents);
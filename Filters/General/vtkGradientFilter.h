@@ -161,6 +161,22 @@ public:
   vtkBooleanMacro(ComputeQCriterion, int);
   //@}
 
+  //@{
+  /**
+   * Compute the gradients of grids that are not a vtkImageData,
+   * vtkRectilinearGrid or vtkStructuredGrid in parallel with vtkSMPTools,
+   * for point and cell data, with or without the faster approximation.
+   * The cells using each point are found through vtkStaticCellLinks and
+   * each thread evaluates the derivatives in its own vtkGenericCell. The
+   * point gradients average the cell derivatives in the order of the
+   * cell ids, so the point gradients of datasets other than
+   * vtkUnstructuredGrid and vtkPolyData remain serial. The default is off.
+   */
+  vtkSetMacro(Threaded, int);
+  vtkGetMacro(Threaded, int);
+  vtkBooleanMacro(Threaded, int);
+  //@}
+
 protected:
   vtkGradientFilter();
   ~vtkGradientFilter() VTK_OVERRIDE;
@@ -252,6 +268,12 @@ protected:
    */
   int ComputeVorticity;
 
+  /**
+   * Flag to indicate that the gradients of unstructured data are computed
+   * with vtkSMPTools. By default Threaded is off.
+   */
+  int Threaded;
+
 private:
   vtkGradientFilter(const vtkGradientFilter &) VTK_DELETE_FUNCTION;
   void operator=(const vtkGradientFilter &) VTK_DELETE_FUNCTION;
@@ -57,6 +57,15 @@
 #include "vtkRectilinearGrid.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkGenericCell.h"
+#include "vtkArrayListTemplate.h"
+#include "vtkAtomic.h"
+#include "vtkCellPointsCursor.h"
+#include "vtkIdTypeArray.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <algorithm>
 
 #include "vtkTableBasedClipCases.h"
 
@@ -1596,6 +1605,639 @@ inline void GetPoint( double * pt, const double * X, const double * Y,
 // =============== vtkTableBasedClipperVolumeFromVolume ( end ) ===============
 // ============================================================================
 
+// ============================================================================
+// ================== vtkTableBasedClipperThreaded (begin) ====================
+// ============================================================================
+
+
+namespace
+{
+
+typedef const int vtkTableBasedClipperEdgeVertices[2];
+
+// Number of consecutive cells clipped by a task. The output does not depend
+// on it.
+const vtkIdType vtkTableBasedClipperBatchSize = 1024;
+
+// A point created on the edge (Point1, Point2) of a cell, Point1 < Point2.
+// Percent is the weight of Point1 and Index the rank of the edge among those
+// of all the batches.
+struct vtkTableBasedClipperEdge
+{
+  vtkIdType Point1;
+  vtkIdType Point2;
+  vtkIdType Index;
+  double    Percent;
+
+  bool operator < ( const vtkTableBasedClipperEdge & other ) const
+  {
+    return ( this->Point1 < other.Point1 ) ||
+           ( this->Point1 == other.Point1 && ( this->Point2 < other.Point2 ||
+           ( this->Point2 == other.Point2 && this->Index < other.Index ) ) );
+  }
+};
+
+// The output of a batch of cells. The points of the output cells and of the
+// centroid points are referred to by their input id, by the number of input
+// points plus the index of an edge of the batch, or by -1 minus the index of
+// a centroid point of the batch.
+struct vtkTableBasedClipperBatch
+{
+  std::vector< unsigned char >            CellTypes;
+  std::vector< vtkIdType >                CellIds;      // input cells
+  std::vector< vtkIdType >                Connectivity; // ( npts, pts )
+  std::vector< vtkTableBasedClipperEdge > Edges;
+  std::vector< vtkIdType >                Centroids;    // ( npts, pts )
+  vtkIdType NumberOfCentroids;
+
+  // Offsets of the batch in the output
+  vtkIdType CellOffset;
+  vtkIdType ConnectivityOffset;
+  vtkIdType EdgeOffset;
+  vtkIdType CentroidOffset;
+
+  vtkTableBasedClipperBatch() : NumberOfCentroids( 0 ), CellOffset( 0 ),
+    ConnectivityOffset( 0 ), EdgeOffset( 0 ), CentroidOffset( 0 ) { }
+};
+
+//-----------------------------------------------------------------------------
+// Whether the cells of a type are clipped by the tables
+bool vtkTableBasedClipperCanClip( int cellType )
+{
+  switch ( cellType )
+  {
+    case VTK_TETRA:
+    case VTK_PYRAMID:
+    case VTK_WEDGE:
+    case VTK_HEXAHEDRON:
+    case VTK_VOXEL:
+    case VTK_TRIANGLE:
+    case VTK_QUAD:
+    case VTK_PIXEL:
+    case VTK_LINE:
+    case VTK_VERTEX:
+      return true;
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+// The output shapes of a case of a cell, and the vertices of its edges
+void vtkTableBasedClipperGetCase( int cellType, int caseIndx,
+  const unsigned char *& thisCase, int & nOutputs,
+  vtkTableBasedClipperEdgeVertices *& edgeVtxs )
+{
+  int startIdx = 0;
+  switch ( cellType )
+  {
+    case VTK_TETRA:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesTet[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesTet[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTet[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::TetVerticesFromEdges;
+      break;
+
+    case VTK_PYRAMID:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesPyr[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesPyr[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPyr[ caseIndx ];
+      edgeVtxs =
+        vtkTableBasedClipperTriangulationTables::PyramidVerticesFromEdges;
+      break;
+
+    case VTK_WEDGE:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesWdg[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesWdg[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesWdg[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::WedgeVerticesFromEdges;
+      break;
+
+    case VTK_HEXAHEDRON:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesHex[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
+      break;
+
+    case VTK_VOXEL:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesVox[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesVox[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVox[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::VoxVerticesFromEdges;
+      break;
+
+    case VTK_TRIANGLE:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesTri[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTri[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::TriVerticesFromEdges;
+      break;
+
+    case VTK_QUAD:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesQua[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
+      break;
+
+    case VTK_PIXEL:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesPix[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesPix[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPix[ caseIndx ];
+      edgeVtxs =
+        vtkTableBasedClipperTriangulationTables::PixelVerticesFromEdges;
+      break;
+
+    case VTK_LINE:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesLin[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
+      break;
+
+    case VTK_VERTEX:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesVtx[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesVtx[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVtx[ caseIndx ];
+      edgeVtxs = NULL;
+      break;
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Difference between the clip values of the points and the iso-value
+struct vtkTableBasedClipperComputeDiffs
+{
+  vtkDataArray * ClipArray;
+  double         IsoValue;
+  double       * GrdDiffs;
+
+  void operator () ( vtkIdType ptId, vtkIdType endPtId )
+  {
+    for ( ; ptId < endPtId; ptId ++ )
+    {
+      this->GrdDiffs[ ptId ] =
+        this->ClipArray->GetComponent( ptId, 0 ) - this->IsoValue;
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Evaluation of the clip function at the points of a dataset
+struct vtkTableBasedClipperEvaluateFunction
+{
+  vtkImplicitFunction * ClipFunction;
+  vtkDataSet          * DataSet;
+  double              * Scalars;
+
+  void operator () ( vtkIdType ptId, vtkIdType endPtId )
+  {
+    double x[3];
+    for ( ; ptId < endPtId; ptId ++ )
+    {
+      this->DataSet->GetPoint( ptId, x );
+      this->Scalars[ ptId ] = this->ClipFunction->FunctionValue( x );
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Clip the batches of cells, as ClipUnstructuredGridData() does
+class vtkTableBasedClipperClipCells
+{
+public:
+  vtkTableBasedClipperClipCells( const vtkCellPointsCursor & cursor,
+    const double * grdDiffs, int insideOut,
+    vtkTableBasedClipperBatch * batches )
+    : Cursors( cursor ), GrdDiffs( grdDiffs ), InsideOut( insideOut ),
+      Batches( batches )
+  {
+    this->NumberOfPoints = cursor.GetDataSet()->GetNumberOfPoints();
+    this->NumberOfCells  = cursor.GetNumberOfCells();
+  }
+
+  void operator () ( vtkIdType batchId, vtkIdType endBatchId )
+  {
+    vtkCellPointsCursor & cursor = this->Cursors.Local();
+    for ( ; batchId < endBatchId; batchId ++ )
+    {
+      vtkTableBasedClipperBatch & batch = this->Batches[ batchId ];
+      vtkIdType cellId  = batchId * vtkTableBasedClipperBatchSize;
+      vtkIdType endCell = std::min( cellId + vtkTableBasedClipperBatchSize,
+                                    this->NumberOfCells );
+      for ( ; cellId < endCell; cellId ++ )
+      {
+        this->ClipCell( cursor, cellId, batch );
+      }
+    }
+  }
+
+private:
+  vtkSMPThreadLocal< vtkCellPointsCursor > Cursors;
+  const double * GrdDiffs;
+  int            InsideOut;
+  vtkTableBasedClipperBatch * Batches;
+  vtkIdType      NumberOfPoints;
+  vtkIdType      NumberOfCells;
+
+  void ClipCell( vtkCellPointsCursor & cursor, vtkIdType cellId,
+                 vtkTableBasedClipperBatch & batch )
+  {
+    const vtkIdType * pntIndxs = NULL;
+    vtkIdType numbPnts = cursor.GetCellPoints( cellId, pntIndxs );
+    int       cellType = cursor.GetCellType( cellId );
+
+    int    caseIndx = 0;
+    double grdDiffs[8];
+    for ( vtkIdType j = numbPnts - 1; j >= 0; j -- )
+    {
+      grdDiffs[j] = this->GrdDiffs[ pntIndxs[j] ];
+      caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
+      caseIndx  <<= (  1 - ( !j )  );
+    }
+
+    const unsigned char * thisCase = NULL;
+    int nOutputs = 0;
+    vtkTableBasedClipperEdgeVertices * edgeVtxs = NULL;
+    vtkTableBasedClipperGetCase( cellType, caseIndx, thisCase, nOutputs,
+                                 edgeVtxs );
+
+    // The edges of this cell are merged right away
+    size_t    firstEdge = batch.Edges.size();
+    vtkIdType intrpIds[4];
+    for ( int j = 0; j < nOutputs; j ++ )
+    {
+      int      nCellPts = 0;
+      int      theColor = -1;
+      int      intrpIdx = -1;
+      int      vtkType  = VTK_EMPTY_CELL;
+      unsigned char theShape = *thisCase ++;
+
+      switch ( theShape )
+      {
+        case ST_HEX: nCellPts = 8; vtkType = VTK_HEXAHEDRON; break;
+        case ST_WDG: nCellPts = 6; vtkType = VTK_WEDGE;      break;
+        case ST_PYR: nCellPts = 5; vtkType = VTK_PYRAMID;    break;
+        case ST_TET: nCellPts = 4; vtkType = VTK_TETRA;      break;
+        case ST_QUA: nCellPts = 4; vtkType = VTK_QUAD;       break;
+        case ST_TRI: nCellPts = 3; vtkType = VTK_TRIANGLE;   break;
+        case ST_LIN: nCellPts = 2; vtkType = VTK_LINE;       break;
+        case ST_VTX: nCellPts = 1; vtkType = VTK_VERTEX;     break;
+        case ST_PNT: intrpIdx = *thisCase ++;                break;
+      }
+      theColor = *thisCase ++;
+      if ( theShape == ST_PNT )
+      {
+        nCellPts = *thisCase ++;
+      }
+
+      if ( (!this->InsideOut && theColor == COLOR0 ) ||
+           ( this->InsideOut && theColor == COLOR1 )
+         )
+      {
+        // We don't want this one; it's the wrong side.
+        thisCase += nCellPts;
+        continue;
+      }
+
+      vtkIdType shapeIds[8];
+      for ( int p = 0; p < nCellPts; p ++ )
+      {
+        unsigned char pntIndex = *thisCase ++;
+
+        if ( pntIndex <= P7 )
+        {
+          shapeIds[p] = pntIndxs[ pntIndex ];
+        }
+        else
+        if ( pntIndex >= EA && pntIndex <= EL )
+        {
+          // The edges are oriented by their point ids, so that the cells
+          // sharing an edge compute the same point
+          int  pt1Index = edgeVtxs[ pntIndex-EA ][0];
+          int  pt2Index = edgeVtxs[ pntIndex-EA ][1];
+          if ( pntIndxs[ pt2Index ] < pntIndxs[ pt1Index ] )
+          {
+            std::swap( pt1Index, pt2Index );
+          }
+          double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
+          double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
+
+          vtkTableBasedClipperEdge edge;
+          edge.Point1  = pntIndxs[ pt1Index ];
+          edge.Point2  = pntIndxs[ pt2Index ];
+          edge.Index   = 0;
+          edge.Percent = 1.0 - pt1ToIso / pt1ToPt2;
+
+          size_t e = firstEdge;
+          while ( e < batch.Edges.size() &&
+                  ( batch.Edges[e].Point1 != edge.Point1 ||
+                    batch.Edges[e].Point2 != edge.Point2 ) )
+          {
+            e ++;
+          }
+          if ( e == batch.Edges.size() )
+          {
+            batch.Edges.push_back( edge );
+          }
+          shapeIds[p] = this->NumberOfPoints + static_cast< vtkIdType >( e );
+        }
+        else
+        if ( pntIndex >= N0 && pntIndex <= N3 )
+        {
+          shapeIds[p] = intrpIds[ pntIndex - N0 ];
+        }
+      }
+
+      if ( theShape == ST_PNT )
+      {
+        batch.Centroids.push_back( nCellPts );
+        batch.Centroids.insert( batch.Centroids.end(),
+                                shapeIds, shapeIds + nCellPts );
+        intrpIds[ intrpIdx ] = -1 - batch.NumberOfCentroids ++;
+      }
+      else
+      {
+        batch.CellTypes.push_back( static_cast< unsigned char >( vtkType ) );
+        batch.CellIds.push_back( cellId );
+        batch.Connectivity.push_back( nCellPts );
+        batch.Connectivity.insert( batch.Connectivity.end(),
+                                   shapeIds, shapeIds + nCellPts );
+      }
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// The numbering of the output points, shared by the functors assembling the
+// output
+struct vtkTableBasedClipperPointNumbering
+{
+  vtkTableBasedClipperBatch * Batches;
+  vtkIdType   NumberOfPoints;     // in the input
+  vtkIdType   NumberOfUsedPoints; // input points kept in the output
+  vtkIdType   CentroidStart;      // output id of the first centroid point
+  vtkIdType * PointMap;           // output ids of the input points
+  vtkIdType * EdgePointIds;       // output ids of the edges, less numUsed
+
+  vtkIdType GetOutputId( const vtkTableBasedClipperBatch & batch,
+                         vtkIdType ref ) const
+  {
+    if ( ref < 0 )
+    {
+      return this->CentroidStart + batch.CentroidOffset - 1 - ref;
+    }
+    if ( ref >= this->NumberOfPoints )
+    {
+      return this->NumberOfUsedPoints + this->EdgePointIds
+        [ batch.EdgeOffset + ref - this->NumberOfPoints ];
+    }
+    return this->PointMap[ ref ];
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Gather the edges of the batches, ranked in the order of the cells
+struct vtkTableBasedClipperGatherEdges
+{
+  vtkTableBasedClipperBatch * Batches;
+  vtkTableBasedClipperEdge  * Edges;
+
+  void operator () ( vtkIdType batchId, vtkIdType endBatchId )
+  {
+    for ( ; batchId < endBatchId; batchId ++ )
+    {
+      const vtkTableBasedClipperBatch & batch = this->Batches[ batchId ];
+      for ( size_t e = 0; e < batch.Edges.size(); e ++ )
+      {
+        vtkTableBasedClipperEdge & edge = this->Edges[ batch.EdgeOffset + e ];
+        edge = batch.Edges[e];
+        edge.Index = batch.EdgeOffset + static_cast< vtkIdType >( e );
+      }
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Flag the first of the sorted edges sharing the same points
+struct vtkTableBasedClipperFlagEdges
+{
+  const vtkTableBasedClipperEdge * Edges;
+  vtkIdType * Firsts;
+
+  void operator () ( vtkIdType i, vtkIdType end )
+  {
+    for ( ; i < end; i ++ )
+    {
+      this->Firsts[i] = ( i == 0 || this->Edges[i].Point1 != this->Edges[i-1].Point1 ||
+                          this->Edges[i].Point2 != this->Edges[i-1].Point2 ) ? 1 : 0;
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Map the edges of the batches to the merged edges
+struct vtkTableBasedClipperMapEdges
+{
+  const vtkTableBasedClipperEdge * Edges;
+  const vtkIdType * Firsts;
+  const vtkIdType * MergedIds;
+  vtkIdType * EdgePointIds;
+  vtkIdType * MergedEdges; // the first sorted edge of each merged edge
+
+  void operator () ( vtkIdType i, vtkIdType end )
+  {
+    for ( ; i < end; i ++ )
+    {
+      this->EdgePointIds[ this->Edges[i].Index ] =
+        this->MergedIds[i] + this->Firsts[i] - 1;
+      if ( this->Firsts[i] )
+      {
+        this->MergedEdges[ this->MergedIds[i] ] = i;
+      }
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Flag the input points used by the output
+struct vtkTableBasedClipperMarkPoints
+{
+  vtkTableBasedClipperBatch * Batches;
+  vtkIdType                   NumberOfPoints;
+  vtkAtomic< vtkIdType >    * Used;
+
+  void Mark( const std::vector< vtkIdType > & list )
+  {
+    for ( size_t i = 0; i < list.size(); i += list[i] + 1 )
+    {
+      for ( vtkIdType p = 1; p <= list[i]; p ++ )
+      {
+        vtkIdType ref = list[ i + p ];
+        // Most points are shared: avoid the atomic writes
+        if ( ref >= 0 && ref < this->NumberOfPoints && !this->Used[ ref ] )
+        {
+          this->Used[ ref ] = 1;
+        }
+      }
+    }
+  }
+
+  void operator () ( vtkIdType batchId, vtkIdType endBatchId )
+  {
+    for ( ; batchId < endBatchId; batchId ++ )
+    {
+      this->Mark( this->Batches[ batchId ].Connectivity );
+      this->Mark( this->Batches[ batchId ].Centroids );
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Copy the input points used by the output
+struct vtkTableBasedClipperCopyPoints
+{
+  vtkAtomic< vtkIdType > * Used;
+  const vtkIdType * PointMap;
+  vtkPoints * InPts;
+  vtkPoints * OutPts;
+  ArrayList * Arrays;
+
+  void operator () ( vtkIdType ptId, vtkIdType endPtId )
+  {
+    double x[3];
+    for ( ; ptId < endPtId; ptId ++ )
+    {
+      if ( this->Used[ ptId ] )
+      {
+        this->InPts->GetPoint( ptId, x );
+        this->OutPts->SetPoint( this->PointMap[ ptId ], x );
+        this->Arrays->Copy( ptId, this->PointMap[ ptId ] );
+      }
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Interpolate the points of the merged edges
+struct vtkTableBasedClipperInterpolateEdges
+{
+  const vtkTableBasedClipperEdge * Edges;
+  const vtkIdType * MergedEdges;
+  vtkIdType   NumberOfUsedPoints;
+  vtkPoints * InPts;
+  vtkPoints * OutPts;
+  ArrayList * Arrays;
+
+  void operator () ( vtkIdType i, vtkIdType end )
+  {
+    double pt1[3], pt2[3], pt[3];
+    for ( ; i < end; i ++ )
+    {
+      const vtkTableBasedClipperEdge & edge = this->Edges[ this->MergedEdges[i] ];
+      this->InPts->GetPoint( edge.Point1, pt1 );
+      this->InPts->GetPoint( edge.Point2, pt2 );
+      double p  = edge.Percent;
+      double bp = 1.0 - p;
+      pt[0] = pt1[0] * p + pt2[0] * bp;
+      pt[1] = pt1[1] * p + pt2[1] * bp;
+      pt[2] = pt1[2] * p + pt2[2] * bp;
+      vtkIdType ptIdx = this->NumberOfUsedPoints + i;
+      this->OutPts->SetPoint( ptIdx, pt );
+      this->Arrays->InterpolateEdge( edge.Point1, edge.Point2, bp, ptIdx );
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Interpolate the centroid points from the output points, in the order of
+// their creation since they may depend on each other
+struct vtkTableBasedClipperInterpolateCentroids
+{
+  const vtkTableBasedClipperPointNumbering * Numbering;
+  vtkPoints * OutPts;
+  ArrayList * Arrays;
+
+  void operator () ( vtkIdType batchId, vtkIdType endBatchId )
+  {
+    vtkIdType ids[8];
+    double    weights[8];
+    double    pts[3];
+    for ( ; batchId < endBatchId; batchId ++ )
+    {
+      const vtkTableBasedClipperBatch & batch =
+        this->Numbering->Batches[ batchId ];
+      vtkIdType ptIdx = this->Numbering->CentroidStart + batch.CentroidOffset;
+      for ( size_t i = 0; i < batch.Centroids.size();
+            i += batch.Centroids[i] + 1, ptIdx ++ )
+      {
+        int    nPts = static_cast< int >( batch.Centroids[i] );
+        double weight_factor = 1.0 / nPts;
+        double pt[3] = { 0.0, 0.0, 0.0 };
+        for ( int k = 0; k < nPts; k ++ )
+        {
+          ids[k] = this->Numbering->GetOutputId
+                   ( batch, batch.Centroids[ i + 1 + k ] );
+          weights[k] = weight_factor;
+          this->OutPts->GetPoint( ids[k], pts );
+          pt[0] += pts[0];
+          pt[1] += pts[1];
+          pt[2] += pts[2];
+        }
+        pt[0] *= weight_factor;
+        pt[1] *= weight_factor;
+        pt[2] *= weight_factor;
+        this->OutPts->SetPoint( ptIdx, pt );
+        this->Arrays->Interpolate( nPts, ids, weights, ptIdx );
+      }
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Fill the output cells and their data
+struct vtkTableBasedClipperBuildCells
+{
+  const vtkTableBasedClipperPointNumbering * Numbering;
+  vtkIdType     * Connectivity;
+  vtkIdType     * Locations;
+  unsigned char * Types;
+  ArrayList     * Arrays;
+
+  void operator () ( vtkIdType batchId, vtkIdType endBatchId )
+  {
+    for ( ; batchId < endBatchId; batchId ++ )
+    {
+      const vtkTableBasedClipperBatch & batch =
+        this->Numbering->Batches[ batchId ];
+      vtkIdType cellId = batch.CellOffset;
+      vtkIdType loc    = batch.ConnectivityOffset;
+      const vtkIdType * conn = batch.Connectivity.empty() ? NULL :
+                               &batch.Connectivity[0];
+      for ( size_t c = 0; c < batch.CellTypes.size(); c ++, cellId ++ )
+      {
+        vtkIdType npts = *conn ++;
+        this->Types[ cellId ]     = batch.CellTypes[c];
+        this->Locations[ cellId ] = loc;
+        this->Connectivity[ loc ++ ] = npts;
+        for ( vtkIdType p = 0; p < npts; p ++ )
+        {
+          this->Connectivity[ loc ++ ] =
+            this->Numbering->GetOutputId( batch, *conn ++ );
+        }
+        this->Arrays->Copy( batch.CellIds[c], cellId );
+      }
+    }
+  }
+};
+
+}
+
+// ============================================================================
+// =================== vtkTableBasedClipperThreaded ( end ) ===================
+// ============================================================================
+
+
 
 //-----------------------------------------------------------------------------
 // Construct with user-specified implicit function; InsideOut turned off; value
@@ -1619,6 +2261,7 @@ vtkTableBasedClipDataSet::vtkTableBasedClipDataSet( vtkImplicitFunction * cf )
   this->GenerateClippedOutput = 0;
 
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->Threaded              = 0;
 
   this->SetNumberOfOutputPorts( 2 );
   vtkUnstructuredGrid * output2 = vtkUnstructuredGrid::New();
@@ -1810,10 +2453,22 @@ int vtkTableBasedClipDataSet::RequestData( vtkInformation * vtkNotUsed( request
       cpyInput->GetPointData()->SetScalars( pScalars );
     }
 
-    for ( i = 0; i < numbPnts; i ++ )
+    if ( this->Threaded )
     {
-      double s = this->ClipFunction->FunctionValue(  cpyInput->GetPoint( i )  );
-      pScalars->SetTuple1( i, s );
+      // Make the later calls to GetPoint() thread safe
+      double x[3];
+      cpyInput->GetPoint( 0, x );
+      vtkTableBasedClipperEvaluateFunction evaluateFunction =
+        { this->ClipFunction, cpyInput.GetPointer(), pScalars->GetPointer( 0 ) };
+      vtkSMPTools::For( 0, numbPnts, evaluateFunction );
+    }
+    else
+    {
+      for ( i = 0; i < numbPnts; i ++ )
+      {
+        double s = this->ClipFunction->FunctionValue(  cpyInput->GetPoint( i )  );
+        pScalars->SetTuple1( i, s );
+      }
     }
 
     clipAray = pScalars;
@@ -3021,6 +3676,13 @@ void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
 void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
      vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
 {
+  if ( this->Threaded &&
+       this->ThreadedClipUnstructuredGridData( inputGrd, clipAray, isoValue,
+                                               outputUG ) )
+  {
+    return;
+  }
+
   vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
 
   vtkIdType   i, j;
@@ -3423,6 +4085,193 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
   unstruct = NULL;
 }
 
+//-----------------------------------------------------------------------------
+int vtkTableBasedClipDataSet::ThreadedClipUnstructuredGridData
+  ( vtkDataSet * inputGrd, vtkDataArray * clipAray, double isoValue,
+    vtkUnstructuredGrid * outputUG )
+{
+  vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
+
+  vtkIdType     i;
+  vtkIdType     numbPnts = unstruct->GetNumberOfPoints();
+  vtkIdType     numCells = unstruct->GetNumberOfCells();
+  vtkPointData * inPD    = unstruct->GetPointData();
+  vtkCellData  * inCD    = unstruct->GetCellData();
+
+  // The attributes are processed by array lists, and the cells need to be
+  // handled by the clip tables
+  if ( numCells < 1 || inPD->GetArray( "avtOriginalNodeNumbers" ) ||
+       !ArrayList::HasNamedDataArrays( inPD ) ||
+       !ArrayList::HasNamedDataArrays( inCD ) )
+  {
+    return 0;
+  }
+  const unsigned char * inTypes =
+    unstruct->GetCellTypesArray()->GetPointer( 0 );
+  for ( i = 0; i < numCells; i ++ )
+  {
+    if ( !vtkTableBasedClipperCanClip( inTypes[i] ) )
+    {
+      return 0;
+    }
+  }
+
+  std::vector< double > grdDiffs( numbPnts );
+  vtkTableBasedClipperComputeDiffs computeDiffs =
+    { clipAray, isoValue, &grdDiffs[0] };
+  vtkSMPTools::For( 0, numbPnts, computeDiffs );
+
+  // Clip the batches of cells
+  vtkIdType numBatches = ( numCells - 1 ) / vtkTableBasedClipperBatchSize + 1;
+  std::vector< vtkTableBasedClipperBatch > batches( numBatches );
+  vtkCellPointsCursor cursor( unstruct );
+  vtkTableBasedClipperClipCells clipCells
+    ( cursor, &grdDiffs[0], this->InsideOut, &batches[0] );
+  vtkSMPTools::For( 0, numBatches, 1, clipCells );
+
+  // Place the outputs of the batches in the order of the cells
+  vtkIdType numOutCells  = 0;
+  vtkIdType connSize     = 0;
+  vtkIdType numEdges     = 0;
+  vtkIdType numCentroids = 0;
+  for ( i = 0; i < numBatches; i ++ )
+  {
+    vtkTableBasedClipperBatch & batch = batches[i];
+    batch.CellOffset         = numOutCells;
+    batch.ConnectivityOffset = connSize;
+    batch.EdgeOffset         = numEdges;
+    batch.CentroidOffset     = numCentroids;
+    numOutCells  += static_cast< vtkIdType >( batch.CellTypes.size() );
+    connSize     += static_cast< vtkIdType >( batch.Connectivity.size() );
+    numEdges     += static_cast< vtkIdType >( batch.Edges.size() );
+    numCentroids += batch.NumberOfCentroids;
+  }
+
+  // Merge the points created on the same edge by different cells. Sorted,
+  // the edges sharing the same points are consecutive, and the merged edges
+  // are numbered in the order of their points.
+  std::vector< vtkTableBasedClipperEdge > edges( numEdges );
+  std::vector< vtkIdType > edgePointIds( numEdges );
+  std::vector< vtkIdType > mergedEdges;
+  vtkIdType numEdgePts = 0;
+  if ( numEdges > 0 )
+  {
+    vtkTableBasedClipperGatherEdges gatherEdges = { &batches[0], &edges[0] };
+    vtkSMPTools::For( 0, numBatches, 1, gatherEdges );
+    vtkSMPTools::Sort( edges.begin(), edges.end() );
+
+    std::vector< vtkIdType > firsts( numEdges );
+    std::vector< vtkIdType > mergedIds( numEdges );
+    vtkTableBasedClipperFlagEdges flagEdges = { &edges[0], &firsts[0] };
+    vtkSMPTools::For( 0, numEdges, flagEdges );
+    vtkSMPTools::ExclusiveScan( firsts.begin(), firsts.end(),
+                                mergedIds.begin(), static_cast< vtkIdType >( 0 ) );
+    numEdgePts = mergedIds[ numEdges - 1 ] + firsts[ numEdges - 1 ];
+
+    mergedEdges.resize( numEdgePts );
+    vtkTableBasedClipperMapEdges mapEdges = { &edges[0], &firsts[0],
+      &mergedIds[0], &edgePointIds[0], &mergedEdges[0] };
+    vtkSMPTools::For( 0, numEdges, mapEdges );
+  }
+
+  // Keep the input points used by the output, in their order
+  vtkAtomic< vtkIdType > * used = new vtkAtomic< vtkIdType >[ numbPnts ];
+  vtkTableBasedClipperMarkPoints markPoints = { &batches[0], numbPnts, used };
+  vtkSMPTools::For( 0, numBatches, 1, markPoints );
+  std::vector< vtkIdType > pointMap( numbPnts );
+  vtkSMPTools::ExclusiveScan( used, used + numbPnts, pointMap.begin(),
+                              static_cast< vtkIdType >( 0 ) );
+  vtkIdType numUsed = pointMap[ numbPnts - 1 ] + used[ numbPnts - 1 ];
+
+  vtkTableBasedClipperPointNumbering numbering;
+  numbering.Batches            = &batches[0];
+  numbering.NumberOfPoints     = numbPnts;
+  numbering.NumberOfUsedPoints = numUsed;
+  numbering.CentroidStart      = numUsed + numEdgePts;
+  numbering.PointMap           = &pointMap[0];
+  numbering.EdgePointIds       = numEdges > 0 ? &edgePointIds[0] : NULL;
+
+  //
+  // Set up the output points and its point data.
+  //
+  vtkPoints * inputPts = unstruct->GetPoints();
+  vtkPoints * outPts   = vtkPoints::New();
+  if ( this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION )
+  {
+    outPts->SetDataType( inputPts->GetDataType() );
+  }
+  else if ( this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION )
+  {
+    outPts->SetDataType( VTK_FLOAT );
+  }
+  else if ( this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION )
+  {
+    outPts->SetDataType( VTK_DOUBLE );
+  }
+
+  vtkIdType nOutPts = numbering.CentroidStart + numCentroids;
+  outPts->SetNumberOfPoints( nOutPts );
+  vtkPointData * outPD = outputUG->GetPointData();
+  outPD->CopyAllocate( inPD, nOutPts );
+  ArrayList pointArrays;
+  pointArrays.AddArrays( nOutPts, inPD, outPD, 0.0, false );
+
+  vtkTableBasedClipperCopyPoints copyPoints =
+    { used, &pointMap[0], inputPts, outPts, &pointArrays };
+  vtkSMPTools::For( 0, numbPnts, copyPoints );
+  delete [] used;
+
+  if ( numEdgePts > 0 )
+  {
+    vtkTableBasedClipperInterpolateEdges interpolateEdges =
+      { &edges[0], &mergedEdges[0], numUsed, inputPts, outPts, &pointArrays };
+    vtkSMPTools::For( 0, numEdgePts, interpolateEdges );
+  }
+
+  if ( numCentroids > 0 )
+  {
+    ArrayList centroidArrays;
+    centroidArrays.AddSelfInterpolatingArrays( nOutPts, outPD );
+    vtkTableBasedClipperInterpolateCentroids interpolateCentroids =
+      { &numbering, outPts, &centroidArrays };
+    vtkSMPTools::For( 0, numBatches, 1, interpolateCentroids );
+  }
+
+  outputUG->SetPoints( outPts );
+  outPts->Delete();
+
+  //
+  // Now set up the shapes and the cell data.
+  //
+  vtkCellData * outCD = outputUG->GetCellData();
+  outCD->CopyAllocate( inCD, numOutCells );
+  ArrayList cellArrays;
+  cellArrays.AddArrays( numOutCells, inCD, outCD, 0.0, false );
+
+  vtkIdTypeArray * nlist = vtkIdTypeArray::New();
+  nlist->SetNumberOfValues( connSize );
+  vtkUnsignedCharArray * cellTypes = vtkUnsignedCharArray::New();
+  cellTypes->SetNumberOfValues( numOutCells );
+  vtkIdTypeArray * cellLocations = vtkIdTypeArray::New();
+  cellLocations->SetNumberOfValues( numOutCells );
+
+  vtkTableBasedClipperBuildCells buildCells = { &numbering,
+    nlist->GetPointer( 0 ), cellLocations->GetPointer( 0 ),
+    cellTypes->GetPointer( 0 ), &cellArrays };
+  vtkSMPTools::For( 0, numBatches, 1, buildCells );
+
+  vtkCellArray * cells = vtkCellArray::New();
+  cells->SetCells( numOutCells, nlist );
+  nlist->Delete();
+
+  outputUG->SetCells( cellTypes, cellLocations, cells );
+  cellTypes->Delete();
+  cellLocations->Delete();
+  cells->Delete();
+
+  return 1;
+}
+
 //-----------------------------------------------------------------------------
 void vtkTableBasedClipDataSet::PrintSelf( ostream & os, vtkIndent indent )
 {
@@ -3459,4 +4308,6 @@ void vtkTableBasedClipDataSet::PrintSelf( ostream & os, vtkIndent indent )
 
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
+
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
@@ -228,6 +228,23 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   //@}
 
+  //@{
+  /**
+   * Set/Get whether unstructured grids are clipped in parallel, with
+   * vtkSMPTools. The cells are clipped in batches, the new points on the
+   * edges are merged through a parallel sort of the edges, and the output
+   * is assembled in parallel. The output cells follow the order of the input
+   * cells, and the output does not depend on the number of threads. The clip
+   * function, if any, is evaluated in parallel as well and must be thread
+   * safe, as are vtkPlane, vtkBox or vtkSphere. Grids with cells of other
+   * types than the linear cells handled by the clip tables are clipped
+   * serially. Default is off.
+   */
+  vtkSetMacro(Threaded, int);
+  vtkGetMacro(Threaded, int);
+  vtkBooleanMacro(Threaded, int);
+  //@}
+
 protected:
   vtkTableBasedClipDataSet( vtkImplicitFunction * cf = NULL );
   ~vtkTableBasedClipDataSet() VTK_OVERRIDE;
@@ -287,6 +304,16 @@ protected:
   void ClipUnstructuredGridData( vtkDataSet * inputGrd, vtkDataArray * clipAray,
                                  double isoValue, vtkUnstructuredGrid * outputUG );
 
+  /**
+   * This function clips a vtkUnstructuredGrid in parallel, as
+   * ClipUnstructuredGridData(......) does serially. It returns 0, without
+   * any output, if the grid has cells that it cannot clip.
+   */
+  int ThreadedClipUnstructuredGridData( vtkDataSet * inputGrd,
+                                        vtkDataArray * clipAray,
+                                        double isoValue,
+                                        vtkUnstructuredGrid * outputUG );
+
 
   /**
    * Register a callback function with the InternalProgressObserver.
@@ -311,6 +338,7 @@ protected:
   vtkIncrementalPointLocator * Locator;
 
   int OutputPointsPrecision;
+  int Threaded;
 
 private:
   vtkTableBasedClipDataSet( const vtkTableBasedClipDataSet &) VTK_DELETE_FUNCTION;
@@ -0,0 +1,102 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceFilterThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded extraction of the surface of unstructured grids
+// produces the same output as the serial one.
+
+#include "vtkCellData.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataComparison.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+
+// A lattice grid with point and cell scalars
+void MakeGrid(vtkUnstructuredGrid *grid, int n)
+{
+  vtkTest::MakeLatticeGrid(grid, n);
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  pointScalars->SetNumberOfTuples(grid->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); ++i)
+  {
+    pointScalars->SetValue(i, 0.5 * i);
+  }
+  grid->GetPointData()->SetScalars(pointScalars.GetPointer());
+  vtkNew<vtkIntArray> cellScalars;
+  cellScalars->SetName("CellScalars");
+  cellScalars->SetNumberOfTuples(grid->GetNumberOfCells());
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+  {
+    cellScalars->SetValue(i, static_cast<int>(3 * i));
+  }
+  grid->GetCellData()->SetScalars(cellScalars.GetPointer());
+}
+
+}
+
+int TestDataSetSurfaceFilterThreaded(int, char *[])
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid.GetPointer(), 12);
+
+  vtkNew<vtkDataSetSurfaceFilter> serial;
+  serial->SetInputData(grid.GetPointer());
+  serial->PassThroughCellIdsOn();
+  serial->PassThroughPointIdsOn();
+  serial->Update();
+
+  vtkNew<vtkDataSetSurfaceFilter> threaded;
+  threaded->SetInputData(grid.GetPointer());
+  threaded->PassThroughCellIdsOn();
+  threaded->PassThroughPointIdsOn();
+  threaded->ThreadedOn();
+
+  // The surface extracted by several threads is the one of a single thread
+  if (!vtkTest::SameOutputsWithThreads(threaded.GetPointer()))
+  {
+    return EXIT_FAILURE;
+  }
+  if (serial->GetOutput()->GetNumberOfCells() == 0 ||
+      !vtkTest::SameDataSets(serial->GetOutput(), threaded->GetOutput()))
+  {
+    cerr << "Error: different surfaces" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // A grid of hexahedra only has its outer faces
+  vtkNew<vtkUnstructuredGrid> hexes;
+  const int hexahedron = VTK_HEXAHEDRON;
+  vtkTest::MakeLatticeGrid(hexes.GetPointer(), 4, &hexahedron, 1);
+  threaded->SetInputData(hexes.GetPointer());
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    threaded->Update();
+  });
+  if (threaded->GetOutput()->GetNumberOfPolys() != 6 * 16 ||
+      threaded->GetOutput()->GetNumberOfPoints() != 5 * 5 * 5 - 3 * 3 * 3)
+  {
+    cerr << "Error: wrong surface of hexahedra "
+         << threaded->GetOutput()->GetNumberOfPolys() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
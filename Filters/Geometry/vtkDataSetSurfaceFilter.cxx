@@ -15,9 +15,11 @@
 #include "vtkDataSetSurfaceFilter.h"
 
 #include "vtkCell.h"
+#include "vtkAtomic.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
+#include "vtkCellPointsCursor.h"
 #include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
 #include "vtkHexahedron.h"
@@ -31,6 +33,8 @@
 #include "vtkPolyData.h"
 #include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGridGeometryFilter.h"
@@ -47,6 +51,7 @@
 #include "vtkStructuredData.h"
 
 #include <algorithm>
+#include <vector>
 #include <vtksys/hash_map.hxx>
 
 #include <cassert>
@@ -100,6 +105,259 @@ protected:
   MapType Map;
 };
 
+//----------------------------------------------------------------------------
+// Parallel extraction of the surface of unstructured grids of linear 3D
+// cells. A face is identified by its cell and its index in the cell, packed
+// as 8*cellId+faceId, and goes to the bin of its smallest point id. The
+// faces of a bin are sorted, which gives the order in which the serial code
+// inserts them in its hash, then compared to find the shared ones.
+namespace
+{
+
+// Faces as inserted in the hash by UnstructuredGridExecute()
+const int vtkSurfaceTetraFaces[4][4] = {
+  {0,1,3,-1}, {0,2,1,-1}, {0,3,2,-1}, {1,2,3,-1} };
+const int vtkSurfaceHexFaces[6][4] = {
+  {0,1,5,4}, {0,3,2,1}, {0,4,7,3}, {1,2,6,5}, {2,3,7,6}, {4,5,6,7} };
+const int vtkSurfaceVoxelFaces[6][4] = {
+  {0,1,5,4}, {0,2,3,1}, {0,4,6,2}, {1,3,7,5}, {2,6,7,3}, {4,5,7,6} };
+
+// Number of faces of the cells extracted in parallel, 0 for other cells
+int vtkSurfaceNumberOfFaces(int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_TETRA:
+      return 4;
+    case VTK_WEDGE:
+    case VTK_PYRAMID:
+      return 5;
+    case VTK_HEXAHEDRON:
+    case VTK_VOXEL:
+      return 6;
+    default:
+      return 0;
+  }
+}
+
+// Get the points of a face, reordered as by InsertTriInHash() and
+// InsertQuadInHash(), and return their number.
+int vtkSurfaceGetFace(int cellType, const vtkIdType *ids, int faceId,
+                      vtkIdType pts[4])
+{
+  const int *face;
+  switch (cellType)
+  {
+    case VTK_TETRA:
+      face = vtkSurfaceTetraFaces[faceId];
+      break;
+    case VTK_HEXAHEDRON:
+      face = vtkSurfaceHexFaces[faceId];
+      break;
+    case VTK_VOXEL:
+      face = vtkSurfaceVoxelFaces[faceId];
+      break;
+    case VTK_WEDGE:
+      face = vtkWedge::GetFaceArray(faceId);
+      break;
+    default:
+      face = vtkPyramid::GetFaceArray(faceId);
+      break;
+  }
+
+  vtkIdType a = ids[face[0]];
+  vtkIdType b = ids[face[1]];
+  vtkIdType c = ids[face[2]];
+  if (face[3] < 0)
+  {
+    if (b < a && b < c)
+    {
+      pts[0] = b; pts[1] = c; pts[2] = a;
+    }
+    else if (c < a && c < b)
+    {
+      pts[0] = c; pts[1] = a; pts[2] = b;
+    }
+    else
+    {
+      pts[0] = a; pts[1] = b; pts[2] = c;
+    }
+    return 3;
+  }
+
+  vtkIdType d = ids[face[3]];
+  if (b < a && b < c && b < d)
+  {
+    pts[0] = b; pts[1] = c; pts[2] = d; pts[3] = a;
+  }
+  else if (c < a && c < b && c < d)
+  {
+    pts[0] = c; pts[1] = d; pts[2] = a; pts[3] = b;
+  }
+  else if (d < a && d < b && d < c)
+  {
+    pts[0] = d; pts[1] = a; pts[2] = b; pts[3] = c;
+  }
+  else
+  {
+    pts[0] = a; pts[1] = b; pts[2] = c; pts[3] = d;
+  }
+  return 4;
+}
+
+// Whether two faces of the same bin match, as in the hash
+bool vtkSurfaceSameFace(vtkIdType numPts1, const vtkIdType *pts1,
+                        vtkIdType numPts2, const vtkIdType *pts2)
+{
+  if (numPts1 != numPts2)
+  {
+    return false;
+  }
+  if (numPts1 == 4)
+  {
+    return pts1[2] == pts2[2] &&
+      ((pts1[1] == pts2[1] && pts1[3] == pts2[3]) ||
+       (pts1[1] == pts2[3] && pts1[3] == pts2[1]));
+  }
+  return (pts1[1] == pts2[1] && pts1[2] == pts2[2]) ||
+    (pts1[1] == pts2[2] && pts1[2] == pts2[1]);
+}
+
+// Count the faces of each bin
+struct vtkSurfaceCountFaces
+{
+  vtkSMPThreadLocal<vtkCellPointsCursor> Cursors;
+  vtkAtomic<vtkIdType> *Counts;
+
+  vtkSurfaceCountFaces(const vtkCellPointsCursor &cursor,
+                       vtkAtomic<vtkIdType> *counts) :
+    Cursors(cursor), Counts(counts)
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkCellPointsCursor &cursor = this->Cursors.Local();
+    const vtkIdType *ids;
+    vtkIdType pts[4];
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      int cellType = cursor.GetCellType(cellId);
+      cursor.GetCellPoints(cellId, ids);
+      int numFaces = vtkSurfaceNumberOfFaces(cellType);
+      for (int faceId = 0; faceId < numFaces; ++faceId)
+      {
+        vtkSurfaceGetFace(cellType, ids, faceId, pts);
+        ++this->Counts[pts[0]];
+      }
+    }
+  }
+};
+
+// Start the insertion positions of the bins at their offsets
+struct vtkSurfaceStartPositions
+{
+  const vtkIdType *Offsets;
+  vtkAtomic<vtkIdType> *Positions;
+
+  void operator()(vtkIdType bin, vtkIdType endBin)
+  {
+    for ( ; bin < endBin; ++bin)
+    {
+      this->Positions[bin] = this->Offsets[bin];
+    }
+  }
+};
+
+// Insert the faces in their bins
+struct vtkSurfaceInsertFaces
+{
+  vtkSMPThreadLocal<vtkCellPointsCursor> Cursors;
+  vtkAtomic<vtkIdType> *Positions;
+  vtkIdType *Faces;
+
+  vtkSurfaceInsertFaces(const vtkCellPointsCursor &cursor,
+                        vtkAtomic<vtkIdType> *positions, vtkIdType *faces) :
+    Cursors(cursor), Positions(positions), Faces(faces)
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkCellPointsCursor &cursor = this->Cursors.Local();
+    const vtkIdType *ids;
+    vtkIdType pts[4];
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      int cellType = cursor.GetCellType(cellId);
+      cursor.GetCellPoints(cellId, ids);
+      int numFaces = vtkSurfaceNumberOfFaces(cellType);
+      for (int faceId = 0; faceId < numFaces; ++faceId)
+      {
+        vtkSurfaceGetFace(cellType, ids, faceId, pts);
+        this->Faces[this->Positions[pts[0]]++] = 8 * cellId + faceId;
+      }
+    }
+  }
+};
+
+// Sort the faces of each bin and replace the shared ones by -1
+struct vtkSurfaceResolveFaces
+{
+  vtkSMPThreadLocal<vtkCellPointsCursor> Cursors;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Points;
+  const vtkIdType *Offsets;
+  vtkIdType *Faces;
+
+  vtkSurfaceResolveFaces(const vtkCellPointsCursor &cursor,
+                         const vtkIdType *offsets, vtkIdType *faces) :
+    Cursors(cursor), Offsets(offsets), Faces(faces)
+  {
+  }
+
+  void operator()(vtkIdType bin, vtkIdType endBin)
+  {
+    vtkCellPointsCursor &cursor = this->Cursors.Local();
+    std::vector<vtkIdType> &points = this->Points.Local();
+    const vtkIdType *ids;
+    for ( ; bin < endBin; ++bin)
+    {
+      vtkIdType *faces = this->Faces + this->Offsets[bin];
+      vtkIdType numFaces = this->Offsets[bin + 1] - this->Offsets[bin];
+      if (numFaces < 2)
+      {
+        continue;
+      }
+      std::sort(faces, faces + numFaces);
+
+      // Number of points, then points of each face
+      points.resize(5 * numFaces);
+      for (vtkIdType i = 0; i < numFaces; ++i)
+      {
+        vtkIdType cellId = faces[i] / 8;
+        cursor.GetCellPoints(cellId, ids);
+        points[5 * i] = vtkSurfaceGetFace(cursor.GetCellType(cellId), ids,
+                                          static_cast<int>(faces[i] % 8),
+                                          &points[5 * i + 1]);
+      }
+      for (vtkIdType i = 0; i < numFaces; ++i)
+      {
+        for (vtkIdType j = 0; j < numFaces; ++j)
+        {
+          if (j != i && vtkSurfaceSameFace(points[5 * i], &points[5 * i + 1],
+                                           points[5 * j], &points[5 * j + 1]))
+          {
+            faces[i] = -1;
+            break;
+          }
+        }
+      }
+    }
+  }
+};
+
+}
+
 vtkStandardNewMacro(vtkDataSetSurfaceFilter);
 
 //----------------------------------------------------------------------------
@@ -110,6 +368,7 @@ vtkDataSetSurfaceFilter::vtkDataSetSurfaceFilter()
   this->EdgeMap = NULL;
   this->QuadHashLength = 0;
   this->UseStrips = 0;
+  this->Threaded = 0;
   this->NumberOfNewCells = 0;
 
   // Quad allocation stuff.
@@ -1433,6 +1692,7 @@ void vtkDataSetSurfaceFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "NonlinearSubdivisionLevel: "
      << this->GetNonlinearSubdivisionLevel() << endl;
+  os << indent << "Threaded: " << (this->Threaded ? "On\n" : "Off\n");
 }
 
 //========================================================================
@@ -1505,6 +1765,11 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
     input = tempInput;
     cellIter = vtkSmartPointer<vtkCellIterator>::Take(input->NewCellIterator());
   }
+  else if (this->Threaded &&
+           this->ThreadedUnstructuredGridExecute(input, output))
+  {
+    return 1;
+  }
 
   vtkUnsignedCharArray* ghosts = input->GetPointGhostArray();
   vtkCellArray *newVerts;
@@ -2180,6 +2445,166 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkDataSetSurfaceFilter::ThreadedUnstructuredGridExecute(
+  vtkDataSet *dataSetInput, vtkPolyData *output)
+{
+  vtkUnstructuredGrid *input = vtkUnstructuredGrid::SafeDownCast(dataSetInput);
+  if (input == NULL || input->GetCellTypesArray() == NULL ||
+      input->GetPoints() == NULL)
+  {
+    return 0;
+  }
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numCells = input->GetNumberOfCells();
+  // A face is stored as 8 * cellId + faceId, which must fit in a vtkIdType
+  if (numCells > VTK_ID_MAX / 8)
+  {
+    return 0;
+  }
+  const unsigned char *cellTypes = input->GetCellTypesArray()->GetPointer(0);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    if (vtkSurfaceNumberOfFaces(cellTypes[cellId]) == 0)
+    {
+      return 0;
+    }
+  }
+  if (numPts < 1 || numCells < 1)
+  {
+    return 0;
+  }
+
+  vtkUnsignedCharArray* ghosts = input->GetPointGhostArray();
+  vtkCellData *inputCD = input->GetCellData();
+  vtkPointData *outputPD = output->GetPointData();
+  vtkCellData *outputCD = output->GetCellData();
+
+  // Shallow copy field data not associated with points or cells
+  output->GetFieldData()->ShallowCopy(input->GetFieldData());
+
+  // Distribute the faces in the bins of their smallest point id
+  vtkCellPointsCursor cursor(input);
+  vtkAtomic<vtkIdType> *counts = new vtkAtomic<vtkIdType>[numPts];
+  vtkSurfaceCountFaces countFaces(cursor, counts);
+  vtkSMPTools::For(0, numCells, countFaces);
+
+  std::vector<vtkIdType> offsets(numPts + 1);
+  vtkSMPTools::ExclusiveScan(counts, counts + numPts, offsets.begin(),
+                             static_cast<vtkIdType>(0));
+  offsets[numPts] = offsets[numPts - 1] + counts[numPts - 1];
+  vtkIdType numFaces = offsets[numPts];
+
+  std::vector<vtkIdType> faces(numFaces);
+  vtkSurfaceStartPositions startPositions = { &offsets[0], counts };
+  vtkSMPTools::For(0, numPts, startPositions);
+  vtkSurfaceInsertFaces insertFaces(cursor, counts, &faces[0]);
+  vtkSMPTools::For(0, numCells, insertFaces);
+  delete [] counts;
+  this->UpdateProgress(0.4);
+
+  // Find the faces used by a single cell
+  vtkSurfaceResolveFaces resolveFaces(cursor, &offsets[0], &faces[0]);
+  vtkSMPTools::For(0, numPts, resolveFaces);
+  this->UpdateProgress(0.8);
+
+  // Allocate
+  vtkPoints *newPts = vtkPoints::New();
+  newPts->SetDataType(input->GetPoints()->GetData()->GetDataType());
+  newPts->Allocate(numPts);
+  vtkCellArray *newPolys = vtkCellArray::New();
+  newPolys->Allocate(4*numCells,numCells/2);
+  outputPD->CopyGlobalIdsOn();
+  outputPD->CopyAllocate(input->GetPointData(), numPts, numPts/2);
+  outputCD->CopyGlobalIdsOn();
+  outputCD->CopyAllocate(inputCD, numCells, numCells/2);
+
+  if (this->PassThroughCellIds)
+  {
+    this->OriginalCellIds = vtkIdTypeArray::New();
+    this->OriginalCellIds->SetName(this->GetOriginalCellIdsName());
+    this->OriginalCellIds->SetNumberOfComponents(1);
+  }
+  if (this->PassThroughPointIds)
+  {
+    this->OriginalPointIds = vtkIdTypeArray::New();
+    this->OriginalPointIds->SetName(this->GetOriginalPointIdsName());
+    this->OriginalPointIds->SetNumberOfComponents(1);
+  }
+
+  this->NumberOfNewCells = 0;
+  this->PointMap = new vtkIdType[numPts];
+  vtkSMPTools::Fill(this->PointMap, this->PointMap + numPts,
+                    static_cast<vtkIdType>(-1));
+
+  // Transfer the remaining faces in the order of the bins, numbering the
+  // points as they are used
+  const vtkIdType *ids;
+  vtkIdType pts[4];
+  for (vtkIdType i = 0; i < numFaces; ++i)
+  {
+    if (faces[i] < 0)
+    {
+      continue;
+    }
+    vtkIdType cellId = faces[i] / 8;
+    cursor.GetCellPoints(cellId, ids);
+    int numFacePts = vtkSurfaceGetFace(cursor.GetCellType(cellId), ids,
+                                       static_cast<int>(faces[i] % 8), pts);
+
+    // If all of the face points are duplicate (boundary), or if one of them
+    // is hidden, do not extract the face.
+    bool allGhosts = (ghosts != NULL);
+    bool oneHidden = false;
+    for (int j = 0; j < numFacePts; j++)
+    {
+      if (ghosts)
+      {
+        unsigned char val = ghosts->GetValue(pts[j]);
+        if (!(val & vtkDataSetAttributes::DUPLICATEPOINT))
+        {
+          allGhosts = false;
+        }
+        if (val & vtkDataSetAttributes::HIDDENPOINT)
+        {
+          oneHidden = true;
+        }
+      }
+      pts[j] = this->GetOutputPointId(pts[j], input, newPts, outputPD);
+    }
+    if (allGhosts || oneHidden)
+    {
+      continue;
+    }
+    newPolys->InsertNextCell(numFacePts, pts);
+    this->RecordOrigCellId(this->NumberOfNewCells, cellId);
+    outputCD->CopyData(inputCD, cellId, this->NumberOfNewCells++);
+  }
+
+  if (this->PassThroughCellIds)
+  {
+    outputCD->AddArray(this->OriginalCellIds);
+    this->OriginalCellIds->Delete();
+    this->OriginalCellIds = NULL;
+  }
+  if (this->PassThroughPointIds)
+  {
+    outputPD->AddArray(this->OriginalPointIds);
+    this->OriginalPointIds->Delete();
+    this->OriginalPointIds = NULL;
+  }
+  delete [] this->PointMap;
+  this->PointMap = NULL;
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+  output->SetPolys(newPolys);
+  newPolys->Delete();
+  output->Squeeze();
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkDataSetSurfaceFilter::InitializeQuadHash(vtkIdType numPoints)
 {
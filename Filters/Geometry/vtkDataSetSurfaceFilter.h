@@ -128,6 +128,20 @@ public:
   vtkGetMacro(NonlinearSubdivisionLevel, int);
   //@}
 
+  //@{
+  /**
+   * If on, the surface of unstructured grids made only of tetrahedra,
+   * hexahedra, voxels, wedges and pyramids is extracted in parallel with
+   * vtkSMPTools: the faces are distributed by their smallest point id, each
+   * thread resolving the faces shared by cells in its own point ids. The
+   * output is the same as when off, and does not depend on the number of
+   * threads. Other inputs are processed serially. Off by default.
+   */
+  vtkSetMacro(Threaded, int);
+  vtkGetMacro(Threaded, int);
+  vtkBooleanMacro(Threaded, int);
+  //@}
+
   //@{
   /**
    * Direct access methods that can be used to use the this class as an
@@ -175,6 +189,7 @@ protected:
   ~vtkDataSetSurfaceFilter() VTK_OVERRIDE;
 
   int UseStrips;
+  int Threaded;
 
   int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *) VTK_OVERRIDE;
 
@@ -209,6 +224,14 @@ protected:
                         int aAxis, int bAxis, int cAxis,
                         vtkIdType *wholeExt);
 
+  /**
+   * Parallel surface extraction of unstructured grids of linear 3D cells,
+   * used by UnstructuredGridExecute() when Threaded is on. Return 0 if the
+   * input has other cells, or too many cells to number their faces in a
+   * vtkIdType, leaving the output untouched.
+   */
+  int ThreadedUnstructuredGridExecute(vtkDataSet *input, vtkPolyData *output);
+
   void InitializeQuadHash(vtkIdType numPoints);
   void DeleteQuadHash();
   virtual void InsertQuadInHash(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType d,
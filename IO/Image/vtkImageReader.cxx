@@ -390,6 +390,16 @@ void vtkImageReaderUpdate1(vtkImageReader *self, vtkImageData *data, T *inPtr)
 void vtkImageReader::ExecuteDataWithInformation(vtkDataObject *output,
                                                 vtkInformation *outInfo)
 {
+  // The mask and the transform are applied while reading
+  if (!this->Transform &&
+      this->DataMask == static_cast<vtkTypeUInt64>(~0UL) &&
+      this->MapOutputData(output, outInfo))
+  {
+    vtkImageData::SafeDownCast(output)->GetPointData()->GetScalars()->SetName(
+      this->ScalarArrayName);
+    return;
+  }
+
   vtkImageData *data = this->AllocateOutputData(output, outInfo);
 
   void *ptr = NULL;
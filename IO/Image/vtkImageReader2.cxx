@@ -19,6 +19,7 @@
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMappedFileDataArray.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkErrorCode.h"
@@ -72,6 +73,8 @@ vtkImageReader2::vtkImageReader2()
   this->FileNameSliceOffset = 0;
   this->FileNameSliceSpacing = 1;
 
+  this->UseMemoryMapping = 0;
+
   // Left over from short reader
   this->SwapBytes = 0;
   this->FileLowerLeft = 0;
@@ -417,6 +420,8 @@ void vtkImageReader2::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Swap Bytes: " << (this->SwapBytes ? "On\n" : "Off\n");
 
+  os << indent << "UseMemoryMapping: " << this->UseMemoryMapping << "\n";
+
   os << indent << "DataIncrements: (" << this->DataIncrements[0];
   for (idx = 1; idx < 2; ++idx)
   {
@@ -766,12 +771,114 @@ void vtkImageReader2Update(vtkImageReader2 *self, vtkImageData *data, OT *outPtr
   }
 }
 
+//----------------------------------------------------------------------------
+// Map numTuples tuples of the file at position, NULL if they are not aligned
+// or cannot be mapped.
+template <class T>
+vtkDataArray* vtkImageReader2MapScalars(T*, const char* fileName,
+                                        vtkTypeUInt64 position,
+                                        int numComponents,
+                                        vtkIdType numTuples)
+{
+  if (position % sizeof(T) != 0)
+  {
+    return NULL;
+  }
+  vtkMappedFileDataArray<T>* array = vtkMappedFileDataArray<T>::New();
+  array->SetNumberOfComponents(numComponents);
+  if (!array->MapFile(fileName, position, numTuples))
+  {
+    array->Delete();
+    return NULL;
+  }
+  return array;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageReader2::MapOutputData(vtkDataObject *output,
+                                   vtkInformation *outInfo)
+{
+  vtkImageData *data = vtkImageData::SafeDownCast(output);
+  int *ext = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT());
+  if (!this->UseMemoryMapping || !data || !ext || this->MemoryBuffer ||
+      (!this->FileName && !this->FilePattern) ||
+      vtkImageData::GetScalarType(outInfo) != this->DataScalarType ||
+      vtkImageData::GetNumberOfScalarComponents(outInfo) !=
+        this->NumberOfScalarComponents ||
+      (this->SwapBytes &&
+       vtkDataArray::GetDataTypeSize(this->DataScalarType) > 1))
+  {
+    return 0;
+  }
+
+  // The rows, then the slices, must follow each other in the file
+  bool wholeSlices = ext[2] == this->DataExtent[2] &&
+    ext[3] == this->DataExtent[3] && (this->FileLowerLeft || ext[2] == ext[3]);
+  if (ext[0] != this->DataExtent[0] || ext[1] != this->DataExtent[1] ||
+      ext[0] > ext[1] || ext[2] > ext[3] || ext[4] > ext[5] ||
+      (!wholeSlices && (ext[2] != ext[3] || ext[4] != ext[5])) ||
+      (this->FileDimensionality == 2 && ext[4] != ext[5]) ||
+      (this->FileDimensionality != 2 && this->FileDimensionality != 3))
+  {
+    return 0;
+  }
+
+  // Same position as SeekFile(ext[0], ext[2], ext[4])
+  this->ComputeDataIncrements();
+  vtkTypeUInt64 position = this->GetHeaderSize(ext[4]);
+  if (this->FileLowerLeft)
+  {
+    position += static_cast<vtkTypeUInt64>(ext[2] - this->DataExtent[2]) *
+      this->DataIncrements[1];
+  }
+  else
+  {
+    position += static_cast<vtkTypeUInt64>(
+      this->DataExtent[3] - this->DataExtent[2] - ext[2]) *
+      this->DataIncrements[1];
+  }
+  if (this->FileDimensionality == 3)
+  {
+    position += static_cast<vtkTypeUInt64>(ext[4] - this->DataExtent[4]) *
+      this->DataIncrements[2];
+  }
+  this->ComputeInternalFileName(this->FileDimensionality == 3 ? 0 : ext[4]);
+
+  vtkIdType numTuples = static_cast<vtkIdType>(ext[1] - ext[0] + 1) *
+    (ext[3] - ext[2] + 1) * (ext[5] - ext[4] + 1);
+  vtkDataArray *scalars = NULL;
+  switch (this->DataScalarType)
+  {
+    vtkTemplateMacro(scalars = vtkImageReader2MapScalars(
+      static_cast<VTK_TT*>(0), this->InternalFileName, position,
+      this->NumberOfScalarComponents, numTuples));
+  }
+  if (!scalars)
+  {
+    return 0;
+  }
+
+  vtkDebugMacro("Mapping extent: " << ext[0] << ", " << ext[1] << ", "
+        << ext[2] << ", " << ext[3] << ", " << ext[4] << ", " << ext[5]);
+  data->SetExtent(ext);
+  data->GetPointData()->SetScalars(scalars);
+  scalars->Delete();
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 // This function reads a data from a file.  The datas extent/axes
 // are assumed to be the same as the file extent/order.
 void vtkImageReader2::ExecuteDataWithInformation(vtkDataObject *output,
                                                  vtkInformation *outInfo)
 {
+  if (this->MapOutputData(output, outInfo))
+  {
+    vtkImageData::SafeDownCast(output)->GetPointData()->GetScalars()->SetName(
+      "ImageFile");
+    return;
+  }
+
   vtkImageData *data = this->AllocateOutputData(output, outInfo);
 
   void *ptr;
@@ -243,6 +243,23 @@ public:
   vtkBooleanMacro(SwapBytes,int);
   //@}
 
+  //@{
+  /**
+   * If on, the scalars are not read but mapped from the file (see
+   * vtkMappedFileDataArray) when the requested extent is a contiguous
+   * block of the file: whole rows and slices of a 3D file (or a single
+   * slice of a 2D file), stored from the lower left corner without byte
+   * swapping and at a position aligned on the size of the scalars. The
+   * values are then loaded by the system as they are accessed and the
+   * pages of the file are shared between processes. Other requests are
+   * read as usual. The file must not be modified while the output exists.
+   * Default is off.
+   */
+  vtkSetMacro(UseMemoryMapping, int);
+  vtkGetMacro(UseMemoryMapping, int);
+  vtkBooleanMacro(UseMemoryMapping, int);
+  //@}
+
   ifstream *GetFile() {return this->File;}
   vtkGetVectorMacro(DataIncrements,unsigned long,4);
 
@@ -332,12 +349,21 @@ protected:
   int FileNameSliceOffset;
   int FileNameSliceSpacing;
 
+  int UseMemoryMapping;
+
   int RequestInformation(vtkInformation* request,
                                  vtkInformationVector** inputVector,
                                  vtkInformationVector* outputVector) VTK_OVERRIDE;
   virtual void ExecuteInformation();
   void ExecuteDataWithInformation(vtkDataObject *data, vtkInformation *outInfo) VTK_OVERRIDE;
   virtual void ComputeDataIncrements();
+
+  /**
+   * Set the update extent of outInfo on output and map its scalars from the
+   * file if UseMemoryMapping is on and the extent is a contiguous block of
+   * the file. Return 1 if the scalars were mapped, 0 if they must be read.
+   */
+  int MapOutputData(vtkDataObject *output, vtkInformation *outInfo);
 private:
   vtkImageReader2(const vtkImageReader2&) VTK_DELETE_FUNCTION;
   void operator=(const vtkImageReader2&) VTK_DELETE_FUNCTION;
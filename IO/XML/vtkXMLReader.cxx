@@ -34,6 +34,8 @@
 #include "vtkInformationVector.h"
 #include "vtkInstantiator.h"
 #include "vtkLZ4DataCompressor.h"
+#include "vtkMappedFileDataArray.h"
+#include "vtkMemoryMappedFile.h"
 #include "vtkObjectFactory.h"
 #include "vtkQuadratureSchemeDefinition.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -104,6 +106,8 @@ vtkXMLReader::vtkXMLReader()
   this->StringStream = 0;
   this->ReadFromInputString = 0;
   this->InputString = "";
+  this->UseMemoryMapping = 0;
+  this->MappedFile = 0;
   this->XMLParser = 0;
   this->ReaderErrorObserver = 0;
   this->ParserErrorObserver = 0;
@@ -158,6 +162,10 @@ vtkXMLReader::~vtkXMLReader()
     this->DestroyXMLParser();
   }
   this->CloseStream();
+  if (this->MappedFile)
+  {
+    this->MappedFile->Delete();
+  }
   this->CellDataArraySelection->RemoveObserver(this->SelectionObserver);
   this->PointDataArraySelection->RemoveObserver(this->SelectionObserver);
   this->SelectionObserver->Delete();
@@ -192,6 +200,7 @@ void vtkXMLReader::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << indent << "Stream: (none)\n";
   }
+  os << indent << "UseMemoryMapping: " << this->UseMemoryMapping << "\n";
   os << indent << "TimeStep:" << this->TimeStep << "\n";
   os << indent << "NumberOfTimeSteps:" << this->NumberOfTimeSteps << "\n";
   os << indent << "TimeStepRange:(" << this->TimeStepRange[0] << ","
@@ -351,6 +360,12 @@ void vtkXMLReader::CloseVTKFile()
     delete this->FileStream;
     this->FileStream = 0;
   }
+  // The mapped arrays keep the mapping alive
+  if (this->MappedFile)
+  {
+    this->MappedFile->Delete();
+    this->MappedFile = 0;
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -788,6 +803,73 @@ int vtkXMLDataReaderReadArrayValues(
 
 }
 
+namespace
+{
+//----------------------------------------------------------------------------
+// Create an array whose values may be mapped from the file, NULL for the
+// types that cannot be.
+vtkAbstractArray* vtkXMLReaderNewMappedArray(int dataType)
+{
+  // vtkIdTypeArray has its own data type
+  if (dataType == VTK_ID_TYPE)
+  {
+    return NULL;
+  }
+  switch (dataType)
+  {
+    vtkTemplateMacro(return vtkMappedFileDataArray<VTK_TT>::New());
+  }
+  return NULL;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+int vtkXMLReaderMapArray(T*, vtkAbstractArray* array,
+                         vtkMemoryMappedFile* file, vtkTypeInt64 position)
+{
+  vtkMappedFileDataArray<T>* mapped =
+    vtkMappedFileDataArray<T>::SafeDownCast(array);
+  if (!mapped || position % sizeof(T) != 0)
+  {
+    return 0;
+  }
+  return mapped->MapRegion(file, static_cast<vtkTypeUInt64>(position),
+                           mapped->GetNumberOfTuples()) ? 1 : 0;
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLReader::MapArrayValues(vtkXMLDataElement* da,
+                                 vtkAbstractArray* array)
+{
+  vtkTypeInt64 offset = 0;
+  vtkTypeInt64 position = 0;
+  if (!this->UseMemoryMapping || this->ReadFromInputString ||
+      !this->FileName || !da->GetScalarAttribute("offset", offset) ||
+      !this->XMLParser->GetAppendedDataFilePosition(offset,
+        array->GetNumberOfValues(), array->GetDataType(), position))
+  {
+    return 0;
+  }
+
+  if (!this->MappedFile)
+  {
+    this->MappedFile = vtkMemoryMappedFile::New();
+  }
+  if (!this->MappedFile->IsOpen() && !this->MappedFile->Open(this->FileName))
+  {
+    return 0;
+  }
+
+  switch (array->GetDataType())
+  {
+    vtkTemplateMacro(
+      return vtkXMLReaderMapArray(static_cast<VTK_TT*>(0), array,
+                                  this->MappedFile, position));
+  }
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 int vtkXMLReader::ReadArrayValues(
   vtkXMLDataElement* da, vtkIdType arrayIndex,
@@ -801,19 +883,28 @@ int vtkXMLReader::ReadArrayValues(
   }
   this->InReadData = 1;
   int result;
-  // All arrays types except vtkBitArray.
-  vtkArrayIterator* iter = array->NewIterator();
-  switch (array->GetDataType())
+  if (arrayIndex == 0 && startIndex == 0 &&
+      numValues == array->GetNumberOfValues() &&
+      this->MapArrayValues(da, array))
   {
-    vtkArrayIteratorTemplateMacro(
-      result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
-        arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
-  default:
-    result = 0;
+    result = 1;
   }
-  if (iter)
+  else
   {
-    iter->Delete();
+    // All arrays types except vtkBitArray.
+    vtkArrayIterator* iter = array->NewIterator();
+    switch (array->GetDataType())
+    {
+      vtkArrayIteratorTemplateMacro(
+        result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
+          arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
+    default:
+      result = 0;
+    }
+    if (iter)
+    {
+      iter->Delete();
+    }
   }
 
   this->ConvertGhostLevelsToGhostType(fieldType, array, startIndex, numValues);
@@ -1270,7 +1361,18 @@ vtkAbstractArray* vtkXMLReader::CreateArray(vtkXMLDataElement* da)
     return 0;
   }
 
-  vtkAbstractArray* array = vtkAbstractArray::CreateArray(dataType);
+  // Arrays stored in the raw appended data section may be mapped later
+  vtkAbstractArray* array = NULL;
+  if (this->UseMemoryMapping && !this->ReadFromInputString &&
+      da->GetAttribute("offset") && this->XMLParser &&
+      this->XMLParser->IsAppendedDataRaw())
+  {
+    array = vtkXMLReaderNewMappedArray(dataType);
+  }
+  if (!array)
+  {
+    array = vtkAbstractArray::CreateArray(dataType);
+  }
 
   array->SetName(da->GetAttribute("Name"));
 
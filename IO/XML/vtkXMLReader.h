@@ -39,6 +39,7 @@ class vtkXMLDataParser;
 class vtkInformationVector;
 class vtkInformation;
 class vtkCommand;
+class vtkMemoryMappedFile;
 
 class VTKIOXML_EXPORT vtkXMLReader : public vtkAlgorithm
 {
@@ -72,6 +73,21 @@ public:
   void SetInputString(std::string s) { this->InputString = s; }
   //@}
 
+  //@{
+  /**
+   * If on, the arrays stored uncompressed in the raw appended data section
+   * of the file are not read but mapped from the file (see
+   * vtkMappedFileDataArray) whenever an array of the output is a whole
+   * block of the file, in the byte order of this machine, at a position
+   * aligned on the size of its values. The values are then loaded by the
+   * system as they are accessed. The other arrays are read as usual. The
+   * file must not be modified while the output exists. Default is off.
+   */
+  vtkSetMacro(UseMemoryMapping, int);
+  vtkGetMacro(UseMemoryMapping, int);
+  vtkBooleanMacro(UseMemoryMapping, int);
+  //@}
+
   /**
    * Test whether the file (type) with the given name can be read by this
    * reader. If the file has a newer version than the reader, we still say
@@ -272,6 +288,11 @@ protected:
     vtkXMLDataElement* da, vtkIdType arrayIndex, vtkAbstractArray* array,
     vtkIdType startIndex, vtkIdType numValues, FieldType type = OTHER);
 
+  // Use the values of the appended data block of the array element da as
+  // the values of the array, without reading them, if the array was
+  // created for it and memory mapping is possible. Returns 1 on success.
+  int MapArrayValues(vtkXMLDataElement* da, vtkAbstractArray* array);
+
   // Setup the data array selections for the input's set of arrays.
   void SetDataArraySelections(vtkXMLDataElement* eDSA,
                               vtkDataArraySelection* sel);
@@ -310,6 +331,11 @@ protected:
   // The input string.
   std::string InputString;
 
+  // Whether arrays are mapped from the file, and the file mapping shared by
+  // the arrays of the current read.
+  int UseMemoryMapping;
+  vtkMemoryMappedFile* MappedFile;
+
   // The array selections.
   vtkDataArraySelection* PointDataArraySelection;
   vtkDataArraySelection* CellDataArraySelection;
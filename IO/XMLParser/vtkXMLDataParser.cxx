@@ -926,6 +926,58 @@ size_t vtkXMLDataParser::ReadAppendedData(vtkTypeInt64 offset,
   return this->ReadBinaryData(buffer, startWord, numWords, wordType);
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::IsAppendedDataRaw()
+{
+#ifdef VTK_WORDS_BIGENDIAN
+  const int nativeByteOrder = vtkXMLDataParser::BigEndian;
+#else
+  const int nativeByteOrder = vtkXMLDataParser::LittleEndian;
+#endif
+  return (this->AppendedDataPosition > 0 && !this->Compressor &&
+          this->ByteOrder == nativeByteOrder &&
+          !vtkBase64InputStream::SafeDownCast(this->AppendedDataStream));
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::GetAppendedDataFilePosition(vtkTypeInt64 offset,
+                                                  size_t numWords,
+                                                  int wordType,
+                                                  vtkTypeInt64& position)
+{
+  if (!this->IsAppendedDataRaw())
+  {
+    return 0;
+  }
+
+  // The block starts with the length of the data
+#if defined(VTK_HAS_STD_UNIQUE_PTR)
+  std::unique_ptr<vtkXMLDataHeader>
+    uh(vtkXMLDataHeader::New(this->HeaderType, 1));
+#else
+  std::auto_ptr<vtkXMLDataHeader>
+    uh(vtkXMLDataHeader::New(this->HeaderType, 1));
+#endif
+  istream* stream = this->GetStream();
+  stream->clear(stream->rdstate() & ~ios::eofbit);
+  stream->clear(stream->rdstate() & ~ios::failbit);
+  this->SeekG(this->AppendedDataPosition + offset);
+  size_t const headerSize = uh->DataSize();
+  if (!stream->read(reinterpret_cast<char*>(uh->Data()), headerSize))
+  {
+    stream->clear(stream->rdstate() & ~(ios::eofbit | ios::failbit));
+    return 0;
+  }
+  if (uh->Get(0) < static_cast<vtkTypeUInt64>(numWords) *
+                   this->GetWordTypeSize(wordType))
+  {
+    return 0;
+  }
+
+  position = this->AppendedDataPosition + offset + headerSize;
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 // Define a parsing function template.  The extra "long" argument is used
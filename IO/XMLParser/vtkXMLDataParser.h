@@ -79,6 +79,23 @@ public:
   { return this->ReadAppendedData(offset, buffer, startWord, numWords,
                                     VTK_CHAR); }
 
+  /**
+   * Return whether the values of the appended data section can be accessed
+   * directly in the file, that is whether it is raw (not base64 encoded),
+   * uncompressed and in the byte order of this machine.
+   */
+  int IsAppendedDataRaw();
+
+  /**
+   * Compute the position in the file of the values of the appended data
+   * block at the given offset, which must hold at least numWords words of
+   * the given type. This lets readers access the values directly, e.g. by
+   * mapping the file. Returns 0 if IsAppendedDataRaw() is false or the
+   * block is too small.
+   */
+  int GetAppendedDataFilePosition(vtkTypeInt64 offset, size_t numWords,
+                                  int wordType, vtkTypeInt64& position);
+
   /**
    * Read from an ascii data section starting at the current position in
    * the stream.  Returns the number of words read.
@@ -0,0 +1,401 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTestDataComparison.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @brief   Comparison of arrays, attributes and cells in tests.
+ *
+ * These functions compare the outputs of two runs of a filter, typically
+ * a serial run and a threaded run, value by value. They only report the
+ * name of the first array that differs, so that a test can add the context
+ * (configuration, number of threads) of the failure. The lattice grid and
+ * the wavy surface are inputs shared by the tests of the threaded filters.
+*/
+
+#ifndef vtkTestDataComparison_h
+#define vtkTestDataComparison_h
+
+#include "vtkAbstractArray.h"
+#include "vtkAlgorithm.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkVariant.h"
+
+#include <cmath>   // For std::fabs and std::sin
+#include <cstring> // For strcmp
+
+namespace vtkTest
+{
+
+/**
+ * Return true if both arrays have the same type, size and values. Data
+ * array values may differ by tolerance * (1 + |value|) to account for a
+ * different summation order. A nonzero tolerance also accepts integer
+ * values that differ by one, since interpolated integers are truncated.
+ * Other arrays are compared exactly.
+ */
+inline bool SameArrays(vtkAbstractArray *a1, vtkAbstractArray *a2,
+                       double tolerance = 0.0)
+{
+  if (!a1 || !a2 || a1->GetDataType() != a2->GetDataType() ||
+      a1->GetNumberOfComponents() != a2->GetNumberOfComponents() ||
+      a1->GetNumberOfTuples() != a2->GetNumberOfTuples())
+  {
+    return false;
+  }
+  vtkDataArray *d1 = vtkDataArray::SafeDownCast(a1);
+  vtkDataArray *d2 = vtkDataArray::SafeDownCast(a2);
+  if (!d1 || !d2)
+  {
+    for (vtkIdType i = 0; i < a1->GetNumberOfValues(); ++i)
+    {
+      if (a1->GetVariantValue(i) != a2->GetVariantValue(i))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+  bool integral = d1->GetDataType() != VTK_FLOAT &&
+    d1->GetDataType() != VTK_DOUBLE;
+  for (vtkIdType i = 0; i < d1->GetNumberOfTuples(); ++i)
+  {
+    for (int c = 0; c < d1->GetNumberOfComponents(); ++c)
+    {
+      double v1 = d1->GetComponent(i, c);
+      double v2 = d2->GetComponent(i, c);
+      double allowed = tolerance == 0.0 ? 0.0 :
+        (integral ? 1.0 : tolerance * (1.0 + std::fabs(v1)));
+      if (std::fabs(v1 - v2) > allowed)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Return true if both attributes have the same arrays and the same
+ * attribute arrays. Named arrays are matched by name, unnamed arrays by
+ * index. The first array that differs is reported on cerr.
+ */
+inline bool SameAttributes(vtkDataSetAttributes *a1, vtkDataSetAttributes *a2,
+                           double tolerance = 0.0)
+{
+  if (a1->GetNumberOfArrays() != a2->GetNumberOfArrays())
+  {
+    cerr << "Error: " << a1->GetNumberOfArrays() << " arrays instead of "
+         << a2->GetNumberOfArrays() << endl;
+    return false;
+  }
+  for (int i = 0; i < a1->GetNumberOfArrays(); ++i)
+  {
+    vtkAbstractArray *array = a1->GetAbstractArray(i);
+    const char *name = array->GetName();
+    if (!SameArrays(array, name ? a2->GetAbstractArray(name) :
+                    a2->GetAbstractArray(i), tolerance))
+    {
+      cerr << "Error: different array " << (name ? name : "(unnamed)")
+           << endl;
+      return false;
+    }
+  }
+  for (int attr = 0; attr < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attr)
+  {
+    vtkAbstractArray *attr1 = a1->GetAbstractAttribute(attr);
+    vtkAbstractArray *attr2 = a2->GetAbstractAttribute(attr);
+    if ((attr1 == NULL) != (attr2 == NULL) ||
+        (attr1 && (attr1->GetName() == NULL) != (attr2->GetName() == NULL)) ||
+        (attr1 && attr1->GetName() &&
+         strcmp(attr1->GetName(), attr2->GetName())))
+    {
+      cerr << "Error: different attribute "
+           << vtkDataSetAttributes::GetAttributeTypeAsString(attr) << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Return true if both cell arrays have the same cells. A NULL cell array
+ * is the same as an empty one.
+ */
+inline bool SameCells(vtkCellArray *cells1, vtkCellArray *cells2)
+{
+  vtkIdType num1 = cells1 ? cells1->GetNumberOfCells() : 0;
+  vtkIdType num2 = cells2 ? cells2->GetNumberOfCells() : 0;
+  return num1 == num2 &&
+    (num1 == 0 || SameArrays(cells1->GetData(), cells2->GetData()));
+}
+
+/**
+ * Return true if both data sets have the same points, the same cells and
+ * the same attributes. The points and the attributes are compared with the
+ * tolerance of SameArrays(). The first difference is reported on cerr.
+ */
+inline bool SameDataSets(vtkDataSet *d1, vtkDataSet *d2,
+                         double tolerance = 0.0)
+{
+  if (d1->GetNumberOfPoints() != d2->GetNumberOfPoints() ||
+      d1->GetNumberOfCells() != d2->GetNumberOfCells())
+  {
+    cerr << "Error: " << d1->GetNumberOfPoints() << " points and "
+         << d1->GetNumberOfCells() << " cells instead of "
+         << d2->GetNumberOfPoints() << " points and "
+         << d2->GetNumberOfCells() << " cells" << endl;
+    return false;
+  }
+  vtkPointSet *ps1 = vtkPointSet::SafeDownCast(d1);
+  vtkPointSet *ps2 = vtkPointSet::SafeDownCast(d2);
+  if (ps1 && ps2 && ps1->GetPoints() && ps2->GetPoints() &&
+      !SameArrays(ps1->GetPoints()->GetData(), ps2->GetPoints()->GetData(),
+                  tolerance))
+  {
+    cerr << "Error: different points" << endl;
+    return false;
+  }
+  vtkUnstructuredGrid *ug1 = vtkUnstructuredGrid::SafeDownCast(d1);
+  vtkUnstructuredGrid *ug2 = vtkUnstructuredGrid::SafeDownCast(d2);
+  vtkPolyData *pd1 = vtkPolyData::SafeDownCast(d1);
+  vtkPolyData *pd2 = vtkPolyData::SafeDownCast(d2);
+  if ((ug1 && ug2 &&
+       (!SameCells(ug1->GetCells(), ug2->GetCells()) ||
+        (ug1->GetCellTypesArray() &&
+         !SameArrays(ug1->GetCellTypesArray(), ug2->GetCellTypesArray())))) ||
+      (pd1 && pd2 &&
+       (!SameCells(pd1->GetVerts(), pd2->GetVerts()) ||
+        !SameCells(pd1->GetLines(), pd2->GetLines()) ||
+        !SameCells(pd1->GetPolys(), pd2->GetPolys()) ||
+        !SameCells(pd1->GetStrips(), pd2->GetStrips()))))
+  {
+    cerr << "Error: different cells" << endl;
+    return false;
+  }
+  return SameAttributes(d1->GetPointData(), d2->GetPointData(), tolerance) &&
+         SameAttributes(d1->GetCellData(), d2->GetCellData(), tolerance);
+}
+
+/**
+ * Return true if the output of the algorithm does not depend on the number
+ * of threads. The algorithm is updated by a single thread, then by 4
+ * threads, and both outputs are compared by SameDataSets(). The output of 4
+ * threads is left in the algorithm.
+ */
+inline bool SameOutputsWithThreads(vtkAlgorithm *algorithm,
+                                   double tolerance = 0.0)
+{
+  vtkSmartPointer<vtkDataSet> reference;
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(1), [&]()
+  {
+    algorithm->Modified();
+    algorithm->Update();
+  });
+  vtkDataSet *output =
+    vtkDataSet::SafeDownCast(algorithm->GetOutputDataObject(0));
+  reference.TakeReference(output->NewInstance());
+  reference->DeepCopy(output);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config(4), [&]()
+  {
+    algorithm->Modified();
+    algorithm->Update();
+  });
+  output = vtkDataSet::SafeDownCast(algorithm->GetOutputDataObject(0));
+  if (!SameDataSets(reference, output, tolerance))
+  {
+    cerr << "Error: the output of 4 threads is not the output of 1" << endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Fill the grid with the n^3 unit cubes of a lattice. The cube (i, j, k) is
+ * made of the cells of type cellTypes[(i + 2 j + 3 k) % numberOfCellTypes]:
+ * a hexahedron, a voxel, two wedges, the six tetrahedra around its diagonal
+ * or two pyramids. By default, all these types are used in this order. No
+ * attributes are added.
+ */
+inline void MakeLatticeGrid(vtkUnstructuredGrid *grid, int n,
+                            const int *cellTypes = NULL,
+                            int numberOfCellTypes = 0)
+{
+  static const int allCellTypes[5] =
+    { VTK_HEXAHEDRON, VTK_VOXEL, VTK_WEDGE, VTK_TETRA, VTK_PYRAMID };
+  if (!cellTypes)
+  {
+    cellTypes = allCellTypes;
+    numberOfCellTypes = 5;
+  }
+
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k <= n; ++k)
+  {
+    for (int j = 0; j <= n; ++j)
+    {
+      for (int i = 0; i <= n; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  grid->SetPoints(points.GetPointer());
+
+  grid->Allocate(6 * n * n * n);
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        // The points of the cube, x varying first
+        vtkIdType p[8];
+        for (int c = 0; c < 8; ++c)
+        {
+          p[c] = ((k + c / 4) * (n + 1) + j + (c / 2) % 2) * (n + 1) +
+                 i + c % 2;
+        }
+        switch (cellTypes[(i + 2 * j + 3 * k) % numberOfCellTypes])
+        {
+          case VTK_HEXAHEDRON:
+          {
+            vtkIdType hex[8] = { p[0], p[1], p[3], p[2],
+                                 p[4], p[5], p[7], p[6] };
+            grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+            break;
+          }
+          case VTK_VOXEL:
+            grid->InsertNextCell(VTK_VOXEL, 8, p);
+            break;
+          case VTK_WEDGE:
+          {
+            vtkIdType wedge1[6] = { p[0], p[1], p[2], p[4], p[5], p[6] };
+            vtkIdType wedge2[6] = { p[1], p[3], p[2], p[5], p[7], p[6] };
+            grid->InsertNextCell(VTK_WEDGE, 6, wedge1);
+            grid->InsertNextCell(VTK_WEDGE, 6, wedge2);
+            break;
+          }
+          case VTK_TETRA:
+          {
+            static const int paths[6][2] = { { 1, 3 }, { 1, 5 }, { 2, 3 },
+                                             { 2, 6 }, { 4, 5 }, { 4, 6 } };
+            for (int t = 0; t < 6; ++t)
+            {
+              vtkIdType tetra[4] = { p[0], p[paths[t][0]], p[paths[t][1]],
+                                     p[7] };
+              grid->InsertNextCell(VTK_TETRA, 4, tetra);
+            }
+            break;
+          }
+          default:
+          {
+            vtkIdType pyramid1[5] = { p[0], p[1], p[3], p[2], p[7] };
+            vtkIdType pyramid2[5] = { p[4], p[6], p[7], p[5], p[0] };
+            grid->InsertNextCell(VTK_PYRAMID, 5, pyramid1);
+            grid->InsertNextCell(VTK_PYRAMID, 5, pyramid2);
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Add a quad, a triangle, a line and a vertex on the points of each cube
+ * (i, i, 0) of a grid made by MakeLatticeGrid().
+ */
+inline void AddLatticeLowerCells(vtkUnstructuredGrid *grid, int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    vtkIdType p0 = i * (n + 2);
+    vtkIdType quad[4] = { p0, p0 + 1, p0 + n + 2, p0 + n + 1 };
+    grid->InsertNextCell(VTK_QUAD, 4, quad);
+    vtkIdType top = p0 + (n + 1) * (n + 1);
+    vtkIdType triangle[3] = { top, top + 1, top + n + 2 };
+    grid->InsertNextCell(VTK_TRIANGLE, 3, triangle);
+    grid->InsertNextCell(VTK_LINE, 2, quad + 1);
+    grid->InsertNextCell(VTK_VERTEX, 1, triangle + 2);
+  }
+}
+
+/**
+ * Fill the polydata with a wavy surface of n^2 quads, every third one being
+ * split into two triangles, with a polyline along its diagonal and a vertex
+ * on every seventh point. No attributes are added.
+ */
+inline void MakeWavySurface(vtkPolyData *surface, int n)
+{
+  vtkNew<vtkPoints> points;
+  for (int j = 0; j <= n; ++j)
+  {
+    for (int i = 0; i <= n; ++i)
+    {
+      points->InsertNextPoint(i, j, std::sin(0.3 * i) * std::cos(0.2 * j));
+    }
+  }
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      vtkIdType p0 = j * (n + 1) + i;
+      vtkIdType quad[4] = { p0, p0 + 1, p0 + n + 2, p0 + n + 1 };
+      if ((i + j) % 3)
+      {
+        polys->InsertNextCell(4, quad);
+      }
+      else
+      {
+        vtkIdType tri1[3] = { p0, p0 + 1, p0 + n + 2 };
+        vtkIdType tri2[3] = { p0, p0 + n + 2, p0 + n + 1 };
+        polys->InsertNextCell(3, tri1);
+        polys->InsertNextCell(3, tri2);
+      }
+    }
+  }
+  vtkNew<vtkCellArray> lines;
+  lines->InsertNextCell(n + 1);
+  for (int i = 0; i <= n; ++i)
+  {
+    lines->InsertCellPoint(i * (n + 2));
+  }
+  vtkNew<vtkCellArray> verts;
+  for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ptId += 7)
+  {
+    verts->InsertNextCell(1, &ptId);
+  }
+  surface->SetPoints(points.GetPointer());
+  surface->SetVerts(verts.GetPointer());
+  surface->SetLines(lines.GetPointer());
+  surface->SetPolys(polys.GetPointer());
+}
+
+}
+
+#endif // vtkTestDataComparison_h